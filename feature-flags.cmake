@@ -16,3 +16,6 @@ include(src/cmake/feature-flag.cmake)
 
 # The new Windows backend based on Hyper-V Host Compute System / Host Compute Networking APIs
 feature_flag(HYPERV_HCS_ENABLED "Hyper-V HCS backend" WIN32)
+
+# Google Benchmark microbenchmarks for daemon and client hot paths (needs MULTIPASS_ENABLE_TESTS)
+feature_flag(BENCHMARKS_ENABLED "microbenchmarks")
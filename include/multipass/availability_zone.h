@@ -22,6 +22,8 @@
 #include "subnet.h"
 #include "virtual_machine.h"
 
+#include <cstddef>
+#include <functional>
 #include <memory>
 
 namespace multipass
@@ -31,13 +33,17 @@ class AvailabilityZone : private DisabledCopyMove
 public:
     using UPtr = std::unique_ptr<AvailabilityZone>;
     using ShPtr = std::shared_ptr<AvailabilityZone>;
+    // Called once per instance after it has transitioned, with how many of the zone's instances
+    // are done so far and their total. Calls are serialized, but may come from any thread.
+    using TransitionProgress =
+        std::function<void(const VirtualMachine& vm, std::size_t done, std::size_t total)>;
 
     virtual ~AvailabilityZone() = default;
 
     [[nodiscard]] virtual const std::string& get_name() const = 0;
     [[nodiscard]] virtual const Subnet& get_subnet() const = 0;
     [[nodiscard]] virtual bool is_available() const = 0;
-    virtual void set_available(bool new_available) = 0;
+    virtual void set_available(bool new_available, const TransitionProgress& progress = {}) = 0;
     virtual void add_vm(VirtualMachine& vm) = 0;
     virtual void remove_vm(VirtualMachine& vm) = 0;
 };
@@ -23,10 +23,27 @@
 #include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace multipass
 {
+// How automatic placement picks a zone for new instances
+enum class ZonePlacement
+{
+    first_available, // the first zone that is available, in order
+    least_loaded,    // the available zone with the smallest share of committed resources
+};
+
+// Resources committed to the instances in a zone
+struct ZoneLoad
+{
+    int instances = 0;
+    int cpus = 0;
+    long long memory_bytes = 0;
+    long long disk_bytes = 0;
+};
+
 class AvailabilityZoneManager : private DisabledCopyMove
 {
 public:
@@ -34,15 +51,19 @@ public:
     using ShPtr = std::shared_ptr<AvailabilityZoneManager>;
 
     using Zones = std::vector<std::reference_wrapper<const AvailabilityZone>>;
+    using ZoneLoads = std::unordered_map<std::string, ZoneLoad>; // keyed by zone name
 
     virtual ~AvailabilityZoneManager() = default;
 
     virtual AvailabilityZone& get_zone(const std::string& name) = 0;
     virtual const AvailabilityZone& get_zone(const std::string& name) const = 0;
     virtual Zones get_zones() const = 0;
-    // this returns a computed zone name, using an algorithm e.g. round-robin
+    // this returns a computed zone name, using the given placement policy and the loads of the
+    // zones (zones missing from [loads] count as empty)
     // not to be confused with [get_default_zone_name]
-    virtual std::string get_automatic_zone_name() = 0;
+    virtual std::string get_automatic_zone_name(
+        ZonePlacement placement = ZonePlacement::first_available,
+        const ZoneLoads& loads = {}) = 0;
     // this always returns the same zone name, to be given to VMs that were not assigned to a zone
     // in the past not to be confused with [get_automatic_zone]
     virtual std::string get_default_zone_name() const = 0;
@@ -39,12 +39,15 @@ public:
     const std::string& get_name() const override;
     const Subnet& get_subnet() const override;
     bool is_available() const override;
-    void set_available(bool new_available) override;
+    void set_available(bool new_available, const TransitionProgress& progress = {}) override;
     void add_vm(VirtualMachine& vm) override;
     void remove_vm(VirtualMachine& vm) override;
 
 private:
     mutable std::recursive_mutex mutex;
+    // Serializes set_available, which lets go of `mutex` while instances transition (so they need
+    // to outlive that)
+    std::mutex transition_mutex;
     const std::filesystem::path file_path;
     const std::string name;
     std::vector<std::reference_wrapper<VirtualMachine>> vms;
@@ -37,7 +37,8 @@ public:
     AvailabilityZone& get_zone(const std::string& name) override;
     const AvailabilityZone& get_zone(const std::string& name) const override;
     std::vector<std::reference_wrapper<const AvailabilityZone>> get_zones() const override;
-    std::string get_automatic_zone_name() override;
+    std::string get_automatic_zone_name(ZonePlacement placement = ZonePlacement::first_available,
+                                        const ZoneLoads& loads = {}) override;
     std::string get_default_zone_name() const override;
 
 private:
@@ -51,7 +52,8 @@ private:
         const ZoneArray zones{};
 
         ZoneCollection(ZoneArray&& zones, std::string last_used);
-        [[nodiscard]] std::string next_available();
+        [[nodiscard]] std::string next_available(ZonePlacement placement,
+                                                 const ZoneLoads& loads);
         [[nodiscard]] std::string last_used() const;
 
     private:
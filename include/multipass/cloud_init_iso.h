@@ -21,7 +21,9 @@
 
 #include <multipass/singleton.h>
 
+#include <cstdint>
 #include <filesystem>
+#include <ios>
 #include <string>
 #include <vector>
 
@@ -41,8 +43,14 @@ public:
 
     void write_to(const std::filesystem::path& path);
     void read_from(const std::filesystem::path& path);
+    // Writes the files that changed since the last read_from/write_to of the same path over their
+    // existing extents, as long as they still fit there; falls back to write_to otherwise
+    void write_changes_to(const std::filesystem::path& path);
 
-    friend bool operator==(const CloudInitIso& lhs, const CloudInitIso& rhs) = default;
+    friend bool operator==(const CloudInitIso& lhs, const CloudInitIso& rhs)
+    {
+        return lhs.files == rhs.files;
+    }
 
 private:
     struct FileEntry
@@ -52,7 +60,20 @@ private:
         std::string name;
         std::string data;
     };
+
+    // Where a file lives in the image on disk, along with the data it holds there
+    struct FileExtent
+    {
+        std::string name;
+        std::string data;
+        std::uint32_t location;   // in logical blocks
+        std::uint32_t num_blocks; // allocated to the file
+        std::streamoff iso_record_pos;
+        std::streamoff joliet_record_pos;
+    };
+
     std::vector<FileEntry> files;
+    std::vector<FileExtent> extents;
 };
 
 struct NetworkInterface;
@@ -39,6 +39,23 @@ constexpr auto min_cpu_cores = "1";
 constexpr auto default_memory_size = "1G";
 constexpr auto default_disk_size = "5G";
 constexpr auto default_cpu_cores = min_cpu_cores;
+
+// How the root disk is attached to QEMU instances
+constexpr auto disk_profile_default = "default";       // virtio-scsi, I/O on QEMU's main loop
+constexpr auto disk_profile_iothread = "iothread";     // virtio-scsi, dedicated I/O thread
+constexpr auto disk_profile_virtio_blk = "virtio-blk"; // virtio-blk, I/O thread, queue per vCPU
+constexpr auto disk_profiles = {disk_profile_default,
+                                disk_profile_iothread,
+                                disk_profile_virtio_blk};
+
+// Where QEMU instances get their RAM from
+constexpr auto memory_backing_default = "default";     // anonymous memory, regular pages
+constexpr auto memory_backing_memfd = "memfd";         // shareable memfd, regular pages
+constexpr auto memory_backing_hugepages = "hugepages"; // memfd on the host's 2 MiB hugepages
+constexpr auto memory_backings = {memory_backing_default,
+                                  memory_backing_memfd,
+                                  memory_backing_hugepages};
+
 constexpr auto default_timeout = std::chrono::seconds(300);
 constexpr auto image_resize_timeout =
     std::chrono::duration_cast<std::chrono::milliseconds>(5min).count();
@@ -48,6 +65,7 @@ constexpr auto home_automount_dir = "Home";
 constexpr auto multipass_storage_env_var = "MULTIPASS_STORAGE";
 constexpr auto driver_env_var = "MULTIPASS_VM_DRIVER";
 constexpr auto distributions_url_env_var = "MULTIPASS_DISTRIBUTIONS_URL";
+constexpr auto database_format_env_var = "MULTIPASS_DATABASE_FORMAT";
 
 constexpr auto winterm_profile_guid =
     "{aaaa9e6d-1e09-4be6-b76c-82b4ba1885fb}"; // identifies the primary Multipass profile in Windows
@@ -66,12 +84,24 @@ constexpr auto bridged_interface_key = "local.bridged-network";
 constexpr auto mounts_key = "local.privileged-mounts";
 constexpr auto winterm_key = "client.apps.windows-terminal.profiles";
 constexpr auto mirror_key = "local.image.mirror"; // the mirror of simple streams
+constexpr auto autostart_concurrency_key = "local.autostart.concurrency";
+constexpr auto autostart_priority_key = "local.autostart.priority";
+constexpr auto memory_reclaim_key = "local.memory-reclaim";
+constexpr auto multiplexed_mounts_key = "local.multiplexed-mounts";
+constexpr auto zone_placement_key = "local.zone-placement";
+constexpr auto warm_pool_size_key = "local.warm-pool.size";
+constexpr auto suspend_mode_key = "local.suspend-mode";
 
 constexpr auto cloud_init_file_name = "cloud-init-config.iso";
 
 [[maybe_unused]] // hands off clang-format
 constexpr auto key_examples = {petenv_key, driver_key, mounts_key};
 constexpr auto petenv_default = "primary";
+constexpr auto autostart_concurrency_default = "4";
+constexpr auto zone_placement_first_available = "first-available";
+constexpr auto zone_placement_least_loaded = "least-loaded";
+constexpr auto suspend_mode_snapshot = "snapshot"; // guest state saved inside the disk image
+constexpr auto suspend_mode_file = "file";         // guest state migrated to a file next to it
 constexpr auto timeout_exit_code = 5;
 constexpr auto authenticated_certs_dir = "authenticated-certs";
 constexpr auto home_in_instance = "/home/ubuntu";
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <boost/json.hpp>
+
+namespace multipass
+{
+// Which host CPUs an instance runs on
+struct CpuAffinity
+{
+    std::string host_cpus;  // CPU list, e.g. "0-3,8"; empty for any
+    bool pin_vcpus = false; // give each vCPU thread one of those CPUs, round-robin
+
+    friend inline bool operator==(const CpuAffinity& a, const CpuAffinity& b) = default;
+};
+
+// Parses a CPU list in the format of cpuset(7), e.g. "0-3,8", into sorted and unique CPU numbers.
+// Throws std::invalid_argument when the list is malformed.
+std::vector<int> parse_cpu_list(const std::string& list);
+// The shortest CPU list naming the given CPUs
+std::string format_cpu_list(std::vector<int> cpus);
+
+inline void tag_invoke(const boost::json::value_from_tag&,
+                       boost::json::value& json,
+                       const CpuAffinity& affinity)
+{
+    json = {{"host_cpus", affinity.host_cpus}, {"pin_vcpus", affinity.pin_vcpus}};
+}
+
+inline CpuAffinity tag_invoke(const boost::json::value_to_tag<CpuAffinity>&,
+                              const boost::json::value& json)
+{
+    return {value_to<std::string>(json.at("host_cpus")), value_to<bool>(json.at("pin_vcpus"))};
+}
+} // namespace multipass
@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "constants.h"
+
+#include <optional>
+#include <string>
+
+#include <boost/json.hpp>
+
+namespace multipass
+{
+constexpr auto hugepage_size_mb = 2; // the only hugepage size QEMU is asked to use
+
+// How the host provides guest RAM
+struct MemoryBacking
+{
+    std::string type = memory_backing_default;
+    bool prealloc = false;        // fault all of it in before the guest boots
+    std::optional<int> host_node; // host NUMA node to allocate it from, if any
+
+    friend inline bool operator==(const MemoryBacking& a, const MemoryBacking& b) = default;
+};
+
+inline void tag_invoke(const boost::json::value_from_tag&,
+                       boost::json::value& json,
+                       const MemoryBacking& backing)
+{
+    json = {{"type", backing.type},
+            {"prealloc", backing.prealloc},
+            {"host_node", backing.host_node ? boost::json::value(*backing.host_node) : nullptr}};
+}
+
+inline MemoryBacking tag_invoke(const boost::json::value_to_tag<MemoryBacking>&,
+                                const boost::json::value& json)
+{
+    const auto& host_node = json.at("host_node");
+    return {value_to<std::string>(json.at("type")),
+            value_to<bool>(json.at("prealloc")),
+            host_node.is_null() ? std::nullopt : std::optional{value_to<int>(host_node)}};
+}
+} // namespace multipass
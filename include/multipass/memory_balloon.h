@@ -0,0 +1,32 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "memory_size.h"
+
+#include <optional>
+
+namespace multipass
+{
+// What a memory balloon device reports about the guest
+struct MemoryBalloon
+{
+    MemorySize actual;                   // memory the guest is currently left with
+    std::optional<MemorySize> available; // memory the guest can still use, once it reports it
+};
+} // namespace multipass
@@ -0,0 +1,108 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "disabled_copy_move.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace multipass::metrics
+{
+using Labels = std::vector<std::pair<std::string, std::string>>;
+
+// Upper bounds, in seconds, covering anything from a quick RPC to a slow instance boot
+inline const std::vector<double> duration_buckets{0.005, 0.025, 0.1, 0.5, 1, 2.5, 10, 30, 60, 180};
+
+// A count that only goes up. Updating it is lock-free.
+class Counter : private DisabledCopyMove
+{
+public:
+    Counter() = default;
+
+    void increment(std::uint64_t amount = 1) noexcept;
+    std::uint64_t value() const noexcept;
+
+private:
+    std::atomic<std::uint64_t> count{0};
+};
+
+// Sorts observations into fixed buckets and keeps their sum. Updating it is lock-free.
+class Histogram : private DisabledCopyMove
+{
+public:
+    explicit Histogram(std::vector<double> upper_bounds);
+
+    void observe(double value) noexcept;
+    void observe(std::chrono::steady_clock::duration duration) noexcept; // recorded in seconds
+
+    const std::vector<double>& upper_bounds() const noexcept;
+    // The observations in each bucket (not cumulative), plus a last one for those above all bounds
+    std::vector<std::uint64_t> bucket_counts() const;
+    std::uint64_t count() const noexcept;
+    double sum() const noexcept;
+
+private:
+    const std::vector<double> bounds;
+    const std::unique_ptr<std::atomic<std::uint64_t>[]> buckets;
+    std::atomic<double> total{0};
+};
+
+// Metrics are created on first use and then live as long as their registry, so callers can hold on
+// to the references they get. Looking a metric up takes a lock, updating it does not.
+class Registry : private DisabledCopyMove
+{
+public:
+    Registry() = default;
+
+    Counter& counter(std::string_view name, std::string_view help, const Labels& labels = {});
+    Histogram& histogram(std::string_view name,
+                         std::string_view help,
+                         const Labels& labels = {},
+                         const std::vector<double>& upper_bounds = duration_buckets);
+
+    // Every metric, in Prometheus' text exposition format
+    std::string to_text() const;
+
+private:
+    struct Family
+    {
+        std::string type;
+        std::string help;
+        std::map<std::string, std::unique_ptr<Counter>> counters;     // by rendered labels
+        std::map<std::string, std::unique_ptr<Histogram>> histograms; // by rendered labels
+    };
+
+    Family& family(std::string_view name, std::string_view type, std::string_view help);
+
+    mutable std::mutex mutex;
+    std::map<std::string, Family, std::less<>> families;
+};
+
+// The registry that the daemon serves
+Registry& registry();
+} // namespace multipass::metrics
@@ -20,6 +20,7 @@
 #include <multipass/file_ops.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
 #include <multipass/ssh/ssh_key_provider.h>
+#include <multipass/tracing.h>
 #include <multipass/vm_mount.h>
 
 #include <chrono>
@@ -54,6 +55,7 @@ public:
 
     void activate(ServerVariant server, std::chrono::milliseconds timeout = std::chrono::minutes(5))
     {
+        tracing::Span span{"MountHandler::activate"};
         std::lock_guard active_lock{active_mutex};
         if (!is_active())
             activate_impl(server, timeout);
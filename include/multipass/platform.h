@@ -35,6 +35,7 @@
 #include <QDir>
 #include <QString>
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -65,6 +66,11 @@ public:
     virtual bool link(const char* target, const char* link) const;
     virtual bool symlink(const char* target, const char* link, bool is_dir) const;
     virtual int utime(const char* path, int atime, int mtime) const;
+    // Copies a regular file, sharing extents with the source where the filesystem allows it and
+    // preserving holes otherwise. Reports how many source bytes have been processed so far.
+    virtual void clone_file(const std::filesystem::path& source,
+                            const std::filesystem::path& dest,
+                            const std::function<void(std::uintmax_t)>& on_progress) const;
     virtual QString get_username() const;
     virtual QDir get_alias_scripts_folder() const;
     virtual void create_alias_script(const std::string& alias, const AliasDefinition& def) const;
@@ -79,7 +85,10 @@ public:
     virtual QString default_driver() const;
     virtual QString default_privileged_mounts() const;
     [[nodiscard]] virtual std::string bridge_nomenclature() const;
-    [[nodiscard]] virtual bool subnet_used_locally(Subnet subnet) const;
+    // Snapshot of the subnets the host already routes or has addresses in
+    [[nodiscard]] virtual SubnetOverlapIndex local_subnets() const;
+    [[nodiscard]] virtual bool subnet_used_locally(Subnet subnet,
+                                                   const SubnetOverlapIndex& local_subnets) const;
     [[nodiscard]] virtual Subnet get_preferred_subnet(const std::filesystem::path& data_dir) const;
 
     virtual int get_cpus() const;
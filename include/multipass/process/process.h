@@ -114,6 +114,11 @@ public:
 
     virtual ProcessState execute(const int timeout = 30000) = 0;
 
+    // Re-apply the spec's security policy, for specs whose policy changes while running
+    virtual void reload_security_policy()
+    {
+    }
+
 signals:
     void started();
     void finished(multipass::ProcessState process_state);
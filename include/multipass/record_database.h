@@ -0,0 +1,96 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <QString>
+
+#include <boost/json.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class QFile;
+
+namespace multipass
+{
+class CorruptRecordDatabaseException : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+// A database of named records (instance specs, image vault records...), stored either as a JSON
+// object or in a compact binary file. Binary files are memory-mapped and each record is only
+// decoded when it is asked for.
+class RecordDatabase
+{
+public:
+    enum class Format
+    {
+        json,
+        binary
+    };
+
+    // The format databases are written in: binary when MULTIPASS_DATABASE_FORMAT is "binary"
+    static Format configured_format();
+    // Where the database stored as JSON at json_path is stored in binary, e.g. "foo.json" ->
+    // "foo.db"
+    static QString binary_path(const QString& json_path);
+
+    // Opens the database stored at json_path or at its binary path, preferring the configured
+    // format. A database that only exists in the other format is converted first. Returns
+    // std::nullopt when neither file exists or has any contents. Throws std::runtime_error when the
+    // database cannot be read.
+    static std::optional<RecordDatabase> open(const QString& json_path);
+    // Opens the database in the file at path, whatever its format
+    static RecordDatabase open_file(const QString& path);
+
+    // Writes records in the configured format and removes the database in the other format
+    static void write(const QString& json_path, const boost::json::value& records);
+
+    static QByteArray encode(const boost::json::object& records);
+
+    RecordDatabase(RecordDatabase&&) noexcept;
+    RecordDatabase& operator=(RecordDatabase&&) noexcept;
+    ~RecordDatabase();
+
+    Format format() const;
+    const std::vector<std::string>& keys() const;
+    // Throws std::out_of_range for unknown keys and CorruptRecordDatabaseException when the record
+    // cannot be decoded
+    boost::json::value at(const std::string& key) const;
+    boost::json::object to_json() const;
+
+private:
+    explicit RecordDatabase(boost::json::object records);
+    RecordDatabase(std::unique_ptr<QFile> file, const uchar* mapped, QByteArray contents);
+
+    Format db_format;
+    std::unique_ptr<QFile> file; // kept open while mapped
+    QByteArray contents;         // when the file could not be mapped
+    std::vector<std::string> record_keys;
+    boost::json::object json_records;
+    std::unordered_map<std::string, std::span<const std::byte>> binary_records;
+};
+} // namespace multipass
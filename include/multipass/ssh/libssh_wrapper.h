@@ -68,6 +68,7 @@ public:
                                              void* dest,
                                              uint32_t count,
                                              int is_stderr) const;
+    virtual int ssh_channel_poll_timeout(ssh_channel channel, int timeout_ms, int is_stderr) const;
     virtual int ssh_channel_request_pty_size(ssh_channel channel,
                                              const char* term,
                                              int cols,
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/disabled_copy_move.h>
+#include <multipass/ssh/ssh_session.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+/**
+ * A pool of connected SSH sessions to the same instance, so that guest commands can run
+ * concurrently without a key exchange each time.
+ *
+ * Sessions are handed out for exclusive use and return to the pool when released. Idle sessions
+ * are checked before being handed out and those that are no longer connected are dropped, as are
+ * those that stay idle for longer than the idle timeout (except for the most recently used one).
+ */
+class SSHSessionPool : private DisabledCopyMove
+{
+public:
+    using Connect = std::function<std::unique_ptr<SSHSession>()>;
+
+    static constexpr std::size_t default_max_sessions = 4;
+    static constexpr std::chrono::seconds default_max_idle{120};
+
+    explicit SSHSessionPool(Connect connect,
+                            std::size_t max_sessions = default_max_sessions,
+                            std::chrono::milliseconds max_idle = default_max_idle);
+    ~SSHSessionPool();
+
+    /**
+     * Obtain a session for exclusive use. This is an idle session if one is connected, otherwise
+     * a new one if the pool is not full. Otherwise, this waits for a session to be released.
+     * @return A session that returns to the pool when destroyed
+     * @throws Whatever the connect function throws
+     */
+    [[nodiscard]] std::unique_ptr<SSHSession> acquire();
+
+    /**
+     * Execute a command in a session from acquire(), which stays in use until the process is
+     * destroyed.
+     */
+    [[nodiscard]] std::unique_ptr<SSHProcess> exec(const std::string& cmd, bool whisper = false);
+
+    /**
+     * Add an already connected session to the idle ones.
+     */
+    void add(std::unique_ptr<SSHSession> session);
+
+    /**
+     * Drop all sessions, then add the given one, if any. Sessions in use are disconnected when
+     * released.
+     */
+    void reset(std::unique_ptr<SSHSession> session = nullptr);
+
+    /**
+     * Drop idle sessions that are no longer connected.
+     * @return Whether any session remains, idle or in use
+     */
+    bool healthy();
+
+    std::size_t size() const; // idle and in use
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<SSHSession> session;
+        std::chrono::steady_clock::time_point last_used;
+    };
+
+    struct State
+    {
+        std::mutex mutex;
+        std::condition_variable released;
+        std::vector<Entry> idle; // most recently used last
+        std::size_t in_use = 0;
+        std::uint64_t generation = 0; // incremented on reset, to recognize stale sessions
+        std::chrono::milliseconds max_idle;
+
+        void release(std::unique_ptr<SSHSession> session, std::uint64_t session_generation);
+        std::vector<Entry> evict_idle();
+    };
+
+    class Lease;
+
+    Connect connect;
+    std::size_t max_sessions;
+    std::shared_ptr<State> state; // shared with leases, which may outlive the pool
+};
+} // namespace multipass
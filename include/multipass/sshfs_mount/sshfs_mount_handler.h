@@ -22,15 +22,22 @@
 #include <multipass/qt_delete_later_unique_ptr.h>
 #include <multipass/sshfs_server_config.h>
 
+#include <memory>
+
 namespace multipass
 {
+class SharedSSHFSServer;
+
 class SSHFSMountHandler : public MountHandler
 {
 public:
+    // A multiplexed handler shares one sshfs_server process with all other multiplexed mounts of
+    // the instance, instead of starting its own.
     SSHFSMountHandler(VirtualMachine* vm,
                       const SSHKeyProvider* ssh_key_provider,
                       const std::string& target,
-                      VMMount mount_spec);
+                      VMMount mount_spec,
+                      bool multiplexed = false);
     ~SSHFSMountHandler() override;
 
     void activate_impl(ServerVariant server, std::chrono::milliseconds timeout) override;
@@ -39,5 +46,8 @@ public:
 private:
     qt_delete_later_unique_ptr<Process> process;
     SSHFSServerConfig config;
+    const bool multiplexed;
+    std::shared_ptr<SharedSSHFSServer> shared_server;
+    std::string mount_id;
 };
 } // namespace multipass
@@ -19,7 +19,9 @@
 
 #include <multipass/id_mappings.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace multipass
 {
@@ -35,6 +37,9 @@ struct SSHFSServerConfig
     std::string target_path;
     id_mappings gid_mappings;
     id_mappings uid_mappings;
+    // When set, the server multiplexes all of the instance's mounts, which it receives at runtime.
+    // Lists the host directories currently shared, which the security policy needs to cover.
+    std::shared_ptr<std::vector<std::string>> multiplexed_sources = nullptr;
 };
 
 } // namespace multipass
@@ -23,6 +23,9 @@
 
 #include <boost/json.hpp>
 
+#include <optional>
+#include <vector>
+
 #include "ip_address.h"
 
 namespace multipass
@@ -116,6 +119,35 @@ private:
     PrefixLength prefix;
 };
 
+// An immutable set of subnets, indexed to answer overlap queries in logarithmic time
+class SubnetOverlapIndex
+{
+public:
+    SubnetOverlapIndex() = default;
+    explicit SubnetOverlapIndex(const std::vector<Subnet>& subnets);
+
+    // Whether any indexed subnet shares at least one address with `subnet`
+    [[nodiscard]] bool overlaps(Subnet subnet) const;
+    // Whether a single indexed subnet contains all of `subnet`
+    [[nodiscard]] bool covers(Subnet subnet) const;
+
+    [[nodiscard]] size_t size() const;
+
+private:
+    // Address ranges sorted by first address, each also recording the furthest last address of
+    // itself and all preceding ranges
+    struct Range
+    {
+        uint32_t first;
+        uint32_t last;
+        uint32_t furthest_last;
+    };
+
+    [[nodiscard]] std::optional<uint32_t> furthest_last_starting_by(uint32_t address) const;
+
+    std::vector<Range> ranges;
+};
+
 // Allocate child subnets from a base subnet
 class SubnetAllocator
 {
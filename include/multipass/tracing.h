@@ -0,0 +1,102 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "disabled_copy_move.h"
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace multipass::tracing
+{
+using Clock = std::chrono::steady_clock;
+
+struct SpanRecord
+{
+    std::string name;
+    Clock::time_point start;
+    Clock::time_point end;
+    int thread; // a small number identifying the thread the span ran on
+};
+
+// The spans recorded while serving a single request. Spans can be added from any thread.
+class Trace : private DisabledCopyMove
+{
+public:
+    Trace();
+
+    void add(SpanRecord span);
+    std::vector<SpanRecord> spans() const;
+
+    // The spans in Chrome's Trace Event Format, timed from the creation of the trace. This loads
+    // in chrome://tracing or https://ui.perfetto.dev
+    std::string to_chrome_json() const;
+
+private:
+    const Clock::time_point origin;
+    mutable std::mutex mutex;
+    std::vector<SpanRecord> records;
+};
+
+// The trace that spans started on the calling thread record into, if any
+std::shared_ptr<Trace> current_trace();
+
+// Makes a trace current on the calling thread for the lifetime of this object, restoring the
+// previous one afterwards. A null trace disables tracing in its scope.
+class ActiveTrace : private DisabledCopyMove
+{
+public:
+    explicit ActiveTrace(std::shared_ptr<Trace> trace);
+    ~ActiveTrace();
+
+private:
+    std::shared_ptr<Trace> previous;
+};
+
+// Records the time from its construction to its destruction in the current trace. Without one,
+// it costs a thread-local lookup.
+class Span : private DisabledCopyMove
+{
+public:
+    explicit Span(std::string_view name);
+    ~Span();
+
+private:
+    std::shared_ptr<Trace> trace;
+    std::string name;
+    Clock::time_point start;
+};
+
+// Wraps a callable so that it runs with the calling thread's current trace, for work that is
+// handed over to other threads (e.g. with QtConcurrent::run)
+template <typename F>
+auto traced(F&& f)
+{
+    return [trace = current_trace(),
+            f = std::forward<F>(f)](auto&&... args) mutable -> decltype(auto) {
+        ActiveTrace active_trace{trace};
+        return std::invoke(f, std::forward<decltype(args)>(args)...);
+    };
+}
+} // namespace multipass::tracing
@@ -27,10 +27,14 @@
 
 #include <yaml-cpp/yaml.h>
 
+#include <algorithm>
 #include <chrono>
+#include <exception>
 #include <filesystem>
 #include <functional>
 #include <future>
+#include <iterator>
+#include <mutex>
 #include <ranges>
 #include <string>
 #include <vector>
@@ -219,6 +223,58 @@ void parallel_for_each(Container& input_container, UnaryOperation&& unary_op)
         empty_future.get();
     }
 }
+
+// like parallel_for_each, but with at most max_concurrency operations in flight at any time. Once
+// an operation throws, no further items are started; the first exception is rethrown after the
+// operations already running have finished.
+template <typename Container, typename UnaryOperation>
+void bounded_parallel_for_each(Container& input_container,
+                               std::size_t max_concurrency,
+                               UnaryOperation&& unary_op)
+{
+    std::mutex mutex;
+    auto next = std::begin(input_container);
+    const auto end = std::end(input_container);
+    std::exception_ptr first_error;
+
+    auto worker = [&] {
+        while (true)
+        {
+            decltype(next) item;
+            {
+                std::lock_guard lock{mutex};
+                if (first_error || next == end)
+                    return;
+                item = next++;
+            }
+
+            try
+            {
+                unary_op(*item);
+            }
+            catch (...)
+            {
+                std::lock_guard lock{mutex};
+                if (!first_error)
+                    first_error = std::current_exception();
+            }
+        }
+    };
+
+    const auto num_workers =
+        std::min(std::max(max_concurrency, std::size_t{1}), std::size(input_container));
+    std::vector<std::future<void>> workers;
+    workers.reserve(num_workers);
+
+    for (std::size_t i = 0; i < num_workers; ++i)
+        workers.emplace_back(std::async(std::launch::async, worker));
+
+    for (auto& finished_worker : workers)
+        finished_worker.get();
+
+    if (first_error)
+        std::rethrow_exception(first_error);
+}
 } // namespace utils
 
 class Utils : public Singleton<Utils>
@@ -0,0 +1,64 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <istream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+namespace backend
+{
+class Qcow2FormatException : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
+struct Qcow2Snapshot
+{
+    std::string id;
+    std::string tag;
+    std::uint64_t vm_state_size;
+    std::uint32_t date_sec;
+    std::uint32_t date_nsec;
+    std::uint64_t vm_clock_nsec;
+    std::optional<std::uint64_t> icount;
+};
+
+struct Qcow2Info
+{
+    std::uint32_t version;
+    std::uint32_t cluster_bits;
+    std::uint64_t virtual_size;
+    std::string backing_file;
+    std::vector<Qcow2Snapshot> snapshots;
+};
+
+// Reads the qcow2 header and snapshot table without involving qemu-img. Returns std::nullopt when
+// the data does not start with the qcow2 magic (e.g. raw images) or cannot be opened; throws
+// Qcow2FormatException when it does, but the metadata is truncated or inconsistent.
+std::optional<Qcow2Info> read_qcow2_info(std::istream& image);
+std::optional<Qcow2Info> read_qcow2_info(const std::filesystem::path& image_path);
+} // namespace backend
+} // namespace multipass
@@ -17,7 +17,10 @@
 
 #pragma once
 
+#include "cpu_affinity.h"
 #include "disabled_copy_move.h"
+#include "memory_backing.h"
+#include "memory_balloon.h"
 #include "network_interface.h"
 #include "user_messages.h"
 
@@ -102,6 +105,12 @@ public:
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) = 0;
+    virtual void set_network_multiqueue(bool enabled) = 0;
+    virtual void set_disk_profile(const std::string& profile) = 0;
+    virtual void set_memory_backing(const MemoryBacking& backing) = 0;
+    virtual void set_cpu_affinity(const CpuAffinity& affinity) = 0;
+    virtual MemoryBalloon memory_balloon() = 0;
+    virtual void set_memory_balloon_target(const MemorySize& target) = 0;
     virtual std::unique_ptr<MountHandler> make_native_mount_handler(const std::string& target,
                                                                     const VMMount& mount) = 0;
 
@@ -119,6 +128,13 @@ public:
     virtual std::shared_ptr<const Snapshot> take_snapshot(const VMSpecs& specs,
                                                           const std::string& snapshot_name,
                                                           const std::string& comment) = 0;
+    // Snapshots the disk of a running instance; `pause_duration` receives how long guest I/O was
+    // held while capturing
+    virtual std::shared_ptr<const Snapshot> take_live_snapshot(
+        const VMSpecs& specs,
+        const std::string& snapshot_name,
+        const std::string& comment,
+        std::chrono::microseconds& pause_duration) = 0;
     virtual void rename_snapshot(
         const std::string& old_name,
         const std::string& new_name) = 0; // only VM can avoid repeated names
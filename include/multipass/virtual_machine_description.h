@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <multipass/constants.h>
+#include <multipass/cpu_affinity.h>
+#include <multipass/memory_backing.h>
 #include <multipass/memory_size.h>
 #include <multipass/network_interface.h>
 #include <multipass/path.h>
@@ -50,6 +53,10 @@ public:
     YAML::Node user_data_config;
     YAML::Node vendor_data_config;
     YAML::Node network_data_config;
+    bool network_multiqueue = false;
+    std::string disk_profile = disk_profile_default;
+    MemoryBacking memory_backing{};
+    CpuAffinity cpu_affinity{};
 };
 } // namespace multipass
 
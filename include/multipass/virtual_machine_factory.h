@@ -53,7 +53,8 @@ public:
                                                const std::string& dest_name,
                                                const VMImage& dest_image,
                                                const SSHKeyProvider& key_provider,
-                                               VMStatusMonitor& monitor) = 0;
+                                               VMStatusMonitor& monitor,
+                                               const ProgressMonitor& progress_monitor) = 0;
 
     /** Removes any resources associated with a VM of the given name.
      *
@@ -31,7 +31,8 @@ public:
     enum class MountType : int
     {
         Classic = 0,
-        Native = 1
+        Native = 1,
+        Virtiofs = 2
     };
 
     VMMount() = default;
@@ -18,6 +18,9 @@
 #pragma once
 
 #include "availability_zone_manager.h"
+#include "constants.h"
+#include "cpu_affinity.h"
+#include "memory_backing.h"
 #include "memory_size.h"
 #include "network_interface.h"
 #include "virtual_machine.h"
@@ -46,6 +49,10 @@ struct VMSpecs
     int clone_count =
         0; // tracks the number of cloned vm from this source vm (regardless of deletes)
     std::string zone;
+    bool network_multiqueue = false;
+    std::string disk_profile = disk_profile_default;
+    MemoryBacking memory_backing{};
+    CpuAffinity cpu_affinity{};
 
     friend inline bool operator==(const VMSpecs& a, const VMSpecs& b) = default;
 };
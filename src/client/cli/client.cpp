@@ -30,6 +30,7 @@
 #include "cmd/info.h"
 #include "cmd/launch.h"
 #include "cmd/list.h"
+#include "cmd/metrics.h"
 #include "cmd/mount.h"
 #include "cmd/networks.h"
 #include "cmd/prefer.h"
@@ -97,6 +98,7 @@ mp::Client::Client(ClientConfig& config)
     add_command<cmd::Help>();
     add_command<cmd::Info>();
     add_command<cmd::List>();
+    add_command<cmd::Metrics>();
     add_command<cmd::Networks>();
     add_command<cmd::Mount>();
     add_command<cmd::Prefer>(aliases);
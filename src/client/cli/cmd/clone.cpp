@@ -34,7 +34,12 @@ mp::ReturnCodeVariant cmd::Clone::run(ArgParser* parser)
     }
 
     AnimatedSpinner spinner{cout};
-    auto action_on_success = [this, &spinner](CloneReply& reply) -> ReturnCodeVariant {
+    bool showing_progress = false;
+    auto action_on_success = [this, &spinner, &showing_progress](
+                                 CloneReply& reply) -> ReturnCodeVariant {
+        if (showing_progress)
+            cout << "\n";
+
         spinner.stop();
         cout << reply.reply_message();
 
@@ -47,8 +52,29 @@ mp::ReturnCodeVariant cmd::Clone::run(ArgParser* parser)
         return standard_failure_handler_for(name(), cerr, status, reply.reply_message());
     };
 
-    spinner.start("Cloning " + rpc_request.source_name());
-    return dispatch(&RpcMethod::clone, rpc_request, action_on_success, action_on_failure);
+    const auto cloning_message = "Cloning " + rpc_request.source_name();
+    auto streaming_callback =
+        [this, &spinner, &cloning_message, &showing_progress](
+            CloneReply& reply,
+            grpc::ClientReaderWriterInterface<CloneRequest, CloneReply>*) {
+            if (!reply.log_line().empty())
+                spinner.print(cerr, reply.log_line());
+
+            if (!reply.percent_complete().empty())
+            {
+                spinner.stop();
+                cout << "\r";
+                cout << cloning_message << ": " << reply.percent_complete() << "%" << std::flush;
+                showing_progress = true;
+            }
+        };
+
+    spinner.start(cloning_message);
+    return dispatch(&RpcMethod::clone,
+                    rpc_request,
+                    action_on_success,
+                    action_on_failure,
+                    streaming_callback);
 }
 
 std::string cmd::Clone::name() const
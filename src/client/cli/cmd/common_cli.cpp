@@ -24,6 +24,7 @@
 #include <multipass/constants.h>
 #include <multipass/exceptions/cmd_exceptions.h>
 #include <multipass/exceptions/settings_exceptions.h>
+#include <multipass/utils.h>
 
 #include <QCommandLineOption>
 #include <QString>
@@ -206,6 +207,34 @@ void multipass::cmd::add_timeout(multipass::ArgParser* parser)
     add_timeout_option(parser);
 }
 
+void multipass::cmd::add_trace_option(multipass::ArgParser* parser)
+{
+    QCommandLineOption trace_option(trace_option_name,
+                                    "Write a trace of where the daemon spent its time to <file>, "
+                                    "in Chrome's Trace Event Format (e.g. for "
+                                    "https://ui.perfetto.dev).",
+                                    "file");
+    parser->addOption(trace_option);
+}
+
+void multipass::cmd::write_trace(const multipass::ArgParser* parser,
+                                 const std::string& trace,
+                                 std::ostream& cerr)
+{
+    if (!parser->isSet(trace_option_name) || trace.empty())
+        return;
+
+    const auto file = parser->value(trace_option_name).toStdString();
+    try
+    {
+        MP_UTILS.make_file_with_content(file, trace, /*overwrite=*/true);
+    }
+    catch (const std::exception& e)
+    {
+        fmt::print(cerr, "Could not write the trace to {}: {}\n", file, e.what());
+    }
+}
+
 int multipass::cmd::parse_timeout(const multipass::ArgParser* parser)
 {
     if (parser->isSet("timeout"))
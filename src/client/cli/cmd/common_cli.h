@@ -38,6 +38,7 @@ namespace cmd
 {
 const QString all_option_name{"all"};
 const QString format_option_name{"format"};
+const QString trace_option_name{"trace"};
 
 ParseCode check_for_name_and_all_option_conflict(const ArgParser* parser,
                                                  std::ostream& cerr,
@@ -65,6 +66,9 @@ QString describe_common_settings_keys();
 void add_instance_timeout(multipass::ArgParser*);
 void add_timeout(multipass::ArgParser*);
 int parse_timeout(const multipass::ArgParser* parser);
+void add_trace_option(multipass::ArgParser*);
+// Writes the trace the daemon replied with to the file given with --trace, if any
+void write_trace(const multipass::ArgParser* parser, const std::string& trace, std::ostream& cerr);
 std::unique_ptr<multipass::utils::Timer> make_timer(int timeout,
                                                     AnimatedSpinner* spinner,
                                                     std::ostream& cerr,
@@ -67,7 +67,7 @@ ReturnCodeVariant DisableZones::run(ArgParser* parser)
     };
 
     const auto streaming_callback =
-        make_logging_spinner_callback<ZonesStateRequest, ZonesStateReply>(spinner, cerr);
+        make_reply_spinner_callback<ZonesStateRequest, ZonesStateReply>(spinner, cerr);
 
     return dispatch(&RpcMethod::zones_state, request, on_success, on_failure, streaming_callback);
 }
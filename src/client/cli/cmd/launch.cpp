@@ -269,6 +269,7 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
     });
 
     mp::cmd::add_instance_timeout(parser);
+    mp::cmd::add_trace_option(parser);
 
     auto status = parser->commandParse(this);
 
@@ -466,6 +467,7 @@ mp::ParseCode cmd::Launch::parse_args(mp::ArgParser* parser)
 
     request.set_time_zone(QTimeZone::systemTimeZoneId().toStdString());
     request.set_verbosity_level(parser->verbosityLevel());
+    request.set_trace(parser->isSet(mp::cmd::trace_option_name));
 
     return status;
 }
@@ -506,6 +508,8 @@ mp::ReturnCodeVariant cmd::Launch::request_launch(const ArgParser* parser)
         instance_name = QString::fromStdString(
             request.instance_name().empty() ? reply.vm_instance_name() : request.instance_name());
 
+        mp::cmd::write_trace(parser, reply.trace(), cerr);
+
         std::vector<std::string> warning_aliases;
         for (const auto& alias_to_be_created : reply.aliases_to_be_created())
         {
@@ -0,0 +1,76 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "metrics.h"
+#include "common_cli.h"
+
+#include <multipass/cli/argparser.h>
+
+namespace multipass::cmd
+{
+ReturnCodeVariant Metrics::run(ArgParser* parser)
+{
+    if (const auto ret = parse_args(parser); ret != ParseCode::Ok)
+        return parser->returnCodeFrom(ret);
+
+    auto on_success = [this](const MetricsReply& reply) -> ReturnCodeVariant {
+        cout << reply.metrics();
+        return Ok;
+    };
+
+    auto on_failure = [this](const grpc::Status& status) -> ReturnCodeVariant {
+        return standard_failure_handler_for(name(), cerr, status);
+    };
+
+    MetricsRequest request{};
+    request.set_verbosity_level(parser->verbosityLevel());
+    return dispatch(&RpcMethod::metrics, request, on_success, on_failure);
+}
+
+std::string Metrics::name() const
+{
+    return "metrics";
+}
+
+QString Metrics::short_help() const
+{
+    return QStringLiteral("Show daemon metrics");
+}
+
+QString Metrics::description() const
+{
+    return QStringLiteral(
+        "Show what the Multipass daemon has measured since it started: requests\n"
+        "served and how long they took, image downloads and cache hits, instance\n"
+        "boot times and file operations on mounts. The output is in Prometheus'\n"
+        "text exposition format.");
+}
+
+ParseCode Metrics::parse_args(ArgParser* parser)
+{
+    if (const auto status = parser->commandParse(this); status != ParseCode::Ok)
+        return status;
+
+    if (parser->positionalArguments().count() > 0)
+    {
+        cerr << "This command takes no arguments\n";
+        return ParseCode::CommandLineError;
+    }
+
+    return ParseCode::Ok;
+}
+} // namespace multipass::cmd
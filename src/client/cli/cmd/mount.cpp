@@ -42,6 +42,7 @@ namespace
 constexpr auto category = "mount cmd";
 const QString default_mount_type{"classic"};
 const QString native_mount_type{"native"};
+const QString virtiofs_mount_type{"virtiofs"};
 
 auto convert_id_for(const QString& id_string)
 {
@@ -62,11 +63,15 @@ auto checked_mount_type(const QString& type)
     if (type == native_mount_type)
         return mp::MountRequest_MountType_NATIVE;
 
+    if (type == virtiofs_mount_type)
+        return mp::MountRequest_MountType_VIRTIOFS;
+
     throw mp::ValidationException{
-        fmt::format("Bad mount type '{}' specified, please use '{}' or '{}'",
+        fmt::format("Bad mount type '{}' specified, please use '{}', '{}' or '{}'",
                     type,
                     default_mount_type,
-                    native_mount_type)};
+                    native_mount_type,
+                    virtiofs_mount_type)};
 }
 } // namespace
 
@@ -144,7 +149,8 @@ mp::ParseCode cmd::Mount::parse_args(mp::ArgParser* parser)
         "Specify the type of mount to use.\n"
         "Classic mounts use technology built into Multipass.\n"
         "Native mounts use hypervisor and/or platform specific mounts.\n"
-        "Valid types are: \'classic\' (default) and \'native\'",
+        "Virtiofs mounts share the directory through virtiofsd (QEMU on Linux only).\n"
+        "Valid types are: \'classic\' (default), \'native\' and \'virtiofs\'",
         "type",
         default_mount_type);
 
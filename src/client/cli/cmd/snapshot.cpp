@@ -36,6 +36,10 @@ mp::ReturnCodeVariant cmd::Snapshot::run(mp::ArgParser* parser)
     auto on_success = [this, &spinner](mp::SnapshotReply& reply) -> ReturnCodeVariant {
         spinner.stop();
         fmt::print(cout, "Snapshot taken: {}.{}\n", request.instance(), reply.snapshot());
+        if (request.live())
+            fmt::print(cout,
+                       "Instance paused for {:.3f} ms.\n",
+                       static_cast<double>(reply.pause_duration_us()) / 1000);
         return ReturnCode::Ok;
     };
 
@@ -65,7 +69,8 @@ QString cmd::Snapshot::short_help() const
 QString cmd::Snapshot::description() const
 {
     return QStringLiteral("Take a snapshot of a stopped instance that can later be restored to "
-                          "recover the current state.");
+                          "recover the current state. With --live, take a crash-consistent snapshot "
+                          "of the disk of a running instance instead, pausing it only briefly.");
 }
 
 mp::ParseCode cmd::Snapshot::parse_args(mp::ArgParser* parser)
@@ -82,7 +87,10 @@ mp::ParseCode cmd::Snapshot::parse_args(mp::ArgParser* parser)
         "An optional free comment to associate with the snapshot. (Hint: quote the text to "
         "avoid spaces being parsed by your shell)",
         "comment"};
-    parser->addOptions({name_opt, comment_opt});
+    QCommandLineOption live_opt{"live",
+                                "Snapshot a running instance without stopping it. Only the disk is "
+                                "captured; restoring the snapshot boots the instance from it."};
+    parser->addOptions({name_opt, comment_opt, live_opt});
 
     if (auto status = parser->commandParse(this); status != ParseCode::Ok)
         return status;
@@ -104,6 +112,7 @@ mp::ParseCode cmd::Snapshot::parse_args(mp::ArgParser* parser)
     request.set_instance(positional_args.first().toStdString());
     request.set_comment(parser->value(comment_opt).toStdString());
     request.set_snapshot(parser->value(name_opt).toStdString());
+    request.set_live(parser->isSet(live_opt));
     request.set_verbosity_level(parser->verbosityLevel());
 
     return ParseCode::Ok;
@@ -57,8 +57,9 @@ mp::ReturnCodeVariant cmd::Start::run(mp::ArgParser* parser)
 
     AnimatedSpinner spinner{cout};
 
-    auto on_success = [&spinner, this](mp::StartReply& reply) -> ReturnCodeVariant {
+    auto on_success = [&spinner, this, parser](mp::StartReply& reply) -> ReturnCodeVariant {
         spinner.stop();
+        mp::cmd::write_trace(parser, reply.trace(), cerr);
         if (term->is_live() && update_available(reply.update_info()))
             cout << update_notice(reply.update_info());
         return ReturnCode::Ok;
@@ -172,6 +173,7 @@ mp::ParseCode cmd::Start::parse_args(mp::ArgParser* parser)
     parser->addOption(all_option);
 
     mp::cmd::add_instance_timeout(parser);
+    mp::cmd::add_trace_option(parser);
 
     auto status = parser->commandParse(this);
 
@@ -193,6 +195,7 @@ mp::ParseCode cmd::Start::parse_args(mp::ArgParser* parser)
     try
     {
         request.set_timeout(mp::cmd::parse_timeout(parser));
+        request.set_trace(parser->isSet(mp::cmd::trace_option_name));
     }
     catch (const mp::ValidationException& e)
     {
@@ -278,15 +278,19 @@ std::string mp::CSVFormatter::format(const mp::AliasDict& aliases) const
 std::string mp::CSVFormatter::format(const ZonesReply& reply) const
 {
     fmt::memory_buffer buf;
-    fmt::format_to(std::back_inserter(buf), "Name,Available,Subnet\n");
+    fmt::format_to(std::back_inserter(buf), "Name,Available,Subnet,Instances,CPUs,Memory,Disk\n");
 
     for (const auto& zone : reply.zones())
     {
         fmt::format_to(std::back_inserter(buf),
-                       "{},{},{}\n",
+                       "{},{},{},{},{},{},{}\n",
                        zone.name(),
                        zone.available(),
-                       zone.subnet());
+                       zone.subnet(),
+                       zone.instances(),
+                       zone.cpus(),
+                       zone.memory(),
+                       zone.disk());
     }
 
     return fmt::to_string(buf);
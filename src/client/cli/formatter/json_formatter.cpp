@@ -109,6 +109,8 @@ boost::json::object generate_instance_details(const mp::DetailedInfoItem& item)
         memory.emplace("used", std::stoll(instance_details.memory_usage()));
     if (!item.memory_total().empty())
         memory.emplace("total", std::stoll(item.memory_total()));
+    if (!instance_details.memory_reclaimed().empty())
+        memory.emplace("reclaimed", std::stoll(instance_details.memory_reclaimed()));
     instance_info.emplace("memory", std::move(memory));
 
     instance_info.emplace("ipv4", boost::json::value_from(instance_details.ipv4()));
@@ -315,7 +317,12 @@ std::string mp::JsonFormatter::format(const ZonesReply& reply) const
     boost::json::object root_object;
 
     for (const auto& zone : reply.zones())
-        root_object[zone.name()] = {{"available", zone.available()}, {"subnet", zone.subnet()}};
+        root_object[zone.name()] = {{"available", zone.available()},
+                                    {"subnet", zone.subnet()},
+                                    {"instances", zone.instances()},
+                                    {"cpus", zone.cpus()},
+                                    {"memory", zone.memory()},
+                                    {"disk", zone.disk()}};
 
     return pretty_print(root_object);
 }
@@ -188,9 +188,14 @@ void generate_instance_details(Dest&& dest, const mp::DetailedInfoItem& item)
                    "Disk usage:",
                    to_usage(instance_details.disk_usage(), item.disk_total()));
     fmt::format_to(dest,
-                   "{:<16}{}\n",
+                   "{:<16}{}",
                    "Memory usage:",
                    to_usage(instance_details.memory_usage(), item.memory_total()));
+    if (!instance_details.memory_reclaimed().empty())
+        fmt::format_to(dest,
+                       " ({} reclaimed)",
+                       mp::MemorySize{instance_details.memory_reclaimed()}.human_readable());
+    fmt::format_to(dest, "\n");
 
     const auto& mount_paths = item.mount_info().mount_paths();
     fmt::format_to(dest, "{:<16}{}", "Mounts:", mount_paths.empty() ? "--\n" : "");
@@ -616,16 +621,33 @@ std::string mp::TableFormatter::format(const ZonesReply& reply) const
         [](const auto& zone) -> int { return zone.name().length(); },
         name_col_header.length());
 
+    const std::string subnet_col_header = "Subnet";
+    const auto subnet_column_width = mp::format::column_width(
+        zones.begin(),
+        zones.end(),
+        [](const auto& zone) -> int { return zone.subnet().length(); },
+        subnet_col_header.length());
+
     const std::string::size_type state_column_width = 14;
+    const std::string::size_type count_column_width = 11;
+    const std::string::size_type size_column_width = 10;
 
-    constexpr auto row_format = "{:<{}}{:<{}}{:<}\n";
+    constexpr auto row_format = "{:<{}}{:<{}}{:<{}}{:<{}}{:<{}}{:<{}}{:<}\n";
     fmt::format_to(std::back_inserter(buf),
                    row_format,
                    name_col_header,
                    name_column_width,
                    "State",
                    state_column_width,
-                   "Subnet");
+                   subnet_col_header,
+                   subnet_column_width,
+                   "Instances",
+                   count_column_width,
+                   "CPUs",
+                   count_column_width,
+                   "Memory",
+                   size_column_width,
+                   "Disk");
 
     for (const auto& zone : zones)
     {
@@ -635,8 +657,19 @@ std::string mp::TableFormatter::format(const ZonesReply& reply) const
                        name_column_width,
                        zone.available() ? "Available" : "Unavailable",
                        state_column_width,
-                       zone.subnet());
+                       zone.subnet(),
+                       subnet_column_width,
+                       zone.instances(),
+                       count_column_width,
+                       zone.cpus(),
+                       count_column_width,
+                       mp::MemorySize::from_bytes(zone.memory()).human_readable(),
+                       size_column_width,
+                       mp::MemorySize::from_bytes(zone.disk()).human_readable());
     }
 
+    if (!reply.placement().empty())
+        fmt::format_to(std::back_inserter(buf), "\nAutomatic placement: {}\n", reply.placement());
+
     return fmt::to_string(buf);
 }
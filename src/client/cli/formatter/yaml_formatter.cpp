@@ -145,6 +145,8 @@ YAML::Node generate_instance_details(const mp::DetailedInfoItem& item)
                           : YAML::Node(std::stoll(instance_details.memory_usage()));
     memory["total"] =
         item.memory_total().empty() ? YAML::Node() : YAML::Node(std::stoll(item.memory_total()));
+    if (!instance_details.memory_reclaimed().empty())
+        memory["reclaimed"] = std::stoll(instance_details.memory_reclaimed());
     instance_node["memory"] = memory;
 
     instance_node["ipv4"] = YAML::Node(YAML::NodeType::Sequence);
@@ -367,6 +369,10 @@ std::string mp::YamlFormatter::format(const mp::ZonesReply& reply) const
         YAML::Node zone_node;
         zone_node["available"] = zone.available();
         zone_node["subnet"] = zone.subnet();
+        zone_node["instances"] = zone.instances();
+        zone_node["cpus"] = zone.cpus();
+        zone_node["memory"] = zone.memory();
+        zone_node["disk"] = zone.disk();
         root_node[zone.name()] = zone_node;
     }
 
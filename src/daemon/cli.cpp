@@ -17,8 +17,10 @@
 
 #include "cli.h"
 
+#include <multipass/json_utils.h>
 #include <multipass/logging/standard_logger.h>
 #include <multipass/platform.h>
+#include <multipass/record_database.h>
 #include <multipass/utils.h>
 
 #include <multipass/format.h>
@@ -26,6 +28,9 @@
 #include <QCommandLineOption>
 #include <QCommandLineParser>
 
+#include <cstdlib>
+#include <iostream>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 
@@ -67,13 +72,37 @@ mp::DaemonConfigBuilder mp::cli::parse(const QCoreApplication& app)
                                       "specifies which address to use for the multipassd service;"
                                       " a socket can be specified using unix:<socket_file>",
                                       "server_name:port"};
+    QCommandLineOption export_db_option{"export-db",
+                                        "prints the instance or image database in <file> as JSON"
+                                        " and exits; useful with binary databases",
+                                        "file"};
 
     parser.addOption(logger_option);
     parser.addOption(verbosity_option);
     parser.addOption(address_option);
+    parser.addOption(export_db_option);
 
     parser.process(app);
 
+    if (parser.isSet(export_db_option))
+    {
+        try
+        {
+            auto records = RecordDatabase::open_file(parser.value(export_db_option)).to_json();
+            std::cout << pretty_print(records) << std::endl;
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << fmt::format("Could not export {}: {}",
+                                     parser.value(export_db_option),
+                                     e.what())
+                      << std::endl;
+            std::exit(EXIT_FAILURE);
+        }
+
+        std::exit(EXIT_SUCCESS);
+    }
+
     DaemonConfigBuilder builder;
 
     if (parser.isSet(verbosity_option))
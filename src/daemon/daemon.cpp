@@ -42,16 +42,19 @@
 #include <multipass/json_utils.h>
 #include <multipass/logging/client_logger.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/name_generator.h>
 #include <multipass/network_interface.h>
 #include <multipass/platform.h>
 #include <multipass/query.h>
+#include <multipass/record_database.h>
 #include <multipass/settings/bool_setting_spec.h>
 #include <multipass/settings/settings.h>
 #include <multipass/snapshot.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/top_catch_all.h>
+#include <multipass/tracing.h>
 #include <multipass/utils/grpc_utils.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine.h>
@@ -75,6 +78,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
 #include <functional>
 #include <optional>
 #include <stdexcept>
@@ -96,6 +100,10 @@ using error_string = std::string;
 
 constexpr auto category = "daemon";
 constexpr auto instance_db_name = "multipassd-vm-instances.json";
+constexpr auto warm_pool_db_name = "multipassd-warm-pool.json";
+constexpr auto memory_reclaim_interval = 30s;
+// Loading instances is mostly disk I/O, but each one holds open files and a thread while it runs
+constexpr std::size_t max_parallel_loads = 8;
 constexpr auto reboot_cmd = "sudo reboot";
 constexpr auto stop_ssh_cmd = "sudo systemctl stop ssh";
 constexpr auto sshfs_error_template =
@@ -234,28 +242,36 @@ std::unordered_map<std::string, mp::VMSpecs> load_db(const mp::Path& data_path,
 {
     QDir data_dir{data_path};
     QDir cache_dir{cache_path};
-    QFile db_file{data_dir.filePath(instance_db_name)};
-    if (!db_file.open(QIODevice::ReadOnly))
-    {
-        // Try to open the old location
-        db_file.setFileName(cache_dir.filePath(instance_db_name));
-        if (!db_file.open(QIODevice::ReadOnly))
-            return {};
-    }
 
-    boost::json::value records;
+    std::optional<mp::RecordDatabase> records;
     try
     {
-        records = boost::json::parse(std::string_view(db_file.readAll()));
+        records = mp::RecordDatabase::open(data_dir.filePath(instance_db_name));
+        if (!records) // Try the old location
+            records = mp::RecordDatabase::open(cache_dir.filePath(instance_db_name));
     }
     catch (const std::runtime_error& e)
     {
         return {};
     }
 
+    if (!records)
+        return {};
+
     std::unordered_map<std::string, mp::VMSpecs> reconstructed_records;
-    for (const auto& [key, record] : records.as_object())
+    for (const auto& key : records->keys())
     {
+        boost::json::value record;
+        try
+        {
+            record = records->at(key);
+        }
+        catch (const mp::CorruptRecordDatabaseException& e)
+        {
+            mpl::warn(category, "Ignoring unreadable instance in database: {}", key);
+            continue;
+        }
+
         if (record.as_object().empty())
             return {};
 
@@ -536,6 +552,7 @@ auto connect_rpc(mp::DaemonRpc& rpc, mp::Daemon& daemon)
     QObject::connect(&rpc, &mp::DaemonRpc::on_wait_ready, &daemon, &mp::Daemon::wait_ready);
     QObject::connect(&rpc, &mp::DaemonRpc::on_zones, &daemon, &mp::Daemon::zones);
     QObject::connect(&rpc, &mp::DaemonRpc::on_zones_state, &daemon, &mp::Daemon::zones_state);
+    QObject::connect(&rpc, &mp::DaemonRpc::on_metrics, &daemon, &mp::Daemon::metrics);
 }
 
 enum class InstanceGroup
@@ -554,12 +571,18 @@ using InstanceTrail = std::variant<InstanceTable::iterator, // operative instanc
                                    InstanceTable::iterator, // deleted instances
                                    std::reference_wrapper<const std::string>>; // missing instances
 
+// Tells apart the instances that users are not to see or act upon, which selections deem missing
+using HiddenInstances = std::function<bool(const std::string&)>;
+
 // careful to keep the original `name` around while the returned trail is in use!
 InstanceTrail find_instance(InstanceTable& operative_instances,
                             InstanceTable& deleted_instances,
-                            const std::string& name)
+                            const std::string& name,
+                            const HiddenInstances& hidden = nullptr)
 {
-    if (auto it = operative_instances.find(name); it != std::end(operative_instances))
+    if (hidden && hidden(name))
+        return {name};
+    else if (auto it = operative_instances.find(name); it != std::end(operative_instances))
         return InstanceTrail{std::in_place_index<0>, it};
     else if (it = deleted_instances.find(name); it != std::end(deleted_instances))
         return InstanceTrail{std::in_place_index<1>, it};
@@ -576,13 +599,15 @@ struct InstanceSelectionReport
     MissingInstanceList missing_instances;
 };
 
-LinearInstanceSelection select_all(InstanceTable& instances)
+LinearInstanceSelection select_all(InstanceTable& instances,
+                                   const HiddenInstances& hidden = nullptr)
 {
     LinearInstanceSelection selection;
     selection.reserve(instances.size());
 
     for (auto it = instances.begin(); it != instances.end(); ++it)
-        selection.push_back(it);
+        if (!hidden || !hidden(it->first))
+            selection.push_back(it);
 
     return selection;
 }
@@ -609,13 +634,14 @@ template <typename InstanceNames>
 InstanceSelectionReport select_instances(InstanceTable& operative_instances,
                                          InstanceTable& deleted_instances,
                                          const InstanceNames& names,
-                                         InstanceGroup no_name_means)
+                                         InstanceGroup no_name_means,
+                                         const HiddenInstances& hidden)
 {
     InstanceSelectionReport ret{};
     if (names.empty() && no_name_means != InstanceGroup::None)
     {
         if (no_name_means == InstanceGroup::Operative || no_name_means == InstanceGroup::All)
-            ret.operative_selection = select_all(operative_instances);
+            ret.operative_selection = select_all(operative_instances, hidden);
         if (no_name_means == InstanceGroup::Deleted || no_name_means == InstanceGroup::All)
             ret.deleted_selection = select_all(deleted_instances);
     }
@@ -634,7 +660,8 @@ InstanceSelectionReport select_instances(InstanceTable& operative_instances,
 
             if (seen_instances.insert(*vm_name).second)
             {
-                auto trail = find_instance(operative_instances, deleted_instances, *vm_name);
+                auto trail =
+                    find_instance(operative_instances, deleted_instances, *vm_name, hidden);
                 rank_instance(trail, ret);
             }
         }
@@ -808,12 +835,14 @@ grpc::Status grpc_status_for_instance_trail(const InstanceTrail& trail,
     return grpc::Status{status_code, "", ""};
 }
 
-std::pair<InstanceTrail, grpc::Status> find_instance_and_react(InstanceTable& operative_instances,
-                                                               InstanceTable& deleted_instances,
-                                                               const std::string& name,
-                                                               const SelectionReaction& reaction)
+std::pair<InstanceTrail, grpc::Status>
+find_instance_and_react(InstanceTable& operative_instances,
+                        InstanceTable& deleted_instances,
+                        const std::string& name,
+                        const SelectionReaction& reaction,
+                        const HiddenInstances& hidden = nullptr)
 {
-    auto trail = find_instance(operative_instances, deleted_instances, name);
+    auto trail = find_instance(operative_instances, deleted_instances, name, hidden);
     auto status = grpc_status_for_instance_trail(trail, reaction);
 
     return {std::move(trail), status};
@@ -826,10 +855,11 @@ select_instances_and_react(InstanceTable& operative_instances,
                            InstanceTable& deleted_instances,
                            const InstanceNames& names,
                            InstanceGroup no_name_means,
-                           const SelectionReaction& reaction)
+                           const SelectionReaction& reaction,
+                           const HiddenInstances& hidden)
 {
     auto instance_selection =
-        select_instances(operative_instances, deleted_instances, names, no_name_means);
+        select_instances(operative_instances, deleted_instances, names, no_name_means, hidden);
     return {instance_selection, grpc_status_for_selection(instance_selection, reaction)};
 }
 
@@ -1277,8 +1307,174 @@ void populate_snapshot_info(mp::VirtualMachine& vm,
 
     populate_snapshot_fundamentals(snapshot, fundamentals);
 }
+
+struct InstanceToLoad
+{
+    std::string name;
+    mp::VirtualMachineDescription desc;
+    mp::VirtualMachine::UPtr instance;
+};
+
+mp::ZonePlacement zone_placement()
+{
+    return MP_SETTINGS.get(mp::zone_placement_key) == mp::zone_placement_first_available
+               ? mp::ZonePlacement::first_available
+               : mp::ZonePlacement::least_loaded;
+}
+
+// Warm pool members are left out: they are not anyone's instances yet, and the launch that takes
+// one over counts it from then on
+mp::AvailabilityZoneManager::ZoneLoads
+zone_loads(const std::unordered_map<std::string, mp::VMSpecs>& specs,
+           const std::unordered_map<std::string, std::pair<std::string, mp::ZoneLoad>>& preparing,
+           const mp::WarmPool& warm_pool)
+{
+    mp::AvailabilityZoneManager::ZoneLoads loads;
+    const auto add = [&loads](const std::string& zone, int cpus, long long memory, long long disk) {
+        auto& load = loads[zone];
+        ++load.instances;
+        load.cpus += cpus;
+        load.memory_bytes += memory;
+        load.disk_bytes += disk;
+    };
+
+    for (const auto& [name, spec] : specs)
+        if (!spec.deleted && !warm_pool.contains(name))
+            add(spec.zone, spec.num_cores, spec.mem_size.in_bytes(), spec.disk_space.in_bytes());
+
+    // Instances still being prepared have no specs yet, but they already belong to the zone that
+    // was picked for them, with the resources they asked for
+    for (const auto& [name, preparing_load] : preparing)
+    {
+        const auto& [zone, requested] = preparing_load;
+        if (specs.find(name) == specs.end() && !warm_pool.contains(name))
+            add(zone, requested.cpus, requested.memory_bytes, requested.disk_bytes);
+    }
+
+    return loads;
+}
+
+// What a new instance will weigh on its zone, before the image settles its disk size
+mp::ZoneLoad requested_load(const mp::CreateRequest& request,
+                            const mp::MemorySize& mem_size,
+                            const std::optional<mp::MemorySize>& disk_space)
+{
+    mp::ZoneLoad load{};
+    load.cpus = std::max(request.num_cores(), std::stoi(mp::min_cpu_cores));
+    load.memory_bytes = mem_size.in_bytes();
+    load.disk_bytes = disk_space.value_or(mp::MemorySize{mp::default_disk_size}).in_bytes();
+    return load;
+}
+
+mp::WarmPool load_warm_pool(const mp::Path& data_path)
+{
+    try
+    {
+        const auto records = mp::RecordDatabase::open(QDir{data_path}.filePath(warm_pool_db_name));
+        if (records)
+            return mp::WarmPool::from_json(records->to_json());
+    }
+    catch (const std::exception& e)
+    {
+        mpl::warn(category, "Ignoring unreadable warm pool: {}", e.what());
+    }
+
+    return {};
+}
+
+int warm_pool_size()
+{
+    bool ok;
+    const auto size = MP_SETTINGS.get(mp::warm_pool_size_key).toInt(&ok);
+
+    return ok ? std::max(size, 0) : 0;
+}
+
+int autostart_concurrency()
+{
+    bool ok;
+    const auto concurrency = MP_SETTINGS.get(mp::autostart_concurrency_key).toInt(&ok);
+    if (ok && concurrency > 0)
+        return concurrency;
+
+    return QString{mp::autostart_concurrency_default}.toInt();
+}
+
+// Instances named in the priority setting boot first, in the order given; the rest follow by name
+std::deque<std::string> prioritized_boot_order(std::vector<std::string> names,
+                                               const QString& priority_setting)
+{
+    std::vector<std::string> priorities;
+    for (const auto& entry : priority_setting.split(',', Qt::SkipEmptyParts))
+        priorities.push_back(entry.trimmed().toStdString());
+
+    auto rank = [&priorities](const std::string& name) {
+        return std::distance(priorities.begin(),
+                             std::find(priorities.begin(), priorities.end(), name));
+    };
+
+    std::sort(names.begin(), names.end(), [&rank](const auto& a, const auto& b) {
+        return std::pair{rank(a), a} < std::pair{rank(b), b};
+    });
+
+    return {names.begin(), names.end()};
+}
 } // namespace
 
+// A launch that creates an instance for the warm pool. It stands in for the client, which there is
+// none of, and hands the outcome back to the daemon.
+struct mp::Daemon::WarmUp : public grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>,
+                            public DaemonRpcContext
+{
+    WarmUp(const CreateRequest& request, std::function<void(grpc::Status)> on_finished)
+        : request{request}, on_finished{std::move(on_finished)}
+    {
+    }
+
+    void SendInitialMetadata() override
+    {
+    }
+
+    bool Write(const CreateReply&, grpc::WriteOptions) override
+    {
+        return true;
+    }
+
+    bool NextMessageSize(uint32_t*) override
+    {
+        return false;
+    }
+
+    bool Read(CreateRequest*) override
+    {
+        return false;
+    }
+
+    void set_value(grpc::Status status) override
+    {
+        // This is the creation's last word, after which it no longer refers to the warm-up
+        const auto self = std::move(keep_alive);
+
+        const std::lock_guard lock{mutex};
+        if (on_finished)
+            on_finished(std::move(status));
+    }
+
+    // Drops the outcome of the creation, for when there is no one left to take it
+    void cancel()
+    {
+        const std::lock_guard lock{mutex};
+        on_finished = nullptr;
+    }
+
+    CreateRequest request;
+    std::shared_ptr<WarmUp> keep_alive; // keeps the warm-up around until the creation is done
+
+private:
+    std::mutex mutex;
+    std::function<void(grpc::Status)> on_finished;
+};
+
 mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
     : config{std::move(the_config)},
       vm_instance_specs{
@@ -1316,11 +1512,24 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         mpl::warn(category, "Hypervisor health check failed: {}", e.what());
     }
 
+    warm_pool = load_warm_pool(
+        mp::utils::backend_directory_path(config->data_directory,
+                                          config->factory->get_backend_directory_name()));
+    const auto warm_pool_members = warm_pool.names();
+    std::vector<std::string> interrupted_warm_ups;
+
+    std::vector<InstanceToLoad> instances_to_load;
     for (auto& entry : vm_instance_specs)
     {
         const auto& name = entry.first;
         auto& spec = entry.second;
 
+        if (warm_pool.contains(name) && !warm_pool.is_ready(name))
+        {
+            interrupted_warm_ups.push_back(name);
+            continue;
+        }
+
         if (!config->vault->has_record_for(name))
         {
             invalid_specs.push_back(name);
@@ -1368,15 +1577,47 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                                               {},
                                               {},
                                               {},
-                                              {}};
-
-        auto& instance_record = spec.deleted ? deleted_instances : operative_instances;
-        auto instance = instance_record[name] =
-            config->factory->create_virtual_machine(vm_desc, *config->ssh_key_provider, *this);
-        instance->load_snapshots();
+                                              {},
+                                              spec.network_multiqueue,
+                                              spec.disk_profile,
+                                              spec.memory_backing,
+                                              spec.cpu_affinity};
 
         // Add the new macs to the daemon's list only if we got this far
         allocated_mac_addrs = std::move(new_macs);
+        instances_to_load.push_back({name, std::move(vm_desc), nullptr});
+    }
+
+    // Reconstructing instances is dominated by disk I/O (images, snapshot metadata), so do it for
+    // all of them at once. Qt-based instances must still live in the daemon's thread, where their
+    // queued signals are delivered.
+    const auto daemon_thread = thread();
+    mpu::bounded_parallel_for_each(
+        instances_to_load,
+        max_parallel_loads,
+        [this, daemon_thread](InstanceToLoad& item) {
+            item.instance = config->factory->create_virtual_machine(item.desc,
+                                                                    *config->ssh_key_provider,
+                                                                    *this);
+            item.instance->load_snapshots();
+
+            if (auto* qobject = dynamic_cast<QObject*>(item.instance.get()))
+                qobject->moveToThread(daemon_thread);
+        });
+
+    std::vector<std::string> instances_to_boot;
+    for (auto& item : instances_to_load)
+    {
+        const auto& name = item.name;
+        if (warm_pool.contains(name))
+        {
+            warm_instances[name] = std::move(item.instance);
+            continue;
+        }
+
+        auto& spec = vm_instance_specs.at(name);
+        auto& instance_record = spec.deleted ? deleted_instances : operative_instances;
+        instance_record[name] = std::move(item.instance);
 
         // FIXME: somehow we're writing contradictory state to disk.
         if (spec.deleted && spec.state != e_state::stopped && spec.state != e_state::off)
@@ -1392,7 +1633,6 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
 
         if (!spec.deleted)
             init_mounts(name);
-        std::unique_lock lock{start_mutex};
 
         if (spec.state == e_state::running)
         {
@@ -1406,28 +1646,31 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
                 mpl::info(category, "{} needs syncing. Syncing now...", name);
                 // We don't need to start the instance, but we need to ensure that
                 // the daemon side resources for the VM are initialized.
-                multipass::top_catch_all(name, [this, &name, &lock] {
-                    lock.unlock();
-                    on_restart(name);
-                });
+                multipass::top_catch_all(name, [this, &name] { on_restart(name); });
             }
             break;
             default:
             {
                 assert(!spec.deleted);
-                mpl::info(category, "{} needs starting. Starting now...", name);
-
-                multipass::top_catch_all(name, [this, &name, &lock]() {
-                    operative_instances[name]->start();
-                    lock.unlock();
-                    on_restart(name);
-                });
+                instances_to_boot.push_back(name);
             }
             break;
             }
         }
     }
 
+    if (!instances_to_boot.empty())
+    {
+        boot_concurrency = autostart_concurrency();
+        boot_queue = prioritized_boot_order(std::move(instances_to_boot),
+                                            MP_SETTINGS.get(mp::autostart_priority_key));
+        mpl::info(category,
+                  "Restarting {} previously running instance(s), {} at a time",
+                  boot_queue.size(),
+                  boot_concurrency);
+        dispatch_boot_queue();
+    }
+
     for (const auto& bad_spec : invalid_specs)
     {
         mpl::warn(category, "Removing invalid instance: {}", bad_spec);
@@ -1435,9 +1678,26 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         config->vault->remove(bad_spec);
     }
 
-    if (!invalid_specs.empty())
+    for (const auto& name : interrupted_warm_ups)
+    {
+        mpl::info(category, "Discarding {}, whose warm-up was interrupted", name);
+        release_resources(name);
+    }
+
+    for (const auto& name : warm_pool_members)
+        if (warm_instances.find(name) == warm_instances.end())
+            warm_pool.remove(name);
+
+    if (!warm_pool_members.empty())
+        for (const auto& name : warm_pool.surplus(warm_pool_size()))
+            discard_warm_instance(name);
+
+    if (!invalid_specs.empty() || !interrupted_warm_ups.empty())
         persist_instances();
 
+    if (warm_pool.names() != warm_pool_members)
+        persist_warm_pool();
+
     config->vault->prune_expired_images();
 
     // Fire timer every six hours to perform maintenance on source images such as
@@ -1483,11 +1743,21 @@ mp::Daemon::Daemon(std::unique_ptr<const DaemonConfig> the_config)
         }
     });
     source_images_maintenance_task.start(config->image_refresh_timer);
+
+    connect(&memory_reclaim_task, &QTimer::timeout, this, &Daemon::reclaim_memory);
+    memory_reclaim_task.start(memory_reclaim_interval);
 }
 
 mp::Daemon::~Daemon()
 {
     mp::top_catch_all(category, [this] {
+        boot_queue.clear(); // don't start anything else while tearing down
+
+        // Warm-ups still being created live on until the creation is done, which no longer reports
+        // back here
+        for (auto& [_, warm_up] : warm_ups)
+            warm_up->cancel();
+
         MP_SETTINGS.unregister_handler(instance_mod_handler);
         MP_SETTINGS.unregister_handler(snapshot_mod_handler);
 
@@ -1756,7 +2026,8 @@ try
                                    deleted_instances,
                                    request->instance_snapshot_pairs(),
                                    InstanceGroup::All,
-                                   require_existing_instances_reaction);
+                                   require_existing_instances_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
@@ -1872,7 +2143,7 @@ try
 
     auto cmd = request->snapshots() ? std::function(fetch_snapshot) : std::function(fetch_instance);
 
-    auto status = cmd_vms(select_all(operative_instances), cmd);
+    auto status = cmd_vms(select_all(operative_instances, hidden_instances()), cmd);
     if (status.ok())
     {
         deleted = true;
@@ -1948,7 +2219,7 @@ try
         auto target_path = q_target_path.toStdString();
 
         auto it = operative_instances.find(name);
-        if (it == operative_instances.end())
+        if (it == operative_instances.end() || hidden_instances()(name))
         {
             add_fmt_to(errors, "instance '{}' does not exist", name);
             continue;
@@ -1979,8 +2250,10 @@ try
         }
 
         const auto mount_type = request->mount_type() == MountRequest_MountType_CLASSIC
-                                  ? VMMount::MountType::Classic
-                                  : VMMount::MountType::Native;
+                                    ? VMMount::MountType::Classic
+                                : request->mount_type() == MountRequest_MountType_VIRTIOFS
+                                    ? VMMount::MountType::Virtiofs
+                                    : VMMount::MountType::Native;
 
         VMMount vm_mount{request->source_path(), gid_mappings, uid_mappings, mount_type};
         vm_mounts[target_path] = make_mount(vm.get(), target_path, vm_mount);
@@ -2029,7 +2302,8 @@ try
                                    deleted_instances,
                                    request->instance_names().instance_name(),
                                    InstanceGroup::Deleted,
-                                   recover_reaction);
+                                   recover_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
@@ -2063,7 +2337,8 @@ try
                                    deleted_instances,
                                    request->instance_name(),
                                    InstanceGroup::None,
-                                   require_operative_instances_reaction);
+                                   require_operative_instances_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
@@ -2102,7 +2377,8 @@ try
                                    deleted_instances,
                                    request->instance_names().instance_name(),
                                    InstanceGroup::Operative,
-                                   custom_reaction);
+                                   custom_reaction,
+                                   hidden_instances());
 
     if (!status.ok())
         return context->set_value({status.error_code(),
@@ -2111,6 +2387,9 @@ try
 
     bool complain_disabled_mounts = !MP_SETTINGS.get_as<bool>(mp::mounts_key);
 
+    mp::tracing::ActiveTrace active_trace{
+        request->trace() ? std::make_shared<mp::tracing::Trace>() : nullptr};
+
     std::vector<std::string> starting_vms{};
     starting_vms.reserve(instance_selection.operative_selection.size());
 
@@ -2156,22 +2435,39 @@ try
                 mpl::error(category, "Mounts have been disabled on this instance of Multipass");
             }
 
+            // a client got to it first, so the boot queue must not start it again
+            unqueue_boot(name);
+            mp::tracing::Span span{"VirtualMachine::start"};
+            const auto resuming = vm.current_state() == VirtualMachine::State::suspended;
+            const auto starting_since = std::chrono::steady_clock::now();
             vm.start();
+
+            // How long restoring the state held up the start, for backends that do it then
+            if (resuming)
+            {
+                const auto duration = std::chrono::steady_clock::now() - starting_since;
+                mp::metrics::registry()
+                    .histogram("multipass_instance_resume_seconds",
+                               "Time instances took to restore their state when resumed")
+                    .observe(duration);
+                resume_durations[name] =
+                    std::chrono::duration_cast<std::chrono::microseconds>(duration);
+            }
         }
 
         starting_vms.push_back(vm_it->first);
     }
 
     auto future_watcher = create_future_watcher();
-    future_watcher->setFuture(
-        QtConcurrent::run(&Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
-                          this,
-                          server,
-                          starting_vms,
-                          timeout,
-                          context,
-                          fmt::to_string(start_errors),
-                          fmt::to_string(start_warnings)));
+    future_watcher->setFuture(QtConcurrent::run(
+        mp::tracing::traced(&Daemon::async_wait_for_ready_all<StartReply, StartRequest>),
+        this,
+        server,
+        starting_vms,
+        timeout,
+        context,
+        fmt::to_string(start_errors),
+        fmt::to_string(start_warnings)));
 }
 catch (const std::exception& e)
 {
@@ -2188,13 +2484,20 @@ try
                                    deleted_instances,
                                    request->instance_names().instance_name(),
                                    InstanceGroup::Operative,
-                                   require_operative_instances_reaction);
+                                   require_operative_instances_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
         assert(instance_selection.deleted_selection.empty());
         assert(instance_selection.missing_instances.empty());
 
+        // Instances still waiting to be restarted must stay down, now and across daemon restarts
+        if (!request->cancel_shutdown())
+            for (const auto& vm_it : instance_selection.operative_selection)
+                if (unqueue_boot(vm_it->first))
+                    persist_state_for(vm_it->first, vm_it->second->current_state());
+
         std::function<grpc::Status(VirtualMachine&)> operation;
         if (request->cancel_shutdown())
             operation = [this](const VirtualMachine& vm) { return this->cancel_vm_shutdown(vm); };
@@ -2219,7 +2522,7 @@ catch (const std::exception& e)
 }
 
 void mp::Daemon::suspend(const SuspendRequest* request,
-                         grpc::ServerReaderWriterInterface<SuspendReply, SuspendRequest>*,
+                         grpc::ServerReaderWriterInterface<SuspendReply, SuspendRequest>* server,
                          DaemonRpcContext* context)
 try
 {
@@ -2228,11 +2531,18 @@ try
                                    deleted_instances,
                                    request->instance_names().instance_name(),
                                    InstanceGroup::Operative,
-                                   require_operative_instances_reaction);
+                                   require_operative_instances_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
-        status = cmd_vms(instance_selection.operative_selection, [this](auto& vm) {
+        // Instances still waiting to be restarted have no state to save, and must stay down
+        for (const auto& vm_it : instance_selection.operative_selection)
+            if (unqueue_boot(vm_it->first))
+                persist_state_for(vm_it->first, vm_it->second->current_state());
+
+        SuspendReply reply;
+        status = cmd_vms(instance_selection.operative_selection, [this, &reply](auto& vm) {
             if (vm.current_state() == VirtualMachine::State::unavailable)
             {
                 mpl::log(mpl::Level::info,
@@ -2243,9 +2553,21 @@ try
 
             stop_mounts(vm.get_name());
 
+            const auto suspending_since = std::chrono::steady_clock::now();
             vm.suspend();
+            const auto duration = std::chrono::steady_clock::now() - suspending_since;
+
+            mp::metrics::registry()
+                .histogram("multipass_instance_suspend_seconds",
+                           "Time instances took to save their state when suspended")
+                .observe(duration);
+            (*reply.mutable_suspend_duration_us())[vm.get_name()] =
+                std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
             return grpc::Status::OK;
         });
+
+        if (status.ok())
+            server->Write(reply);
     }
 
     context->set_value(status);
@@ -2268,7 +2590,8 @@ try
                                    deleted_instances,
                                    request->instance_names().instance_name(),
                                    InstanceGroup::Operative,
-                                   require_operative_instances_reaction);
+                                   require_operative_instances_reaction,
+                                   hidden_instances());
 
     if (!status.ok())
     {
@@ -2315,7 +2638,8 @@ try
                                    deleted_instances,
                                    request->instance_snapshot_pairs(),
                                    InstanceGroup::All,
-                                   require_existing_instances_reaction);
+                                   require_existing_instances_reaction,
+                                   hidden_instances());
 
     if (status.ok())
     {
@@ -2396,7 +2720,7 @@ try
         const auto target_path = mpu::normalize_path(path_entry.target_path());
 
         auto vm = operative_instances.find(name);
-        if (vm == operative_instances.end())
+        if (vm == operative_instances.end() || hidden_instances()(name))
         {
             add_fmt_to(errors, "instance '{}' does not exist", name);
             continue;
@@ -2636,7 +2960,8 @@ try
     auto [instance_trail, status] = find_instance_and_react(operative_instances,
                                                             deleted_instances,
                                                             instance_name,
-                                                            require_operative_instances_reaction);
+                                                            require_operative_instances_reaction,
+                                                            hidden_instances());
 
     if (status.ok())
     {
@@ -2645,7 +2970,12 @@ try
         assert(vm_ptr);
 
         using St = VirtualMachine::State;
-        if (auto state = vm_ptr->current_state(); state != St::off && state != St::stopped)
+        const auto state = vm_ptr->current_state();
+        if (request->live() && state != St::running)
+            return context->set_value(
+                grpc::Status{grpc::FAILED_PRECONDITION,
+                             "Multipass can only take live snapshots of running instances."});
+        if (!request->live() && state != St::off && state != St::stopped)
             return context->set_value(
                 grpc::Status{grpc::FAILED_PRECONDITION,
                              "Multipass can only take snapshots of stopped instances."});
@@ -2659,10 +2989,49 @@ try
         const auto spec_it = vm_instance_specs.find(instance_name);
         assert(spec_it != vm_instance_specs.end() && "missing instance specs");
 
+        if (request->live())
+        {
+            // The instance can need this thread to hear from its hypervisor meanwhile, so the
+            // snapshot is taken elsewhere, with the instance kept around until it is done
+            auto future_watcher =
+                create_future_watcher([vm = std::get<0>(instance_trail)->second] {});
+            future_watcher->setFuture(QtConcurrent::run([server,
+                                                         context,
+                                                         vm_ptr,
+                                                         specs = spec_it->second,
+                                                         snapshot_name,
+                                                         comment = request->comment()] {
+                try
+                {
+                    std::chrono::microseconds pause_duration{};
+                    SnapshotReply reply;
+                    reply.set_snapshot(
+                        vm_ptr->take_live_snapshot(specs, snapshot_name, comment, pause_duration)
+                            ->get_name());
+                    reply.set_pause_duration_us(pause_duration.count());
+                    server->Write(reply);
+                }
+                catch (const SnapshotNameTakenException& e)
+                {
+                    return AsyncOperationStatus{
+                        grpc::Status(grpc::StatusCode::INVALID_ARGUMENT, e.what(), ""),
+                        context};
+                }
+                catch (const std::exception& e)
+                {
+                    return AsyncOperationStatus{
+                        grpc::Status(grpc::StatusCode::INTERNAL, e.what(), ""),
+                        context};
+                }
+
+                return AsyncOperationStatus{grpc::Status{}, context};
+            }));
+            return;
+        }
+
         SnapshotReply reply;
         reply.set_snapshot(
             vm_ptr->take_snapshot(spec_it->second, snapshot_name, request->comment())->get_name());
-
         server->Write(reply);
     }
 
@@ -2687,7 +3056,8 @@ try
     auto [instance_trail, status] = find_instance_and_react(operative_instances,
                                                             deleted_instances,
                                                             instance_name,
-                                                            require_operative_instances_reaction);
+                                                            require_operative_instances_reaction,
+                                                            hidden_instances());
 
     if (status.ok())
     {
@@ -2773,7 +3143,8 @@ try
         find_instance_and_react(operative_instances,
                                 deleted_instances,
                                 source_name,
-                                require_operative_instances_reaction);
+                                require_operative_instances_reaction,
+                                hidden_instances());
     if (src_vm_status.ok())
     {
         assert(src_instance_trail.index() == 0);
@@ -2811,6 +3182,11 @@ try
         // Specs need to be in place before the factory can create the VM
         // Notice that we are passing `this`, which can be used to retrieve further info
         vm_instance_specs.emplace(destination_name, dest_spec);
+        auto progress_monitor = [server](int /*progress_type*/, int percentage) {
+            CloneReply progress_reply;
+            progress_reply.set_percent_complete(std::to_string(percentage));
+            return server->Write(progress_reply);
+        };
         operative_instances[destination_name] =
             config->factory->clone_bare_vm(src_spec,
                                            dest_spec,
@@ -2818,7 +3194,8 @@ try
                                            destination_name,
                                            dest_vm_image,
                                            *config->ssh_key_provider,
-                                           *this);
+                                           *this,
+                                           progress_monitor);
         ++src_spec.clone_count;
         // preparing instance is done
         preparing_instances.erase(destination_name);
@@ -2898,13 +3275,24 @@ void mp::Daemon::zones(const ZonesRequest*,
 try // clang-format on
 {
     ZonesReply response{};
+    response.set_placement(MP_SETTINGS.get(mp::zone_placement_key).toStdString());
 
+    const auto loads = zone_loads(vm_instance_specs, preparing_loads, warm_pool);
     for (const auto& zone : config->az_manager->get_zones())
     {
+        const auto& zone_name = zone.get().get_name();
         const auto reply_zone = response.add_zones();
-        reply_zone->set_name(zone.get().get_name());
+        reply_zone->set_name(zone_name);
         reply_zone->set_subnet(zone.get().get_subnet().to_cidr());
         reply_zone->set_available(zone.get().is_available());
+
+        if (const auto it = loads.find(zone_name); it != loads.end())
+        {
+            reply_zone->set_instances(it->second.instances);
+            reply_zone->set_cpus(it->second.cpus);
+            reply_zone->set_memory(it->second.memory_bytes);
+            reply_zone->set_disk(it->second.disk_bytes);
+        }
     }
 
     server->Write(response);
@@ -2915,28 +3303,74 @@ catch (const std::exception& e)
     context->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
-void mp::Daemon::zones_state(const ZonesStateRequest* request,
-                             grpc::ServerReaderWriterInterface<ZonesStateReply, ZonesStateRequest>*,
-                             DaemonRpcContext* context) // clang-format off
+void mp::Daemon::zones_state(
+    const ZonesStateRequest* request,
+    grpc::ServerReaderWriterInterface<ZonesStateReply, ZonesStateRequest>* server,
+    DaemonRpcContext* context) // clang-format off
 try // clang-format on
 {
     auto& az_manager = *config->az_manager;
+    const auto available = request->available();
+
+    std::vector<std::string> zone_names;
     if (request->zones().empty())
     {
         for (auto&& zone : az_manager.get_zones())
         {
-            az_manager.get_zone(zone.get().get_name()).set_available(request->available());
+            zone_names.push_back(zone.get().get_name());
         }
     }
     else
     {
         for (const auto& zone_name : request->zones())
         {
-            az_manager.get_zone(zone_name).set_available(request->available());
+            az_manager.get_zone(zone_name); // throws if there is no such zone
+            zone_names.push_back(zone_name);
         }
     }
 
-    context->set_value(grpc::Status{});
+    // Instances can need this thread to transition (e.g. to handle their processes), so zones go
+    // elsewhere. Meanwhile, keep the instances around, to let go of them here once it is done.
+    std::vector<VirtualMachine::ShPtr> transitioning;
+    for (const auto& [name, vm] : operative_instances)
+        transitioning.push_back(vm);
+
+    auto future_watcher =
+        create_future_watcher([transitioning = std::move(transitioning)]() mutable {
+            transitioning.clear();
+        });
+    future_watcher->setFuture(QtConcurrent::run(
+        [this, &az_manager, server, context, available, zone_names = std::move(zone_names)] {
+            try
+            {
+                for (const auto& zone_name : zone_names)
+                {
+                    // Report each instance as it goes, since a zone can hold many of them
+                    const auto progress = [this, server, &zone_name, available](
+                                              const VirtualMachine& vm,
+                                              std::size_t done,
+                                              std::size_t total) {
+                        reply_msg(server,
+                                  fmt::format("{}: {} {}available ({}/{})",
+                                              zone_name,
+                                              vm.get_name(),
+                                              available ? "" : "un",
+                                              done,
+                                              total));
+                    };
+
+                    az_manager.get_zone(zone_name).set_available(available, progress);
+                }
+            }
+            catch (const std::exception& e)
+            {
+                return AsyncOperationStatus{
+                    grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""),
+                    context};
+            }
+
+            return AsyncOperationStatus{grpc::Status{}, context};
+        }));
 }
 catch (const AvailabilityZoneNotFound& e)
 {
@@ -2947,6 +3381,16 @@ catch (const std::exception& e)
     context->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
 }
 
+void mp::Daemon::metrics(const MetricsRequest*,
+                         grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>* server,
+                         DaemonRpcContext* context)
+{
+    MetricsReply response{};
+    response.set_metrics(mp::metrics::registry().to_text());
+    server->Write(response);
+    context->set_value(grpc::Status{});
+}
+
 void mp::Daemon::on_shutdown()
 {
 }
@@ -2960,9 +3404,15 @@ void mp::Daemon::on_suspend()
 }
 
 void mp::Daemon::on_restart(const std::string& name)
+{
+    sync_restarted_instance(name, [] {});
+}
+
+void mp::Daemon::sync_restarted_instance(const std::string& name,
+                                         const std::function<void()>& on_synced)
 {
     stop_mounts(name);
-    auto future_watcher = create_future_watcher([this, &name]() {
+    auto future_watcher = create_future_watcher([this, name, on_synced]() {
         try
         {
             auto virtual_machine = operative_instances.at(name);
@@ -2976,6 +3426,8 @@ void mp::Daemon::on_restart(const std::string& name)
         {
             // logging is dangerous since this thread is probably in a corrupt state
         }
+
+        on_synced();
     });
     future_watcher->setFuture(
         QtConcurrent::run(&Daemon::async_wait_for_ready_all<StartReply, StartRequest>,
@@ -2988,14 +3440,62 @@ void mp::Daemon::on_restart(const std::string& name)
                           std::string()));
 }
 
+void mp::Daemon::dispatch_boot_queue()
+{
+    while (booting_instances < boot_concurrency && !boot_queue.empty())
+    {
+        const auto name = std::move(boot_queue.front());
+        boot_queue.pop_front();
+
+        // The instance may have been deleted or stopped while it waited its turn
+        const auto it = operative_instances.find(name);
+        if (it == operative_instances.end() ||
+            vm_instance_specs[name].state != VirtualMachine::State::running)
+            continue;
+
+        mpl::info(category, "{} needs starting. Starting now...", name);
+        multipass::top_catch_all(name, [this, &name, &vm = *it->second]() {
+            {
+                std::lock_guard lock{start_mutex};
+                vm.start();
+            }
+
+            sync_restarted_instance(name, [this] {
+                --booting_instances;
+                dispatch_boot_queue();
+            });
+            ++booting_instances;
+        });
+    }
+}
+
+std::function<bool(const std::string&)> mp::Daemon::hidden_instances() const
+{
+    // Warm-ups are created like any instance, but they are no one's until a launch takes them
+    return [this](const std::string& name) { return warm_ups.find(name) != warm_ups.end(); };
+}
+
+bool mp::Daemon::unqueue_boot(const std::string& name)
+{
+    const auto it = std::find(boot_queue.begin(), boot_queue.end(), name);
+    if (it == boot_queue.end())
+        return false;
+
+    boot_queue.erase(it);
+    return true;
+}
+
 void mp::Daemon::persist_state_for(const std::string& name, const VirtualMachine::State& state)
 {
+    // Zones take their instances down in parallel, each reporting its new state from its own thread
+    const std::lock_guard lock{persist_state_mutex};
     vm_instance_specs[name].state = state;
     persist_instances();
 }
 
 void mp::Daemon::update_metadata_for(const std::string& name, const boost::json::object& metadata)
 {
+    const std::lock_guard lock{persist_state_mutex};
     vm_instance_specs[name].metadata = metadata;
 
     persist_instances();
@@ -3003,7 +3503,10 @@ void mp::Daemon::update_metadata_for(const std::string& name, const boost::json:
 
 boost::json::object mp::Daemon::retrieve_metadata_for(const std::string& name)
 {
-    return vm_instance_specs[name].metadata;
+    // Instances are constructed in parallel on startup and read their metadata as they go
+    const std::lock_guard lock{persist_state_mutex};
+    const auto it = vm_instance_specs.find(name);
+    return it != vm_instance_specs.end() ? it->second.metadata : boost::json::object{};
 }
 
 void mp::Daemon::persist_instances()
@@ -3011,8 +3514,7 @@ void mp::Daemon::persist_instances()
     auto instance_records_json = boost::json::value_from(vm_instance_specs);
     QDir data_dir{mp::utils::backend_directory_path(config->data_directory,
                                                     config->factory->get_backend_directory_name())};
-    MP_FILEOPS.write_transactionally(data_dir.filePath(instance_db_name),
-                                     pretty_print(instance_records_json));
+    mp::RecordDatabase::write(data_dir.filePath(instance_db_name), instance_records_json);
 }
 
 void mp::Daemon::release_resources(const std::string& instance)
@@ -3063,8 +3565,11 @@ void mp::Daemon::create_vm(const CreateRequest* request,
 
     auto name = name_from(checked_args.instance_name, *config->name_generator, operative_instances);
 
-    auto zone_name = checked_args.zone_name.empty() ? config->az_manager->get_automatic_zone_name()
-                                                    : checked_args.zone_name;
+    auto zone_name = checked_args.zone_name.empty()
+                         ? config->az_manager->get_automatic_zone_name(
+                               zone_placement(),
+                               zone_loads(vm_instance_specs, preparing_loads, warm_pool))
+                         : checked_args.zone_name;
 
     auto [instance_trail, status] = find_instance_and_react(operative_instances,
                                                             deleted_instances,
@@ -3086,13 +3591,48 @@ void mp::Daemon::create_vm(const CreateRequest* request,
     auto timeout = timeout_for(request->timeout());
 
     preparing_instances.insert(name);
+    preparing_loads[name] = {
+        zone_name,
+        requested_load(*request, checked_args.mem_size, checked_args.disk_space)};
+
+    // Spans recorded from here on, on whatever thread, end up in the reply's trace
+    mp::tracing::ActiveTrace active_trace{
+        request->trace() ? std::make_shared<mp::tracing::Trace>() : nullptr};
+
+    // Launches the pool can serve take one of its instances, and have it topped up again
+    if (start && warm_ups.find(name) == warm_ups.end())
+    {
+        // Members keep the zone they were created in, so the pool is keyed on the zone the
+        // instance goes to, whether it was asked for or placement picked it
+        auto placed_request = *request;
+        placed_request.set_zone(zone_name);
+
+        if (const auto profile = WarmPool::profile_for(placed_request))
+        {
+            const auto member = warm_pool.take(*profile);
+            mp::top_catch_all(category, [this, &profile, &placed_request] {
+                refill_warm_pool(*profile, placed_request);
+            });
+
+            if (member)
+                return launch_from_warm_pool(*member, name, server, context, timeout);
+        }
+    }
 
     auto prepare_future_watcher = new QFutureWatcher<mp::VirtualMachineDescription>();
 
     QObject::connect(prepare_future_watcher,
                      &QFutureWatcher<mp::VirtualMachineDescription>::finished,
-                     [this, server, context, name, timeout, start, prepare_future_watcher] {
+                     [this,
+                      server,
+                      context,
+                      name,
+                      timeout,
+                      start,
+                      prepare_future_watcher,
+                      trace = mp::tracing::current_trace()] {
                          // Per-RPC ClientLogger lifecycle is managed by DaemonRpcContextImpl.
+                         mp::tracing::ActiveTrace active_trace{trace};
 
                          try
                          {
@@ -3112,42 +3652,22 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                                  0,
                                  vm_desc.zone,
                              };
-                             operative_instances[name] =
-                                 config->factory->create_virtual_machine(vm_desc,
-                                                                         *config->ssh_key_provider,
-                                                                         *this);
+                             {
+                                 mp::tracing::Span span{
+                                     "VirtualMachineFactory::create_virtual_machine"};
+                                 operative_instances[name] =
+                                     config->factory->create_virtual_machine(
+                                         vm_desc,
+                                         *config->ssh_key_provider,
+                                         *this);
+                             }
                              preparing_instances.erase(name);
+                             preparing_loads.erase(name);
 
                              persist_instances();
 
                              if (start)
-                             {
-                                 LaunchReply reply;
-                                 reply.set_create_message("Starting " + name);
-                                 server->Write(reply);
-
-                                 operative_instances[name]->start();
-
-                                 auto future_watcher = create_future_watcher(
-                                     [this, server, name, zone = vm_desc.zone] {
-                                         LaunchReply reply;
-                                         reply.set_vm_instance_name(name);
-                                         config->update_prompt->populate_if_time_to_show(
-                                             reply.mutable_update_info());
-
-                                         reply.set_zone(zone);
-                                         server->Write(reply);
-                                     });
-                                 future_watcher->setFuture(QtConcurrent::run(
-                                     &Daemon::async_wait_for_ready_all<LaunchReply, LaunchRequest>,
-                                     this,
-                                     server,
-                                     std::vector<std::string>{name},
-                                     timeout,
-                                     context,
-                                     std::string(),
-                                     std::string()));
-                             }
+                                 start_created_vm(name, vm_desc.zone, server, context, timeout);
                              else
                              {
                                  context->set_value(grpc::Status::OK);
@@ -3157,6 +3677,7 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                          {
                              mp::top_catch_all(category, [this, &name]() {
                                  preparing_instances.erase(name);
+                                 preparing_loads.erase(name);
                                  release_resources(name);
                                  operative_instances.erase(name);
                                  persist_instances();
@@ -3171,6 +3692,7 @@ void mp::Daemon::create_vm(const CreateRequest* request,
 
     auto make_vm_description = [this, server, request, name, zone_name, checked_args]() mutable
         -> mp::VirtualMachineDescription {
+        mp::tracing::Span span{"Daemon::make_vm_description"};
         try
         {
             CreateReply reply;
@@ -3215,6 +3737,7 @@ void mp::Daemon::create_vm(const CreateRequest* request,
                 reply.set_create_message("Preparing image for " + name);
                 server->Write(reply);
 
+                mp::tracing::Span span{"VirtualMachineFactory::prepare_source_image"};
                 return config->factory->prepare_source_image(source_image);
             };
 
@@ -3272,7 +3795,10 @@ void mp::Daemon::create_vm(const CreateRequest* request,
 
             vm_desc.image = vm_image;
             config->factory->configure(vm_desc);
-            config->factory->prepare_instance_image(vm_image, vm_desc);
+            {
+                mp::tracing::Span span{"VirtualMachineFactory::prepare_instance_image"};
+                config->factory->prepare_instance_image(vm_image, vm_desc);
+            }
 
             // Everything went well, add the MAC addresses used in this instance.
             allocated_mac_addrs = std::move(new_macs);
@@ -3285,7 +3811,47 @@ void mp::Daemon::create_vm(const CreateRequest* request,
         }
     };
 
-    prepare_future_watcher->setFuture(QtConcurrent::run(make_vm_description));
+    prepare_future_watcher->setFuture(
+        QtConcurrent::run(mp::tracing::traced(std::move(make_vm_description))));
+}
+
+void mp::Daemon::start_created_vm(
+    const std::string& name,
+    const std::string& zone,
+    grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
+    DaemonRpcContext* context,
+    std::chrono::seconds timeout)
+{
+    LaunchReply reply;
+    reply.set_create_message("Starting " + name);
+    server->Write(reply);
+
+    {
+        mp::tracing::Span span{"VirtualMachine::start"};
+        operative_instances[name]->start();
+    }
+
+    auto future_watcher =
+        create_future_watcher([this, server, name, zone, trace = mp::tracing::current_trace()] {
+            LaunchReply reply;
+            reply.set_vm_instance_name(name);
+            if (warm_ups.find(name) == warm_ups.end()) // keep update notices for actual users
+                config->update_prompt->populate_if_time_to_show(reply.mutable_update_info());
+
+            reply.set_zone(zone);
+            if (trace)
+                reply.set_trace(trace->to_chrome_json());
+            server->Write(reply);
+        });
+    future_watcher->setFuture(QtConcurrent::run(
+        mp::tracing::traced(&Daemon::async_wait_for_ready_all<LaunchReply, LaunchRequest>),
+        this,
+        server,
+        std::vector<std::string>{name},
+        timeout,
+        context,
+        std::string(),
+        std::string()));
 }
 
 bool mp::Daemon::delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteReply& response)
@@ -3298,6 +3864,7 @@ bool mp::Daemon::delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteRepl
     {
         mpl::debug(category, "Deleting instance: {}", name);
         erase_from = &operative_instances;
+        unqueue_boot(name);
         if (instance->current_state() == VirtualMachine::State::delayed_shutdown)
             delayed_shutdown_instances.erase(name);
 
@@ -3492,7 +4059,8 @@ mp::MountHandler::UPtr mp::Daemon::make_mount(VirtualMachine* vm,
              ? std::make_unique<SSHFSMountHandler>(vm,
                                                    config->ssh_key_provider.get(),
                                                    target,
-                                                   mount)
+                                                   mount,
+                                                   MP_SETTINGS.get_as<bool>(multiplexed_mounts_key))
              : vm->make_native_mount_handler(target, mount);
 }
 
@@ -3520,6 +4088,8 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
     const std::chrono::seconds& timeout,
     grpc::ServerReaderWriterInterface<Reply, Request>* server)
 {
+    mp::tracing::Span span{"Daemon::async_wait_for_ssh_and_start_mounts_for"};
+
     fmt::memory_buffer errors;
     try
     {
@@ -3532,7 +4102,12 @@ error_string mp::Daemon::async_wait_for_ssh_and_start_mounts_for(
             return fmt::to_string(errors);
         }
         const auto vm = it->second;
+        const auto waiting_since = std::chrono::steady_clock::now();
         vm->wait_until_ssh_up(timeout);
+        mp::metrics::registry()
+            .histogram("multipass_instance_boot_seconds",
+                       "Time instances took to answer SSH once started")
+            .observe(std::chrono::steady_clock::now() - waiting_since);
 
         if (std::is_same<Reply, LaunchReply>::value)
         {
@@ -3621,7 +4196,8 @@ mp::Daemon::async_wait_for_ready_all(grpc::ServerReaderWriterInterface<Reply, Re
             else
             {
                 auto future = QtConcurrent::run(
-                    &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply, Request>,
+                    mp::tracing::traced(
+                        &Daemon::async_wait_for_ssh_and_start_mounts_for<Reply, Request>),
                     this,
                     name,
                     timeout,
@@ -3638,11 +4214,14 @@ mp::Daemon::async_wait_for_ready_all(grpc::ServerReaderWriterInterface<Reply, Re
 
     warnings.append(start_warnings);
 
+    std::unordered_map<std::string, std::chrono::microseconds> resumed;
     {
         std::lock_guard<decltype(start_mutex)> lock{start_mutex};
         for (const auto& name : vms)
         {
             async_running_futures.erase(name);
+            if (auto resume_duration = resume_durations.extract(name))
+                resumed.insert(std::move(resume_duration));
         }
     }
 
@@ -3666,6 +4245,15 @@ mp::Daemon::async_wait_for_ready_all(grpc::ServerReaderWriterInterface<Reply, Re
                 reply.set_log_line(fmt::to_string(warnings));
             }
 
+            if constexpr (std::is_same_v<Reply, StartReply>)
+            {
+                if (const auto trace = mp::tracing::current_trace())
+                    reply.set_trace(trace->to_chrome_json());
+
+                for (const auto& [name, duration] : resumed)
+                    (*reply.mutable_resume_duration_us())[name] = duration.count();
+            }
+
             server->Write(reply);
         }
     }
@@ -3788,11 +4376,31 @@ void mp::Daemon::populate_instance_info(VirtualMachine& vm,
     timestamp->set_nanos(created_time.time().msec() * 1'000'000);
 
     if (!no_runtime_info && MP_UTILS.is_running(present_state))
+    {
         RuntimeInstanceInfoHelper::populate_runtime_info(vm,
                                                          info,
                                                          instance_info,
                                                          original_release,
                                                          vm_specs.num_cores != 1);
+
+        if (const auto reclaimed = memory_reclaimer.reclaimed_memory(name))
+            instance_info->set_memory_reclaimed(std::to_string(reclaimed->in_bytes()));
+    }
+}
+
+void mp::Daemon::reclaim_memory()
+{
+    std::vector<MemoryReclaimer::Instance> instances;
+    for (const auto& [name, vm] : operative_instances)
+    {
+        // Inflating the balloon gives nothing back when guest memory is pinned on the host
+        const auto& backing = vm_instance_specs[name].memory_backing;
+        if (vm->current_state() == VirtualMachine::State::running &&
+            backing.type != memory_backing_hugepages && !backing.prealloc)
+            instances.push_back({name, *vm, vm_instance_specs[name].mem_size});
+    }
+
+    memory_reclaimer.reclaim(instances, MP_SETTINGS.get_as<bool>(memory_reclaim_key));
 }
 
 std::string mp::Daemon::dest_name_for_clone(const CloneRequest& request)
@@ -3860,6 +4468,168 @@ mp::VMSpecs mp::Daemon::clone_spec(const VMSpecs& src_vm_spec,
     return dest_vm_spec;
 }
 
+void mp::Daemon::launch_from_warm_pool(
+    const std::string& member,
+    const std::string& name,
+    grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
+    DaemonRpcContext* context,
+    std::chrono::seconds timeout)
+try
+{
+    // The member goes either way: handed out as the new instance, or found wanting
+    auto discard_member = sg::make_scope_guard([this, member]() noexcept {
+        top_catch_all(category, [this, &member] {
+            discard_warm_instance(member);
+            persist_warm_pool();
+        });
+    });
+    auto rollback_resources = sg::make_scope_guard([this, name]() noexcept {
+        top_catch_all(category, [this, &name] {
+            operative_instances.erase(name);
+            release_resources(name);
+            preparing_instances.erase(name);
+            preparing_loads.erase(name);
+        });
+    });
+
+    mpl::debug(category, "Launching {} from {} in the warm pool", name, member);
+
+    CreateReply reply;
+    reply.set_create_message(fmt::format("Creating {} from the warm pool", name));
+    server->Write(reply);
+
+    // The member is copied the same way as a clone, which gives it a new hostname, instance ID and
+    // MAC addresses. Cloud-init applies them when the new instance boots.
+    const auto& member_spec = vm_instance_specs.at(member);
+    auto spec = clone_spec(member_spec, member, name);
+    config->vault->clone(member, name);
+
+    const auto image = fetch_image_for(name, *config->factory, *config->vault);
+    vm_instance_specs.emplace(name, spec);
+    {
+        mp::tracing::Span span{"VirtualMachineFactory::clone_bare_vm"};
+        operative_instances[name] = config->factory->clone_bare_vm(member_spec,
+                                                                   spec,
+                                                                   member,
+                                                                   name,
+                                                                   image,
+                                                                   *config->ssh_key_provider,
+                                                                   *this,
+                                                                   [](int, int) { return true; });
+    }
+    preparing_instances.erase(name);
+    preparing_loads.erase(name);
+    persist_instances();
+    rollback_resources.dismiss();
+
+    start_created_vm(name, spec.zone, server, context, timeout);
+}
+catch (const std::exception& e)
+{
+    context->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+}
+
+void mp::Daemon::refill_warm_pool(const std::string& profile, const CreateRequest& request)
+{
+    for (auto missing = warm_pool.missing(profile, warm_pool_size()); missing > 0; --missing)
+    {
+        std::string name;
+        do
+            name = fmt::format("warm-{}", mp::utils::make_uuid().substr(0, 8));
+        while (vm_instance_specs.find(name) != vm_instance_specs.end() || warm_pool.contains(name));
+
+        auto& warm_up = warm_ups[name] =
+            std::make_shared<WarmUp>(request, [this, name](grpc::Status status) {
+                QMetaObject::invokeMethod(
+                    this,
+                    [this, name, status] { finish_warm_up(name, status); },
+                    Qt::QueuedConnection);
+            });
+        warm_up->keep_alive = warm_up;
+        warm_up->request.set_instance_name(name);
+        warm_up->request.set_verbosity_level(0);
+        warm_up->request.set_trace(false);
+
+        warm_pool.add(name, profile);
+        persist_warm_pool();
+        mpl::info(category, "Warming up {} for launches of {}", name, profile);
+
+        try
+        {
+            create_vm(&warm_up->request, warm_up.get(), warm_up.get(), /*start=*/true);
+        }
+        catch (const std::exception& e)
+        {
+            warm_up->set_value(grpc::Status(grpc::StatusCode::FAILED_PRECONDITION, e.what(), ""));
+        }
+    }
+}
+
+void mp::Daemon::finish_warm_up(const std::string& name, const grpc::Status& status)
+{
+    warm_ups.erase(name);
+
+    auto it = operative_instances.find(name);
+    auto error = status.error_message();
+    if (status.ok() && it != operative_instances.end())
+    {
+        try
+        {
+            // First boot is over. What remains to be done is tied to the identity the instance
+            // gets when it is handed out, so it waits switched off.
+            it->second->shutdown(VirtualMachine::ShutdownPolicy::Halt);
+            warm_instances[name] = std::move(it->second);
+            operative_instances.erase(it);
+            mounts.erase(name);
+            warm_pool.mark_ready(name);
+            mpl::info(category, "{} is ready in the warm pool", name);
+        }
+        catch (const std::exception& e)
+        {
+            error = e.what();
+        }
+    }
+    else if (status.ok())
+    {
+        error = "the instance is gone";
+    }
+
+    if (!warm_pool.is_ready(name))
+    {
+        mpl::warn(category, "Could not warm up {}: {}", name, error);
+        top_catch_all(category, [this, &name] {
+            if (auto vm_it = operative_instances.find(name); vm_it != operative_instances.end())
+            {
+                vm_it->second->shutdown(VirtualMachine::ShutdownPolicy::Poweroff);
+                operative_instances.erase(vm_it);
+                mounts.erase(name);
+                release_resources(name);
+            }
+        });
+        warm_pool.remove(name);
+    }
+
+    persist_instances();
+    persist_warm_pool();
+}
+
+void mp::Daemon::discard_warm_instance(const std::string& name)
+{
+    mpl::debug(category, "Discarding {} from the warm pool", name);
+
+    warm_pool.remove(name);
+    warm_instances.erase(name);
+    release_resources(name);
+    persist_instances();
+}
+
+void mp::Daemon::persist_warm_pool()
+{
+    QDir data_dir{mp::utils::backend_directory_path(config->data_directory,
+                                                    config->factory->get_backend_directory_name())};
+    mp::RecordDatabase::write(data_dir.filePath(warm_pool_db_name), warm_pool.to_json());
+}
+
 bool mp::Daemon::is_bridged(const std::string& instance_name) const
 {
     return is_bridged_impl(vm_instance_specs.at(instance_name),
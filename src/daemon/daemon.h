@@ -19,6 +19,8 @@
 
 #include "daemon_config.h"
 #include "daemon_rpc.h"
+#include "memory_reclaimer.h"
+#include "warm_pool.h"
 
 #include <multipass/async_periodic_download_task.h>
 #include <multipass/delayed_shutdown_timer.h>
@@ -29,6 +31,8 @@
 #include <multipass/vm_status_monitor.h>
 
 #include <chrono>
+#include <deque>
+#include <functional>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -177,6 +181,10 @@ public slots:
         grpc::ServerReaderWriterInterface<ZonesStateReply, ZonesStateRequest>* server,
         DaemonRpcContext* context);
 
+    virtual void metrics(const MetricsRequest* request,
+                         grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>* server,
+                         DaemonRpcContext* context);
+
     virtual void wait_ready(
         const WaitReadyRequest* request,
         grpc::ServerReaderWriterInterface<WaitReadyReply, WaitReadyRequest>* server,
@@ -188,6 +196,11 @@ private:
                    grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
                    DaemonRpcContext* context,
                    bool start);
+    void start_created_vm(const std::string& name,
+                          const std::string& zone,
+                          grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
+                          DaemonRpcContext* context,
+                          std::chrono::seconds timeout);
     bool delete_vm(InstanceTable::iterator vm_it, bool purge, DeleteReply& response);
     grpc::Status reboot_vm(VirtualMachine& vm);
     grpc::Status shutdown_vm(VirtualMachine& vm, const std::chrono::milliseconds delay);
@@ -198,6 +211,11 @@ private:
     void init_mounts(const std::string& name);
     void stop_mounts(const std::string& name);
 
+    void sync_restarted_instance(const std::string& name, const std::function<void()>& on_synced);
+    void dispatch_boot_queue();
+    bool unqueue_boot(const std::string& name); // returns whether the instance was waiting to boot
+    std::function<bool(const std::string&)> hidden_instances() const; // not for users to select
+
     // This returns whether any specs were updated (and need persisting)
     bool update_mounts(VMSpecs& vm_specs,
                        std::unordered_map<std::string, MountHandler::UPtr>& vm_mounts,
@@ -237,6 +255,7 @@ private:
     QFutureWatcher<AsyncOperationStatus>* create_future_watcher(
         std::function<void()> const& finished_op = []() {});
     void update_manifests_all(const bool force_update = false);
+    void reclaim_memory();
     void wait_update_manifests_all_and_optionally_applied_force(
         const bool force_manifest_network_download);
 
@@ -257,6 +276,18 @@ private:
                        const std::string& src_name,
                        const std::string& dest_name);
 
+    struct WarmUp;
+    void launch_from_warm_pool(
+        const std::string& member,
+        const std::string& name,
+        grpc::ServerReaderWriterInterface<CreateReply, CreateRequest>* server,
+        DaemonRpcContext* context,
+        std::chrono::seconds timeout);
+    void refill_warm_pool(const std::string& profile, const CreateRequest& request);
+    void finish_warm_up(const std::string& name, const grpc::Status& status);
+    void discard_warm_instance(const std::string& name);
+    void persist_warm_pool();
+
     std::unique_ptr<const DaemonConfig> config;
 
 protected:
@@ -273,6 +304,8 @@ private:
     std::unordered_set<std::string> allocated_mac_addrs;
     DaemonRpc daemon_rpc;
     QTimer source_images_maintenance_task;
+    QTimer memory_reclaim_task;
+    MemoryReclaimer memory_reclaimer;
     multipass::utils::AsyncPeriodicDownloadTask<void> update_manifests_all_task{
         "fetch manifest periodically",
         std::chrono::minutes(15),
@@ -283,12 +316,22 @@ private:
     std::unordered_map<std::string, std::unique_ptr<QFutureWatcher<AsyncOperationStatus>>>
         async_future_watchers;
     std::unordered_map<std::string, QFuture<std::string>> async_running_futures;
+    std::unordered_map<std::string, std::chrono::microseconds> resume_durations; // by start_mutex
     std::mutex start_mutex;
+    std::mutex persist_state_mutex;
     std::unordered_set<std::string> preparing_instances;
+    // The zones picked for instances being prepared, and the resources they asked for, by name
+    std::unordered_map<std::string, std::pair<std::string, ZoneLoad>> preparing_loads;
     QFuture<void> image_update_future;
     SettingsHandler* instance_mod_handler;
     SettingsHandler* snapshot_mod_handler;
     std::unordered_map<std::string, std::unordered_map<std::string, MountHandler::UPtr>> mounts;
     std::unordered_set<std::string> user_authorized_bridges;
+    std::deque<std::string> boot_queue; // previously running instances waiting to be restarted
+    int boot_concurrency = 1;
+    int booting_instances = 0;
+    WarmPool warm_pool;
+    InstanceTable warm_instances; // stopped instances ready to be handed out by the warm pool
+    std::unordered_map<std::string, std::shared_ptr<WarmUp>> warm_ups;
 };
 } // namespace multipass
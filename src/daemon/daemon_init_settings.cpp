@@ -92,6 +92,51 @@ QString image_mirror_interpreter(QString val)
     return val;
 }
 
+QString autostart_concurrency_interpreter(QString val)
+{
+    bool ok;
+    if (val.toInt(&ok) < 1 || !ok)
+        throw mp::InvalidSettingException(mp::autostart_concurrency_key,
+                                          val,
+                                          "Need a positive integer");
+
+    return val;
+}
+
+QString warm_pool_size_interpreter(QString val)
+{
+    bool ok;
+    if (val.toInt(&ok) < 0 || !ok)
+        throw mp::InvalidSettingException(mp::warm_pool_size_key,
+                                          val,
+                                          "Need a non-negative integer");
+
+    return val;
+}
+
+QString zone_placement_interpreter(QString val)
+{
+    if (val != mp::zone_placement_first_available && val != mp::zone_placement_least_loaded)
+        throw mp::InvalidSettingException(
+            mp::zone_placement_key,
+            val,
+            QString{"Need '%1' or '%2'"}.arg(mp::zone_placement_first_available,
+                                             mp::zone_placement_least_loaded));
+
+    return val;
+}
+
+QString suspend_mode_interpreter(QString val)
+{
+    if (val != mp::suspend_mode_snapshot && val != mp::suspend_mode_file)
+        throw mp::InvalidSettingException(
+            mp::suspend_mode_key,
+            val,
+            QString{"Need '%1' or '%2'"}.arg(mp::suspend_mode_snapshot, mp::suspend_mode_file));
+
+    return val;
+}
+
 } // namespace
 
 void mp::daemon::monitor_and_quit_on_settings_change() // temporary
@@ -123,6 +168,21 @@ void mp::daemon::register_global_settings_handlers()
     }));
     settings.insert(
         std::make_unique<CustomSettingSpec>(mp::mirror_key, "", image_mirror_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::autostart_concurrency_key,
+                                                        mp::autostart_concurrency_default,
+                                                        autostart_concurrency_interpreter));
+    settings.insert(std::make_unique<BasicSettingSpec>(mp::autostart_priority_key, ""));
+    settings.insert(std::make_unique<BoolSettingSpec>(mp::memory_reclaim_key, "false"));
+    settings.insert(std::make_unique<BoolSettingSpec>(mp::multiplexed_mounts_key, "false"));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::zone_placement_key,
+                                                        mp::zone_placement_least_loaded,
+                                                        zone_placement_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::warm_pool_size_key,
+                                                        "0",
+                                                        warm_pool_size_interpreter));
+    settings.insert(std::make_unique<CustomSettingSpec>(mp::suspend_mode_key,
+                                                        mp::suspend_mode_snapshot,
+                                                        suspend_mode_interpreter));
 
     MP_SETTINGS.register_handler(
         std::make_unique<PersistentSettingsHandler>(persistent_settings_filename(),
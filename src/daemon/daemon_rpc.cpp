@@ -20,9 +20,11 @@
 #include <multipass/daemon_rpc_context.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/utils.h>
 
+#include <array>
 #include <chrono>
 #include <stdexcept>
 
@@ -86,6 +88,47 @@ auto server_socket_type_for(const std::string& server_address)
     return mp::ServerSocketType::tcp;
 }
 
+std::string status_code_name(grpc::StatusCode code)
+{
+    constexpr std::array names{"OK",
+                               "CANCELLED",
+                               "UNKNOWN",
+                               "INVALID_ARGUMENT",
+                               "DEADLINE_EXCEEDED",
+                               "NOT_FOUND",
+                               "ALREADY_EXISTS",
+                               "PERMISSION_DENIED",
+                               "RESOURCE_EXHAUSTED",
+                               "FAILED_PRECONDITION",
+                               "ABORTED",
+                               "OUT_OF_RANGE",
+                               "UNIMPLEMENTED",
+                               "INTERNAL",
+                               "UNAVAILABLE",
+                               "DATA_LOSS",
+                               "UNAUTHENTICATED"};
+
+    const auto index = static_cast<std::size_t>(code);
+    return index < names.size() ? names[index] : std::to_string(index);
+}
+
+void record_rpc(const std::string& request_type,
+                const grpc::Status& status,
+                std::chrono::steady_clock::duration duration)
+{
+    auto& registry = mp::metrics::registry();
+    registry
+        .counter("multipass_rpc_requests_total",
+                 "Requests handled by the daemon, by type and status",
+                 {{"request", request_type}, {"code", status_code_name(status.error_code())}})
+        .increment();
+    registry
+        .histogram("multipass_rpc_duration_seconds",
+                   "Time the daemon took to handle requests, by type",
+                   {{"request", request_type}})
+        .observe(duration);
+}
+
 template <typename T>
 concept HasVerbosityLevel = requires(T t) { t.verbosity_level(); };
 
@@ -102,13 +145,19 @@ grpc::Status emit_signal_and_wait_for_result(OperationSignal operation_signal,
             return mpl::Level::error;
     }();
 
+    const auto started = std::chrono::steady_clock::now();
     std::promise<grpc::Status> promise;
     auto future = promise.get_future();
     multipass::DaemonRpcContextImpl<T, U> ctx{promise, server, level, mpx};
     emit operation_signal(request,
                           static_cast<grpc::ServerReaderWriter<T, U>*>(server),
                           static_cast<multipass::DaemonRpcContext*>(&ctx));
-    return future.get();
+
+    auto status = future.get();
+    record_rpc(std::string{U::descriptor()->name()},
+               status,
+               std::chrono::steady_clock::now() - started);
+    return status;
 }
 
 std::string client_cert_from(grpc::ServerContext* context)
@@ -542,6 +591,18 @@ grpc::Status mp::DaemonRpc::zones_state(
                                                 server);
 }
 
+grpc::Status mp::DaemonRpc::metrics(grpc::ServerContext* context,
+                                    grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server)
+{
+    return verify_client_and_dispatch_operation(std::bind(&DaemonRpc::on_metrics,
+                                                          this,
+                                                          std::placeholders::_1,
+                                                          std::placeholders::_2,
+                                                          std::placeholders::_3),
+                                                client_cert_from(context),
+                                                server);
+}
+
 template <typename T, typename U, typename OperationSignal>
 grpc::Status
 mp::DaemonRpc::verify_client_and_dispatch_operation(OperationSignal signal,
@@ -146,6 +146,9 @@ signals:
     void on_zones_state(const ZonesStateRequest* request,
                         grpc::ServerReaderWriter<ZonesStateReply, ZonesStateRequest>* server,
                         DaemonRpcContext* context);
+    void on_metrics(const MetricsRequest* request,
+                    grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server,
+                    DaemonRpcContext* context);
 
 private:
     template <typename T, typename U, typename OperationSignal>
@@ -226,5 +229,7 @@ protected:
     grpc::Status zones_state(
         grpc::ServerContext* context,
         grpc::ServerReaderWriter<ZonesStateReply, ZonesStateRequest>* server) override;
+    grpc::Status metrics(grpc::ServerContext* context,
+                         grpc::ServerReaderWriter<MetricsReply, MetricsRequest>* server) override;
 };
 } // namespace multipass
@@ -25,10 +25,13 @@
 #include <multipass/format.h>
 #include <multipass/json_utils.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/process/qemuimg_process_spec.h>
 #include <multipass/query.h>
+#include <multipass/record_database.h>
 #include <multipass/rpc/multipass.grpc.pb.h>
+#include <multipass/tracing.h>
 #include <multipass/url_downloader.h>
 #include <multipass/utils.h>
 #include <multipass/utils/qemu_img_utils.h>
@@ -51,15 +54,28 @@ constexpr auto category = "image vault";
 constexpr auto instance_db_name = "multipassd-instance-image-records.json";
 constexpr auto image_db_name = "multipassd-image-records.json";
 
+// Whether a requested image was already prepared ("hit"), was being fetched by another request
+// ("shared") or had to be fetched ("miss")
+void count_lookup(const std::string& result)
+{
+    mp::metrics::registry()
+        .counter("multipass_image_vault_lookups_total",
+                 "Image requests to the vault, by whether they were served from its cache",
+                 {{"result", result}})
+        .increment();
+}
+
 std::unordered_map<std::string, mp::VaultRecord> load_db(const QString& db_name)
 {
-    QFile db_file{db_name};
-    auto opened = db_file.open(QIODevice::ReadOnly);
-    if (!opened || db_file.size() == 0)
+    auto records = mp::RecordDatabase::open(db_name);
+    if (!records)
         return {};
 
-    auto records = boost::json::parse(std::string_view(db_file.readAll()));
-    return value_to<std::unordered_map<std::string, mp::VaultRecord>>(records);
+    std::unordered_map<std::string, mp::VaultRecord> ret;
+    for (const auto& key : records->keys())
+        ret.emplace(key, value_to<mp::VaultRecord>(records->at(key)));
+
+    return ret;
 }
 
 void remove_source_images(const mp::VMImage& source_image, const mp::VMImage& prepared_image)
@@ -92,8 +108,7 @@ mp::MemorySize get_image_size(const std::filesystem::path& image_path)
 void persist_records(const std::unordered_map<std::string, mp::VaultRecord>& records,
                      const QString& path)
 {
-    auto json = boost::json::value_from(records);
-    MP_FILEOPS.write_transactionally(path, mp::pretty_print(json));
+    mp::RecordDatabase::write(path, boost::json::value_from(records));
 }
 } // namespace
 
@@ -158,6 +173,8 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const Query& query,
                                                  const std::optional<std::string>& checksum,
                                                  const mp::Path& save_dir)
 {
+    mp::tracing::Span span{"DefaultVMImageVault::fetch_image"};
+
     {
         std::lock_guard<decltype(fetch_mutex)> lock{fetch_mutex};
         auto name_entry = instance_image_records.find(query.name);
@@ -236,18 +253,22 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const Query& query,
                 if (last_modified.isValid() &&
                     (last_modified.toString().toStdString() == record.image.release_date))
                 {
-                    return finalize_image_records(query, record.image, id, save_dir);
+                    auto image = finalize_image_records(query, record.image, id, save_dir);
+                    count_lookup("hit");
+                    return image;
                 }
             }
 
             auto running_future = get_image_future(id);
             if (running_future)
             {
+                count_lookup("shared");
                 monitor(LaunchProgress::WAITING, -1);
                 future = *running_future;
             }
             else
             {
+                count_lookup("miss");
                 const VMImageInfo info{{},
                                        {},
                                        {},
@@ -271,14 +292,14 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const Query& query,
 
                 // Had to use std::bind here to workaround the 5 allowable function arguments
                 // constraint of QtConcurrent::run()
-                future = QtConcurrent::run(
+                future = QtConcurrent::run(mp::tracing::traced(
                     std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
                               this,
                               info,
                               source_image,
                               image_dir,
                               prepare,
-                              monitor));
+                              monitor)));
 
                 in_progress_image_fetches[id] = {image_dir, future};
             }
@@ -299,7 +320,10 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const Query& query,
                 {
                     try
                     {
-                        return finalize_image_records(query, entry->second.image, id, save_dir);
+                        auto image =
+                            finalize_image_records(query, entry->second.image, id, save_dir);
+                        count_lookup("hit");
+                        return image;
                     }
                     catch (const std::exception& e)
                     {
@@ -311,25 +335,27 @@ mp::VMImage mp::DefaultVMImageVault::fetch_image(const Query& query,
             auto running_future = get_image_future(id);
             if (running_future)
             {
+                count_lookup("shared");
                 monitor(LaunchProgress::WAITING, -1);
                 future = *running_future;
             }
             else
             {
+                count_lookup("miss");
                 const auto image_dir =
                     MP_UTILS.make_dir(images_dir,
                                       QString("%1-%2").arg(info->release).arg(info->version));
 
                 // Had to use std::bind here to workaround the 5 allowable function arguments
                 // constraint of QtConcurrent::run()
-                future = QtConcurrent::run(
+                future = QtConcurrent::run(mp::tracing::traced(
                     std::bind(&DefaultVMImageVault::download_and_prepare_source_image,
                               this,
                               *info,
                               source_image,
                               image_dir,
                               prepare,
-                              monitor));
+                              monitor)));
 
                 in_progress_image_fetches[id] = {image_dir, future};
             }
@@ -542,6 +568,8 @@ mp::VMImage mp::DefaultVMImageVault::download_and_prepare_source_image(
     const PrepareAction& prepare,
     const ProgressMonitor& monitor)
 {
+    mp::tracing::Span span{"DefaultVMImageVault::download_and_prepare_source_image"};
+
     VMImage source_image;
     auto id = info.id;
 
@@ -19,12 +19,15 @@
 
 #include <multipass/cli/prompters.h>
 #include <multipass/constants.h>
+#include <multipass/cpu_affinity.h>
 #include <multipass/exceptions/invalid_memory_size_exception.h>
 #include <multipass/settings/bool_setting_spec.h>
 
 #include <QRegularExpression>
 #include <QStringList>
 
+#include <algorithm>
+
 namespace mp = multipass;
 
 namespace
@@ -33,6 +36,24 @@ constexpr auto cpus_suffix = "cpus";
 constexpr auto mem_suffix = "memory";
 constexpr auto disk_suffix = "disk";
 constexpr auto bridged_suffix = "bridged";
+constexpr auto network_multiqueue_suffix = "network-multiqueue";
+constexpr auto disk_profile_suffix = "disk-profile";
+constexpr auto memory_backing_suffix = "memory-backing";
+constexpr auto memory_prealloc_suffix = "memory-prealloc";
+constexpr auto memory_host_node_suffix = "memory-host-node";
+constexpr auto cpu_affinity_suffix = "cpu-affinity";
+constexpr auto cpu_pinning_suffix = "cpu-pinning";
+constexpr auto suffixes = {cpus_suffix,
+                           mem_suffix,
+                           disk_suffix,
+                           bridged_suffix,
+                           network_multiqueue_suffix,
+                           disk_profile_suffix,
+                           memory_backing_suffix,
+                           memory_prealloc_suffix,
+                           memory_host_node_suffix,
+                           cpu_affinity_suffix,
+                           cpu_pinning_suffix};
 
 enum class Operation
 {
@@ -50,8 +71,7 @@ QRegularExpression make_key_regex()
 {
     const auto instance_pattern = QStringLiteral("(?<instance>.+)");
     const auto prop_template = QStringLiteral("(?<property>%1)");
-    const auto either_prop =
-        QStringList{cpus_suffix, mem_suffix, disk_suffix, bridged_suffix}.join("|");
+    const auto either_prop = QStringList(suffixes.begin(), suffixes.end()).join("|");
     const auto prop_pattern = prop_template.arg(either_prop);
 
     const auto key_template = QStringLiteral(R"(%1\.%2\.%3)");
@@ -196,6 +216,115 @@ void update_bridged(const QString& key,
     else
         add_interface(instance_name); // if already bridged, this merely warns
 }
+
+void update_network_multiqueue(const QString& key,
+                               const QString& val,
+                               mp::VirtualMachine& instance,
+                               mp::VMSpecs& spec)
+{
+    auto want_multiqueue = mp::BoolSettingSpec{key, "false"}.interpret(val) == "true";
+    if (want_multiqueue != spec.network_multiqueue) // NOOP if equal
+    {
+        instance.set_network_multiqueue(want_multiqueue);
+        spec.network_multiqueue = want_multiqueue;
+    }
+}
+
+std::string interpret_choice(const QString& key,
+                             const QString& val,
+                             std::initializer_list<const char*> choices)
+{
+    auto ret = val.toLower().toStdString();
+    if (std::ranges::find(choices, ret) == std::ranges::end(choices))
+        throw mp::InvalidSettingException{
+            key,
+            val,
+            QString("Valid values are: %1")
+                .arg(QStringList(choices.begin(), choices.end()).join(", "))};
+
+    return ret;
+}
+
+void update_disk_profile(const QString& key,
+                         const QString& val,
+                         mp::VirtualMachine& instance,
+                         mp::VMSpecs& spec)
+{
+    if (const auto profile = interpret_choice(key, val, mp::disk_profiles);
+        profile != spec.disk_profile) // NOOP if equal
+    {
+        instance.set_disk_profile(profile);
+        spec.disk_profile = profile;
+    }
+}
+
+void update_memory_backing(const QString& key,
+                           const QString& val,
+                           const std::string& property,
+                           mp::VirtualMachine& instance,
+                           mp::VMSpecs& spec)
+{
+    auto backing = spec.memory_backing;
+    if (property == memory_backing_suffix)
+        backing.type = interpret_choice(key, val, mp::memory_backings);
+    else if (property == memory_prealloc_suffix)
+        backing.prealloc = mp::BoolSettingSpec{key, "false"}.interpret(val) == "true";
+    else
+    {
+        assert(property == memory_host_node_suffix);
+
+        bool converted_ok = false;
+        if (val.toLower() == "none")
+            backing.host_node = std::nullopt;
+        else if (auto node = val.toInt(&converted_ok); converted_ok && node >= 0)
+            backing.host_node = node;
+        else
+            throw mp::InvalidSettingException{key,
+                                              val,
+                                              "Need a non-negative integer or \"none\""};
+    }
+
+    if (backing != spec.memory_backing) // NOOP if equal
+    {
+        instance.set_memory_backing(backing);
+        spec.memory_backing = backing;
+    }
+}
+
+void update_cpu_affinity(const QString& key,
+                         const QString& val,
+                         const std::string& property,
+                         mp::VirtualMachine& instance,
+                         mp::VMSpecs& spec)
+{
+    auto affinity = spec.cpu_affinity;
+    if (property == cpu_pinning_suffix)
+        affinity.pin_vcpus = mp::BoolSettingSpec{key, "false"}.interpret(val) == "true";
+    else
+    {
+        assert(property == cpu_affinity_suffix);
+
+        if (val.toLower() == "none")
+            affinity.host_cpus.clear();
+        else
+        {
+            try
+            {
+                affinity.host_cpus = mp::format_cpu_list(mp::parse_cpu_list(val.toStdString()));
+            }
+            catch (const std::invalid_argument& e)
+            {
+                throw mp::InvalidSettingException{key, val, e.what()};
+            }
+        }
+    }
+
+    if (affinity != spec.cpu_affinity) // NOOP if equal
+    {
+        instance.set_cpu_affinity(affinity);
+        spec.cpu_affinity = affinity;
+    }
+}
 } // namespace
 
 mp::InstanceSettingsException::InstanceSettingsException(const std::string& reason,
@@ -229,7 +358,7 @@ std::set<QString> mp::InstanceSettingsHandler::keys() const
 
     std::set<QString> ret;
     for (const auto& item : vm_instance_specs)
-        for (const auto& suffix : {cpus_suffix, mem_suffix, disk_suffix, bridged_suffix})
+        for (const auto& suffix : suffixes)
             ret.insert(key_template.arg(item.first.c_str()).arg(suffix));
 
     return ret;
@@ -244,6 +373,23 @@ QString mp::InstanceSettingsHandler::get(const QString& key) const
     {
         return is_bridged(instance_name) ? "true" : "false";
     }
+    if (property == network_multiqueue_suffix)
+        return spec.network_multiqueue ? "true" : "false";
+    if (property == disk_profile_suffix)
+        return QString::fromStdString(spec.disk_profile);
+    if (property == memory_backing_suffix)
+        return QString::fromStdString(spec.memory_backing.type);
+    if (property == memory_prealloc_suffix)
+        return spec.memory_backing.prealloc ? "true" : "false";
+    if (property == memory_host_node_suffix)
+        return spec.memory_backing.host_node ? QString::number(*spec.memory_backing.host_node)
+                                             : "none";
+    if (property == cpu_affinity_suffix)
+        return spec.cpu_affinity.host_cpus.empty()
+                   ? "none"
+                   : QString::fromStdString(spec.cpu_affinity.host_cpus);
+    if (property == cpu_pinning_suffix)
+        return spec.cpu_affinity.pin_vcpus ? "true" : "false";
     if (property == cpus_suffix)
         return QString::number(spec.num_cores);
     if (property == mem_suffix)
@@ -277,6 +423,15 @@ void mp::InstanceSettingsHandler::set(const QString& key,
     {
         update_bridged(key, val, instance_name, is_bridged, add_interface);
     }
+    else if (property == network_multiqueue_suffix)
+        update_network_multiqueue(key, val, instance, spec);
+    else if (property == disk_profile_suffix)
+        update_disk_profile(key, val, instance, spec);
+    else if (property == memory_backing_suffix || property == memory_prealloc_suffix ||
+             property == memory_host_node_suffix)
+        update_memory_backing(key, val, property, instance, spec);
+    else if (property == cpu_affinity_suffix || property == cpu_pinning_suffix)
+        update_cpu_affinity(key, val, property, instance, spec);
     else
     {
         auto size = get_memory_size(key, val);
@@ -0,0 +1,104 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "memory_reclaimer.h"
+
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+#include <multipass/virtual_machine.h>
+
+#include <algorithm>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "memory-reclaim";
+constexpr auto min_memory = 512LL * 1024 * 1024;   // never shrink an instance below this
+constexpr auto min_headroom = 256LL * 1024 * 1024; // nor leave it with less available than this
+} // namespace
+
+mp::MemorySize mp::memory_balloon_target(const MemorySize& total, const MemoryBalloon& balloon)
+{
+    const auto total_bytes = total.in_bytes();
+    const auto actual = balloon.actual.in_bytes();
+    if (!balloon.available)
+        return balloon.actual; // nothing to go by until the guest reports its memory
+
+    const auto available = balloon.available->in_bytes();
+    const auto headroom = std::max(total_bytes / 4, min_headroom);
+
+    if (available < headroom / 2)
+        return total;
+
+    if (available <= headroom)
+        return balloon.actual;
+
+    const auto floor = std::min(std::max(total_bytes / 4, min_memory), total_bytes);
+    const auto step = std::min(total_bytes / 8, available - headroom);
+
+    return MemorySize::from_bytes(std::clamp(actual - step, floor, total_bytes));
+}
+
+void mp::MemoryReclaimer::reclaim(const std::vector<Instance>& instances, bool enabled)
+{
+    std::unordered_map<std::string, MemorySize> still_reclaimed;
+    for (const auto& [name, vm, total] : instances)
+    {
+        try
+        {
+            // The balloon tells what was taken, even by an earlier daemon or a round that failed
+            const auto balloon = vm.memory_balloon();
+            const auto target = enabled ? memory_balloon_target(total, balloon) : total;
+            if (target != balloon.actual)
+            {
+                mpl::debug(category,
+                           "Setting the balloon target of {} to {}",
+                           name,
+                           target.human_readable());
+                vm.set_memory_balloon_target(target);
+            }
+
+            if (balloon.actual < total)
+                still_reclaimed.emplace(
+                    name,
+                    MemorySize::from_bytes(total.in_bytes() - balloon.actual.in_bytes()));
+        }
+        catch (const NotImplementedOnThisBackendException&)
+        {
+            // no balloon to inflate
+        }
+        catch (const std::exception& e)
+        {
+            mpl::warn(category, "Could not reclaim memory from {}: {}", name, e.what());
+            if (const auto it = reclaimed.find(name); it != reclaimed.end())
+                still_reclaimed.insert(*it); // so that it is still given back when disabled
+        }
+    }
+
+    reclaimed = std::move(still_reclaimed);
+}
+
+std::optional<mp::MemorySize> mp::MemoryReclaimer::reclaimed_memory(const std::string& name) const
+{
+    if (const auto it = reclaimed.find(name); it != reclaimed.end())
+        return it->second;
+
+    return std::nullopt;
+}
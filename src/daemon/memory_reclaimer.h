@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/memory_balloon.h>
+#include <multipass/memory_size.h>
+
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace multipass
+{
+class VirtualMachine;
+
+// The memory to leave an instance with, given its total memory and what its balloon reports:
+// instances that leave much of their memory unused are shrunk a step at a time, and get all of it
+// back as soon as they run short
+MemorySize memory_balloon_target(const MemorySize& total, const MemoryBalloon& balloon);
+
+// Overcommits host memory by inflating the balloons of running instances that do not use all of
+// theirs. Instances whose backend has no balloon are left alone.
+class MemoryReclaimer
+{
+public:
+    struct Instance
+    {
+        std::string name;
+        VirtualMachine& vm;
+        MemorySize total;
+    };
+
+    // Adjusts the balloon of each instance; when not enabled, deflates any balloon that holds memory
+    void reclaim(const std::vector<Instance>& instances, bool enabled);
+
+    // What the last round took from the instance, if anything
+    std::optional<MemorySize> reclaimed_memory(const std::string& name) const;
+
+private:
+    std::unordered_map<std::string, MemorySize> reclaimed;
+};
+} // namespace multipass
@@ -0,0 +1,135 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "warm_pool.h"
+
+#include <multipass/format.h>
+
+#include <algorithm>
+
+namespace mp = multipass;
+
+std::optional<std::string> mp::WarmPool::profile_for(const LaunchRequest& request)
+{
+    // Instances are handed out with their image, resources, zone and time zone. Everything else
+    // would have to be redone at first boot, which is what the pool is there to avoid.
+    if (!request.cloud_init_user_data().empty() || request.network_options_size() > 0 ||
+        !request.kernel_name().empty())
+        return std::nullopt;
+
+    return fmt::format("{}:{} cpus={} memory={} disk={} zone={} time-zone={}",
+                       request.remote_name(),
+                       request.image().empty() ? "default" : request.image(),
+                       request.num_cores(),
+                       request.mem_size().empty() ? "default" : request.mem_size(),
+                       request.disk_space().empty() ? "default" : request.disk_space(),
+                       request.zone().empty() ? "auto" : request.zone(),
+                       request.time_zone().empty() ? "default" : request.time_zone());
+}
+
+mp::WarmPool mp::WarmPool::from_json(const boost::json::object& records)
+{
+    WarmPool pool;
+    for (const auto& [name, record] : records)
+    {
+        const auto& member = record.as_object();
+        pool.members.emplace(name,
+                             Member{boost::json::value_to<std::string>(member.at("profile")),
+                                    member.at("ready").as_bool()});
+    }
+
+    return pool;
+}
+
+boost::json::object mp::WarmPool::to_json() const
+{
+    boost::json::object records;
+    for (const auto& [name, member] : members)
+        records[name] = {{"profile", member.profile}, {"ready", member.ready}};
+
+    return records;
+}
+
+void mp::WarmPool::add(const std::string& name, const std::string& profile)
+{
+    members.insert_or_assign(name, Member{profile, false});
+}
+
+void mp::WarmPool::mark_ready(const std::string& name)
+{
+    if (auto it = members.find(name); it != members.end())
+        it->second.ready = true;
+}
+
+void mp::WarmPool::remove(const std::string& name)
+{
+    members.erase(name);
+}
+
+std::optional<std::string> mp::WarmPool::take(const std::string& profile)
+{
+    const auto it = std::find_if(members.begin(), members.end(), [&profile](const auto& item) {
+        return item.second.ready && item.second.profile == profile;
+    });
+    if (it == members.end())
+        return std::nullopt;
+
+    auto name = it->first;
+    members.erase(it);
+
+    return name;
+}
+
+bool mp::WarmPool::contains(const std::string& name) const
+{
+    return members.find(name) != members.end();
+}
+
+bool mp::WarmPool::is_ready(const std::string& name) const
+{
+    const auto it = members.find(name);
+    return it != members.end() && it->second.ready;
+}
+
+int mp::WarmPool::missing(const std::string& profile, int size) const
+{
+    const auto held = std::count_if(members.begin(), members.end(), [&profile](const auto& item) {
+        return item.second.profile == profile;
+    });
+
+    return std::max(size - static_cast<int>(held), 0);
+}
+
+std::vector<std::string> mp::WarmPool::surplus(int size) const
+{
+    std::map<std::string, int> kept;
+    std::vector<std::string> ret;
+    for (const auto& [name, member] : members)
+        if (member.ready && ++kept[member.profile] > size)
+            ret.push_back(name);
+
+    return ret;
+}
+
+std::vector<std::string> mp::WarmPool::names() const
+{
+    std::vector<std::string> ret;
+    for (const auto& [name, _] : members)
+        ret.push_back(name);
+
+    return ret;
+}
@@ -0,0 +1,71 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <boost/json.hpp>
+
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace multipass
+{
+// Keeps track of the instances created ahead of launches that ask for the same image and resources.
+// Such a launch takes a ready instance instead of creating one from scratch, after which the pool
+// is topped up again in the background.
+class WarmPool
+{
+public:
+    // What launches need to share to be served from the same instances, or std::nullopt for
+    // launches that customise their instance beyond image, resources, zone and time zone
+    static std::optional<std::string> profile_for(const LaunchRequest& request);
+
+    // Restores a pool from what to_json() produced. Throws when the records cannot be understood.
+    static WarmPool from_json(const boost::json::object& records);
+    boost::json::object to_json() const;
+
+    // Tracks an instance that is being warmed up for profile
+    void add(const std::string& name, const std::string& profile);
+    // Makes a warmed-up instance available to launches
+    void mark_ready(const std::string& name);
+    void remove(const std::string& name);
+    // Hands out a ready instance for profile, if there is one, and stops tracking it
+    std::optional<std::string> take(const std::string& profile);
+
+    bool contains(const std::string& name) const;
+    bool is_ready(const std::string& name) const;
+    // How many more instances profile needs for the pool to hold size of them, counting those
+    // still warming up
+    int missing(const std::string& profile, int size) const;
+    // Ready instances beyond size for their profile, which the pool no longer needs
+    std::vector<std::string> surplus(int size) const;
+    std::vector<std::string> names() const;
+
+private:
+    struct Member
+    {
+        std::string profile;
+        bool ready;
+    };
+
+    std::map<std::string, Member> members;
+};
+} // namespace multipass
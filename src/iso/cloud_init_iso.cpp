@@ -59,6 +59,9 @@ namespace mpu = multipass::utils;
 // ---------------------------------
 // data blocks
 // ---------------------------------
+//
+// Each directory spans as many blocks as its records need; records never cross a block boundary,
+// the rest of a block is zero-padded instead.
 
 namespace
 {
@@ -121,12 +124,6 @@ void set_at(T& t, SizeType offset, const V& value)
     std::copy(std::begin(value), std::end(value), t.begin() + offset);
 }
 
-template <typename T>
-void write(const T& t, std::ofstream& f)
-{
-    f.write(reinterpret_cast<const char*>(t.data.data()), t.data.size());
-}
-
 // The below three utility functions should serve as the abstraction layer for binary file reading,
 // the std::vector<uint8_t>, std::array<uint8_t, N> and uint8_t should be the only ones to receive
 // data because they indicate the nature of the data which is raw binary bytes.
@@ -248,13 +245,11 @@ struct RootDirRecord
         root_parent
     };
 
-    RootDirRecord(Type type, uint32_t location) : data{}
+    RootDirRecord(Type type, uint32_t location, uint32_t size) : data{}
     {
         data[0] = data.size();
         set_at(data, 2, to_lsb_msb(location));
-
-        uint32_t block_size = logical_block_size;
-        set_at(data, 10, to_lsb_msb(block_size));    // size of entry (limited to one block)
+        set_at(data, 10, to_lsb_msb(size));          // size of the directory extent
         data[25] = 0x02;                             // record is a directory entry
         set_at(data, 28, to_lsb_msb(1_u16));         // vol seq #
         data[32] = 1;                                // id_len length
@@ -456,17 +451,59 @@ std::size_t num_blocks(std::size_t num_bytes)
     return ((num_bytes + logical_block_size - 1) / logical_block_size);
 }
 
-void seek_to_next_block(std::ofstream& f)
+// Offsets of the file records within their directory, following the root and root parent records
+template <typename Record>
+std::vector<std::size_t> layout_file_records(const std::vector<Record>& records)
+{
+    std::vector<std::size_t> offsets;
+    offsets.reserve(records.size());
+
+    auto offset = 2 * sizeof(RootDirRecord);
+    for (const auto& record : records)
+    {
+        if (offset % logical_block_size + record.data.size() > logical_block_size)
+            offset = num_blocks(offset) * logical_block_size;
+
+        offsets.push_back(offset);
+        offset += record.data.size();
+    }
+
+    return offsets;
+}
+
+uint32_t directory_blocks(const std::vector<std::size_t>& record_offsets, std::size_t last_size)
 {
-    const auto next_block_pos = num_blocks(f.tellp()) * logical_block_size;
-    f.seekp(next_block_pos);
+    return num_blocks(record_offsets.empty() ? 2 * sizeof(RootDirRecord)
+                                             : record_offsets.back() + last_size);
 }
 
-void pad_to_end(std::ofstream& f)
+// Walks the file records of the directory described by `root_dir_record`, calling
+// `on_record(record_pos, record_size)` for each of them
+template <typename OnRecord>
+void for_each_file_record(std::ifstream& iso_file,
+                          const std::array<uint8_t, 34>& root_dir_record,
+                          OnRecord&& on_record)
 {
-    seek_to_next_block(f);
-    f.seekp(-1, std::ios::cur);
-    f.put('\0');
+    const uint32_t location = from_lsb_msb(std::span<const uint8_t, 8>{&root_dir_record[2], 8});
+    const uint32_t size = from_lsb_msb(std::span<const uint8_t, 8>{&root_dir_record[10], 8});
+    const uint32_t directory_start = location * logical_block_size;
+    const uint32_t directory_end = directory_start + size;
+
+    // total size of root dir and root dir parent
+    uint32_t record_pos = directory_start + 2u * sizeof(RootDirRecord);
+    while (record_pos < directory_end)
+    {
+        const uint8_t record_size = read_single_byte(iso_file, record_pos);
+        if (record_size == 0_u8)
+        {
+            // Zero padding up to the end of the block, the next record (if any) starts the next one
+            record_pos = num_blocks(record_pos + 1) * logical_block_size;
+            continue;
+        }
+
+        on_record(record_pos, record_size);
+        record_pos += to_u32(record_size);
+    }
 }
 } // namespace
 
@@ -545,17 +582,37 @@ void mp::CloudInitIso::write_to(const std::filesystem::path& path)
 
     const uint32_t num_reserved_bytes = 32768u;
     const uint32_t num_reserved_blocks = num_blocks(num_reserved_bytes);
-    f.seekp(num_reserved_bytes);
 
     PrimaryVolumeDescriptor prim_desc;
     JolietVolumeDescriptor joliet_desc;
 
     const uint32_t num_blocks_for_descriptors = 3u;
     const uint32_t num_blocks_for_path_table = 2u;
-    const uint32_t num_blocks_for_dir_records = 2u;
+
+    // The records only depend on the data layout through their location, so lay the directories
+    // out with placeholder locations first to find how many blocks they take
+    std::vector<ISOFileRecord> iso_file_records;
+    std::vector<JolietFileRecord> joliet_file_records;
+    iso_file_records.reserve(files.size());
+    joliet_file_records.reserve(files.size());
+    for (const auto& entry : files)
+    {
+        iso_file_records.emplace_back(entry.name, 0u, entry.data.size());
+        joliet_file_records.emplace_back(entry.name, 0u, entry.data.size());
+    }
+
+    const auto iso_record_offsets = layout_file_records(iso_file_records);
+    const auto joliet_record_offsets = layout_file_records(joliet_file_records);
+    const auto num_blocks_for_iso_dir = directory_blocks(
+        iso_record_offsets,
+        iso_file_records.empty() ? 0 : iso_file_records.back().data.size());
+    const auto num_blocks_for_joliet_dir = directory_blocks(
+        joliet_record_offsets,
+        joliet_file_records.empty() ? 0 : joliet_file_records.back().data.size());
 
     auto volume_size = num_reserved_blocks + num_blocks_for_descriptors +
-                       num_blocks_for_path_table + num_blocks_for_dir_records;
+                       num_blocks_for_path_table + num_blocks_for_iso_dir +
+                       num_blocks_for_joliet_dir;
     for (const auto& entry : files)
     {
         volume_size += num_blocks(entry.data.size());
@@ -567,65 +624,81 @@ void mp::CloudInitIso::write_to(const std::filesystem::path& path)
     uint32_t current_block_index = num_reserved_blocks + num_blocks_for_descriptors;
 
     // The following records are simply to specify that a root filesystem exists
-    RootPathTable root_path{current_block_index + num_blocks_for_path_table};
-    prim_desc.set_path_table_info(root_path.data.size(), current_block_index);
-    ++current_block_index;
-
-    RootPathTable joliet_root_path{current_block_index + num_blocks_for_path_table};
-    joliet_desc.set_path_table_info(joliet_root_path.data.size(), current_block_index);
-    ++current_block_index;
-
-    RootDirRecord root_record{RootDirRecord::Type::root, current_block_index};
-    RootDirRecord root_parent_record{RootDirRecord::Type::root_parent, current_block_index};
+    const uint32_t path_table_location = current_block_index;
+    const uint32_t joliet_path_table_location = path_table_location + 1u;
+    const uint32_t iso_dir_location = path_table_location + num_blocks_for_path_table;
+    const uint32_t joliet_dir_location = iso_dir_location + num_blocks_for_iso_dir;
+
+    RootPathTable root_path{iso_dir_location};
+    prim_desc.set_path_table_info(root_path.data.size(), path_table_location);
+
+    RootPathTable joliet_root_path{joliet_dir_location};
+    joliet_desc.set_path_table_info(joliet_root_path.data.size(), joliet_path_table_location);
+
+    const uint32_t iso_dir_size = num_blocks_for_iso_dir * logical_block_size;
+    RootDirRecord root_record{RootDirRecord::Type::root, iso_dir_location, iso_dir_size};
+    RootDirRecord root_parent_record{RootDirRecord::Type::root_parent,
+                                     iso_dir_location,
+                                     iso_dir_size};
     prim_desc.set_root_dir_record(root_record);
-    ++current_block_index;
 
-    RootDirRecord joliet_root_record{RootDirRecord::Type::root, current_block_index};
-    RootDirRecord joliet_root_parent_record{RootDirRecord::Type::root_parent, current_block_index};
+    const uint32_t joliet_dir_size = num_blocks_for_joliet_dir * logical_block_size;
+    RootDirRecord joliet_root_record{RootDirRecord::Type::root,
+                                     joliet_dir_location,
+                                     joliet_dir_size};
+    RootDirRecord joliet_root_parent_record{RootDirRecord::Type::root_parent,
+                                            joliet_dir_location,
+                                            joliet_dir_size};
     joliet_desc.set_root_dir_record(joliet_root_record);
-    ++current_block_index;
 
-    std::vector<ISOFileRecord> iso_file_records;
-    std::vector<JolietFileRecord> joliet_file_records;
+    current_block_index = joliet_dir_location + num_blocks_for_joliet_dir;
 
-    for (const auto& entry : files)
-    {
-        iso_file_records.emplace_back(entry.name, current_block_index, entry.data.size());
-        joliet_file_records.emplace_back(entry.name, current_block_index, entry.data.size());
-        current_block_index += num_blocks(entry.data.size());
-    }
+    // Assemble the whole image in memory, so that it goes to disk in a single write
+    std::string image(std::size_t{volume_size} * logical_block_size, '\0');
+    auto block_offset = [](uint32_t block) { return std::size_t{block} * logical_block_size; };
 
-    write(prim_desc, f);
-    write(joliet_desc, f);
-    write(VolumeDescriptorSetTerminator(), f);
+    set_at(image, num_reserved_bytes, prim_desc.data);
+    set_at(image, num_reserved_bytes + logical_block_size, joliet_desc.data);
+    set_at(image, num_reserved_bytes + 2 * logical_block_size, VolumeDescriptorSetTerminator().data);
 
-    write(root_path, f);
-    seek_to_next_block(f);
-    write(joliet_root_path, f);
-    seek_to_next_block(f);
+    set_at(image, block_offset(path_table_location), root_path.data);
+    set_at(image, block_offset(joliet_path_table_location), joliet_root_path.data);
 
-    write(root_record, f);
-    write(root_parent_record, f);
-    for (const auto& iso_record : iso_file_records)
-    {
-        write(iso_record, f);
-    }
-    seek_to_next_block(f);
+    set_at(image, block_offset(iso_dir_location), root_record.data);
+    set_at(image, block_offset(iso_dir_location) + sizeof(RootDirRecord), root_parent_record.data);
+    set_at(image, block_offset(joliet_dir_location), joliet_root_record.data);
+    set_at(image,
+           block_offset(joliet_dir_location) + sizeof(RootDirRecord),
+           joliet_root_parent_record.data);
 
-    write(joliet_root_record, f);
-    write(joliet_root_parent_record, f);
-    for (const auto& joliet_record : joliet_file_records)
+    extents.clear();
+    extents.reserve(files.size());
+    for (std::size_t i = 0; i < files.size(); ++i)
     {
-        write(joliet_record, f);
-    }
-    seek_to_next_block(f);
+        const auto& entry = files[i];
+        const auto location = to_lsb_msb(current_block_index);
+        set_at(iso_file_records[i].data, 2, location);
+        set_at(joliet_file_records[i].data, 2, location);
 
-    for (const auto& entry : files)
-    {
-        f.write(entry.data.data(), entry.data.size());
-        seek_to_next_block(f);
+        const auto iso_record_pos = block_offset(iso_dir_location) + iso_record_offsets[i];
+        const auto joliet_record_pos = block_offset(joliet_dir_location) + joliet_record_offsets[i];
+        set_at(image, iso_record_pos, iso_file_records[i].data);
+        set_at(image, joliet_record_pos, joliet_file_records[i].data);
+        set_at(image, block_offset(current_block_index), entry.data);
+
+        const auto entry_blocks = static_cast<uint32_t>(num_blocks(entry.data.size()));
+        extents.push_back(FileExtent{entry.name,
+                                     entry.data,
+                                     current_block_index,
+                                     entry_blocks,
+                                     static_cast<std::streamoff>(iso_record_pos),
+                                     static_cast<std::streamoff>(joliet_record_pos)});
+        current_block_index += entry_blocks;
     }
-    pad_to_end(f);
+
+    if (!f.write(image.data(), image.size()))
+        throw std::runtime_error{
+            fmt::format("Failed to write cloud-init image; path: {}", path.string())};
 }
 
 void mp::CloudInitIso::read_from(const std::filesystem::path& fs_path)
@@ -666,39 +739,21 @@ void mp::CloudInitIso::read_from(const std::filesystem::path& fs_path)
         throw std::runtime_error("The root directory record data is malformed.");
     }
 
-    // location lsb_msb bytes starts from 2
-    std::span<const uint8_t, 8> root_dir_record_data_location_lsb_bytes(
-        root_dir_record_data.begin() + 2u,
-        std::size_t(8));
-    const uint32_t root_dir_record_data_location_by_blocks =
-        from_lsb_msb(root_dir_record_data_location_lsb_bytes);
-    const uint32_t file_records_start_pos =
-        root_dir_record_data_location_by_blocks * logical_block_size +
-        2u * sizeof(RootDirRecord); // total size of root dir and root dir parent
-
-    uint32_t current_file_record_start_pos = file_records_start_pos;
-    while (true)
-    {
-        const uint8_t file_record_data_size =
-            read_single_byte(iso_file, current_file_record_start_pos);
-        if (file_record_data_size == 0_u8)
-        {
-            break;
-        }
-
+    extents.clear();
+    for_each_file_record(iso_file, root_dir_record_data, [&](uint32_t record_pos, uint8_t) {
         // In each iteration, the file record provides the size and location of the extent.
         // Initially, we utilize this information to navigate to and read the file data.
         // Subsequently, we return to the file record to extract the file name.
         const uint32_t file_content_location_by_blocks =
-            from_lsb_msb(read_bytes_to_array<8>(iso_file, current_file_record_start_pos + 2u));
+            from_lsb_msb(read_bytes_to_array<8>(iso_file, record_pos + 2u));
         const uint32_t file_content_size =
-            from_lsb_msb(read_bytes_to_array<8>(iso_file, current_file_record_start_pos + 10u));
+            from_lsb_msb(read_bytes_to_array<8>(iso_file, record_pos + 10u));
         const std::vector<uint8_t> file_content =
             read_bytes_to_vec(iso_file,
                               file_content_location_by_blocks * logical_block_size,
                               file_content_size);
 
-        const uint32_t file_name_length_start_pos = current_file_record_start_pos + 32u;
+        const uint32_t file_name_length_start_pos = record_pos + 32u;
         const uint8_t encoded_file_name_length =
             read_single_byte(iso_file, file_name_length_start_pos);
         const uint32_t file_name_start_pos = file_name_length_start_pos + 1u;
@@ -708,10 +763,88 @@ void mp::CloudInitIso::read_from(const std::filesystem::path& fs_path)
         const std::string original_file_name = convert_u16_name_back(
             std::string_view{reinterpret_cast<const char*>(encoded_file_name.data()),
                              encoded_file_name.size()});
-        files.emplace_back(
+        const auto& entry = files.emplace_back(
             FileEntry{original_file_name, std::string{file_content.cbegin(), file_content.cend()}});
 
-        current_file_record_start_pos += to_u32(file_record_data_size);
+        extents.push_back(FileExtent{entry.name,
+                                     entry.data,
+                                     file_content_location_by_blocks,
+                                     static_cast<uint32_t>(num_blocks(file_content_size)),
+                                     -1,
+                                     record_pos});
+    });
+
+    // The ISO9660 records describe the same extents, in the same order; they need to be kept in
+    // sync when patching files in place
+    const std::array<uint8_t, 34> iso_root_dir_record_data =
+        read_bytes_to_array<34>(iso_file, num_reserved_bytes + 156u);
+    std::size_t index = 0;
+    for_each_file_record(iso_file, iso_root_dir_record_data, [&](uint32_t record_pos, uint8_t) {
+        if (index < extents.size() &&
+            from_lsb_msb(read_bytes_to_array<8>(iso_file, record_pos + 2u)) ==
+                extents[index].location &&
+            num_blocks(from_lsb_msb(read_bytes_to_array<8>(iso_file, record_pos + 10u))) ==
+                extents[index].num_blocks)
+            extents[index].iso_record_pos = record_pos;
+        ++index;
+    });
+}
+
+void mp::CloudInitIso::write_changes_to(const std::filesystem::path& path)
+{
+    auto find_extent = [this](const std::string& name) {
+        return std::find_if(extents.begin(), extents.end(), [&name](const FileExtent& extent) {
+            return extent.name == name;
+        });
+    };
+
+    // Adding or removing files changes the directories, and growing one can overlap the next
+    const auto fits_in_place =
+        files.size() == extents.size() &&
+        std::all_of(files.cbegin(), files.cend(), [&find_extent, this](const FileEntry& entry) {
+            const auto extent = find_extent(entry.name);
+            return extent != extents.end() && extent->iso_record_pos >= 0 &&
+                   num_blocks(entry.data.size()) <= extent->num_blocks;
+        });
+
+    if (!fits_in_place)
+    {
+        write_to(path);
+        return;
+    }
+
+    std::fstream f{path, std::ios::binary | std::ios::in | std::ios::out};
+    if (!f.is_open())
+        throw std::runtime_error{
+            fmt::format("Failed to open file for patching cloud-init image; path: {}",
+                        path.string())};
+
+    for (const auto& entry : files)
+    {
+        auto& extent = *find_extent(entry.name);
+        if (entry.data == extent.data)
+            continue;
+
+        // Zero the rest of the extent, so that no stale data is left behind
+        std::string extent_data{entry.data};
+        extent_data.resize(std::size_t{extent.num_blocks} * logical_block_size, '\0');
+        f.seekp(std::streamoff{extent.location} * logical_block_size);
+        f.write(extent_data.data(), extent_data.size());
+
+        const auto size = to_lsb_msb(static_cast<uint32_t>(entry.data.size()));
+        for (const auto record_pos : {extent.iso_record_pos, extent.joliet_record_pos})
+        {
+            f.seekp(record_pos + 10);
+            f.write(reinterpret_cast<const char*>(size.data()), size.size());
+        }
+
+        if (!f)
+            throw std::runtime_error{
+                fmt::format("Failed to patch \"{}\" in cloud-init image; path: {}",
+                            entry.name,
+                            path.string())};
+
+        extent.data = entry.data;
     }
 }
 
@@ -737,7 +870,7 @@ void mp::CloudInitFileOps::update_cloud_init_with_new_extra_interfaces_and_new_i
     // overwrite the whole network-config file content
     iso_file["network-config"] = mpu::emit_cloud_config(
         mpu::make_cloud_init_network_config(default_mac_addr, extra_interfaces));
-    iso_file.write_to(cloud_init_path);
+    iso_file.write_changes_to(cloud_init_path);
 }
 
 void mp::CloudInitFileOps::update_identifiers(const std::string& default_mac_addr,
@@ -758,7 +891,7 @@ void mp::CloudInitFileOps::update_identifiers(const std::string& default_mac_add
                                                                    extra_interfaces,
                                                                    network_config_file_content));
 
-    iso_file.write_to(cloud_init_path);
+    iso_file.write_changes_to(cloud_init_path);
 }
 
 void mp::CloudInitFileOps::add_extra_interface_to_cloud_init(
@@ -776,7 +909,7 @@ void mp::CloudInitFileOps::add_extra_interface_to_cloud_init(
         mpu::add_extra_interface_to_network_config(default_mac_addr,
                                                    extra_interface,
                                                    iso_file["network-config"]));
-    iso_file.write_to(cloud_init_path);
+    iso_file.write_changes_to(cloud_init_path);
 }
 
 std::string mp::CloudInitFileOps::get_instance_id_from_cloud_init(
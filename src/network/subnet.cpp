@@ -25,6 +25,7 @@
 #include <fmt/format.h>
 
 #include <algorithm>
+#include <iterator>
 #include <limits>
 
 namespace mp = multipass;
@@ -167,6 +168,56 @@ std::strong_ordering mp::Subnet::operator<=>(const Subnet& other) const
     return other.prefix <=> prefix;
 }
 
+mp::SubnetOverlapIndex::SubnetOverlapIndex(const std::vector<Subnet>& subnets)
+{
+    ranges.reserve(subnets.size());
+    for (const auto& subnet : subnets)
+        ranges.push_back({subnet.masked_address().as_uint32(),
+                          subnet.broadcast_address().as_uint32(),
+                          0});
+
+    std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) {
+        return a.first < b.first;
+    });
+
+    uint32_t furthest_last = 0;
+    for (auto& range : ranges)
+        range.furthest_last = furthest_last = std::max(furthest_last, range.last);
+}
+
+std::optional<uint32_t> mp::SubnetOverlapIndex::furthest_last_starting_by(uint32_t address) const
+{
+    const auto end = std::upper_bound(ranges.begin(),
+                                      ranges.end(),
+                                      address,
+                                      [](uint32_t address, const Range& range) {
+                                          return address < range.first;
+                                      });
+
+    if (end == ranges.begin())
+        return std::nullopt;
+    return std::prev(end)->furthest_last;
+}
+
+bool mp::SubnetOverlapIndex::overlaps(Subnet subnet) const
+{
+    // Some range starts no later than the subnet's end and reaches at least its start
+    const auto reach = furthest_last_starting_by(subnet.broadcast_address().as_uint32());
+    return reach && *reach >= subnet.masked_address().as_uint32();
+}
+
+bool mp::SubnetOverlapIndex::covers(Subnet subnet) const
+{
+    // Some range starts no later than the subnet's start and reaches at least its end
+    const auto reach = furthest_last_starting_by(subnet.masked_address().as_uint32());
+    return reach && *reach >= subnet.broadcast_address().as_uint32();
+}
+
+size_t mp::SubnetOverlapIndex::size() const
+{
+    return ranges.size();
+}
+
 mp::SubnetAllocator::SubnetAllocator(Subnet base_subnet, Subnet::PrefixLength prefix)
     : base_subnet(base_subnet), prefix(prefix)
 {
@@ -192,6 +243,9 @@ mp::Subnet mp::SubnetAllocator::next_available()
     // The step size as a byte offset for each subnet to allocate.
     const std::uint32_t step = std::size_t{1} << (32 - prefix);
 
+    // Look at what the host already uses once, rather than once per candidate.
+    const auto local_subnets = MP_PLATFORM.local_subnets();
+
     while (block_idx < possible_subnets)
     {
         // Compute a new address, ensuring that we remain within the base subnet.
@@ -200,7 +254,7 @@ mp::Subnet mp::SubnetAllocator::next_available()
 
         ++block_idx;
         mp::Subnet subnet{address, prefix};
-        if (!MP_PLATFORM.subnet_used_locally(subnet))
+        if (!MP_PLATFORM.subnet_used_locally(subnet, local_subnets))
             return subnet;
     }
 
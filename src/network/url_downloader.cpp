@@ -22,6 +22,7 @@
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/utils.h>
 #include <multipass/version.h>
@@ -34,6 +35,8 @@
 #include <QTimer>
 #include <QUrl>
 
+#include <algorithm>
+#include <chrono>
 #include <memory>
 
 namespace mp = multipass;
@@ -80,6 +83,17 @@ QString multipass_user_agent()
     return user_agent;
 }
 
+// Downloads are labelled with where they came from, as cache reads would skew network throughput
+void record_download(qint64 bytes, bool from_cache, std::chrono::steady_clock::duration duration)
+{
+    const mp::metrics::Labels labels{{"source", from_cache ? "cache" : "network"}};
+    auto& registry = mp::metrics::registry();
+    registry.counter("multipass_download_bytes_total", "Bytes downloaded", labels)
+        .increment(static_cast<std::uint64_t>(std::max<qint64>(bytes, 0)));
+    registry.histogram("multipass_download_duration_seconds", "Time taken by downloads", labels)
+        .observe(duration);
+}
+
 void wait_for_reply(QNetworkReply* reply, QTimer& download_timeout)
 {
     QEventLoop event_loop;
@@ -116,11 +130,14 @@ QByteArray download(QNetworkAccessManager* manager,
     request.setAttribute(QNetworkRequest::CacheLoadControlAttribute, cache_load_control);
     request.setHeader(QNetworkRequest::UserAgentHeader, multipass_user_agent());
 
+    const auto started = std::chrono::steady_clock::now();
+    qint64 received = 0;
     NetworkReplyUPtr reply{manager->get(request)};
 
     QObject::connect(reply.get(),
                      &QNetworkReply::downloadProgress,
                      [&](qint64 bytes_received, qint64 bytes_total) {
+                         received = bytes_received;
                          on_progress(reply.get(), bytes_received, bytes_total);
                      });
     QObject::connect(reply.get(), &QNetworkReply::readyRead, [&]() {
@@ -171,12 +188,16 @@ QByteArray download(QNetworkAccessManager* manager,
                           QNetworkRequest::CacheLoadControl::AlwaysCache);
     }
 
-    mpl::trace(category,
-               "Found {} in cache: {}",
-               url.toString(),
-               reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool());
+    const auto from_cache = reply->attribute(QNetworkRequest::SourceIsFromCacheAttribute).toBool();
+    mpl::trace(category, "Found {} in cache: {}", url.toString(), from_cache);
+
+    auto data = reply->readAll();
+    // Streamed replies are consumed as they arrive, so only their progress reports add them up
+    record_download(std::max<qint64>(received, data.size()),
+                    from_cache,
+                    std::chrono::steady_clock::now() - started);
 
-    return reply->readAll();
+    return data;
 }
 
 template <typename Time>
@@ -19,6 +19,7 @@
 #include "hyperv_snapshot.h"
 
 #include <multipass/constants.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/exceptions/start_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
 #include <multipass/ip_address.h>
@@ -516,6 +517,9 @@ mp::MountHandler::UPtr mp::HyperVVirtualMachine::make_native_mount_handler(
     const std::string& target,
     const mp::VMMount& mount)
 {
+    if (mount.get_mount_type() == VMMount::MountType::Virtiofs)
+        throw NotImplementedOnThisBackendException{"virtiofs mounts"};
+
     static const SmbManager smb_manager{};
     return std::make_unique<SmbMountHandler>(this,
                                              &key_provider,
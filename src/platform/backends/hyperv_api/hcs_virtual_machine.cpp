@@ -29,6 +29,7 @@
 #include <shared/windows/wsa_init_wrapper.h>
 
 #include <multipass/constants.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
 #include <multipass/file_ops.h>
 #include <multipass/top_catch_all.h>
@@ -688,6 +689,9 @@ HCSVirtualMachine::make_native_mount_handler(const std::string& target, const VM
 {
     mpl::debug(get_name(), "make_native_mount_handler() -> target: {}", target);
 
+    if (mount.get_mount_type() == VMMount::MountType::Virtiofs)
+        throw NotImplementedOnThisBackendException{"virtiofs mounts"};
+
     static const SmbManager smb_manager{};
     return std::make_unique<SmbMountHandler>(this,
                                              &key_provider,
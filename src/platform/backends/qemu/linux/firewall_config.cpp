@@ -25,9 +25,14 @@
 #include <multipass/utils/semver_compare.h>
 #include <shared/linux/process_factory.h>
 
+#include <algorithm>
+#include <map>
+#include <set>
 #include <stdexcept>
+#include <utility>
 
 #include <QRegularExpression>
+#include <QTemporaryFile>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -166,10 +171,18 @@ auto get_firewall_rules(const QString& firewall, const QString& table)
     return process->read_all_standard_output();
 }
 
-void set_firewall_rules(const QString& firewall,
-                        const QString& bridge_name,
-                        const mp::Subnet& cidr,
-                        const QString& comment)
+struct FirewallRule
+{
+    QString table;
+    QString chain;
+    QStringList rule;
+    bool append = false;
+};
+
+// The complete set of rules Multipass needs for one bridge, in the order they are to be installed
+std::vector<FirewallRule> multipass_firewall_rules(const QString& bridge_name,
+                                                   const mp::Subnet& cidr,
+                                                   const QString& comment)
 {
     const QString cidr_str = QString::fromStdString(cidr.to_cidr());
 
@@ -178,123 +191,105 @@ void set_firewall_rules(const QString& firewall,
                                      QStringLiteral("--comment"),
                                      comment};
 
-    // Setup basic firewall overrides for DHCP/DNS
-    add_firewall_rule(firewall,
-                      filter,
-                      INPUT,
-                      QStringList() << in_interface << bridge_name << protocol << udp << dport
-                                    << port_67 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      INPUT,
-                      QStringList() << in_interface << bridge_name << protocol << udp << dport
-                                    << port_53 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      INPUT,
-                      QStringList() << in_interface << bridge_name << protocol << tcp << dport
-                                    << port_53 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      OUTPUT,
-                      QStringList() << out_interface << bridge_name << protocol << udp << sport
-                                    << port_67 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      OUTPUT,
-                      QStringList() << out_interface << bridge_name << protocol << udp << sport
-                                    << port_53 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      OUTPUT,
-                      QStringList() << out_interface << bridge_name << protocol << tcp << sport
-                                    << port_53 << jump << ACCEPT << comment_option);
-
-    add_firewall_rule(firewall,
-                      mangle,
-                      POSTROUTING,
-                      QStringList() << out_interface << bridge_name << protocol << udp << dport
-                                    << port_68 << jump << QStringLiteral("CHECKSUM")
-                                    << QStringLiteral("--checksum-fill") << comment_option);
-
-    // Do not masquerade to these reserved address blocks.
-    add_firewall_rule(firewall,
-                      nat,
-                      POSTROUTING,
-                      QStringList()
-                          << source << cidr_str << destination << QStringLiteral("224.0.0.0/24")
-                          << jump << RETURN << comment_option);
-
-    add_firewall_rule(firewall,
-                      nat,
-                      POSTROUTING,
-                      QStringList() << source << cidr_str << destination
-                                    << QStringLiteral("255.255.255.255/32") << jump << RETURN
-                                    << comment_option);
-
-    // Masquerade all packets going from VMs to the LAN/Internet
-    add_firewall_rule(firewall,
-                      nat,
-                      POSTROUTING,
-                      QStringList()
-                          << source << cidr_str << negate << destination << cidr_str << protocol
-                          << tcp << jump << MASQUERADE << to_ports << port_range << comment_option);
-
-    add_firewall_rule(firewall,
-                      nat,
-                      POSTROUTING,
-                      QStringList()
-                          << source << cidr_str << negate << destination << cidr_str << protocol
-                          << udp << jump << MASQUERADE << to_ports << port_range << comment_option);
-
-    add_firewall_rule(firewall,
-                      nat,
-                      POSTROUTING,
-                      QStringList() << source << cidr_str << negate << destination << cidr_str
-                                    << jump << MASQUERADE << comment_option);
-
-    // Allow established traffic to the private subnet
-    add_firewall_rule(
-        firewall,
-        filter,
-        FORWARD,
-        QStringList() << destination << cidr_str << out_interface << bridge_name << match
-                      << QStringLiteral("conntrack") << QStringLiteral("--ctstate")
-                      << QStringLiteral("RELATED,ESTABLISHED") << jump << ACCEPT << comment_option);
-
-    // Allow outbound traffic from the private subnet
-    add_firewall_rule(firewall,
-                      filter,
-                      FORWARD,
-                      QStringList() << source << cidr_str << in_interface << bridge_name << jump
-                                    << ACCEPT << comment_option);
-
-    // Allow traffic between virtual machines
-    add_firewall_rule(firewall,
-                      filter,
-                      FORWARD,
-                      QStringList() << in_interface << bridge_name << out_interface << bridge_name
-                                    << jump << ACCEPT << comment_option);
-
-    // Reject everything else
-    add_firewall_rule(firewall,
-                      filter,
-                      FORWARD,
-                      QStringList() << in_interface << bridge_name << jump << REJECT << reject_with
-                                    << icmp_port_unreachable << comment_option,
-                      /*append=*/true);
-
-    add_firewall_rule(firewall,
-                      filter,
-                      FORWARD,
-                      QStringList() << out_interface << bridge_name << jump << REJECT << reject_with
-                                    << icmp_port_unreachable << comment_option,
-                      /*append=*/true);
+    return {
+        // Setup basic firewall overrides for DHCP/DNS
+        {filter,
+         INPUT,
+         QStringList() << in_interface << bridge_name << protocol << udp << dport << port_67
+                       << jump << ACCEPT << comment_option},
+        {filter,
+         INPUT,
+         QStringList() << in_interface << bridge_name << protocol << udp << dport << port_53
+                       << jump << ACCEPT << comment_option},
+        {filter,
+         INPUT,
+         QStringList() << in_interface << bridge_name << protocol << tcp << dport << port_53
+                       << jump << ACCEPT << comment_option},
+        {filter,
+         OUTPUT,
+         QStringList() << out_interface << bridge_name << protocol << udp << sport << port_67
+                       << jump << ACCEPT << comment_option},
+        {filter,
+         OUTPUT,
+         QStringList() << out_interface << bridge_name << protocol << udp << sport << port_53
+                       << jump << ACCEPT << comment_option},
+        {filter,
+         OUTPUT,
+         QStringList() << out_interface << bridge_name << protocol << tcp << sport << port_53
+                       << jump << ACCEPT << comment_option},
+        {mangle,
+         POSTROUTING,
+         QStringList() << out_interface << bridge_name << protocol << udp << dport << port_68
+                       << jump << QStringLiteral("CHECKSUM") << QStringLiteral("--checksum-fill")
+                       << comment_option},
+
+        // Do not masquerade to these reserved address blocks.
+        {nat,
+         POSTROUTING,
+         QStringList() << source << cidr_str << destination << QStringLiteral("224.0.0.0/24")
+                       << jump << RETURN << comment_option},
+        {nat,
+         POSTROUTING,
+         QStringList() << source << cidr_str << destination
+                       << QStringLiteral("255.255.255.255/32") << jump << RETURN
+                       << comment_option},
+
+        // Masquerade all packets going from VMs to the LAN/Internet
+        {nat,
+         POSTROUTING,
+         QStringList() << source << cidr_str << negate << destination << cidr_str << protocol
+                       << tcp << jump << MASQUERADE << to_ports << port_range << comment_option},
+        {nat,
+         POSTROUTING,
+         QStringList() << source << cidr_str << negate << destination << cidr_str << protocol
+                       << udp << jump << MASQUERADE << to_ports << port_range << comment_option},
+        {nat,
+         POSTROUTING,
+         QStringList() << source << cidr_str << negate << destination << cidr_str << jump
+                       << MASQUERADE << comment_option},
+
+        // Allow established traffic to the private subnet
+        {filter,
+         FORWARD,
+         QStringList() << destination << cidr_str << out_interface << bridge_name << match
+                       << QStringLiteral("conntrack") << QStringLiteral("--ctstate")
+                       << QStringLiteral("RELATED,ESTABLISHED") << jump << ACCEPT
+                       << comment_option},
+
+        // Allow outbound traffic from the private subnet
+        {filter,
+         FORWARD,
+         QStringList() << source << cidr_str << in_interface << bridge_name << jump << ACCEPT
+                       << comment_option},
+
+        // Allow traffic between virtual machines
+        {filter,
+         FORWARD,
+         QStringList() << in_interface << bridge_name << out_interface << bridge_name << jump
+                       << ACCEPT << comment_option},
+
+        // Reject everything else
+        {filter,
+         FORWARD,
+         QStringList() << in_interface << bridge_name << jump << REJECT << reject_with
+                       << icmp_port_unreachable << comment_option,
+         /*append=*/true},
+        {filter,
+         FORWARD,
+         QStringList() << out_interface << bridge_name << jump << REJECT << reject_with
+                       << icmp_port_unreachable << comment_option,
+         /*append=*/true},
+    };
+}
+
+void set_firewall_rules(const QString& firewall,
+                        const QString& bridge_name,
+                        const mp::Subnet& cidr,
+                        const QString& comment)
+{
+    for (const auto& [table, chain, rule, append] :
+         multipass_firewall_rules(bridge_name, cidr, comment))
+        add_firewall_rule(firewall, table, chain, rule, append);
 }
 
 void clear_firewall_rules_for(const QString& firewall,
@@ -387,6 +382,176 @@ QString detect_firewall()
 
     return firewall_exec;
 }
+
+// The batched backend below dumps and restores whole rulesets with the -save/-restore companions of
+// the selected firewall, instead of running one process per rule
+using SavedRules = std::map<QString, QStringList>; // table -> "-A <chain> <rule>" lines
+
+QString quoted(const QString& arg)
+{
+    return arg.contains(' ') ? QString{"\"%1\""}.arg(arg) : arg;
+}
+
+QString restore_line(const QString& action, const QString& chain, const QStringList& rule)
+{
+    QStringList line{action, chain};
+    std::transform(rule.cbegin(), rule.cend(), std::back_inserter(line), quoted);
+
+    return line.join(' ');
+}
+
+// Splits on spaces, keeping double-quoted arguments (e.g. comments) together
+QStringList split_rule(const QString& line)
+{
+    QStringList tokens;
+    QString current;
+    auto in_quotes = false;
+
+    for (const auto c : line)
+    {
+        if (c == '"')
+            in_quotes = !in_quotes;
+        else if (c == ' ' && !in_quotes)
+        {
+            if (!current.isEmpty())
+                tokens << std::exchange(current, {});
+        }
+        else
+            current += c;
+    }
+
+    if (!current.isEmpty())
+        tokens << current;
+
+    return tokens;
+}
+
+// -save prints short options, adds implicit protocol matches and may reorder arguments, so rules
+// are compared as sorted token lists in a common vocabulary
+QString canonical_rule(const QString& table, const QStringList& tokens)
+{
+    static const std::map<QString, QString> short_options{{in_interface, "-i"},
+                                                          {out_interface, "-o"},
+                                                          {protocol, "-p"},
+                                                          {source, "-s"},
+                                                          {destination, "-d"},
+                                                          {jump, "-j"},
+                                                          {match, "-m"},
+                                                          {append_rule, "-A"},
+                                                          {insert_rule, "-A"},
+                                                          {"-I", "-A"}};
+
+    QStringList canonical{table};
+    for (auto i = 0; i < tokens.size(); ++i)
+    {
+        const auto it = short_options.find(tokens[i]);
+        const auto& token = it == short_options.end() ? tokens[i] : it->second;
+
+        const auto implicit_match = token == "-m" && i + 1 < tokens.size() &&
+                                    (tokens[i + 1] == udp || tokens[i + 1] == tcp);
+
+        if (implicit_match)
+            ++i;
+        else
+            canonical << token;
+    }
+
+    canonical.sort();
+    return canonical.join(' ');
+}
+
+std::multiset<QString> canonical_rules(const SavedRules& saved)
+{
+    std::multiset<QString> ret;
+    for (const auto& [table, lines] : saved)
+        for (const auto& line : lines)
+            ret.insert(canonical_rule(table, split_rule(line)));
+
+    return ret;
+}
+
+std::multiset<QString> canonical_rules(const std::vector<FirewallRule>& rules)
+{
+    std::multiset<QString> ret;
+    for (const auto& [table, chain, rule, append] : rules)
+        ret.insert(canonical_rule(table, QStringList{append_rule, chain} + rule));
+
+    return ret;
+}
+
+// Collects the rules that belong to this bridge, with a single -save for all tables
+SavedRules get_multipass_rules(const QString& firewall,
+                               const QString& bridge_name,
+                               const mp::Subnet& cidr,
+                               const QString& comment)
+{
+    auto process = MP_PROCFACTORY.create_process(firewall + QStringLiteral("-save"), QStringList{});
+    if (const auto exit_state = process->execute(); !exit_state.completed_successfully())
+        throw FirewallException("Failed to save firewall rules",
+                                firewall_tables.join(','),
+                                exit_state.failure_message(),
+                                process->read_all_standard_error());
+
+    const QString cidr_str = QString::fromStdString(cidr.to_cidr());
+
+    SavedRules ret;
+    QString table;
+    for (const auto& line : QString::fromUtf8(process->read_all_standard_output()).split('\n'))
+    {
+        if (line.startsWith('*'))
+            table = line.mid(1).trimmed();
+        else if (line.startsWith("-A ") && firewall_tables.contains(table) &&
+                 (line.contains(comment) || line.contains(bridge_name) || line.contains(cidr_str)))
+            ret[table] << line.trimmed();
+    }
+
+    return ret;
+}
+
+// One block per table, each of which -restore commits atomically; existing rules are deleted before
+// the new ones go in, so that rule order matches what per-rule installation would produce
+QString make_ruleset(const SavedRules& stale, const std::vector<FirewallRule>& rules)
+{
+    QString ruleset;
+    for (const auto& table : firewall_tables)
+    {
+        QStringList lines;
+        if (const auto it = stale.find(table); it != stale.end())
+            for (const auto& line : it->second)
+                lines << QStringLiteral("-D ") + line.mid(3);
+
+        for (const auto& [rule_table, chain, rule, append] : rules)
+            if (rule_table == table)
+                lines << restore_line(append ? QStringLiteral("-A") : QStringLiteral("-I"),
+                                      chain,
+                                      rule);
+
+        if (!lines.isEmpty())
+            ruleset += QString{"*%1\n%2\nCOMMIT\n"}.arg(table, lines.join('\n'));
+    }
+
+    return ruleset;
+}
+
+void apply_ruleset(const QString& firewall, const QString& ruleset)
+{
+    QTemporaryFile ruleset_file;
+    if (!ruleset_file.open() || ruleset_file.write(ruleset.toUtf8()) < 0 || !ruleset_file.flush())
+        throw FirewallException("Failed to write firewall rules",
+                                firewall_tables.join(','),
+                                ruleset_file.errorString(),
+                                ruleset_file.fileName());
+
+    auto process = MP_PROCFACTORY.create_process(
+        firewall + QStringLiteral("-restore"),
+        QStringList{QStringLiteral("--noflush"), wait, ruleset_file.fileName()});
+
+    if (const auto exit_state = process->execute(); !exit_state.completed_successfully())
+        throw FirewallException("Failed to restore firewall rules",
+                                firewall_tables.join(','),
+                                exit_state.failure_message(),
+                                process->read_all_standard_error());
+}
 } // namespace
 
 mp::BasicFirewallConfig::BasicFirewallConfig(const QString& bridge_name, const mp::Subnet& subnet)
@@ -432,9 +597,96 @@ void mp::BasicFirewallConfig::clear_all_firewall_rules()
     }
 }
 
+mp::BatchedFirewallConfig::BatchedFirewallConfig(const QString& bridge_name,
+                                                 const mp::Subnet& subnet)
+    : firewall{detect_firewall()},
+      bridge_name{bridge_name},
+      cidr{subnet.canonical()},
+      comment{multipass_firewall_comment(bridge_name)}
+{
+    try
+    {
+        sync_firewall_rules();
+    }
+    catch (const FirewallException& e)
+    {
+        mpl::log_message(mpl::Level::warning, category, e.what());
+        firewall_error = true;
+        error_string = e.what();
+    }
+}
+
+mp::BatchedFirewallConfig::~BatchedFirewallConfig()
+{
+    if (!firewall.isEmpty())
+    {
+        mp::top_catch_all(category, [this] { clear_all_firewall_rules(); });
+    }
+}
+
+void mp::BatchedFirewallConfig::verify_firewall_rules()
+{
+    if (firewall_error)
+    {
+        throw std::runtime_error(error_string);
+    }
+
+    try
+    {
+        sync_firewall_rules();
+    }
+    catch (const FirewallException& e)
+    {
+        throw std::runtime_error(e.what());
+    }
+}
+
+void mp::BatchedFirewallConfig::sync_firewall_rules()
+{
+    const auto rules = multipass_firewall_rules(bridge_name, cidr, comment);
+
+    try
+    {
+        const auto installed = get_multipass_rules(firewall, bridge_name, cidr, comment);
+        if (canonical_rules(installed) == canonical_rules(rules))
+            return;
+
+        if (!installed.empty())
+            mpl::info(category, "Firewall rules for {} are out of date, reinstalling", bridge_name);
+
+        apply_ruleset(firewall, make_ruleset(installed, rules));
+    }
+    catch (const FirewallException& e)
+    {
+        mpl::warn(category, "Falling back to updating firewall rules one by one: {}", e.what());
+
+        for (const auto& table : firewall_tables)
+            clear_firewall_rules_for(firewall, table, bridge_name, cidr, comment);
+
+        set_firewall_rules(firewall, bridge_name, cidr, comment);
+    }
+}
+
+void mp::BatchedFirewallConfig::clear_all_firewall_rules()
+{
+    try
+    {
+        if (const auto installed = get_multipass_rules(firewall, bridge_name, cidr, comment);
+            !installed.empty())
+            apply_ruleset(firewall, make_ruleset(installed, {}));
+    }
+    catch (const FirewallException& e)
+    {
+        mpl::warn(category, "Falling back to deleting firewall rules one by one: {}", e.what());
+
+        for (const auto& table : firewall_tables)
+            clear_firewall_rules_for(firewall, table, bridge_name, cidr, comment);
+    }
+}
+
 mp::FirewallConfig::UPtr mp::FirewallConfigFactory::make_firewall_config(
     const QString& bridge_name,
     const mp::Subnet& subnet) const
 {
-    return std::make_unique<mp::BasicFirewallConfig>(bridge_name, subnet);
+    return std::make_unique<mp::BatchedFirewallConfig>(bridge_name, subnet);
 }
@@ -56,6 +56,30 @@ private:
     std::string error_string;
 };
 
+// Installs the same rules as BasicFirewallConfig, but reads and writes them all at once through the
+// -save and -restore companions of the firewall, applying changes only when the installed rules
+// differ from the expected ones. Falls back to one process per rule when that fails.
+class BatchedFirewallConfig final : public FirewallConfig
+{
+public:
+    BatchedFirewallConfig(const QString& bridge_name, const Subnet& subnet);
+    ~BatchedFirewallConfig() override;
+
+    void verify_firewall_rules() override;
+
+private:
+    void sync_firewall_rules();
+    void clear_all_firewall_rules();
+
+    const QString firewall;
+    const QString bridge_name;
+    const Subnet cidr;
+    const QString comment;
+
+    bool firewall_error{false};
+    std::string error_string;
+};
+
 #define MP_FIREWALL_CONFIG_FACTORY multipass::FirewallConfigFactory::instance()
 
 class FirewallConfigFactory : public Singleton<FirewallConfigFactory>
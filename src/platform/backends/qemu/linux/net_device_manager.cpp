@@ -0,0 +1,348 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "net_device_manager.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <linux/if_tun.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "netlink";
+constexpr auto tun_device = "/dev/net/tun";
+constexpr auto reply_timeout_sec = 5;
+
+class FileDescriptor
+{
+public:
+    explicit FileDescriptor(int fd) : fd{fd}
+    {
+    }
+
+    ~FileDescriptor()
+    {
+        if (fd >= 0)
+            ::close(fd);
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    int get() const
+    {
+        return fd;
+    }
+
+private:
+    int fd;
+};
+
+// A single rtnetlink message: the netlink header, a fixed family header (ifinfomsg, ifaddrmsg...)
+// and a sequence of attributes, each padded to 4 bytes as the kernel expects
+class NetlinkRequest
+{
+public:
+    template <typename FamilyHeader>
+    NetlinkRequest(std::uint16_t type, std::uint16_t flags, const FamilyHeader& family_header)
+        : buffer(NLMSG_SPACE(sizeof(FamilyHeader)), 0)
+    {
+        auto* hdr = header();
+        hdr->nlmsg_type = type;
+        hdr->nlmsg_flags = NLM_F_REQUEST | NLM_F_ACK | flags;
+        std::memcpy(NLMSG_DATA(hdr), &family_header, sizeof(FamilyHeader));
+    }
+
+    void add_attribute(std::uint16_t type, const void* data, std::size_t length)
+    {
+        const auto offset = buffer.size();
+        buffer.resize(offset + RTA_SPACE(length), 0);
+
+        auto* attr = reinterpret_cast<rtattr*>(buffer.data() + offset);
+        attr->rta_type = type;
+        attr->rta_len = static_cast<unsigned short>(RTA_LENGTH(length));
+        if (length)
+            std::memcpy(RTA_DATA(attr), data, length);
+    }
+
+    void add_attribute(std::uint16_t type, const std::string& value)
+    {
+        add_attribute(type, value.c_str(), value.size() + 1);
+    }
+
+    std::size_t begin_nested(std::uint16_t type)
+    {
+        const auto offset = buffer.size();
+        add_attribute(type, nullptr, 0);
+        return offset;
+    }
+
+    void end_nested(std::size_t offset)
+    {
+        auto* attr = reinterpret_cast<rtattr*>(buffer.data() + offset);
+        attr->rta_len = static_cast<unsigned short>(buffer.size() - offset);
+    }
+
+    nlmsghdr* header()
+    {
+        return reinterpret_cast<nlmsghdr*>(buffer.data());
+    }
+
+    std::size_t size() const
+    {
+        return buffer.size();
+    }
+
+private:
+    std::vector<char> buffer;
+};
+
+// Sends the request and waits for the kernel's acknowledgement. Returns 0 on success or a
+// negative errno, in the kernel's convention
+int transact(NetlinkRequest& request)
+{
+    FileDescriptor sock{::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)};
+    if (sock.get() < 0)
+        return -errno;
+
+    const timeval timeout{reply_timeout_sec, 0};
+    ::setsockopt(sock.get(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    static std::atomic<std::uint32_t> sequence{0};
+    auto* hdr = request.header();
+    hdr->nlmsg_len = static_cast<std::uint32_t>(request.size());
+    hdr->nlmsg_seq = ++sequence;
+
+    sockaddr_nl kernel{};
+    kernel.nl_family = AF_NETLINK;
+    if (::sendto(sock.get(),
+                 hdr,
+                 request.size(),
+                 0,
+                 reinterpret_cast<sockaddr*>(&kernel),
+                 sizeof(kernel)) < 0)
+        return -errno;
+
+    std::array<char, 8192> reply{};
+    for (;;)
+    {
+        auto received = ::recv(sock.get(), reply.data(), reply.size(), 0);
+        if (received < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return -errno;
+        }
+
+        auto remaining = static_cast<int>(received);
+        for (auto* msg = reinterpret_cast<nlmsghdr*>(reply.data()); NLMSG_OK(msg, remaining);
+             msg = NLMSG_NEXT(msg, remaining))
+        {
+            if (msg->nlmsg_seq != hdr->nlmsg_seq)
+                continue;
+
+            if (msg->nlmsg_type == NLMSG_ERROR)
+                return reinterpret_cast<nlmsgerr*>(NLMSG_DATA(msg))->error;
+        }
+    }
+}
+
+bool failed(int errnum, const char* operation, const QString& name)
+{
+    mpl::debug(category, "Could not {} {}: {}", operation, name, std::strerror(errnum));
+    return false;
+}
+
+bool succeeded(int error, const char* operation, const QString& name)
+{
+    return !error || failed(-error, operation, name);
+}
+
+std::optional<int> index_of(const QString& name)
+{
+    if (auto index = ::if_nametoindex(qUtf8Printable(name)))
+        return static_cast<int>(index);
+
+    return std::nullopt;
+}
+
+ifinfomsg link_header(int index)
+{
+    ifinfomsg ifi{};
+    ifi.ifi_family = AF_UNSPEC;
+    ifi.ifi_index = index;
+    return ifi;
+}
+
+std::uint32_t network_order(const mp::IPAddress& address)
+{
+    std::uint32_t ret;
+    std::memcpy(&ret, address.octets.data(), sizeof(ret));
+    return ret;
+}
+} // namespace
+
+std::optional<bool> mp::NetDeviceManager::link_exists(const QString& name) const
+{
+    if (index_of(name))
+        return true;
+
+    if (errno == ENODEV)
+        return false;
+
+    return std::nullopt;
+}
+
+std::optional<bool> mp::NetDeviceManager::is_multi_queue_tap(const QString& name) const
+{
+    // The tun driver publishes the flags the device was created with, e.g. 0x1102
+    std::ifstream flags_file{fmt::format("/sys/class/net/{}/tun_flags", name)};
+    unsigned int flags = 0;
+    if (!(flags_file >> std::hex >> flags))
+        return std::nullopt;
+
+    return (flags & IFF_MULTI_QUEUE) != 0;
+}
+
+bool mp::NetDeviceManager::add_tap(const QString& name, bool multi_queue) const
+{
+    // Equivalent to `ip tuntap add <name> mode tap [multi_queue]`, which goes through the tun
+    // driver rather than rtnetlink
+    FileDescriptor tun{::open(tun_device, O_RDWR | O_CLOEXEC)};
+    if (tun.get() < 0)
+        return failed(errno, "open", tun_device);
+
+    ifreq ifr{};
+    ifr.ifr_flags = IFF_TAP | IFF_NO_PI | (multi_queue ? IFF_MULTI_QUEUE : 0);
+    std::strncpy(ifr.ifr_name, qUtf8Printable(name), IFNAMSIZ - 1);
+
+    if (::ioctl(tun.get(), TUNSETIFF, &ifr) < 0 || ::ioctl(tun.get(), TUNSETPERSIST, 1) < 0)
+        return failed(errno, "create tap", name);
+
+    return true;
+}
+
+bool mp::NetDeviceManager::add_bridge(const QString& name, const std::string& mac_address) const
+{
+    std::array<unsigned int, 6> octets{};
+    if (std::sscanf(mac_address.c_str(),
+                    "%2x:%2x:%2x:%2x:%2x:%2x",
+                    &octets[0],
+                    &octets[1],
+                    &octets[2],
+                    &octets[3],
+                    &octets[4],
+                    &octets[5]) != 6)
+        return false;
+
+    std::array<unsigned char, 6> mac{};
+    std::copy(octets.begin(), octets.end(), mac.begin());
+
+    NetlinkRequest request{RTM_NEWLINK, NLM_F_CREATE | NLM_F_EXCL, link_header(0)};
+    request.add_attribute(IFLA_IFNAME, name.toStdString());
+    request.add_attribute(IFLA_ADDRESS, mac.data(), mac.size());
+
+    const auto link_info = request.begin_nested(IFLA_LINKINFO);
+    request.add_attribute(IFLA_INFO_KIND, std::string{"bridge"});
+    request.end_nested(link_info);
+
+    return succeeded(transact(request), "create bridge", name);
+}
+
+bool mp::NetDeviceManager::add_address(const QString& name,
+                                       const IPAddress& address,
+                                       Subnet::PrefixLength prefix_length,
+                                       const IPAddress& broadcast) const
+{
+    const auto index = index_of(name);
+    if (!index)
+        return failed(errno, "find", name);
+
+    ifaddrmsg ifa{};
+    ifa.ifa_family = AF_INET;
+    ifa.ifa_prefixlen = prefix_length;
+    ifa.ifa_index = static_cast<std::uint32_t>(*index);
+
+    const auto local = network_order(address);
+    const auto brd = network_order(broadcast);
+
+    NetlinkRequest request{RTM_NEWADDR, NLM_F_CREATE | NLM_F_EXCL, ifa};
+    request.add_attribute(IFA_LOCAL, &local, sizeof(local));
+    request.add_attribute(IFA_ADDRESS, &local, sizeof(local));
+    request.add_attribute(IFA_BROADCAST, &brd, sizeof(brd));
+
+    return succeeded(transact(request), "add an address to", name);
+}
+
+bool mp::NetDeviceManager::set_master(const QString& name, const QString& master) const
+{
+    const auto index = index_of(name);
+    const auto master_index = index ? index_of(master) : std::nullopt;
+    if (!master_index)
+        return failed(errno, "find", index ? master : name);
+
+    const auto master_value = static_cast<std::uint32_t>(*master_index);
+
+    NetlinkRequest request{RTM_NEWLINK, 0, link_header(*index)};
+    request.add_attribute(IFLA_MASTER, &master_value, sizeof(master_value));
+
+    return succeeded(transact(request), "set the master of", name);
+}
+
+bool mp::NetDeviceManager::set_up(const QString& name) const
+{
+    const auto index = index_of(name);
+    if (!index)
+        return failed(errno, "find", name);
+
+    auto ifi = link_header(*index);
+    ifi.ifi_flags = IFF_UP;
+    ifi.ifi_change = IFF_UP;
+
+    NetlinkRequest request{RTM_NEWLINK, 0, ifi};
+    return succeeded(transact(request), "bring up", name);
+}
+
+bool mp::NetDeviceManager::delete_link(const QString& name) const
+{
+    const auto index = index_of(name);
+    if (!index)
+        return failed(errno, "find", name);
+
+    NetlinkRequest request{RTM_DELLINK, 0, link_header(*index)};
+    return succeeded(transact(request), "delete", name);
+}
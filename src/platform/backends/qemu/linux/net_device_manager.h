@@ -0,0 +1,56 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/singleton.h>
+#include <multipass/subnet.h>
+
+#include <optional>
+#include <string>
+
+#include <QString>
+
+#define MP_NET_DEVICE_MANAGER multipass::NetDeviceManager::instance()
+
+namespace multipass
+{
+// Manages host network devices through rtnetlink (and /dev/net/tun for tap devices), saving a
+// fork/exec of `ip` per operation. Every operation reports whether it succeeded, so that callers
+// can fall back to `ip` when netlink is unavailable or refuses the request.
+class NetDeviceManager : public Singleton<NetDeviceManager>
+{
+public:
+    NetDeviceManager(const Singleton<NetDeviceManager>::PrivatePass& pass) noexcept
+        : Singleton<NetDeviceManager>::Singleton{pass} {};
+
+    // std::nullopt when existence could not be determined
+    virtual std::optional<bool> link_exists(const QString& name) const;
+    // std::nullopt when the device is not a tap or its flags could not be read
+    virtual std::optional<bool> is_multi_queue_tap(const QString& name) const;
+
+    virtual bool add_tap(const QString& name, bool multi_queue) const;
+    virtual bool add_bridge(const QString& name, const std::string& mac_address) const;
+    virtual bool add_address(const QString& name,
+                             const IPAddress& address,
+                             Subnet::PrefixLength prefix_length,
+                             const IPAddress& broadcast) const;
+    virtual bool set_master(const QString& name, const QString& master) const;
+    virtual bool set_up(const QString& name) const;
+    virtual bool delete_link(const QString& name) const;
+};
+} // namespace multipass
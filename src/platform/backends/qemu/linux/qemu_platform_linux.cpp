@@ -16,6 +16,8 @@
  */
 
 #include "qemu_platform_linux.h"
+#include "net_device_manager.h"
+#include "thread_affinity.h"
 
 #include <multipass/file_ops.h>
 #include <multipass/format.h>
@@ -27,6 +29,10 @@
 
 #include <QFile>
 
+#include <algorithm>
+#include <filesystem>
+
+namespace fs = std::filesystem;
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
@@ -35,6 +41,7 @@ namespace
 {
 constexpr auto category = "qemu platform";
 const QString multipass_bridge_name{"mpqemubr%1"};
+constexpr auto max_tap_queues = 256; // MAX_TAP_QUEUES in the kernel's tun driver
 
 // An interface name can only be 15 characters, so this generates a hash of the
 // VM instance name with a "tap-" prefix and then truncates it.
@@ -46,42 +53,141 @@ auto generate_tap_device_name(const std::string& vm_name)
     return QString::fromStdString(tap_name);
 }
 
-void create_tap_device(const QString& tap_name, const QString& bridge_name)
+std::optional<long long> free_hugepages(const fs::path& pool)
 {
-    if (!MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_name}))
+    if (const auto contents = MP_FILEOPS.try_read_file(pool / "free_hugepages"))
     {
-        MP_UTILS.run_cmd_for_status("ip", {"tuntap", "add", tap_name, "mode", "tap"});
+        try
+        {
+            return std::stoll(*contents);
+        }
+        catch (const std::logic_error&)
+        {
+        }
+    }
+
+    return std::nullopt;
+}
+
+// Fail early and clearly, rather than have QEMU abort (or the guest get SIGBUS'ed later) when the
+// host cannot provide the memory that was asked for
+void check_memory_backing(const mp::VirtualMachineDescription& vm_desc)
+{
+    const auto& backing = vm_desc.memory_backing;
+    const auto node_dir =
+        fs::path{"/sys/devices/system/node"} / fmt::format("node{}", backing.host_node.value_or(0));
+    if (backing.host_node && !MP_FILEOPS.exists(node_dir))
+        throw std::runtime_error{
+            fmt::format("Host NUMA node {} requested by {} does not exist",
+                        *backing.host_node,
+                        vm_desc.vm_name)};
+
+    if (backing.type != mp::memory_backing_hugepages)
+        return;
+
+    const auto pool = (backing.host_node ? node_dir : fs::path{"/sys/kernel/mm"}) / "hugepages" /
+                      fmt::format("hugepages-{}kB", mp::hugepage_size_mb * 1024);
+    const auto needed = vm_desc.mem_size.in_megabytes() / mp::hugepage_size_mb;
+    if (const auto available = free_hugepages(pool).value_or(0); available < needed)
+        throw std::runtime_error{fmt::format(
+            "Not enough free {} MiB hugepages{} for {}: {} needed, {} available. More can be "
+            "reserved through {}",
+            mp::hugepage_size_mb,
+            backing.host_node ? fmt::format(" on host NUMA node {}", *backing.host_node) : "",
+            vm_desc.vm_name,
+            needed,
+            available,
+            (pool / "nr_hugepages").string())};
+}
+
+// Network devices are managed through netlink where possible, falling back to spawning `ip` when
+// netlink is unavailable or refuses a request.
+bool device_exists(const QString& device_name)
+{
+    if (const auto exists = MP_NET_DEVICE_MANAGER.link_exists(device_name))
+        return *exists;
+
+    return MP_UTILS.run_cmd_for_status("ip", {"addr", "show", device_name});
+}
+
+void set_device_up(const QString& device_name)
+{
+    if (!MP_NET_DEVICE_MANAGER.set_up(device_name))
+        MP_UTILS.run_cmd_for_status("ip", {"link", "set", device_name, "up"});
+}
+
+void delete_device(const QString& device_name)
+{
+    if (!MP_NET_DEVICE_MANAGER.delete_link(device_name))
+        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", device_name});
+}
+
+void create_tap_device(const QString& tap_name, const QString& bridge_name, bool multi_queue)
+{
+    auto exists = device_exists(tap_name);
+
+    // QEMU cannot attach to a tap whose queue mode differs from what it asks for, so a tap left
+    // over from before the instance's network settings changed needs replacing
+    if (exists && MP_NET_DEVICE_MANAGER.is_multi_queue_tap(tap_name) == !multi_queue)
+    {
+        delete_device(tap_name);
+        exists = false;
+    }
+
+    if (!exists && !MP_NET_DEVICE_MANAGER.add_tap(tap_name, multi_queue))
+    {
+        QStringList args{"tuntap", "add", tap_name, "mode", "tap"};
+        if (multi_queue)
+            args << "multi_queue";
+
+        MP_UTILS.run_cmd_for_status("ip", args);
     }
 
     // Ensure the device is linked to the bridge and up, regardless of its prior existence, since it
     // may have been left in a broken state (e.g., attached to a stale bridge).
-    MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
-    MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "up"});
+    if (!MP_NET_DEVICE_MANAGER.set_master(tap_name, bridge_name))
+        MP_UTILS.run_cmd_for_status("ip", {"link", "set", tap_name, "master", bridge_name});
+    set_device_up(tap_name);
 }
 
 void remove_tap_device(const QString& tap_device_name)
 {
-    if (MP_UTILS.run_cmd_for_status("ip", {"addr", "show", tap_device_name}))
+    if (device_exists(tap_device_name))
     {
-        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", tap_device_name});
+        delete_device(tap_device_name);
     }
 }
 
 void create_virtual_switch(const mp::Subnet& subnet, const QString& bridge_name)
 {
-    if (!MP_UTILS.run_cmd_for_status("ip", {"addr", "show", bridge_name}))
+    if (!device_exists(bridge_name))
     {
         const auto mac_address = mp::utils::generate_mac_address();
-        const auto cidr = mp::Subnet{subnet.min_address(), subnet.prefix_length()}.to_cidr();
-        const auto broadcast = subnet.broadcast_address().as_string();
-
-        MP_UTILS.run_cmd_for_status(
-            "ip",
-            {"link", "add", bridge_name, "address", mac_address.c_str(), "type", "bridge"});
-        MP_UTILS.run_cmd_for_status(
-            "ip",
-            {"address", "add", cidr.c_str(), "dev", bridge_name, "broadcast", broadcast.c_str()});
-        MP_UTILS.run_cmd_for_status("ip", {"link", "set", bridge_name, "up"});
+        const auto address = subnet.min_address();
+        const auto broadcast = subnet.broadcast_address();
+
+        if (!MP_NET_DEVICE_MANAGER.add_bridge(bridge_name, mac_address))
+            MP_UTILS.run_cmd_for_status(
+                "ip",
+                {"link", "add", bridge_name, "address", mac_address.c_str(), "type", "bridge"});
+
+        if (!MP_NET_DEVICE_MANAGER.add_address(bridge_name,
+                                               address,
+                                               subnet.prefix_length(),
+                                               broadcast))
+        {
+            const auto cidr = mp::Subnet{address, subnet.prefix_length()}.to_cidr();
+            MP_UTILS.run_cmd_for_status("ip",
+                                        {"address",
+                                         "add",
+                                         cidr.c_str(),
+                                         "dev",
+                                         bridge_name,
+                                         "broadcast",
+                                         broadcast.as_string().c_str()});
+        }
+
+        set_device_up(bridge_name);
     }
 }
 
@@ -110,9 +216,9 @@ mp::DNSMasqServer::UPtr init_nat_network(const mp::Path& network_dir,
 
 void delete_virtual_switch(const QString& bridge_name)
 {
-    if (MP_UTILS.run_cmd_for_status("ip", {"addr", "show", bridge_name}))
+    if (device_exists(bridge_name))
     {
-        MP_UTILS.run_cmd_for_status("ip", {"link", "delete", bridge_name});
+        delete_device(bridge_name);
     }
 }
 } // namespace
@@ -210,10 +316,14 @@ void mp::QemuPlatformLinux::platform_health_check()
 
 QStringList mp::QemuPlatformLinux::vm_platform_args(const VirtualMachineDescription& vm_desc)
 {
+    check_memory_backing(vm_desc);
+
     // Configure and generate the args for the default network interface
     auto tap_device_name = generate_tap_device_name(vm_desc.vm_name);
     const QString& bridge_name = bridges.at(vm_desc.zone).bridge_name;
-    create_tap_device(tap_device_name, bridge_name);
+    const auto queues =
+        vm_desc.network_multiqueue ? std::clamp(vm_desc.num_cores, 1, max_tap_queues) : 1;
+    create_tap_device(tap_device_name, bridge_name, queues > 1);
 
     name_to_net_device_map.emplace(
         vm_desc.vm_name,
@@ -258,15 +368,41 @@ QStringList mp::QemuPlatformLinux::vm_platform_args(const VirtualMachineDescript
     // clang-format on
 
     // Set up the network related args
-    opts << "-nic"
-         << QString::fromStdString(
+    if (vm_desc.network_multiqueue)
+    {
+        // One queue pair per vCPU, each served by its own vhost-net kernel thread. `-nic` cannot
+        // express the device side of this, hence the separate netdev and device
+        auto netdev = fmt::format("tap,id=net0,ifname={},script=no,downscript=no,vhost=on",
+                                  tap_device_name);
 #if defined Q_PROCESSOR_S390
-                fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-ccw,mac={}",
+        auto device = fmt::format("virtio-net-ccw,netdev=net0,mac={}", vm_desc.default_mac_address);
 #else
-                fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
+        auto device = fmt::format("virtio-net-pci,netdev=net0,mac={}", vm_desc.default_mac_address);
 #endif
-                            tap_device_name,
-                            vm_desc.default_mac_address));
+        if (queues > 1)
+        {
+            netdev += fmt::format(",queues={}", queues);
+            device += ",mq=on";
+#if !defined Q_PROCESSOR_S390
+            device += fmt::format(",vectors={}", 2 * queues + 2); // rx/tx per pair, config, control
+#endif
+        }
+
+        opts << "-netdev" << QString::fromStdString(netdev) << "-device"
+             << QString::fromStdString(device);
+    }
+    else
+    {
+        opts << "-nic"
+             << QString::fromStdString(
+#if defined Q_PROCESSOR_S390
+                    fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-ccw,mac={}",
+#else
+                    fmt::format("tap,ifname={},script=no,downscript=no,model=virtio-net-pci,mac={}",
+#endif
+                                tap_device_name,
+                                vm_desc.default_mac_address));
+    }
 
     for (const auto& extra_interface : vm_desc.extra_interfaces)
     {
@@ -310,6 +446,59 @@ void mp::QemuPlatformLinux::set_authorization(std::vector<NetworkInterfaceInfo>&
             net.needs_authorization = true;
 }
 
+bool mp::QemuPlatformLinux::supports_virtiofs() const
+{
+    return true;
+}
+
+bool mp::QemuPlatformLinux::supports_multiqueue_network() const
+{
+    return true;
+}
+
+bool mp::QemuPlatformLinux::supports_memory_backing() const
+{
+    return true;
+}
+
+bool mp::QemuPlatformLinux::supports_cpu_affinity() const
+{
+    return true;
+}
+
+void mp::QemuPlatformLinux::apply_cpu_affinity(qint64 pid,
+                                               const std::vector<qint64>& vcpu_threads,
+                                               const CpuAffinity& affinity)
+{
+    const auto cpus = affinity.host_cpus.empty() ? MP_THREAD_AFFINITY.get(pid)
+                                                 : parse_cpu_list(affinity.host_cpus);
+    if (cpus.empty())
+        throw std::runtime_error{"Could not determine the host CPUs to run on"};
+
+    // Threads are created as they are needed, so some may come and go while we go through them;
+    // only the main one is sure to be there, and the ones created later inherit its affinity
+    if (!affinity.host_cpus.empty())
+        for (const auto tid : MP_THREAD_AFFINITY.threads_of(pid))
+            if (!MP_THREAD_AFFINITY.set(tid, cpus) && tid == pid)
+                throw std::runtime_error{
+                    fmt::format("Could not confine QEMU to host CPUs {}", affinity.host_cpus)};
+
+    if (affinity.pin_vcpus)
+        for (std::size_t vcpu = 0; vcpu < vcpu_threads.size(); ++vcpu)
+        {
+            const auto cpu = cpus[vcpu % cpus.size()];
+            if (!MP_THREAD_AFFINITY.set(vcpu_threads[vcpu], {cpu}))
+                throw std::runtime_error{
+                    fmt::format("Could not pin vCPU {} to host CPU {}", vcpu, cpu)};
+
+            mpl::debug(category,
+                       "Pinned vCPU {} (thread {}) to host CPU {}",
+                       vcpu,
+                       vcpu_threads[vcpu],
+                       cpu);
+        }
+}
+
 std::string mp::QemuPlatformLinux::create_bridge_with(const NetworkInterfaceInfo& interface) const
 {
     assert(interface.type == "ethernet");
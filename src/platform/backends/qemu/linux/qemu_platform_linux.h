@@ -44,6 +44,13 @@ public:
     bool needs_network_prep() const override;
     std::string create_bridge_with(const NetworkInterfaceInfo& interface) const override;
     void set_authorization(std::vector<NetworkInterfaceInfo>& networks) override;
+    bool supports_virtiofs() const override;
+    bool supports_multiqueue_network() const override;
+    bool supports_memory_backing() const override;
+    bool supports_cpu_affinity() const override;
+    void apply_cpu_affinity(qint64 pid,
+                            const std::vector<qint64>& vcpu_threads,
+                            const CpuAffinity& affinity) override;
 
 private:
     // explicitly naming DisabledCopyMove since the private one derived from QemuPlatform takes
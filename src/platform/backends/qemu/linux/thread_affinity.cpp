@@ -0,0 +1,113 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "thread_affinity.h"
+
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+
+#include <sched.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "affinity";
+constexpr auto max_cpus = 8192; // the most the kernel can be configured for (NR_CPUS)
+
+struct CpuSetDeleter
+{
+    void operator()(cpu_set_t* set) const
+    {
+        CPU_FREE(set);
+    }
+};
+
+// Sized for max_cpus, since hosts can have more CPUs than the static cpu_set_t accounts for
+auto make_cpu_set()
+{
+    return std::unique_ptr<cpu_set_t, CpuSetDeleter>{CPU_ALLOC(max_cpus)};
+}
+} // namespace
+
+std::vector<qint64> mp::ThreadAffinity::threads_of(qint64 pid) const
+{
+    std::vector<qint64> ret;
+
+    std::error_code err;
+    for (const auto& entry :
+         std::filesystem::directory_iterator{fmt::format("/proc/{}/task", pid), err})
+    {
+        const auto name = entry.path().filename().string();
+        qint64 tid = 0;
+        if (std::from_chars(name.data(), name.data() + name.size(), tid).ec == std::errc{})
+            ret.push_back(tid);
+    }
+
+    if (err)
+        mpl::debug(category, "Could not list the threads of {}: {}", pid, err.message());
+
+    return ret;
+}
+
+std::vector<int> mp::ThreadAffinity::get(qint64 tid) const
+{
+    std::vector<int> ret;
+
+    const auto set = make_cpu_set();
+    const auto size = CPU_ALLOC_SIZE(max_cpus);
+    if (!set || sched_getaffinity(static_cast<pid_t>(tid), size, set.get()) < 0)
+    {
+        mpl::debug(category, "Could not get the affinity of {}: {}", tid, std::strerror(errno));
+        return ret;
+    }
+
+    for (auto cpu = 0; cpu < max_cpus; ++cpu)
+        if (CPU_ISSET_S(cpu, size, set.get()))
+            ret.push_back(cpu);
+
+    return ret;
+}
+
+bool mp::ThreadAffinity::set(qint64 tid, const std::vector<int>& cpus) const
+{
+    const auto set = make_cpu_set();
+    const auto size = CPU_ALLOC_SIZE(max_cpus);
+    if (!set)
+        return false;
+
+    CPU_ZERO_S(size, set.get());
+    for (const auto cpu : cpus)
+        if (cpu >= 0 && cpu < max_cpus)
+            CPU_SET_S(cpu, size, set.get());
+
+    if (sched_setaffinity(static_cast<pid_t>(tid), size, set.get()) < 0)
+    {
+        mpl::debug(category, "Could not set the affinity of {}: {}", tid, std::strerror(errno));
+        return false;
+    }
+
+    return true;
+}
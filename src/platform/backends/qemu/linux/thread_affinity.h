@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <multipass/singleton.h>
+
+#include <vector>
+
+#include <QtGlobal>
+
+#define MP_THREAD_AFFINITY multipass::ThreadAffinity::instance()
+
+namespace multipass
+{
+// Reads and restricts the host CPUs that threads of other processes may run on
+class ThreadAffinity : public Singleton<ThreadAffinity>
+{
+public:
+    ThreadAffinity(const Singleton<ThreadAffinity>::PrivatePass& pass) noexcept
+        : Singleton<ThreadAffinity>::Singleton{pass} {};
+
+    // Empty when the threads could not be listed
+    virtual std::vector<qint64> threads_of(qint64 pid) const;
+    // Empty when the affinity could not be read
+    virtual std::vector<int> get(qint64 tid) const;
+    virtual bool set(qint64 tid, const std::vector<int>& cpus) const;
+};
+} // namespace multipass
@@ -21,6 +21,7 @@
 #include <multipass/ssh/ssh_process.h>
 #include <multipass/utils.h>
 
+#include <QDir>
 #include <QUuid>
 
 namespace mp = multipass;
@@ -78,6 +79,27 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
     const auto gid_map = this->mount_spec.get_gid_mappings().empty()
                              ? std::make_pair(1000, 1000)
                              : this->mount_spec.get_gid_mappings()[0];
+
+    if (this->mount_spec.get_mount_type() == VMMount::MountType::Virtiofs)
+    {
+        const auto socket_path = QDir{virtiofs_socket_dir()}.filePath(
+            QString::fromStdString(fmt::format("{}.sock", make_tag(vm->get_name() + target))));
+
+        vm_virtiofs_shares = &vm->modifiable_virtiofs_shares();
+        (*vm_virtiofs_shares)[tag] = {
+            source,
+            socket_path,
+            {uid_map.first, uid_map.second == -1 ? 1000 : uid_map.second},
+            {gid_map.first, gid_map.second == -1 ? 1000 : gid_map.second}};
+        vm_mount_args[tag] = {
+            source,
+            {"-chardev",
+             QString{"socket,id=%1,path=%2"}.arg(QString::fromStdString(tag), socket_path),
+             "-device",
+             QString{"vhost-user-fs-pci,chardev=%1,tag=%1"}.arg(QString::fromStdString(tag))}};
+        return;
+    }
+
     const auto uid_arg = QString("uid_map=%1:%2,")
                              .arg(uid_map.first)
                              .arg(uid_map.second == -1 ? 1000 : uid_map.second);
@@ -97,14 +119,17 @@ QemuMountHandler::QemuMountHandler(QemuVirtualMachine* vm,
 bool QemuMountHandler::is_active()
 try
 {
-    return active &&
-           !vm->ssh_exec_process(fmt::format("findmnt --type 9p | grep '{} {}'", target, tag))
-                ->exit_code();
+    return active && !vm->ssh_exec_process(fmt::format("findmnt --type {} | grep '{} {}'",
+                                                       vm_virtiofs_shares ? "virtiofs" : "9p",
+                                                       target,
+                                                       tag))
+                          ->exit_code();
 }
 catch (const std::exception& e)
 {
     mpl::warn(category,
-              "Failed checking 9p mount \"{}\" in instance '{}': {}",
+              "Failed checking {} mount \"{}\" in instance '{}': {}",
+              vm_virtiofs_shares ? "virtiofs" : "9p",
               target,
               vm->get_name(),
               e.what());
@@ -131,9 +156,11 @@ void QemuMountHandler::activate_impl(ServerVariant, std::chrono::milliseconds)
 
     MP_UTILS.run_in_ssh_session(
         *session,
-        fmt::format("sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912",
-                    tag,
-                    target));
+        vm_virtiofs_shares
+            ? fmt::format("sudo mount -t virtiofs {} {}", tag, target)
+            : fmt::format("sudo mount -t 9p {} {} -o trans=virtio,version=9p2000.L,msize=536870912",
+                          tag,
+                          target));
 }
 
 void QemuMountHandler::deactivate_impl(bool force)
@@ -157,6 +184,8 @@ QemuMountHandler::~QemuMountHandler()
 {
     deactivate(/*force=*/true);
     vm_mount_args.erase(tag);
+    if (vm_virtiofs_shares)
+        vm_virtiofs_shares->erase(tag);
 }
 
 std::string QemuMountHandler::make_tag(const std::string& seed)
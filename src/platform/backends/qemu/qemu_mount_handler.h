@@ -40,6 +40,7 @@ public:
 
 private:
     QemuVirtualMachine::MountArgs& vm_mount_args;
+    QemuVirtualMachine::VirtiofsShares* vm_virtiofs_shares{nullptr};
     std::string tag;
 };
 
@@ -18,6 +18,7 @@
 #pragma once
 
 #include <multipass/availability_zone_manager.h>
+#include <multipass/cpu_affinity.h>
 #include <multipass/disabled_copy_move.h>
 #include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/ip_address.h>
@@ -34,6 +35,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace multipass
 {
@@ -60,6 +62,34 @@ public:
     virtual bool needs_network_prep() const = 0;
     virtual std::string create_bridge_with(const NetworkInterfaceInfo& interface) const = 0;
     virtual void set_authorization(std::vector<NetworkInterfaceInfo>& networks) = 0;
+    // Whether QEMU can share host directories through vhost-user-fs and virtiofsd
+    virtual bool supports_virtiofs() const
+    {
+        return false;
+    };
+    // Whether the default NIC can be given one queue per vCPU, with vhost-net
+    virtual bool supports_multiqueue_network() const
+    {
+        return false;
+    };
+    // Whether guest RAM can come from a memfd, possibly on hugepages, and be bound to a host node
+    virtual bool supports_memory_backing() const
+    {
+        return false;
+    };
+    // Whether QEMU threads can be confined to, and pinned on, host CPUs
+    virtual bool supports_cpu_affinity() const
+    {
+        return false;
+    };
+    // Confines the QEMU process with the given PID to the host CPUs of the affinity policy and, if
+    // it asks for pinning, each vCPU thread (listed in vCPU order) to one of them
+    virtual void apply_cpu_affinity(qint64 /*pid*/,
+                                    const std::vector<qint64>& /*vcpu_threads*/,
+                                    const CpuAffinity& /*affinity*/)
+    {
+        throw NotImplementedOnThisBackendException("CPU affinity");
+    };
 
     // Directory holding the QEMU firmware/UEFI assets shipped alongside the binary.
     static QString firmware_path()
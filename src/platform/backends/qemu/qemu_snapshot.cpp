@@ -77,6 +77,7 @@ mp::QemuSnapshot::QemuSnapshot(const std::string& name,
                                QemuVirtualMachine& vm,
                                VirtualMachineDescription& desc)
     : BaseSnapshot{name, comment, cloud_init_instance_id, std::move(parent), specs, vm},
+      vm{vm},
       desc{desc},
       image_path{desc.image.image_path}
 {
@@ -85,7 +86,7 @@ mp::QemuSnapshot::QemuSnapshot(const std::string& name,
 mp::QemuSnapshot::QemuSnapshot(const std::filesystem::path& filename,
                                QemuVirtualMachine& vm,
                                VirtualMachineDescription& desc)
-    : BaseSnapshot{filename, vm, desc}, desc{desc}, image_path{desc.image.image_path}
+    : BaseSnapshot{filename, vm, desc}, vm{vm}, desc{desc}, image_path{desc.image.image_path}
 {
 }
 
@@ -101,20 +102,26 @@ void mp::QemuSnapshot::capture_impl()
             image_path,
             tag)};
 
-    mp::backend::checked_exec_qemu_img(make_capture_spec(tag, image_path));
+    // A running instance holds a lock on its image, so QEMU itself needs to take the snapshot
+    if (vm.current_state() == VirtualMachine::State::running)
+        vm.capture_live_snapshot(tag);
+    else
+        mp::backend::checked_exec_qemu_img(make_capture_spec(tag, image_path));
 }
 
 void mp::QemuSnapshot::erase_impl()
 {
     const auto& tag = get_id();
-    if (backend::instance_image_has_snapshot(image_path, tag))
-        mp::backend::checked_exec_qemu_img(make_delete_spec(tag, image_path));
-    else
+    if (!backend::instance_image_has_snapshot(image_path, tag))
         mpl::warn(BaseSnapshot::get_name(),
                   "Could not find the underlying QEMU snapshot. Assuming it is already "
                   "gone. Image: {}; tag: {}",
                   image_path,
                   tag);
+    else if (vm.current_state() == VirtualMachine::State::running)
+        vm.erase_live_snapshot(tag);
+    else
+        mp::backend::checked_exec_qemu_img(make_delete_spec(tag, image_path));
 }
 
 void mp::QemuSnapshot::apply_impl()
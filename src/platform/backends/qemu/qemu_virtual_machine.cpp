@@ -22,6 +22,7 @@
 #include "qemu_vmstate_process_spec.h"
 
 #include <multipass/constants.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/exceptions/ip_unavailable_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
 #include <multipass/file_ops.h>
@@ -31,9 +32,12 @@
 #include <multipass/logging/log.h>
 #include <multipass/memory_size.h>
 #include <multipass/platform.h>
+#include <multipass/settings/settings.h>
 #include <multipass/top_catch_all.h>
+#include <multipass/utils.h>
 #include <multipass/utils/qemu_img_utils.h>
 #include <multipass/vm_mount.h>
+#include <multipass/vm_specs.h>
 #include <multipass/vm_status_monitor.h>
 
 #include <QFile>
@@ -41,8 +45,16 @@
 #include <QRegularExpression>
 #include <QString>
 #include <QTemporaryFile>
+#include <QThread>
+#include <QTimer>
 
+#include <algorithm>
 #include <cassert>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <thread>
 
 namespace mp = multipass;
 namespace mpl = mp::logging;
@@ -57,8 +69,17 @@ constexpr auto arguments_key = "arguments";
 constexpr auto mount_data_key = "mount_data";
 constexpr auto mount_source_key = "source";
 constexpr auto mount_arguments_key = "arguments";
+constexpr auto migration_options_key = "migration_options";
+constexpr auto root_drive_id = "hda";
+constexpr auto qmp_snapshot_timeout = 2min;
+constexpr auto qmp_query_timeout = 5s;
+constexpr auto balloon_path = "/machine/peripheral/balloon0";
+constexpr auto balloon_stats_interval = 10; // unit: s, how often the guest reports its memory
+constexpr auto migration_poll_interval = 50ms;
+constexpr auto max_multifd_channels = 8;
 
 constexpr int kill_process_timeout = 5000; // unit: ms, 5 seconds timeout for killing the process
+constexpr auto virtiofsd_socket_timeout = 5s;
 
 QString get_vm_machine(const boost::json::value& metadata)
 {
@@ -95,8 +116,15 @@ auto mount_args_from_json(const boost::json::object& object)
     return mount_args;
 }
 
+bool has_suspend_state(const mp::VirtualMachineDescription& desc)
+{
+    return QFile::exists(mp::QemuVMProcessSpec::suspend_state_file(desc)) ||
+           mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag);
+}
+
 auto make_qemu_process(const mp::VirtualMachineDescription& desc,
                        const std::optional<boost::json::object>& resume_metadata,
+                       const QString& state_file,
                        const mp::QemuVirtualMachine::MountArgs& mount_args,
                        const QStringList& platform_args)
 {
@@ -111,7 +139,8 @@ auto make_qemu_process(const mp::VirtualMachineDescription& desc,
         const auto& data = resume_metadata.value();
         resume_data = mp::QemuVMProcessSpec::ResumeData{suspend_tag,
                                                         get_vm_machine(data),
-                                                        get_arguments(data)};
+                                                        get_arguments(data),
+                                                        state_file};
     }
 
     auto process_spec =
@@ -136,6 +165,49 @@ boost::json::object hmc_to_qmp_json(const QString& command_line)
     return qmp;
 }
 
+// When QEMU emitted an event, by its own clock
+std::chrono::microseconds qmp_event_time(const boost::json::object& event)
+{
+    const auto& timestamp = event.at("timestamp");
+    return std::chrono::seconds{value_to<std::int64_t>(timestamp.at("seconds"))} +
+           std::chrono::microseconds{value_to<std::int64_t>(timestamp.at("microseconds"))};
+}
+
+// The commands that set a migration up with the options it was saved with
+std::vector<boost::json::object> migration_option_commands(const boost::json::value& options)
+{
+    std::vector<boost::json::object> commands;
+    const auto* object = options.if_object();
+    if (!object)
+        return commands;
+
+    if (const auto* capabilities = object->if_contains("capabilities"))
+    {
+        auto& qmp = commands.emplace_back(qmp_execute_json("migrate-set-capabilities"));
+        qmp["arguments"] = {{"capabilities", *capabilities}};
+    }
+
+    if (const auto* parameters = object->if_contains("parameters"))
+    {
+        auto& qmp = commands.emplace_back(qmp_execute_json("migrate-set-parameters"));
+        qmp["arguments"] = *parameters;
+    }
+
+    return commands;
+}
+
+// Why the migration QEMU reports on went wrong, or std::nullopt if it did not
+std::optional<std::string> migration_failure(const boost::json::value& info)
+{
+    const auto status = mp::lookup_or<std::string>(info, "status", "");
+    if (status != "failed" && status != "cancelled")
+        return std::nullopt;
+
+    return fmt::format("migration {}: {}",
+                       status,
+                       mp::lookup_or<std::string>(info, "error-desc", "no details"));
+}
+
 std::string get_qemu_machine_type(const QStringList& platform_args)
 {
     QTemporaryFile dump_file;
@@ -225,10 +297,7 @@ mp::QemuVirtualMachine::QemuVirtualMachine(const VirtualMachineDescription& desc
                                            AvailabilityZone& zone,
                                            const Path& instance_dir,
                                            bool remove_snapshots)
-    : BaseVirtualMachine{mp::backend::instance_image_has_snapshot(desc.image.image_path,
-                                                                  suspend_tag)
-                             ? State::suspended
-                             : State::off,
+    : BaseVirtualMachine{has_suspend_state(desc) ? State::suspended : State::off,
                          desc.vm_name,
                          desc,
                          key_provider,
@@ -254,7 +323,7 @@ mp::QemuVirtualMachine::~QemuVirtualMachine()
         update_shutdown_status = false;
 
         mp::top_catch_all(vm_name, [this]() {
-            if (state == State::running)
+            if (state == State::running && virtiofs_shares.empty())
             {
                 suspend();
             }
@@ -264,10 +333,16 @@ mp::QemuVirtualMachine::~QemuVirtualMachine()
             }
         });
     }
+
+    stop_virtiofs_daemons();
 }
 
 void mp::QemuVirtualMachine::start()
 {
+    // the QEMU process and its virtiofsd helpers belong to the thread this instance lives in
+    if (QThread::currentThread() != thread())
+        return in_own_thread([this] { start(); });
+
     initialize_vm_process();
 
     if (state == State::suspended)
@@ -292,6 +367,7 @@ void mp::QemuVirtualMachine::start()
             generate_metadata(qemu_platform->vmstate_platform_args(), proc_args, mount_args));
     }
 
+    start_virtiofs_daemons();
     vm_process->start();
     connect_vm_signals();
 
@@ -317,6 +393,9 @@ void mp::QemuVirtualMachine::start()
     }
 
     vm_process->write(QByteArray::fromStdString(serialize(qmp_execute_json("qmp_capabilities"))));
+    if (is_starting_from_state_file)
+        start_restoring_state_from_file();
+    apply_cpu_affinity();
 }
 
 void mp::QemuVirtualMachine::shutdown(ShutdownPolicy shutdown_policy)
@@ -343,25 +422,33 @@ void mp::QemuVirtualMachine::shutdown(ShutdownPolicy shutdown_policy)
             mpl::info(vm_name, "Killing process");
             force_shutdown = true;
             lock.unlock();
-            vm_process->kill();
-            if (vm_process != nullptr && !vm_process->wait_for_finished(kill_process_timeout))
-            {
-                throw std::runtime_error{fmt::format(
-                    "The QEMU process did not finish within {} milliseconds after being killed",
-                    kill_process_timeout)};
-            }
+            in_own_thread([this] {
+                vm_process->kill();
+                if (vm_process != nullptr && !vm_process->wait_for_finished(kill_process_timeout))
+                {
+                    throw std::runtime_error{fmt::format(
+                        "The QEMU process did not finish within {} milliseconds after being killed",
+                        kill_process_timeout)};
+                }
+            });
         }
         else
         {
             mpl::debug(vm_name, "No process to kill");
         }
 
+        const auto state_file = QemuVMProcessSpec::suspend_state_file(desc);
+        const auto has_suspend_file = QFile::exists(state_file);
         const auto has_suspend_snapshot =
             mp::backend::instance_image_has_snapshot(desc.image.image_path, suspend_tag);
-        if (has_suspend_snapshot != (state == State::suspended)) // clang-format off
-            mpl::warn(vm_name, "Image has {} suspension snapshot, but the state is {}",
-                                                               has_suspend_snapshot ? "a" : "no",
-                                                               static_cast<short>(state)); // clang-format on
+        const auto suspended_on_disk = has_suspend_snapshot || has_suspend_file;
+        if (suspended_on_disk != (state == State::suspended))
+            mpl::warn(vm_name,
+                      "{}, but the state is {}",
+                      has_suspend_snapshot ? "Image has a suspension snapshot"
+                      : has_suspend_file   ? "Instance has a suspend state file"
+                                           : "Instance has no suspension snapshot or state file",
+                      static_cast<short>(state));
 
         if (has_suspend_snapshot)
         {
@@ -369,6 +456,12 @@ void mp::QemuVirtualMachine::shutdown(ShutdownPolicy shutdown_policy)
             mp::backend::delete_snapshot_from_image(desc.image.image_path, suspend_tag);
         }
 
+        if (has_suspend_file)
+        {
+            mpl::info(vm_name, "Deleting suspend state file");
+            QFile::remove(state_file);
+        }
+
         state = State::off;
     }
     else
@@ -377,21 +470,26 @@ void mp::QemuVirtualMachine::shutdown(ShutdownPolicy shutdown_policy)
 
         drop_ssh_session();
 
-        if (vm_process && vm_process->running())
-        {
-            vm_process->write(
-                QByteArray::fromStdString(serialize(qmp_execute_json("system_powerdown"))));
-            if (vm_process->wait_for_finished(vm_shutdown_timeout))
+        std::optional<bool> finished;
+        in_own_thread([this, &finished] {
+            if (vm_process && vm_process->running())
             {
-                lock.lock();
-                state = State::off;
-            }
-            else
-            {
-                throw std::runtime_error{fmt::format(
-                    "The QEMU process did not finish within {} milliseconds after being shutdown",
-                    vm_shutdown_timeout)};
+                vm_process->write(
+                    QByteArray::fromStdString(serialize(qmp_execute_json("system_powerdown"))));
+                finished = vm_process->wait_for_finished(vm_shutdown_timeout);
             }
+        });
+
+        if (finished == true)
+        {
+            lock.lock();
+            state = State::off;
+        }
+        else if (finished == false)
+        {
+            throw std::runtime_error{fmt::format(
+                "The QEMU process did not finish within {} milliseconds after being shutdown",
+                vm_shutdown_timeout)};
         }
     }
 }
@@ -400,6 +498,11 @@ void mp::QemuVirtualMachine::suspend()
 {
     if ((state == State::running || state == State::delayed_shutdown) && vm_process->running())
     {
+        // vhost-user-fs devices block saving the VM state
+        if (!virtiofs_shares.empty())
+            throw std::runtime_error{
+                fmt::format("Cannot suspend '{}' while it has virtiofs mounts", vm_name)};
+
         if (update_shutdown_status)
         {
             state = State::suspending;
@@ -408,9 +511,16 @@ void mp::QemuVirtualMachine::suspend()
         }
 
         drop_ssh_session();
-        vm_process->write(QByteArray::fromStdString(
-            serialize(hmc_to_qmp_json(QString{"savevm "} + suspend_tag))));
-        vm_process->wait_for_finished(vm_shutdown_timeout);
+        if (MP_SETTINGS.get(suspend_mode_key) == suspend_mode_file)
+        {
+            save_state_to_file();
+        }
+        else
+        {
+            vm_process->write(QByteArray::fromStdString(
+                serialize(hmc_to_qmp_json(QString{"savevm "} + suspend_tag))));
+            vm_process->wait_for_finished(vm_shutdown_timeout);
+        }
 
         vm_process.reset(nullptr);
     }
@@ -466,6 +576,7 @@ void mp::QemuVirtualMachine::on_shutdown()
         vm_process.reset(nullptr);
     }
 
+    stop_virtiofs_daemons();
     monitor->on_shutdown();
 }
 
@@ -507,6 +618,22 @@ std::optional<mp::IPAddress> mp::QemuVirtualMachine::management_ipv4()
 
 void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout)
 {
+    // The guest only runs once its state is back in place
+    if (const auto restored = state_restored; restored.valid())
+    {
+        if (restored.wait_for(timeout) != std::future_status::ready)
+            throw std::runtime_error{"timed out waiting for the instance state to be restored"};
+
+        try
+        {
+            restored.get();
+        }
+        catch (const std::future_error&)
+        {
+            throw std::runtime_error{"QEMU quit while restoring the instance state"};
+        }
+    }
+
     BaseVirtualMachine::wait_until_ssh_up(timeout);
 
     if (is_starting_from_suspend)
@@ -518,10 +645,18 @@ void mp::QemuVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout
 
 void mp::QemuVirtualMachine::initialize_vm_process()
 {
+    const auto state_file = QemuVMProcessSpec::suspend_state_file(desc);
+    is_starting_from_state_file = state == State::suspended && QFile::exists(state_file);
+    qmp_reply_handlers.clear();
+    is_taking_live_snapshot = false;
+    state_restored = {};
+    balloon_report = MemoryBalloon{desc.mem_size};
+
     vm_process = make_qemu_process(
         desc,
         ((state == State::suspended) ? std::make_optional(monitor->retrieve_metadata_for(vm_name))
                                      : std::nullopt),
+        is_starting_from_state_file ? state_file : QString{},
         mount_args,
         qemu_platform->vm_platform_args(desc));
 
@@ -534,48 +669,9 @@ void mp::QemuVirtualMachine::initialize_vm_process()
         auto qmp_output = vm_process->read_all_standard_output();
         mpl::debug(vm_name, "QMP: {}", qmp_output);
         // Skip non-JSON output.
-        const auto lines = qmp_output.split('\n');
-        const auto json_line = std::find_if(lines.cbegin(), lines.cend(), [](const QString& line) {
-            return line.startsWith('{');
-        });
-        if (json_line == lines.cend())
-            return;
-        auto qmp_object = boost::json::parse(json_line->toStdString()).as_object();
-
-        if (auto event = qmp_object.if_contains("event"))
-        {
-            auto event_str = value_to<std::string>(*event);
-            if (event_str == "RESET" && state != State::restarting)
-            {
-                mpl::info(vm_name, "VM restarting");
-                on_restart();
-            }
-            else if (event_str == "POWERDOWN")
-            {
-                mpl::info(vm_name, "VM powering down");
-            }
-            else if (event_str == "SHUTDOWN")
-            {
-                mpl::info(vm_name, "VM shut down");
-            }
-            else if (event_str == "STOP")
-            {
-                mpl::info(vm_name, "VM suspending");
-            }
-            else if (event_str == "RESUME")
-            {
-                mpl::info(vm_name, "VM suspended");
-                if (state == State::suspending || state == State::running)
-                {
-                    vm_process->kill();
-                    on_suspend();
-                }
-            }
-        }
-        else if (auto error = qmp_object.if_contains("error"))
-        {
-            mpl::error(vm_name, "QMP error: {}", value_to<std::string>(error->at("desc")));
-        }
+        for (const auto& line : qmp_output.split('\n'))
+            if (line.startsWith('{'))
+                handle_qmp_message(boost::json::parse(line.toStdString()).as_object());
     });
 
     QObject::connect(vm_process.get(), &Process::ready_read_standard_error, [this]() {
@@ -611,6 +707,8 @@ void mp::QemuVirtualMachine::initialize_vm_process()
                      });
 
     QObject::connect(vm_process.get(), &Process::finished, [this](ProcessState process_state) {
+        qmp_reply_handlers.clear(); // there will be no replies for them
+
         if (process_state.exit_code)
         {
             mpl::info(vm_name,
@@ -643,6 +741,395 @@ void mp::QemuVirtualMachine::initialize_vm_process()
     });
 }
 
+void mp::QemuVirtualMachine::handle_qmp_message(boost::json::object qmp_object)
+{
+    // Replies to commands we are waiting on synchronously are picked up by execute_qmp
+    if (auto id = qmp_object.if_contains("id"); id && id->is_string())
+    {
+        auto id_str = value_to<std::string>(*id);
+        if (auto handler = qmp_reply_handlers.extract(id_str))
+        {
+            try
+            {
+                handler.mapped()(std::move(qmp_object));
+            }
+            catch (const std::exception& e)
+            {
+                mpl::warn(vm_name, "Could not handle QMP reply: {}", e.what());
+            }
+        }
+        else
+        {
+            qmp_replies[std::move(id_str)] = std::move(qmp_object);
+        }
+
+        return;
+    }
+
+    if (auto event = qmp_object.if_contains("event"))
+    {
+        auto event_str = value_to<std::string>(*event);
+        if (event_str == "RESET" && state != State::restarting)
+        {
+            mpl::info(vm_name, "VM restarting");
+            on_restart();
+        }
+        else if (event_str == "POWERDOWN")
+        {
+            mpl::info(vm_name, "VM powering down");
+        }
+        else if (event_str == "SHUTDOWN")
+        {
+            mpl::info(vm_name, "VM shut down");
+        }
+        else if (event_str == "STOP" && is_taking_live_snapshot)
+        {
+            live_snapshot_stopped_at = qmp_event_time(qmp_object);
+        }
+        else if (event_str == "RESUME" && is_taking_live_snapshot)
+        {
+            if (live_snapshot_stopped_at)
+                live_snapshot_pause = qmp_event_time(qmp_object) - *live_snapshot_stopped_at;
+        }
+        else if (event_str == "STOP")
+        {
+            mpl::info(vm_name, "VM suspending");
+        }
+        else if (event_str == "RESUME")
+        {
+            mpl::info(vm_name, "VM suspended");
+            // Saving to a file leaves the guest stopped, so it only resumes if that failed
+            if (!is_saving_state_to_file &&
+                (state == State::suspending || state == State::running))
+            {
+                vm_process->kill();
+                on_suspend();
+            }
+        }
+    }
+    else if (auto error = qmp_object.if_contains("error"))
+    {
+        mpl::error(vm_name, "QMP error: {}", value_to<std::string>(error->at("desc")));
+    }
+}
+
+std::string mp::QemuVirtualMachine::new_qmp_id()
+{
+    return fmt::format("multipass-{}", ++qmp_request_count);
+}
+
+void mp::QemuVirtualMachine::write_qmp(boost::json::object command, const std::string& id)
+{
+    if (!vm_process || !vm_process->running())
+        throw std::runtime_error{
+            fmt::format("Cannot execute {}: the QEMU process is not running",
+                        value_to<std::string>(command.at("execute")))};
+
+    command["id"] = id;
+    vm_process->write(QByteArray::fromStdString(serialize(command)));
+}
+
+void mp::QemuVirtualMachine::send_qmp(boost::json::object command,
+                                      std::function<void(const boost::json::value&)> on_return,
+                                      std::function<void(const std::string&)> on_error)
+{
+    auto execute = value_to<std::string>(command.at("execute"));
+
+    // The reply can be handled before writing returns, so the handler needs to be there already
+    const auto id = new_qmp_id();
+    qmp_reply_handlers[id] = [this, execute, on_return = std::move(on_return), on_error](
+                                 const boost::json::object& reply) {
+        if (auto error = reply.if_contains("error"))
+        {
+            const auto message = fmt::format("QEMU failed to execute {}: {}",
+                                             execute,
+                                             value_to<std::string>(error->at("desc")));
+            if (on_error)
+                on_error(message);
+            else
+                mpl::warn(vm_name, "{}", message);
+        }
+        else if (on_return)
+            on_return(reply.at("return"));
+    };
+
+    try
+    {
+        write_qmp(std::move(command), id);
+    }
+    catch (const std::exception& e)
+    {
+        qmp_reply_handlers.erase(id);
+        if (!on_error)
+            throw;
+
+        on_error(e.what());
+    }
+}
+
+void mp::QemuVirtualMachine::send_qmp_in_turn(std::vector<boost::json::object> commands,
+                                              std::function<void()> on_done,
+                                              std::function<void(const std::string&)> on_error)
+{
+    if (commands.empty())
+        return on_done();
+
+    auto command = std::move(commands.front());
+    commands.erase(commands.begin());
+    send_qmp(
+        std::move(command),
+        [this, commands = std::move(commands), on_done, on_error](const boost::json::value&) {
+            send_qmp_in_turn(commands, on_done, on_error);
+        },
+        on_error);
+}
+
+boost::json::object mp::QemuVirtualMachine::execute_qmp(boost::json::object command,
+                                                        std::chrono::milliseconds timeout)
+{
+    const auto execute = value_to<std::string>(command.at("execute"));
+    const auto id = new_qmp_id();
+    write_qmp(std::move(command), id);
+
+    // Waiting for output runs the QMP output handler in-line, which stores our reply
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    auto reply_it = qmp_replies.find(id);
+    while (reply_it == qmp_replies.end())
+    {
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining <= 0ms || !vm_process->wait_for_ready_read(remaining))
+            throw std::runtime_error{
+                fmt::format("Timed out waiting for QEMU to execute {}", execute)};
+
+        reply_it = qmp_replies.find(id);
+    }
+
+    auto reply = std::move(reply_it->second);
+    qmp_replies.erase(reply_it);
+
+    if (auto error = reply.if_contains("error"))
+        throw std::runtime_error{fmt::format("QEMU failed to execute {}: {}",
+                                             execute,
+                                             value_to<std::string>(error->at("desc")))};
+
+    return reply;
+}
+
+void mp::QemuVirtualMachine::apply_cpu_affinity()
+{
+    if (desc.cpu_affinity == CpuAffinity{})
+        return;
+
+    // The instance runs fine unconfined, so failing to apply the policy is not fatal. Nor is it
+    // worth holding the start up for, so it is applied once QEMU lists the vCPU threads.
+    const auto warn = [this](const std::string& error) {
+        mpl::warn(vm_name, "Could not apply the CPU affinity: {}", error);
+    };
+
+    send_qmp(
+        qmp_execute_json("query-cpus-fast"),
+        [this, warn](const boost::json::value& reply) {
+            try
+            {
+                std::vector<std::pair<std::int64_t, qint64>> cpus;
+                for (const auto& cpu : reply.as_array())
+                    cpus.emplace_back(value_to<std::int64_t>(cpu.at("cpu-index")),
+                                      value_to<qint64>(cpu.at("thread-id")));
+                std::sort(cpus.begin(), cpus.end());
+
+                std::vector<qint64> vcpu_threads;
+                for (const auto& [_, thread_id] : cpus)
+                    vcpu_threads.push_back(thread_id);
+
+                qemu_platform->apply_cpu_affinity(vm_process->process_id(),
+                                                  vcpu_threads,
+                                                  desc.cpu_affinity);
+            }
+            catch (const std::exception& e)
+            {
+                warn(e.what());
+            }
+        },
+        warn);
+}
+
+void mp::QemuVirtualMachine::save_state_to_file()
+{
+    const auto started_at = std::chrono::steady_clock::now();
+    const auto state_file = QemuVMProcessSpec::suspend_state_file(desc);
+
+    // With mapped-ram (QEMU 9.0 onwards), every page has a fixed offset in the file, which lets
+    // multifd channels write and read guest RAM in parallel
+    boost::json::object options;
+    const auto supported =
+        execute_qmp(qmp_execute_json("query-migrate-capabilities"), qmp_query_timeout);
+    const auto& capabilities = supported.at("return").as_array();
+    if (std::any_of(capabilities.begin(), capabilities.end(), [](const auto& capability) {
+            return value_to<std::string>(capability.at("capability")) == "mapped-ram";
+        }))
+    {
+        options["capabilities"] =
+            boost::json::array{boost::json::object{{"capability", "mapped-ram"}, {"state", true}},
+                               boost::json::object{{"capability", "multifd"}, {"state", true}}};
+        options["parameters"] = {
+            {"multifd-channels", std::clamp(desc.num_cores, 1, max_multifd_channels)}};
+    }
+
+    is_saving_state_to_file = true;
+    try
+    {
+        // Stopping the guest first has its RAM written in one pass, with nothing getting dirtied
+        execute_qmp(qmp_execute_json("stop"), qmp_query_timeout);
+        set_migration_options(options);
+
+        auto migrate = qmp_execute_json("migrate");
+        migrate["arguments"] = {{"uri", fmt::format("file:{}", state_file)}};
+        execute_qmp(std::move(migrate), qmp_query_timeout);
+        wait_for_migration(vm_shutdown_timeout);
+    }
+    catch (const std::exception& e)
+    {
+        mpl::error(vm_name, "Failed to save the instance state: {}", e.what());
+        QFile::remove(state_file);
+
+        mp::top_catch_all(vm_name, [this] {
+            execute_qmp(qmp_execute_json("cont"), qmp_query_timeout);
+            if (state == State::suspending)
+            {
+                update_shutdown_status = true;
+                state = State::running;
+                handle_state_update();
+            }
+        });
+        is_saving_state_to_file = false;
+        throw;
+    }
+
+    // Restoring needs the same capabilities the state was saved with
+    auto metadata = monitor->retrieve_metadata_for(vm_name);
+    metadata[migration_options_key] = std::move(options);
+    monitor->update_metadata_for(vm_name, metadata);
+
+    mpl::info(vm_name,
+              "Saved the instance state to {} in {} ms",
+              state_file,
+              std::chrono::duration_cast<std::chrono::milliseconds>(
+                  std::chrono::steady_clock::now() - started_at)
+                  .count());
+
+    vm_process->kill();
+    vm_process->wait_for_finished(kill_process_timeout);
+    is_saving_state_to_file = false;
+    on_suspend();
+}
+
+void mp::QemuVirtualMachine::start_restoring_state_from_file()
+{
+    // QEMU loads the state while the daemon gets on with other things. Waiting for the instance to
+    // be up is what waits for it.
+    const auto started_at = std::chrono::steady_clock::now();
+    const auto state_file = QemuVMProcessSpec::suspend_state_file(desc);
+    const auto restored = std::make_shared<std::promise<void>>();
+    state_restored = restored->get_future().share();
+
+    const auto on_error = [this, state_file, restored](const std::string& error) {
+        // A state that does not load cannot be resumed, and leaving it around would have it loaded
+        // over the disk of an instance booted afresh
+        mpl::error(vm_name, "Failed to restore the instance state: {}", error);
+        QFile::remove(state_file);
+
+        // Not starting anymore, or the shutdown would wait for the start to be given up on
+        state = State::off;
+        force_shutdown = true;
+        if (vm_process)
+            vm_process->kill();
+
+        restored->set_exception(std::make_exception_ptr(std::runtime_error{
+            fmt::format("failed to restore the instance state: {}", error)}));
+    };
+
+    const auto on_restored = [this, state_file, restored, started_at](const boost::json::value&) {
+        QFile::remove(state_file);
+        mpl::info(vm_name,
+                  "Restored the instance state from {} in {} ms",
+                  state_file,
+                  std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - started_at)
+                      .count());
+        restored->set_value();
+    };
+
+    auto commands = migration_option_commands(mp::lookup_or<boost::json::value>(
+        monitor->retrieve_metadata_for(vm_name),
+        migration_options_key,
+        {}));
+    auto& incoming = commands.emplace_back(qmp_execute_json("migrate-incoming"));
+    incoming["arguments"] = {{"uri", fmt::format("file:{}", state_file)}};
+
+    send_qmp_in_turn(
+        std::move(commands),
+        [this, on_restored, on_error] {
+            const auto deadline = std::chrono::steady_clock::now() + vm_shutdown_timeout;
+            poll_migration(
+                deadline,
+                [this, on_restored, on_error] {
+                    // The state was saved with the guest stopped, and that is how it comes back
+                    send_qmp(qmp_execute_json("cont"), on_restored, on_error);
+                },
+                on_error);
+        },
+        on_error);
+}
+
+void mp::QemuVirtualMachine::poll_migration(std::chrono::steady_clock::time_point deadline,
+                                            std::function<void()> on_done,
+                                            std::function<void(const std::string&)> on_error)
+{
+    send_qmp(
+        qmp_execute_json("query-migrate"),
+        [this, deadline, on_done, on_error](const boost::json::value& info) {
+            if (mp::lookup_or<std::string>(info, "status", "") == "completed")
+                on_done();
+            else if (const auto failure = migration_failure(info))
+                on_error(*failure);
+            else if (std::chrono::steady_clock::now() > deadline)
+                on_error("timed out waiting for the migration to complete");
+            else
+                QTimer::singleShot(migration_poll_interval, this, [=, this] {
+                    poll_migration(deadline, on_done, on_error);
+                });
+        },
+        on_error);
+}
+
+void mp::QemuVirtualMachine::set_migration_options(const boost::json::value& options)
+{
+    for (auto& qmp : migration_option_commands(options))
+        execute_qmp(std::move(qmp), qmp_query_timeout);
+}
+
+void mp::QemuVirtualMachine::wait_for_migration(std::chrono::milliseconds timeout)
+{
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (true)
+    {
+        const auto reply = execute_qmp(qmp_execute_json("query-migrate"), qmp_query_timeout);
+        const auto& info = reply.at("return");
+
+        if (mp::lookup_or<std::string>(info, "status", "") == "completed")
+            return;
+
+        if (const auto failure = migration_failure(info))
+            throw std::runtime_error{*failure};
+
+        if (std::chrono::steady_clock::now() > deadline)
+            throw std::runtime_error{"timed out waiting for the migration to complete"};
+
+        std::this_thread::sleep_for(migration_poll_interval);
+    }
+}
+
 void mp::QemuVirtualMachine::connect_vm_signals()
 {
     std::unique_lock lock{vm_signal_mutex};
@@ -655,10 +1142,15 @@ void mp::QemuVirtualMachine::connect_vm_signals()
         &QemuVirtualMachine::on_delete_memory_snapshot,
         this,
         [this] {
-            mpl::debug(vm_name, "Deleted memory snapshot");
-            vm_process->write(QByteArray::fromStdString(
-                serialize(hmc_to_qmp_json(QString("delvm ") + suspend_tag))));
+            // A state file is consumed as soon as it is restored
+            if (!is_starting_from_state_file)
+            {
+                mpl::debug(vm_name, "Deleted memory snapshot");
+                vm_process->write(QByteArray::fromStdString(
+                    serialize(hmc_to_qmp_json(QString("delvm ") + suspend_tag))));
+            }
             is_starting_from_suspend = false;
+            is_starting_from_state_file = false;
         },
         Qt::QueuedConnection);
 
@@ -738,12 +1230,175 @@ void mp::QemuVirtualMachine::add_network_interface(int /* not used on this backe
     add_extra_interface_to_instance_cloud_init(default_mac_addr, extra_interface);
 }
 
+void mp::QemuVirtualMachine::set_network_multiqueue(bool enabled)
+{
+    if (enabled && !qemu_platform->supports_multiqueue_network())
+        throw NotImplementedOnThisBackendException{"multiqueue networking"};
+
+    desc.network_multiqueue = enabled;
+}
+
+void mp::QemuVirtualMachine::set_disk_profile(const std::string& profile)
+{
+    desc.disk_profile = profile;
+}
+
+void mp::QemuVirtualMachine::set_memory_backing(const MemoryBacking& backing)
+{
+    if ((backing.type != memory_backing_default || backing.host_node) &&
+        !qemu_platform->supports_memory_backing())
+        throw NotImplementedOnThisBackendException("memfd memory and host NUMA binding");
+
+    desc.memory_backing = backing;
+}
+
+void mp::QemuVirtualMachine::set_cpu_affinity(const CpuAffinity& affinity)
+{
+    if ((!affinity.host_cpus.empty() || affinity.pin_vcpus) &&
+        !qemu_platform->supports_cpu_affinity())
+        throw NotImplementedOnThisBackendException("CPU affinity");
+
+    desc.cpu_affinity = affinity;
+}
+
+mp::MemoryBalloon mp::QemuVirtualMachine::memory_balloon()
+{
+    // This is polled from the daemon's thread, so rather than wait on QEMU, report what it said
+    // last time and ask again for next time
+    const auto ret = balloon_report;
+
+    send_qmp(qmp_execute_json("query-balloon"), [this](const boost::json::value& balloon) {
+        balloon_report.actual = MemorySize::from_bytes(value_to<long long>(balloon.at("actual")));
+    });
+
+    auto get_stats = qmp_execute_json("qom-get");
+    get_stats["arguments"] = {{"path", balloon_path}, {"property", "guest-stats"}};
+    send_qmp(std::move(get_stats), [this](const boost::json::value& stats) {
+        // The guest only reports its statistics once asked to, which needs doing on every boot
+        if (value_to<long long>(stats.at("last-update")) == 0)
+        {
+            auto poll_stats = qmp_execute_json("qom-set");
+            poll_stats["arguments"] = {{"path", balloon_path},
+                                       {"property", "guest-stats-polling-interval"},
+                                       {"value", balloon_stats_interval}};
+            send_qmp(std::move(poll_stats), nullptr);
+        }
+        else if (const auto available =
+                     value_to<long long>(stats.at("stats").at("stat-available-memory"));
+                 available >= 0) // -1 when the guest does not report it
+        {
+            balloon_report.available = MemorySize::from_bytes(available);
+        }
+    });
+
+    return ret;
+}
+
+void mp::QemuVirtualMachine::set_memory_balloon_target(const MemorySize& target)
+{
+    auto qmp = qmp_execute_json("balloon");
+    qmp["arguments"] = {{"value", target.in_bytes()}};
+    send_qmp(std::move(qmp), nullptr);
+}
+
 mp::MountHandler::UPtr mp::QemuVirtualMachine::make_native_mount_handler(const std::string& target,
                                                                          const VMMount& mount)
 {
+    if (mount.get_mount_type() == VMMount::MountType::Virtiofs &&
+        !qemu_platform->supports_virtiofs())
+        throw NotImplementedOnThisBackendException{"virtiofs mounts"};
+
     return std::make_unique<QemuMountHandler>(this, &key_provider, target, mount);
 }
 
+std::shared_ptr<const mp::Snapshot> mp::QemuVirtualMachine::take_live_snapshot(
+    const VMSpecs& specs,
+    const std::string& snapshot_name,
+    const std::string& comment,
+    std::chrono::microseconds& pause_duration)
+{
+    if (state != State::running)
+        throw VMStateInvalidException{
+            fmt::format("Cannot take a live snapshot of {}: the instance is not running", vm_name)};
+
+    // Only the disk is captured, so restoring the snapshot boots from it, as if it had been taken
+    // while the instance was stopped
+    auto snapshot_specs = specs;
+    snapshot_specs.state = State::off;
+
+    auto snapshot = take_snapshot_impl(snapshot_specs, snapshot_name, comment);
+    pause_duration = last_live_snapshot_pause;
+
+    return snapshot;
+}
+
+std::chrono::microseconds mp::QemuVirtualMachine::capture_live_snapshot(const std::string& tag)
+{
+    // QEMU's replies are handled on this instance's thread, so waiting for them there would hang
+    assert(QThread::currentThread() != thread());
+
+    auto snapshot = qmp_execute_json("blockdev-snapshot-internal-sync");
+    snapshot["arguments"] = {{"device", root_drive_id}, {"name", tag}};
+
+    // The guest is stopped around the snapshot, for the disk to be captured at rest. Its STOP and
+    // RESUME events tell how long it was kept from running, by QEMU's clock
+    auto outcome = std::make_shared<std::promise<std::chrono::microseconds>>();
+    auto captured = outcome->get_future();
+    in_own_thread([this, &snapshot, outcome] {
+        const auto fail = [this, outcome](const std::string& error) {
+            is_taking_live_snapshot = false;
+            outcome->set_exception(std::make_exception_ptr(std::runtime_error{error}));
+        };
+
+        // The guest is resumed whatever became of the snapshot
+        const auto resume = [this, outcome, fail](const std::string& snapshot_error) {
+            send_qmp(
+                qmp_execute_json("cont"),
+                [this, outcome, fail, snapshot_error](const boost::json::value&) {
+                    if (!snapshot_error.empty())
+                        return fail(snapshot_error);
+
+                    is_taking_live_snapshot = false;
+                    outcome->set_value(live_snapshot_pause);
+                },
+                fail);
+        };
+
+        is_taking_live_snapshot = true;
+        live_snapshot_stopped_at.reset();
+        live_snapshot_pause = {};
+        send_qmp_in_turn({qmp_execute_json("stop"), snapshot}, [resume] { resume({}); }, resume);
+    });
+
+    if (captured.wait_for(qmp_snapshot_timeout) != std::future_status::ready)
+        throw std::runtime_error{
+            fmt::format("Timed out waiting for QEMU to take live snapshot {}", tag)};
+
+    try
+    {
+        last_live_snapshot_pause = captured.get();
+    }
+    catch (const std::future_error&)
+    {
+        throw std::runtime_error{fmt::format("QEMU stopped before taking live snapshot {}", tag)};
+    }
+
+    mpl::info(vm_name,
+              "Captured live snapshot {} with a pause of {} us",
+              tag,
+              last_live_snapshot_pause.count());
+
+    return last_live_snapshot_pause;
+}
+
+void mp::QemuVirtualMachine::erase_live_snapshot(const std::string& tag)
+{
+    auto qmp = qmp_execute_json("blockdev-snapshot-delete-internal-sync");
+    qmp["arguments"] = {{"device", root_drive_id}, {"name", tag}};
+
+    execute_qmp(std::move(qmp), qmp_snapshot_timeout);
+}
+
 void mp::QemuVirtualMachine::remove_snapshots_from_backend() const
 {
     const QStringList snapshot_tag_list =
@@ -760,6 +1415,91 @@ mp::QemuVirtualMachine::MountArgs& mp::QemuVirtualMachine::modifiable_mount_args
     return mount_args;
 }
 
+mp::QemuVirtualMachine::VirtiofsShares& mp::QemuVirtualMachine::modifiable_virtiofs_shares()
+{
+    return virtiofs_shares;
+}
+
+void mp::QemuVirtualMachine::in_own_thread(const std::function<void()>& work)
+{
+    if (QThread::currentThread() == thread())
+        return work();
+
+    std::exception_ptr error;
+    QMetaObject::invokeMethod(
+        this,
+        [&work, &error] {
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        },
+        Qt::BlockingQueuedConnection);
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void mp::QemuVirtualMachine::start_virtiofs_daemons()
+{
+    stop_virtiofs_daemons();
+
+    if (!virtiofs_shares.empty())
+        make_virtiofs_socket_dir(virtiofs_socket_dir());
+
+    for (const auto& [tag, share] : virtiofs_shares)
+    {
+        QFile::remove(share.socket_path); // left behind if virtiofsd did not exit cleanly
+
+        auto daemon =
+            mp::platform::make_process(std::make_unique<VirtiofsdProcessSpec>(vm_name, tag, share));
+        mpl::debug(vm_name, "virtiofsd arguments '{}'", daemon->arguments().join(", "));
+
+        daemon->start();
+        if (!daemon->wait_for_started())
+            throw std::runtime_error{
+                fmt::format("failed to start virtiofsd for \"{}\": {}",
+                            share.source_path,
+                            daemon->process_state().failure_message())};
+
+        // QEMU connects to the socket on startup, so it has to be listening by then
+        mp::utils::try_action_for(
+            [&share] {
+                throw std::runtime_error{
+                    fmt::format("virtiofsd did not create socket \"{}\" in time",
+                                share.socket_path)};
+            },
+            virtiofsd_socket_timeout,
+            [&share] {
+                return QFile::exists(share.socket_path) ? mp::utils::TimeoutAction::done
+                                                        : mp::utils::TimeoutAction::retry;
+            });
+        check_virtiofs_socket(share.socket_path);
+
+        virtiofs_daemons.emplace(tag, std::move(daemon));
+    }
+}
+
+void mp::QemuVirtualMachine::stop_virtiofs_daemons()
+{
+    for (auto& [tag, daemon] : virtiofs_daemons)
+    {
+        if (daemon->running())
+        {
+            mpl::debug(vm_name, "Stopping virtiofsd for mount tag {}", tag);
+            daemon->terminate();
+            if (!daemon->wait_for_finished(kill_process_timeout))
+                daemon->kill();
+        }
+    }
+
+    virtiofs_daemons.clear();
+}
+
 auto mp::QemuVirtualMachine::make_specific_snapshot(const std::string& snapshot_name,
                                                     const std::string& comment,
                                                     const std::string& instance_id,
@@ -18,6 +18,7 @@
 #pragma once
 
 #include "qemu_platform.h"
+#include "virtiofsd_process_spec.h"
 
 #include <shared/base_virtual_machine.h>
 
@@ -28,8 +29,14 @@
 #include <QObject>
 #include <QStringList>
 
+#include <boost/json.hpp>
+
 #include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
@@ -41,6 +48,7 @@ class QemuVirtualMachine : public QObject, public BaseVirtualMachine
     Q_OBJECT
 public:
     using MountArgs = std::unordered_map<std::string, std::pair<std::string, QStringList>>;
+    using VirtiofsShares = std::unordered_map<std::string, VirtiofsShare>;
 
     QemuVirtualMachine(const VirtualMachineDescription& desc,
                        QemuPlatform* qemu_platform,
@@ -66,9 +74,26 @@ public:
     virtual void add_network_interface(int index,
                                        const std::string& default_mac_addr,
                                        const NetworkInterface& extra_interface) override;
+    void set_network_multiqueue(bool enabled) override;
+    void set_disk_profile(const std::string& profile) override;
+    void set_memory_backing(const MemoryBacking& backing) override;
+    void set_cpu_affinity(const CpuAffinity& affinity) override;
+    MemoryBalloon memory_balloon() override;
+    void set_memory_balloon_target(const MemorySize& target) override;
     virtual MountArgs& modifiable_mount_args();
+    virtual VirtiofsShares& modifiable_virtiofs_shares();
     std::unique_ptr<MountHandler> make_native_mount_handler(const std::string& target,
                                                             const VMMount& mount) override;
+    std::shared_ptr<const Snapshot> take_live_snapshot(
+        const VMSpecs& specs,
+        const std::string& snapshot_name,
+        const std::string& comment,
+        std::chrono::microseconds& pause_duration) override;
+
+    // Internal (disk-only) snapshot operations on the image of the running instance, via QMP.
+    // Capturing waits for QEMU, which this instance's thread needs to be free to hear from.
+    virtual std::chrono::microseconds capture_live_snapshot(const std::string& tag);
+    virtual void erase_live_snapshot(const std::string& tag);
 signals:
     void on_delete_memory_snapshot();
     void on_reset_network();
@@ -102,20 +127,60 @@ private:
     void on_suspend();
     void on_restart();
     void initialize_vm_process();
+    void start_virtiofs_daemons();
+    void stop_virtiofs_daemons();
+    // Runs work on the thread this instance lives in, which owns its processes, waiting for it
+    void in_own_thread(const std::function<void()>& work);
 
     void connect_vm_signals();
     void disconnect_vm_signals();
     void remove_snapshots_from_backend() const;
+    void handle_qmp_message(boost::json::object qmp_object);
+    std::string new_qmp_id();
+    void write_qmp(boost::json::object command, const std::string& id);
+    // Runs on_return with what a successful command returns, once QEMU replies. Failures, including
+    // not getting the command to QEMU, go to on_error, or are logged when there is none.
+    void send_qmp(boost::json::object command,
+                  std::function<void(const boost::json::value&)> on_return,
+                  std::function<void(const std::string&)> on_error = nullptr);
+    // Sends each command once QEMU is done with the previous one, then runs on_done
+    void send_qmp_in_turn(std::vector<boost::json::object> commands,
+                          std::function<void()> on_done,
+                          std::function<void(const std::string&)> on_error);
+    boost::json::object execute_qmp(boost::json::object command, std::chrono::milliseconds timeout);
+    void apply_cpu_affinity();
+    void save_state_to_file();
+    void start_restoring_state_from_file();
+    void poll_migration(std::chrono::steady_clock::time_point deadline,
+                        std::function<void()> on_done,
+                        std::function<void(const std::string&)> on_error);
+    void set_migration_options(const boost::json::value& options);
+    void wait_for_migration(std::chrono::milliseconds timeout);
 
     std::unique_ptr<Process> vm_process{nullptr};
     QemuPlatform* qemu_platform;
     VMStatusMonitor* monitor;
     MountArgs mount_args;
+    VirtiofsShares virtiofs_shares;
+    std::unordered_map<std::string, std::unique_ptr<Process>> virtiofs_daemons;
     bool update_shutdown_status{true};
     bool is_starting_from_suspend{false};
+    bool is_starting_from_state_file{false};
+    bool is_saving_state_to_file{false};
     bool force_shutdown{false};
     std::mutex vm_signal_mutex;
     bool vm_signals_connected{false};
     std::chrono::steady_clock::time_point network_deadline;
+    // QMP state is only touched on this instance's thread, where QEMU's output is handled
+    int qmp_request_count{0};
+    std::unordered_map<std::string, boost::json::object> qmp_replies;
+    std::unordered_map<std::string, std::function<void(const boost::json::object&)>>
+        qmp_reply_handlers;
+    bool is_taking_live_snapshot{false};
+    std::optional<std::chrono::microseconds> live_snapshot_stopped_at; // by QEMU's clock
+    std::chrono::microseconds live_snapshot_pause{};
+    MemoryBalloon balloon_report{};
+    std::shared_future<void> state_restored; // while starting from a state file
+    std::chrono::microseconds last_live_snapshot_pause{}; // on the thread taking the snapshot
 };
 } // namespace multipass
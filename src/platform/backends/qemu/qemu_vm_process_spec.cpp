@@ -16,6 +16,7 @@
  */
 
 #include "qemu_vm_process_spec.h"
+#include "virtiofsd_process_spec.h"
 
 #include <multipass/exceptions/snap_environment_exception.h>
 #include <multipass/format.h>
@@ -27,10 +28,98 @@
 #include <QCoreApplication>
 #include <QRegularExpression>
 
+#include <algorithm>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
 
+namespace
+{
+#if defined Q_PROCESSOR_S390
+constexpr auto bus = "ccw";
+#else
+constexpr auto bus = "pci";
+#endif
+
+bool has_vhost_user_mounts(const mp::QemuVirtualMachine::MountArgs& mount_args)
+{
+    return std::ranges::any_of(mount_args, [](const auto& mount) {
+        return std::ranges::any_of(mount.second.second, [](const QString& arg) {
+            return arg.startsWith("vhost-user-fs-pci");
+        });
+    });
+}
+
+// Guest RAM comes from a memory backend object instead of plain `-m` when it needs to be shareable
+// (vhost-user devices map it), hugepage-backed, preallocated or bound to a host NUMA node
+std::optional<QString> memory_backend(const mp::VirtualMachineDescription& desc,
+                                      const QString& mem_size,
+                                      bool shared)
+{
+    const auto& backing = desc.memory_backing;
+
+    QString backend;
+    if (backing.type == mp::memory_backing_hugepages)
+        backend = QString("memory-backend-memfd,id=mem,size=%1,share=on,hugetlb=on,hugetlbsize=%2M")
+                      .arg(mem_size)
+                      .arg(mp::hugepage_size_mb);
+    else if (backing.type == mp::memory_backing_memfd || shared)
+        backend = QString("memory-backend-memfd,id=mem,size=%1,share=on").arg(mem_size);
+    else if (backing.prealloc || backing.host_node)
+        backend = QString("memory-backend-ram,id=mem,size=%1").arg(mem_size);
+    else
+        return std::nullopt;
+
+    if (backing.prealloc)
+        backend += QString(",prealloc=on,prealloc-threads=%1").arg(std::max(desc.num_cores, 1));
+    if (backing.host_node)
+        backend += QString(",policy=bind,host-nodes=%1").arg(*backing.host_node);
+
+    return backend;
+}
+
+QStringList disk_arguments(const mp::VirtualMachineDescription& desc)
+{
+    auto drive = QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda")
+                     .arg(MP_PLATFORM.path_to_qstr(desc.image.image_path));
+
+    if (desc.disk_profile == mp::disk_profile_default)
+        return {"-device",
+                QString("virtio-scsi-%1,id=scsi0").arg(bus),
+                "-drive",
+                drive,
+                "-device",
+                "scsi-hd,drive=hda,bus=scsi0.0"};
+
+    // Serve guest I/O from a dedicated thread instead of QEMU's main loop, and skip the host page
+    // cache: the guest caches on its own already. Native AIO needs O_DIRECT, hence cache=none
+#if defined Q_OS_LINUX
+    drive += ",cache=none,aio=native";
+#else
+    drive += ",cache=none,aio=threads";
+#endif
+    const auto queues = std::max(desc.num_cores, 1);
+
+    QStringList args{"-object", "iothread,id=iothread0"};
+    if (desc.disk_profile == mp::disk_profile_virtio_blk)
+        args << "-device"
+             << QString("virtio-blk-%1,drive=hda,iothread=iothread0,num-queues=%2")
+                    .arg(bus)
+                    .arg(queues)
+             << "-drive" << drive;
+    else
+        args << "-device"
+             << QString("virtio-scsi-%1,id=scsi0,iothread=iothread0,num_queues=%2")
+                    .arg(bus)
+                    .arg(queues)
+             << "-drive" << drive << "-device"
+             << "scsi-hd,drive=hda,bus=scsi0.0";
+
+    return args;
+}
+} // namespace
+
 mp::QemuVMProcessSpec::QemuVMProcessSpec(const mp::VirtualMachineDescription& desc,
                                          const QStringList& platform_args,
                                          const mp::QemuVirtualMachine::MountArgs& mount_args,
@@ -54,8 +143,13 @@ QStringList mp::QemuVMProcessSpec::arguments() const
             args.prepend("-L");
         }
 
-        // need to append extra arguments for resume
-        args << "-loadvm" << resume_data->suspend_tag;
+        // need to append extra arguments for resume; a state file is read over QMP once QEMU is
+        // up, with the migration capabilities it was written with
+        if (resume_data->state_file.isEmpty())
+            args << "-loadvm" << resume_data->suspend_tag;
+        else
+            args << "-incoming"
+                 << "defer";
 
         QString machine_type = resume_data->machine_type;
         if (!machine_type.isEmpty())
@@ -78,30 +172,37 @@ QStringList mp::QemuVMProcessSpec::arguments() const
     {
         // The UUID needs to be unique per VM and must be consistent across boots.
         const auto vm_uuid = QString::fromStdString(utils::make_uuid(desc.vm_name));
-        auto mem_size =
-            QString::number(desc.mem_size.in_megabytes()) + 'M'; /* flooring here; format documented
+        auto mem_megabytes = desc.mem_size.in_megabytes();
+        if (desc.memory_backing.type == memory_backing_hugepages) // must be made of whole pages
+            mem_megabytes -= mem_megabytes % hugepage_size_mb;
+        auto mem_size = QString::number(mem_megabytes) + 'M'; /* flooring here; format documented
 in `man qemu-system`, under `-m` option; including suffix to avoid relying on default unit */
         // clang-format off
         // Tell QEMU where to look for the BIOS files
         args << "-L"
              << firmware_path();
         args << platform_args;
-        // The VM image itself
-        args << "-device"
-#if defined Q_PROCESSOR_S390
-             << "virtio-scsi-ccw,id=scsi0"
-#else
-             << "virtio-scsi-pci,id=scsi0"
-#endif
-             << "-drive"
-             << QString("file=%1,if=none,format=qcow2,discard=unmap,id=hda")
-                    .arg(MP_PLATFORM.path_to_qstr(desc.image.image_path))
-             << "-device"
-             << "scsi-hd,drive=hda,bus=scsi0.0";
+        // The VM image itself, attached according to the instance's disk profile
+        args << disk_arguments(desc);
         // Number of cpu cores
         args << "-smp" << QString::number(desc.num_cores);
         // Memory to use for VM
         args << "-m" << mem_size;
+        // Memory backend: vhost-user backends (virtiofsd) need guest RAM shared, see memory_backend
+        if (const auto backend = memory_backend(desc, mem_size, has_vhost_user_mounts(mount_args)))
+            args << "-object"
+                 << *backend
+                 << "-numa"
+                 << "node,memdev=mem";
+        // Memory balloon: the guest hands pages it frees back to the host, and the daemon can
+        // reclaim more from instances that leave their memory unused. Preallocated and hugepage
+        // memory is pinned on the host, so reporting would only fault it out and back in again
+        const auto pinned_memory = desc.memory_backing.type == memory_backing_hugepages ||
+                                   desc.memory_backing.prealloc;
+        args << "-device"
+             << QString("virtio-balloon-%1,id=balloon0%2")
+                    .arg(bus)
+                    .arg(pinned_memory ? "" : ",free-page-reporting=on");
         // Control interface
         args << "-qmp"
              << "stdio";
@@ -163,6 +264,7 @@ profile %1 flags=(attach_disconnected) {
   signal (receive) peer=%2,
 
   /dev/net/tun rw,
+  /dev/vhost-net rw,
   /dev/kvm rw,
   /dev/ptmx rw,
   /dev/kqemu rw,
@@ -212,6 +314,12 @@ profile %1 flags=(attach_disconnected) {
   %6 rwk,  # QCow2 filesystem image
   %7 rk,   # cloud-init ISO
 
+  # State of instances suspended to a file
+  %9 rw,
+
+  # vhost-user sockets of virtiofs mounts
+  %10/*.sock rw,
+
   # allow full access just to user-specified mount directories on the host
   %8
 }
@@ -249,7 +357,14 @@ profile %1 flags=(attach_disconnected) {
                                 program(),
                                 QString::fromStdString(desc.image.image_path),
                                 desc.cloud_init_iso,
-                                mount_dirs);
+                                mount_dirs,
+                                suspend_state_file(desc),
+                                virtiofs_socket_dir());
+}
+
+QString mp::QemuVMProcessSpec::suspend_state_file(const VirtualMachineDescription& desc)
+{
+    return MP_PLATFORM.path_to_qstr(desc.image.image_path.parent_path() / "suspend.vmstate");
 }
 
 QString mp::QemuVMProcessSpec::identifier() const
@@ -35,9 +35,12 @@ public:
         QString suspend_tag;
         QString machine_type;
         QStringList arguments;
+        QString state_file{}; // when set, the state is migrated in from it instead of -loadvm
     };
 
     static QString default_machine_type();
+    // Where the state of an instance suspended to a file goes: next to its image
+    static QString suspend_state_file(const VirtualMachineDescription& desc);
 
     explicit QemuVMProcessSpec(const VirtualMachineDescription& desc,
                                const QStringList& platform_args,
@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "virtiofsd_process_spec.h"
+
+#include <multipass/exceptions/snap_environment_exception.h>
+#include <multipass/format.h>
+#include <multipass/logging/log.h>
+#include <multipass/snap_utils.h>
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpu = multipass::utils;
+
+namespace
+{
+constexpr auto virtiofsd_path = "/usr/libexec/virtiofsd";
+
+QString translate_ids(const char* option, const std::pair<int, int>& map)
+{
+    // virtiofsd maps `count` ids starting at the guest id to ids starting at the host id
+    return QString{"--translate-%1=map:%2:%3:1"}.arg(option).arg(map.second).arg(map.first);
+}
+} // namespace
+
+QString mp::virtiofs_socket_dir()
+{
+    // Unix socket paths are limited to 108 bytes, so stay close to the root
+    try
+    {
+        return QString{mpu::snap_common_dir()} + "/virtiofs";
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+        return "/run/multipass-virtiofs";
+    }
+}
+
+void mp::make_virtiofs_socket_dir(const QString& dir)
+{
+    const auto path = dir.toStdString();
+
+    // mkdir fails rather than reuse whatever is already there, so a fresh directory is ours
+    if (::mkdir(path.c_str(), S_IRWXU) == 0)
+        return;
+
+    if (errno != EEXIST)
+        throw std::runtime_error{
+            fmt::format("cannot create virtiofs socket directory "{}": {}",
+                        path,
+                        std::strerror(errno))};
+
+    struct stat info{};
+    if (::lstat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode) ||
+        info.st_uid != ::geteuid() || (info.st_mode & (S_IRWXG | S_IRWXO)) != 0)
+        throw std::runtime_error{
+            fmt::format("refusing to use \"{}\" for virtiofs sockets: it is not a directory that "
+                        "only the daemon's user can access",
+                        path)};
+}
+
+void mp::check_virtiofs_socket(const QString& path)
+{
+    const auto socket_path = path.toStdString();
+
+    struct stat info{};
+    if (::lstat(socket_path.c_str(), &info) != 0 || !S_ISSOCK(info.st_mode) ||
+        info.st_uid != ::geteuid())
+        throw std::runtime_error{
+            fmt::format("refusing to hand \"{}\" to QEMU: it is not a socket owned by the "
+                        "daemon's user",
+                        socket_path)};
+}
+
+mp::VirtiofsdProcessSpec::VirtiofsdProcessSpec(const std::string& instance,
+                                               const std::string& tag,
+                                               VirtiofsShare share)
+    : instance{instance}, tag{tag}, share{std::move(share)}
+{
+}
+
+QString mp::VirtiofsdProcessSpec::program() const
+{
+    try
+    {
+        return QString{mpu::snap_dir()} + virtiofsd_path;
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+        return virtiofsd_path;
+    }
+}
+
+QStringList mp::VirtiofsdProcessSpec::arguments() const
+{
+    return {QString{"--socket-path=%1"}.arg(share.socket_path),
+            QString{"--shared-dir=%1"}.arg(QString::fromStdString(share.source_path)),
+            "--sandbox=chroot",
+            "--cache=auto",
+            "--inode-file-handles=prefer",
+            translate_ids("uid", share.uid_map),
+            translate_ids("gid", share.gid_map)};
+}
+
+mp::logging::Level mp::VirtiofsdProcessSpec::error_log_level() const
+{
+    return mp::logging::Level::debug;
+}
+
+QString mp::VirtiofsdProcessSpec::apparmor_profile() const
+{
+    QString profile_template(R"END(
+#include <tunables/global>
+profile %1 flags=(attach_disconnected) {
+    #include <abstractions/base>
+
+    # Required for reading and searching host directories
+    capability dac_override,
+    capability dac_read_search,
+    # Enables modifying of file ownership and permissions
+    capability chown,
+    capability fsetid,
+    capability fowner,
+    capability mknod,
+    # Multipass allows user to specify arbitrary uid/gid mappings
+    capability setuid,
+    capability setgid,
+    # For the chroot sandbox
+    capability sys_chroot,
+
+    # Allow multipassd send virtiofsd signals
+    signal (receive) peer=%2,
+
+    # binary and its libs
+    %3 ixr,
+    %4/{usr/,}lib/{,@{multiarch}/}{,**/}*.so* rm,
+
+    # vhost-user socket shared with QEMU
+    %5 rw,
+
+    # allow full access just to this user-specified source directory on the host
+    %6/ rw,
+    %6/** rwlk,
+}
+    )END");
+
+    /* Customisations depending on if running inside snap or not */
+    QString root_dir;    // root directory: either "" or $SNAP
+    QString signal_peer; // who can send kill signal to virtiofsd
+
+    try
+    {
+        root_dir = mpu::snap_dir();
+        signal_peer = "snap.multipass.multipassd"; // only multipassd can send virtiofsd signals
+    }
+    catch (const mp::SnapEnvironmentException&)
+    {
+        signal_peer = "unconfined";
+    }
+
+    return profile_template.arg(apparmor_profile_name(),
+                                signal_peer,
+                                program(),
+                                root_dir,
+                                share.socket_path,
+                                QString::fromStdString(share.source_path));
+}
+
+QString mp::VirtiofsdProcessSpec::identifier() const
+{
+    return QString::fromStdString(instance + "." + tag);
+}
@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#pragma once
+
+#include <multipass/process/process_spec.h>
+
+#include <QString>
+#include <QStringList>
+
+#include <string>
+#include <utility>
+
+namespace multipass
+{
+struct VirtiofsShare
+{
+    std::string source_path;
+    QString socket_path;
+    std::pair<int, int> uid_map; // host:instance
+    std::pair<int, int> gid_map; // host:instance
+};
+
+// Where the vhost-user sockets of virtiofs mounts live. Only the daemon's user may enter it, so that
+// no one else can bind a socket's name before virtiofsd does and get hold of the guest's memory.
+QString virtiofs_socket_dir();
+
+// Creates `dir` for virtiofs sockets, or checks that the existing one is a real directory owned by
+// the daemon's user and closed to everyone else. Throws std::runtime_error if it is not.
+void make_virtiofs_socket_dir(const QString& dir);
+
+// Throws std::runtime_error unless `path` is a socket owned by the daemon's user.
+void check_virtiofs_socket(const QString& path);
+
+// Runs one virtiofsd per mount, serving `share.source_path` over a vhost-user socket that QEMU
+// connects to. virtiofsd exits on its own once QEMU disconnects.
+class VirtiofsdProcessSpec : public ProcessSpec
+{
+public:
+    VirtiofsdProcessSpec(const std::string& instance, const std::string& tag, VirtiofsShare share);
+
+    QString program() const override;
+    QStringList arguments() const override;
+    logging::Level error_log_level() const override;
+
+    QString apparmor_profile() const override;
+    QString identifier() const override;
+
+private:
+    const std::string instance;
+    const std::string tag;
+    const VirtiofsShare share;
+};
+} // namespace multipass
@@ -20,17 +20,23 @@
 #include <multipass/file_ops.h>
 #include <multipass/json_utils.h>
 #include <multipass/logging/log.h>
+#include <multipass/utils.h>
 
 #include <fmt/format.h>
 
 #include <scope_guard.hpp>
 
+#include <algorithm>
+
 namespace mpl = multipass::logging;
 
 namespace
 {
 constexpr auto subnet_key = "subnet";
 constexpr auto available_key = "available";
+
+// Transitions are mostly spent waiting on hypervisors and disks, so several can go at once
+constexpr std::size_t max_parallel_transitions = 4;
 } // namespace
 
 namespace multipass
@@ -62,15 +68,25 @@ bool BaseAvailabilityZone::is_available() const
     return m.available;
 }
 
-void BaseAvailabilityZone::set_available(const bool new_available)
+void BaseAvailabilityZone::set_available(const bool new_available,
+                                         const TransitionProgress& progress)
 {
 
     mpl::debug(name, "making AZ {}available", new_available ? "" : "un");
-    const std::unique_lock lock{mutex};
-    if (m.available == new_available)
-        return;
 
-    m.available = new_available;
+    // Instances may need other threads to transition (e.g. the ones owning their processes), which
+    // must not wait on the zone meanwhile. So only transitions are serialized while they run.
+    const std::unique_lock transition_lock{transition_mutex};
+    std::vector<std::reference_wrapper<VirtualMachine>> transitioning;
+    {
+        const std::unique_lock lock{mutex};
+        if (m.available == new_available)
+            return;
+
+        m.available = new_available;
+        transitioning = vms;
+    }
+
     auto save_file_guard = sg::make_scope_guard([this]() noexcept {
         try
         {
@@ -82,18 +98,31 @@ void BaseAvailabilityZone::set_available(const bool new_available)
         }
     });
 
+    std::mutex progress_mutex;
+    std::size_t done = 0;
+    const auto transition = [&](std::reference_wrapper<VirtualMachine> vm) {
+        vm.get().set_available(new_available);
+
+        const std::lock_guard progress_lock{progress_mutex};
+        ++done;
+        if (progress)
+            progress(vm.get(), done, transitioning.size());
+    };
+
     try
     {
-        for (auto& vm : vms)
-            vm.get().set_available(new_available);
+        utils::bounded_parallel_for_each(transitioning, max_parallel_transitions, transition);
     }
     catch (...)
     {
         // if an error occurs fallback to available.
-        m.available = true;
+        {
+            const std::unique_lock lock{mutex};
+            m.available = true;
+        }
 
         // make sure nothing is still unavailable.
-        for (auto& vm : vms)
+        for (auto& vm : transitioning)
         {
             // setting the state here breaks encapsulation, but it's already broken.
             std::unique_lock vm_lock{vm.get().state_mutex};
@@ -120,9 +149,10 @@ void BaseAvailabilityZone::remove_vm(VirtualMachine& vm)
 {
     mpl::debug(name, "removing vm '{}' from AZ", vm.get_name());
     const std::unique_lock lock{mutex};
-    // as of now, we use vm names to uniquely identify vms, so we can do the same here
+    // not by name, since an instance let go of late (e.g. after a transition) can share it with a
+    // newer one
     const auto to_remove = std::remove_if(vms.begin(), vms.end(), [&](const auto& some_vm) {
-        return some_vm.get().get_name() == vm.get_name();
+        return &some_vm.get() == &vm;
     });
     vms.erase(to_remove, vms.end());
 }
@@ -25,6 +25,9 @@
 
 #include <fmt/format.h>
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <utility>
 
 namespace mpl = multipass::logging;
@@ -50,6 +53,39 @@ constexpr auto automatic_zone_key = "automatic_zone";
 
     return zones;
 };
+
+// Score each zone by its share of the resources committed across all zones, summed over vCPUs,
+// memory and disk, so that no single dimension needs a host-specific weight.
+template <typename ZoneArray>
+[[nodiscard]] auto load_scores(const ZoneArray& zones,
+                               const multipass::AvailabilityZoneManager::ZoneLoads& loads)
+{
+    using multipass::ZoneLoad;
+
+    std::array<ZoneLoad, std::tuple_size_v<ZoneArray>> zone_loads{};
+    ZoneLoad total{};
+    for (size_t idx = 0; idx < zones.size(); ++idx)
+    {
+        if (const auto it = loads.find(zones[idx]->get_name()); it != loads.end())
+            zone_loads[idx] = it->second;
+
+        total.cpus += zone_loads[idx].cpus;
+        total.memory_bytes += zone_loads[idx].memory_bytes;
+        total.disk_bytes += zone_loads[idx].disk_bytes;
+    }
+
+    const auto share = [](auto part, auto whole) {
+        return whole > 0 ? static_cast<double>(part) / static_cast<double>(whole) : 0.0;
+    };
+
+    std::array<double, std::tuple_size_v<ZoneArray>> scores{};
+    for (size_t idx = 0; idx < zones.size(); ++idx)
+        scores[idx] = share(zone_loads[idx].cpus, total.cpus) +
+                      share(zone_loads[idx].memory_bytes, total.memory_bytes) +
+                      share(zone_loads[idx].disk_bytes, total.disk_bytes);
+
+    return scores;
+}
 } // namespace
 
 namespace multipass
@@ -79,9 +115,10 @@ const AvailabilityZone& BaseAvailabilityZoneManager::get_zone(const std::string&
     throw AvailabilityZoneNotFound{name};
 }
 
-std::string BaseAvailabilityZoneManager::get_automatic_zone_name()
+std::string BaseAvailabilityZoneManager::get_automatic_zone_name(ZonePlacement placement,
+                                                                 const ZoneLoads& loads)
 {
-    const auto zone_name = zone_collection.next_available();
+    const auto zone_name = zone_collection.next_available(placement, loads);
     save_file();
     return zone_name;
 }
@@ -151,7 +188,8 @@ BaseAvailabilityZoneManager::ZoneCollection::ZoneCollection(
     }
 }
 
-std::string BaseAvailabilityZoneManager::ZoneCollection::next_available()
+std::string BaseAvailabilityZoneManager::ZoneCollection::next_available(ZonePlacement placement,
+                                                                        const ZoneLoads& loads)
 {
     std::unique_lock lock{mutex};
 
@@ -160,6 +198,18 @@ std::string BaseAvailabilityZoneManager::ZoneCollection::next_available()
         return zone->is_available();
     });
 
+    // Or the available zone with the lowest load, keeping the earliest one on ties
+    if (placement == ZonePlacement::least_loaded && zone_it != zones.end())
+    {
+        const auto scores = load_scores(zones, loads);
+        const auto score_of = [&](auto it) { return scores[std::distance(zones.begin(), it)]; };
+        for (auto it = std::next(zone_it); it != zones.end(); ++it)
+        {
+            if ((*it)->is_available() && score_of(it) < score_of(zone_it))
+                zone_it = it;
+        }
+    }
+
     // Check if an available zone was found
     if (zone_it != zones.end())
     {
@@ -33,6 +33,7 @@
 #include <multipass/ssh/plain_ssh_session.h>
 #include <multipass/ssh/ssh_key_provider.h>
 #include <multipass/top_catch_all.h>
+#include <multipass/tracing.h>
 #include <multipass/vm_specs.h>
 #include <scope_guard.hpp>
 
@@ -40,6 +41,7 @@
 #include <QRegularExpression>
 #include <QString>
 
+#include <algorithm>
 #include <chrono>
 #include <functional>
 #include <mutex>
@@ -243,23 +245,19 @@ std::string mp::BaseVirtualMachine::ssh_exec(const std::string& cmd, bool whispe
 std::unique_ptr<mp::SSHProcess> mp::BaseVirtualMachine::ssh_exec_process(const std::string& cmd,
                                                                          bool whisper)
 {
-    std::unique_lock lock{state_mutex};
-
     std::optional<std::string> log_details = std::nullopt;
     bool reconnect = true;
     while (true)
     {
         assert(reconnect && "we should have thrown otherwise");
-        if ((!ssh_session || !ssh_session->is_connected()) && reconnect)
+        if (!ssh_sessions.healthy() && reconnect)
         {
             mpl::info(vm_name,
                       "SSH session disconnected{}",
                       log_details ? fmt::format(": {}", *log_details) : "");
 
             reconnect = false; // once only
-            lock.unlock();
             renew_ssh_session();
-            lock.lock();
         }
 
         try
@@ -268,8 +266,7 @@ std::unique_ptr<mp::SSHProcess> mp::BaseVirtualMachine::ssh_exec_process(const s
         }
         catch (const SSHException& e)
         {
-            assert(ssh_session);
-            if (ssh_session->is_connected() || !reconnect)
+            if (ssh_sessions.healthy() || !reconnect)
                 throw;
 
             log_details = e.what();
@@ -283,19 +280,23 @@ std::unique_ptr<mp::SSHProcess> mp::BaseVirtualMachine::ssh_exec_process(const s
 std::unique_ptr<mp::SSHProcess> mp::BaseVirtualMachine::make_ssh_process(const std::string& cmd,
                                                                          bool whisper)
 {
-    return ssh_session->exec(cmd, whisper);
+    return ssh_sessions.exec(cmd, whisper);
 }
 
 void mp::BaseVirtualMachine::renew_ssh_session()
 {
-    auto new_session = new_ssh_session();
+    auto new_session = connect_ssh_session();
 
-    std::lock_guard lock{state_mutex};
-    mpl::debug(vm_name, "{} SSH session", ssh_session ? "Renewing cached" : "Caching new");
-    ssh_session = std::move(new_session);
+    mpl::debug(vm_name, "{} SSH session", ssh_sessions.size() ? "Adding" : "Caching new");
+    ssh_sessions.add(std::move(new_session));
 }
 
 std::unique_ptr<multipass::SSHSession> multipass::BaseVirtualMachine::new_ssh_session()
+{
+    return ssh_sessions.acquire();
+}
+
+std::unique_ptr<multipass::SSHSession> multipass::BaseVirtualMachine::connect_ssh_session()
 {
     {
         const std::unique_lock lock{state_mutex};
@@ -345,6 +346,8 @@ mp::IPAddress mp::BaseVirtualMachine::require_management_ipv4()
 
 void mp::BaseVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout)
 {
+    mp::tracing::Span span{"BaseVirtualMachine::wait_until_ssh_up"};
+
     drop_ssh_session();
     mpl::debug(vm_name, "Waiting for SSH to be up");
 
@@ -357,6 +360,8 @@ void mp::BaseVirtualMachine::wait_until_ssh_up(std::chrono::milliseconds timeout
 
 void mp::BaseVirtualMachine::wait_for_cloud_init(std::chrono::milliseconds timeout)
 {
+    mp::tracing::Span span{"BaseVirtualMachine::wait_for_cloud_init"};
+
     auto action = [this] {
         detect_aborted_start();
         try
@@ -457,9 +462,7 @@ std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::get_snapshot(int ind
 {
     const std::unique_lock lock{snapshot_mutex};
 
-    auto index_matcher = [index](const auto& elem) { return elem.second->get_index() == index; };
-    if (auto it = std::find_if(snapshots.begin(), snapshots.end(), index_matcher);
-        it != snapshots.end())
+    if (auto it = snapshots_by_index.find(index); it != snapshots_by_index.end())
         return it->second;
 
     throw std::runtime_error{fmt::format(
@@ -496,6 +499,9 @@ void mp::BaseVirtualMachine::take_snapshot_rollback_helper(SnapshotMap::iterator
         head_snapshot = std::move(old_head);
     }
 
+    if (it->second)
+        mp::top_catch_all(vm_name, [this, it] { unlink_snapshot(it->second); });
+
     snapshots.erase(it);
 }
 
@@ -512,8 +518,25 @@ std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::take_snapshot(
     const std::string& snapshot_name,
     const std::string& comment)
 {
-    std::unique_lock lock{snapshot_mutex};
     assert_vm_stopped(state); // precondition
+    return take_snapshot_impl(specs, snapshot_name, comment);
+}
+
+std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::take_live_snapshot(
+    const VMSpecs& /*specs*/,
+    const std::string& /*snapshot_name*/,
+    const std::string& /*comment*/,
+    std::chrono::microseconds& /*pause_duration*/)
+{
+    throw NotImplementedOnThisBackendException{"live snapshots"};
+}
+
+std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::take_snapshot_impl(
+    const VMSpecs& specs,
+    const std::string& snapshot_name,
+    const std::string& comment)
+{
+    std::unique_lock lock{snapshot_mutex};
 
     auto sname = snapshot_name.empty() ? generate_snapshot_name() : snapshot_name;
 
@@ -533,6 +556,7 @@ std::shared_ptr<const mp::Snapshot> mp::BaseVirtualMachine::take_snapshot(
                                get_instance_id_from_the_cloud_init(),
                                specs,
                                head_snapshot);
+    link_snapshot(ret);
     ret->capture();
 
     ++snapshot_count;
@@ -601,7 +625,6 @@ void mp::BaseVirtualMachine::delete_snapshot_helper(std::shared_ptr<Snapshot>& s
 
     // Update children of deleted snapshot
     std::vector<Snapshot*> updated_parents{};
-    updated_parents.reserve(snapshots.size());
 
     auto rollback_parent_updates = make_parent_update_rollback(snapshot, updated_parents);
     update_parents(snapshot, updated_parents);
@@ -610,22 +633,53 @@ void mp::BaseVirtualMachine::delete_snapshot_helper(std::shared_ptr<Snapshot>& s
     snapshot->erase();
     rollback_parent_updates.dismiss();
     rollback_head.dismiss();
+
+    unlink_snapshot(snapshot);
 }
 
 void mp::BaseVirtualMachine::update_parents(std::shared_ptr<Snapshot>& deleted_parent,
                                             std::vector<Snapshot*>& updated_parents)
 {
+    auto it = snapshot_children.find(deleted_parent.get());
+    if (it == snapshot_children.end())
+        return;
+
     auto new_parent = deleted_parent->get_parent();
-    for (auto& [ignore, other] : snapshots)
+    updated_parents.reserve(it->second.size()); // so that recording an update cannot throw
+    for (auto* child : it->second)
     {
-        if (other->get_parent() == deleted_parent)
-        {
-            other->set_parent(new_parent);
-            updated_parents.push_back(other.get());
-        }
+        child->set_parent(new_parent);
+        updated_parents.push_back(child);
     }
 }
 
+void mp::BaseVirtualMachine::link_snapshot(const std::shared_ptr<Snapshot>& snapshot)
+{
+    snapshots_by_index[snapshot->get_index()] = snapshot;
+    snapshot_children[snapshot->get_parent().get()].push_back(snapshot.get());
+}
+
+// Drops the snapshot from the index and hands its children over to its own parent, mirroring what
+// update_parents did to the snapshots themselves
+void mp::BaseVirtualMachine::unlink_snapshot(const std::shared_ptr<Snapshot>& snapshot)
+{
+    if (auto it = snapshots_by_index.find(snapshot->get_index());
+        it != snapshots_by_index.end() && it->second == snapshot)
+        snapshots_by_index.erase(it);
+
+    const auto* parent = snapshot->get_parent().get();
+    auto& siblings = snapshot_children[parent];
+    if (auto orphans = snapshot_children.extract(snapshot.get()); !orphans.empty())
+        siblings.insert(siblings.end(), orphans.mapped().begin(), orphans.mapped().end());
+
+    if (auto pos = std::find(siblings.begin(), siblings.end(), snapshot.get());
+        pos != siblings.end())
+        siblings.erase(pos);
+
+    if (siblings.empty())
+        snapshot_children.erase(parent);
+}
+
 template <typename NodeT>
 auto mp::BaseVirtualMachine::make_reinsert_guard(NodeT& snapshot_node)
 {
@@ -695,11 +749,15 @@ void mp::BaseVirtualMachine::load_snapshots()
 
 std::vector<std::string> mp::BaseVirtualMachine::get_childrens_names(const Snapshot* parent) const
 {
-    std::vector<std::string> children;
+    const std::unique_lock lock{snapshot_mutex};
 
-    for (const auto& snapshot : view_snapshots())
-        if (snapshot->get_parent().get() == parent)
-            children.push_back(snapshot->get_name());
+    std::vector<std::string> children;
+    if (auto it = snapshot_children.find(parent); it != snapshot_children.end())
+    {
+        children.reserve(it->second.size());
+        for (const auto* child : it->second)
+            children.push_back(child->get_name());
+    }
 
     return children;
 }
@@ -753,6 +811,8 @@ void mp::BaseVirtualMachine::load_snapshot(const QString& filename)
         mpl::warn(vm_name, "Snapshot name taken: {}", name);
         throw SnapshotNameTakenException{vm_name, name};
     }
+
+    link_snapshot(snapshot);
 }
 
 auto mp::BaseVirtualMachine::make_common_file_rollback(const Path& file_path,
@@ -907,10 +967,10 @@ std::shared_ptr<mp::Snapshot> mp::BaseVirtualMachine::make_specific_snapshot(
 
 void mp::BaseVirtualMachine::drop_ssh_session()
 {
-    if (ssh_session)
+    if (ssh_sessions.size())
     {
-        mpl::debug(vm_name, "Dropping cached SSH session");
-        ssh_session.reset();
+        mpl::debug(vm_name, "Dropping cached SSH sessions");
+        ssh_sessions.reset();
     }
 }
 
@@ -938,9 +998,9 @@ void mp::BaseVirtualMachine::ssh_and_cross_to_running()
     auto new_session =
         std::make_unique<PlainSSHSession>(ssh_hostname(), ssh_port(), ssh_username(), key_provider);
 
-    std::lock_guard lock{state_mutex};
-    ssh_session = std::move(new_session);
+    ssh_sessions.reset(std::move(new_session));
 
+    std::lock_guard lock{state_mutex};
     state = State::running;
     handle_state_update();
 }
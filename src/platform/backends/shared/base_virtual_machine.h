@@ -23,6 +23,7 @@
 #include <multipass/ip_address.h>
 #include <multipass/path.h>
 #include <multipass/ssh/ssh_session.h>
+#include <multipass/ssh/ssh_session_pool.h>
 #include <multipass/utils.h>
 #include <multipass/virtual_machine.h>
 #include <multipass/virtual_machine_description.h>
@@ -31,6 +32,7 @@
 #include <mutex>
 #include <optional>
 #include <unordered_map>
+#include <vector>
 
 namespace multipass
 {
@@ -68,6 +70,30 @@ public:
     {
         throw NotImplementedOnThisBackendException("networks");
     }
+    void set_network_multiqueue(bool) override
+    {
+        throw NotImplementedOnThisBackendException("multiqueue networking");
+    }
+    void set_disk_profile(const std::string&) override
+    {
+        throw NotImplementedOnThisBackendException("disk profiles");
+    }
+    void set_memory_backing(const MemoryBacking&) override
+    {
+        throw NotImplementedOnThisBackendException("memory backing options");
+    }
+    void set_cpu_affinity(const CpuAffinity&) override
+    {
+        throw NotImplementedOnThisBackendException("CPU affinity");
+    }
+    MemoryBalloon memory_balloon() override
+    {
+        throw NotImplementedOnThisBackendException("memory ballooning");
+    }
+    void set_memory_balloon_target(const MemorySize&) override
+    {
+        throw NotImplementedOnThisBackendException("memory ballooning");
+    }
     std::unique_ptr<MountHandler> make_native_mount_handler(const std::string&,
                                                             const VMMount&) override
     {
@@ -87,6 +113,11 @@ public:
     std::shared_ptr<const Snapshot> take_snapshot(const VMSpecs& specs,
                                                   const std::string& snapshot_name,
                                                   const std::string& comment) override;
+    std::shared_ptr<const Snapshot> take_live_snapshot(
+        const VMSpecs& specs,
+        const std::string& snapshot_name,
+        const std::string& comment,
+        std::chrono::microseconds& pause_duration) override;
     void rename_snapshot(const std::string& old_name, const std::string& new_name) override;
     void delete_snapshot(const std::string& name) override;
     void restore_snapshot(const std::string& name, VMSpecs& specs) override;
@@ -106,6 +137,10 @@ protected:
                                                              const VMSpecs& specs,
                                                              std::shared_ptr<Snapshot> parent);
 
+    std::shared_ptr<const Snapshot> take_snapshot_impl(const VMSpecs& specs,
+                                                       const std::string& snapshot_name,
+                                                       const std::string& comment);
+
     virtual void drop_ssh_session(); // virtual to allow mocking
 
     // TODO@rewiressh make SSHSession mockable instead and use it in tests
@@ -126,6 +161,7 @@ protected:
     virtual void refresh_start();
 
     void renew_ssh_session();
+    std::unique_ptr<SSHSession> connect_ssh_session();
     void detect_aborted_start();
     void save_error_msg(std::string error) noexcept;
     IPAddress require_management_ipv4();
@@ -143,6 +179,8 @@ protected:
 
 private:
     using SnapshotMap = std::unordered_map<std::string, std::shared_ptr<Snapshot>>;
+    using SnapshotIndexMap = std::unordered_map<int, std::shared_ptr<Snapshot>>;
+    using SnapshotChildrenMap = std::unordered_map<const Snapshot*, std::vector<Snapshot*>>;
 
     template <typename LockT>
     void log_latest_snapshot(LockT lock) const;
@@ -150,6 +188,9 @@ private:
     void load_generic_snapshot_info();
     void load_snapshot(const QString& filename);
 
+    void link_snapshot(const std::shared_ptr<Snapshot>& snapshot);
+    void unlink_snapshot(const std::shared_ptr<Snapshot>& snapshot);
+
     auto make_take_snapshot_rollback(SnapshotMap::iterator it);
     void take_snapshot_rollback_helper(SnapshotMap::iterator it,
                                        std::shared_ptr<Snapshot>& old_head,
@@ -204,8 +245,10 @@ protected:
 
 private:
     std::string saved_error_msg = "";
-    std::unique_ptr<SSHSession> ssh_session = nullptr;
+    SSHSessionPool ssh_sessions{[this] { return connect_ssh_session(); }};
     SnapshotMap snapshots;
+    SnapshotIndexMap snapshots_by_index;
+    SnapshotChildrenMap snapshot_children; // keyed by parent, with nullptr for roots
     std::shared_ptr<Snapshot> head_snapshot = nullptr;
     int snapshot_count = 0; // tracks the number of snapshots ever taken (regardless of deletes)
     mutable std::recursive_mutex snapshot_mutex;
@@ -26,11 +26,17 @@
 #include <multipass/vm_specs.h>
 #include <multipass/yaml_node_utils.h>
 
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <numeric>
+
 namespace mp = multipass;
 namespace mpu = multipass::utils;
 
 const mp::Path mp::BaseVirtualMachineFactory::instances_subdir = "vault/instances";
 const std::unordered_set<std::string> cloneable_files{".iso", ".img", ".qcow2", ".raw", ".asif"};
+constexpr auto clone_progress_interval = std::chrono::milliseconds{250};
 
 mp::BaseVirtualMachineFactory::BaseVirtualMachineFactory(const Path& instances_dir,
                                                          AvailabilityZoneManager& az_manager)
@@ -97,12 +103,13 @@ mp::VirtualMachine::UPtr mp::BaseVirtualMachineFactory::clone_bare_vm(
     const std::string& dest_name,
     const VMImage& dest_image,
     const multipass::SSHKeyProvider& key_provider,
-    VMStatusMonitor& monitor)
+    VMStatusMonitor& monitor,
+    const ProgressMonitor& progress_monitor)
 {
     const std::filesystem::path src_instance_dir{get_instance_directory(src_name).toStdString()};
     const std::filesystem::path dest_instance_dir{get_instance_directory(dest_name).toStdString()};
 
-    copy_instance_dir_with_essential_files(src_instance_dir, dest_instance_dir);
+    copy_instance_dir_with_essential_files(src_instance_dir, dest_instance_dir, progress_monitor);
 
     const fs::path cloud_init_path = dest_instance_dir / cloud_init_file_name;
 
@@ -125,18 +132,26 @@ mp::VirtualMachine::UPtr mp::BaseVirtualMachineFactory::clone_bare_vm(
                                                {},
                                                {},
                                                {},
-                                               {}};
+                                               {},
+                                               dest_spec.network_multiqueue,
+                                               dest_spec.disk_profile,
+                                               dest_spec.memory_backing,
+                                               dest_spec.cpu_affinity};
 
     return clone_vm_impl(src_name, src_spec, dest_vm_desc, monitor, key_provider);
 }
 
 void mp::BaseVirtualMachineFactory::copy_instance_dir_with_essential_files(
     const fs::path& source_instance_dir_path,
-    const fs::path& dest_instance_dir_path)
+    const fs::path& dest_instance_dir_path,
+    const ProgressMonitor& progress_monitor)
 {
     assert(fs::exists(source_instance_dir_path) && fs::is_directory(source_instance_dir_path));
 
     fs::create_directory(dest_instance_dir_path);
+
+    std::vector<std::pair<fs::path, fs::path>> files;
+    std::uintmax_t total_bytes = 0;
     for (const auto& entry : fs::directory_iterator(source_instance_dir_path))
     {
         const auto ext = entry.path().extension().string();
@@ -144,7 +159,49 @@ void mp::BaseVirtualMachineFactory::copy_instance_dir_with_essential_files(
         if (cloneable_files.contains(ext))
         {
             const fs::path dest_file_path = dest_instance_dir_path / entry.path().filename();
-            fs::copy(entry.path(), dest_file_path, fs::copy_options::update_existing);
+            if (fs::exists(dest_file_path) &&
+                fs::last_write_time(dest_file_path) >= entry.last_write_time())
+                continue;
+
+            files.emplace_back(entry.path(), dest_file_path);
+            total_bytes += entry.file_size();
         }
     }
+
+    // Images are copied concurrently, each worker publishing how far it got; progress is reported
+    // from this thread only, since the monitor may write to the client stream
+    std::vector<std::atomic<std::uintmax_t>> copied_bytes(files.size());
+    std::vector<std::future<void>> copies;
+    for (std::size_t i = 0; i < files.size(); ++i)
+        copies.push_back(std::async(std::launch::async, [&files, &copied_bytes, i] {
+            MP_PLATFORM.clone_file(files[i].first,
+                                   files[i].second,
+                                   [&bytes = copied_bytes[i]](std::uintmax_t copied) {
+                                       bytes = copied;
+                                   });
+        }));
+
+    auto last_percentage = -1;
+    auto report_progress = [&] {
+        const auto copied = std::accumulate(copied_bytes.begin(),
+                                            copied_bytes.end(),
+                                            std::uintmax_t{0},
+                                            [](auto sum, const auto& bytes) { return sum + bytes; });
+        const auto percentage =
+            total_bytes ? static_cast<int>(std::min(copied * 100 / total_bytes, std::uintmax_t{100}))
+                        : 100;
+        if (progress_monitor && percentage != last_percentage)
+            progress_monitor(0, last_percentage = percentage);
+    };
+
+    for (auto& copy : copies)
+    {
+        while (copy.wait_for(clone_progress_interval) != std::future_status::ready)
+            report_progress();
+    }
+
+    for (auto& copy : copies)
+        copy.get();
+
+    report_progress();
 }
@@ -42,7 +42,8 @@ public:
                                        const std::string& dest_name,
                                        const VMImage& dest_image,
                                        const SSHKeyProvider& key_provider,
-                                       VMStatusMonitor& monitor) override final;
+                                       VMStatusMonitor& monitor,
+                                       const ProgressMonitor& progress_monitor) override final;
 
     void remove_resources_for(const std::string& name) final;
 
@@ -100,7 +101,8 @@ private:
                                                VMStatusMonitor& monitor,
                                                const SSHKeyProvider& key_provider);
     static void copy_instance_dir_with_essential_files(const fs::path& source_instance_dir_path,
-                                                       const fs::path& dest_instance_dir_path);
+                                                       const fs::path& dest_instance_dir_path,
+                                                       const ProgressMonitor& progress_monitor);
 
     Path instances_dir;
 };
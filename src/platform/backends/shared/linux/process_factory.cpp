@@ -52,6 +52,11 @@ public:
         });
     }
 
+    void reload_security_policy() override
+    {
+        apparmor.load_policy(process_spec->apparmor_profile().toLatin1());
+    }
+
     void setup_child_process() final
     {
         // This function runs after fork, but before exec, which is a perfect
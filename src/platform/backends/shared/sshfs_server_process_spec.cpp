@@ -63,6 +63,12 @@ QString mp::SSHFSServerProcessSpec::program() const
 
 QStringList mp::SSHFSServerProcessSpec::arguments() const
 {
+    if (config.multiplexed_sources)
+        return QStringList() << "--multiplex" << QString::fromStdString(config.host)
+                             << QString::number(config.port)
+                             << QString::fromStdString(config.username)
+                             << QString::number(static_cast<int>(mp::logging::get_logging_level()));
+
     return QStringList() << QString::fromStdString(config.host) << QString::number(config.port)
                          << QString::fromStdString(config.username)
                          << QString::fromStdString(config.source_path)
@@ -123,10 +129,8 @@ profile %1 flags=(attach_disconnected) {
     # CLASSIC ONLY: need to specify required libs from core snap
     /{,var/lib/snapd/}snap/core18/*/{,usr/}lib/@{multiarch}/{,**/}*.so* rm,
 
-    # allow full access just to this user-specified source directory on the host
-    %4/ rw,
-    %4/** rwlk,
-}
+    # allow full access just to the user-specified source directories on the host
+%4}
     )END");
 
     /* Customisations depending on if running inside snap or not */
@@ -147,13 +151,20 @@ profile %1 flags=(attach_disconnected) {
         signal_peer = "unconfined";
     }
 
-    return profile_template.arg(apparmor_profile_name(),
-                                signal_peer,
-                                root_dir,
-                                QString::fromStdString(config.source_path));
+    QString source_rules;
+    const auto sources = config.multiplexed_sources ? *config.multiplexed_sources
+                                                    : std::vector<std::string>{config.source_path};
+    for (const auto& source : sources)
+        source_rules +=
+            QString("    %1/ rw,\n    %1/** rwlk,\n").arg(QString::fromStdString(source));
+
+    return profile_template.arg(apparmor_profile_name(), signal_peer, root_dir, source_rules);
 }
 
 QString mp::SSHFSServerProcessSpec::identifier() const
 {
+    if (config.multiplexed_sources)
+        return QString::fromStdString(config.instance) + ".mounts";
+
     return QString::fromStdString(config.instance) + "." + target_hash;
 }
@@ -47,6 +47,8 @@
 #include "shared/sshfs_server_process_spec.h"
 #include <disabled_update_prompt.h>
 
+#include <scope_guard.hpp>
+
 #include <QCoreApplication>
 #include <QDir>
 #include <QFile>
@@ -54,13 +56,25 @@
 #include <QString>
 #include <QTextStream>
 
+#include <arpa/inet.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <linux/fs.h>
 #include <linux/if_arp.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
 #include <string.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <array>
+#include <cstring>
+#include <optional>
+#include <system_error>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpu = multipass::utils;
@@ -69,6 +83,8 @@ namespace
 {
 constexpr auto category = "Linux platform";
 constexpr auto br_nomenclature = "bridge";
+constexpr off_t clone_chunk_size = 64 * 1024 * 1024; // granularity of progress reports
+constexpr std::size_t bounce_buffer_size = 1024 * 1024;
 
 // Fetch the ARP protocol HARDWARE identifier.
 int get_net_type(const QDir& net_dir) // types defined in if_arp.h
@@ -183,6 +199,38 @@ std::string get_alias_script_path(const std::string& alias)
 
     return aliases_folder.absoluteFilePath(QString::fromStdString(alias)).toStdString();
 }
+
+[[noreturn]] void throw_clone_error(const char* what,
+                                    const std::filesystem::path& source,
+                                    const std::filesystem::path& dest)
+{
+    throw std::filesystem::filesystem_error{what,
+                                            source,
+                                            dest,
+                                            std::error_code{errno, std::system_category()}};
+}
+
+// Copies up to `length` bytes at `offset`, returning how many were copied (0 at end of file) or -1
+ssize_t copy_chunk(int in, int out, off_t offset, std::size_t length)
+{
+    loff_t in_offset = offset, out_offset = offset;
+    if (const auto copied = ::copy_file_range(in, &in_offset, out, &out_offset, length, 0);
+        copied >= 0 || (errno != EXDEV && errno != ENOSYS && errno != EOPNOTSUPP && errno != EINVAL))
+        return copied;
+
+    // Older kernels and some filesystem pairs cannot copy in-kernel, so bounce through userspace
+    std::vector<char> buffer(std::min(length, bounce_buffer_size));
+    const auto read = ::pread(in, buffer.data(), buffer.size(), offset);
+    for (ssize_t written = 0; written < read;)
+    {
+        const auto ret = ::pwrite(out, buffer.data() + written, read - written, offset + written);
+        if (ret < 0)
+            return ret;
+        written += ret;
+    }
+
+    return read;
+}
 } // namespace
 
 std::unique_ptr<QFile> multipass::platform::detail::find_os_release()
@@ -271,6 +319,64 @@ bool mp::platform::Platform::link(const char* target, const char* link) const
     return ::link(target, link) == 0;
 }
 
+void mp::platform::Platform::clone_file(
+    const std::filesystem::path& source,
+    const std::filesystem::path& dest,
+    const std::function<void(std::uintmax_t)>& on_progress) const
+{
+    const auto in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+        throw_clone_error("Cannot open clone source", source, dest);
+    auto close_in = sg::make_scope_guard([in]() noexcept { ::close(in); });
+
+    struct stat source_stat;
+    if (::fstat(in, &source_stat) < 0)
+        throw_clone_error("Cannot stat clone source", source, dest);
+
+    const auto out =
+        ::open(dest.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, source_stat.st_mode & 07777);
+    if (out < 0)
+        throw_clone_error("Cannot open clone destination", source, dest);
+    auto close_out = sg::make_scope_guard([out]() noexcept { ::close(out); });
+
+    // Reflinks (btrfs, XFS, bcachefs...) share the extents, so no data is copied at all
+    if (::ioctl(out, FICLONE, in) == 0)
+    {
+        on_progress(source_stat.st_size);
+        return;
+    }
+
+    // Otherwise, copy only the allocated extents; sizing the file up front leaves holes in place
+    if (::ftruncate(out, source_stat.st_size) < 0)
+        throw_clone_error("Cannot resize clone destination", source, dest);
+
+    for (off_t pos = 0; pos < source_stat.st_size;)
+    {
+        const auto data = ::lseek(in, pos, SEEK_DATA);
+        if (data < 0 && errno == ENXIO) // nothing but a hole until the end
+            break;
+        if (data < 0)
+            throw_clone_error("Cannot find data in clone source", source, dest);
+
+        const auto hole = ::lseek(in, data, SEEK_HOLE);
+        if (hole < 0)
+            throw_clone_error("Cannot find hole in clone source", source, dest);
+
+        for (pos = data; pos < hole; on_progress(pos))
+        {
+            const auto copied = copy_chunk(in, out, pos, std::min(hole - pos, clone_chunk_size));
+            if (copied < 0)
+                throw_clone_error("Cannot copy clone data", source, dest);
+            if (copied == 0) // the source shrank under us
+                return;
+
+            pos += copied;
+        }
+    }
+
+    on_progress(source_stat.st_size);
+}
+
 QDir mp::platform::Platform::get_alias_scripts_folder() const
 {
     QDir aliases_folder;
@@ -354,36 +460,57 @@ std::string mp::platform::Platform::bridge_nomenclature() const
     return br_nomenclature;
 }
 
-// validation of the ip and cidr happen later, otherwise this regex would be massive.
-const QRegularExpression subnet_regex(
-    R"(((?:[0-9][0-9]?[0-9]?\.){3}[0-9][0-9]?[0-9]?\/[0-9][0-9]?))");
-
-bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet) const
+mp::SubnetOverlapIndex mp::platform::Platform::local_subnets() const
+try
 {
-    const auto output =
-        QString::fromStdString(MP_UTILS.run_cmd_for_output("ip", {"-4", "route", "show"}));
-
-    QRegularExpressionMatchIterator i = subnet_regex.globalMatch(output);
+    const int fd = ::socket(AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE);
+    if (fd < 0)
+        throw std::system_error{errno, std::generic_category(), "could not open netlink socket"};
+    auto close_fd = sg::make_scope_guard([fd]() noexcept { ::close(fd); });
 
-    while (i.hasNext())
+    // Dump the whole IPv4 routing table in one go
+    struct
     {
-        QRegularExpressionMatch match = i.next();
+        nlmsghdr header;
+        rtmsg route;
+    } request{};
+    request.header.nlmsg_len = NLMSG_LENGTH(sizeof(rtmsg));
+    request.header.nlmsg_type = RTM_GETROUTE;
+    request.header.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+    request.route.rtm_family = AF_INET;
+
+    if (::send(fd, &request, request.header.nlmsg_len, 0) < 0)
+        throw std::system_error{errno, std::generic_category(), "could not request routes"};
+
+    std::vector<mp::Subnet> subnets;
+    alignas(nlmsghdr) std::array<char, 32768> buffer;
+    for (auto done = false; !done;)
+    {
+        const auto received = ::recv(fd, buffer.data(), buffer.size(), 0);
+        if (received < 0 && errno == EINTR)
+            continue;
+        if (received < 0)
+            throw std::system_error{errno, std::generic_category(), "could not read routes"};
+        if (received == 0)
+            break;
+
+        done = detail::collect_routed_subnets({buffer.data(), static_cast<size_t>(received)},
+                                              subnets);
+    }
 
-        try
-        {
-            mp::Subnet found_net{match.captured(1).toStdString()};
+    return SubnetOverlapIndex{subnets};
+}
+catch (const std::exception& e)
+{
+    mpl::warn(category, "Could not read the host's routes: {}", e.what());
+    return {};
+}
 
-            // check for overlap
-            if (found_net.contains(subnet) || subnet.contains(found_net))
-            {
-                return true;
-            }
-        }
-        catch (const std::exception& e)
-        {
-            mpl::warn(category, "invalid subnet from ip command: {}", e.what());
-        }
-    }
+bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet,
+                                                 const SubnetOverlapIndex& local_subnets) const
+{
+    if (local_subnets.overlaps(subnet))
+        return true;
 
     auto can_reach_gateway = [](mp::IPAddress ip) {
         const auto ipstr = ip.as_string();
@@ -401,9 +528,69 @@ mp::Subnet mp::platform::Platform::get_preferred_subnet(const std::filesystem::p
     // when migrated into zone1.
     if (auto filedata = MP_FILEOPS.try_read_file(data_dir / "network/multipass_subnet"))
         return {IPAddress{*filedata + ".0"}, 16};
+
+    // Otherwise, skip defaults that the host routes elsewhere as a whole (e.g. through a VPN), as
+    // no zone subnet could be allocated from them.
+    const auto routed = local_subnets();
+    for (const auto* candidate : {"10.97.0.0/16", "172.27.0.0/16", "192.168.96.0/19"})
+    {
+        if (mp::Subnet subnet{candidate}; !routed.covers(subnet))
+            return subnet;
+    }
+
     return {"10.97.0.0/16"};
 }
 
+bool mp::platform::detail::collect_routed_subnets(std::span<const char> messages,
+                                                  std::vector<Subnet>& subnets)
+{
+    auto remaining = static_cast<int>(messages.size());
+    for (auto header = reinterpret_cast<const nlmsghdr*>(messages.data());
+         NLMSG_OK(header, remaining);
+         header = NLMSG_NEXT(header, remaining))
+    {
+        if (header->nlmsg_type == NLMSG_DONE)
+            return true;
+
+        if (header->nlmsg_type == NLMSG_ERROR)
+        {
+            const auto* error = static_cast<const nlmsgerr*>(NLMSG_DATA(header));
+            throw std::system_error{-error->error, std::generic_category(), "route dump failed"};
+        }
+
+        if (header->nlmsg_type != RTM_NEWROUTE)
+            continue;
+
+        // Like `ip -4 route show`, only consider the main table, and leave out the default route.
+        // Host routes (/31 and /32) can't be represented as subnets, nor clash with ours.
+        const auto* route = static_cast<const rtmsg*>(NLMSG_DATA(header));
+        if (route->rtm_family != AF_INET || route->rtm_dst_len == 0 || route->rtm_dst_len >= 31)
+            continue;
+
+        uint32_t table = route->rtm_table;
+        std::optional<uint32_t> destination;
+        auto attributes_length = static_cast<int>(RTM_PAYLOAD(header));
+        for (auto attribute = RTM_RTA(route); RTA_OK(attribute, attributes_length);
+             attribute = RTA_NEXT(attribute, attributes_length))
+        {
+            if (RTA_PAYLOAD(attribute) != sizeof(uint32_t))
+                continue;
+
+            uint32_t value;
+            std::memcpy(&value, RTA_DATA(attribute), sizeof(value));
+            if (attribute->rta_type == RTA_TABLE)
+                table = value;
+            else if (attribute->rta_type == RTA_DST)
+                destination = ntohl(value);
+        }
+
+        if (table == RT_TABLE_MAIN && destination)
+            subnets.emplace_back(mp::IPAddress{*destination}, route->rtm_dst_len);
+    }
+
+    return false;
+}
+
 auto mp::platform::detail::get_network_interfaces_from(const QDir& sys_dir)
     -> std::map<std::string, NetworkInterfaceInfo>
 {
@@ -18,9 +18,12 @@
 #pragma once
 
 #include <multipass/network_interface_info.h>
+#include <multipass/subnet.h>
 
 #include <map>
 #include <memory>
+#include <span>
+#include <vector>
 
 #include <QDir>
 #include <QString>
@@ -32,4 +35,6 @@ std::map<std::string, NetworkInterfaceInfo> get_network_interfaces_from(const QD
 std::unique_ptr<QFile> find_os_release();
 std::pair<QString, QString> parse_os_release(const QStringList& os_data);
 std::string read_os_release();
+// Add the subnets routed by a chunk of an RTM_GETROUTE dump. Returns whether the dump is complete.
+bool collect_routed_subnets(std::span<const char> messages, std::vector<Subnet>& subnets);
 } // namespace multipass::platform::detail
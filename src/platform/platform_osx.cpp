@@ -58,6 +58,7 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/clonefile.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -275,7 +276,14 @@ std::string mp::platform::Platform::bridge_nomenclature() const
     return br_nomenclature;
 }
 
-bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet) const
+mp::SubnetOverlapIndex mp::platform::Platform::local_subnets() const
+{
+    // No route snapshot on macOS yet; candidates are probed by reaching their gateways instead
+    return {};
+}
+
+bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet,
+                                                 const SubnetOverlapIndex& local_subnets) const
 {
     // NOTE: In Multipass 1.16 and earlier on macOS, we statically define the (single) subnet to
     // use, and unlike on Linux, don't store that value anywhere in our configuration. As a result,
@@ -288,7 +296,9 @@ bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet) const
     if (subnet.address() == preferred_subnet.address())
         return false;
 
-    // ip routes?
+    if (local_subnets.overlaps(subnet))
+        return true;
+
     auto can_reach_gateway = [](mp::IPAddress ip) {
         const auto ipstr = ip.as_string();
         return MP_UTILS.run_cmd_for_status("ping",
@@ -378,6 +388,19 @@ bool mp::platform::Platform::link(const char* target, const char* link) const
     return ::link(target, link) == 0;
 }
 
+void mp::platform::Platform::clone_file(
+    const std::filesystem::path& source,
+    const std::filesystem::path& dest,
+    const std::function<void(std::uintmax_t)>& on_progress) const
+{
+    // APFS clones share the blocks with the source; clonefile refuses to overwrite, so fall back
+    // to a regular copy when the destination is already there or the volume cannot clone
+    if (::clonefile(source.c_str(), dest.c_str(), 0) != 0)
+        std::filesystem::copy_file(source, dest, std::filesystem::copy_options::overwrite_existing);
+
+    on_progress(std::filesystem::file_size(dest));
+}
+
 QDir mp::platform::Platform::get_alias_scripts_folder() const
 {
     QDir aliases_folder;
@@ -884,21 +884,23 @@ std::string mp::platform::Platform::bridge_nomenclature() const
     return "switch";
 }
 
-bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet) const
+mp::SubnetOverlapIndex mp::platform::Platform::local_subnets() const
 {
+    std::vector<Subnet> subnets;
     auto adapters = get_adapters_addresses(AF_INET, GAA_FLAG_INCLUDE_ALL_INTERFACES);
     for (auto pitr = adapters.get(); pitr; pitr = pitr->Next)
     {
         const auto& adapter = *pitr;
-        auto addrs = unicast_addrs_to_net_addrs(adapter.FirstUnicastAddress);
-        for (const auto& addr : addrs)
-        {
-            const Subnet found_net{addr};
-            if (found_net.contains(subnet) || subnet.contains(found_net))
-                return true;
-        }
+        for (const auto& addr : unicast_addrs_to_net_addrs(adapter.FirstUnicastAddress))
+            subnets.emplace_back(addr);
     }
-    return false;
+    return SubnetOverlapIndex{subnets};
+}
+
+bool mp::platform::Platform::subnet_used_locally(mp::Subnet subnet,
+                                                 const SubnetOverlapIndex& local_subnets) const
+{
+    return local_subnets.overlaps(subnet);
 }
 
 mp::Subnet mp::platform::Platform::get_preferred_subnet(const std::filesystem::path& data_dir) const
@@ -1149,6 +1151,15 @@ bool mp::platform::Platform::link(const char* target, const char* link) const
     return CreateHardLink(link, target, nullptr);
 }
 
+void mp::platform::Platform::clone_file(
+    const std::filesystem::path& source,
+    const std::filesystem::path& dest,
+    const std::function<void(std::uintmax_t)>& on_progress) const
+{
+    std::filesystem::copy_file(source, dest, std::filesystem::copy_options::overwrite_existing);
+    on_progress(std::filesystem::file_size(dest));
+}
+
 int mp::platform::Platform::utime(const char* path, int atime, int mtime) const
 {
     DWORD ret = NO_ERROR;
@@ -0,0 +1,276 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/ssh/ssh_session_pool.h>
+
+#include <multipass/logging/log.h>
+#include <multipass/top_catch_all.h>
+
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "ssh session pool";
+
+class PooledSSHProcess : public mp::SSHProcess
+{
+public:
+    PooledSSHProcess(std::unique_ptr<mp::SSHSession> session,
+                     std::unique_ptr<mp::SSHProcess> process)
+        : session{std::move(session)}, process{std::move(process)}
+    {
+    }
+
+    bool exit_recognized(std::chrono::milliseconds timeout) override
+    {
+        return process->exit_recognized(timeout);
+    }
+
+    int exit_code(std::chrono::milliseconds timeout) override
+    {
+        return process->exit_code(timeout);
+    }
+
+    std::string read_std_output() override
+    {
+        return process->read_std_output();
+    }
+
+    std::string read_std_error() override
+    {
+        return process->read_std_error();
+    }
+
+    const std::string& get_cmd() const override
+    {
+        return process->get_cmd();
+    }
+
+private:
+    std::unique_ptr<mp::SSHSession> session; // declared first, so that it outlives the process
+    std::unique_ptr<mp::SSHProcess> process;
+};
+} // namespace
+
+class mp::SSHSessionPool::Lease : public SSHSession
+{
+public:
+    Lease(std::unique_ptr<SSHSession> session,
+          std::weak_ptr<State> pool,
+          std::uint64_t generation)
+        : session{std::move(session)}, pool{std::move(pool)}, generation{generation}
+    {
+    }
+
+    ~Lease() override
+    {
+        top_catch_all(category, [this] {
+            if (auto state = pool.lock())
+                state->release(std::move(session), generation);
+        });
+    }
+
+    std::unique_ptr<SSHProcess> exec(const std::string& cmd, bool whisper) override
+    {
+        return session->exec(cmd, whisper);
+    }
+
+    bool is_connected() const override
+    {
+        return session->is_connected();
+    }
+
+    bool is_moved() const override
+    {
+        return session->is_moved();
+    }
+
+    operator ssh_session() override
+    {
+        return *session;
+    }
+
+    void force_shutdown() override
+    {
+        session->force_shutdown();
+    }
+
+private:
+    std::unique_ptr<SSHSession> session;
+    std::weak_ptr<State> pool;
+    std::uint64_t generation;
+};
+
+mp::SSHSessionPool::SSHSessionPool(Connect connect,
+                                   std::size_t max_sessions,
+                                   std::chrono::milliseconds max_idle)
+    : connect{std::move(connect)},
+      max_sessions{std::max<std::size_t>(max_sessions, 1)},
+      state{std::make_shared<State>()}
+{
+    state->max_idle = max_idle;
+}
+
+mp::SSHSessionPool::~SSHSessionPool() = default;
+
+std::unique_ptr<mp::SSHSession> mp::SSHSessionPool::acquire()
+{
+    std::vector<Entry> dropped; // destroyed after unlocking, since disconnecting may take a while
+    std::unique_lock lock{state->mutex};
+
+    while (true)
+    {
+        std::ranges::move(state->evict_idle(), std::back_inserter(dropped));
+
+        while (!state->idle.empty())
+        {
+            auto entry = std::move(state->idle.back());
+            state->idle.pop_back();
+
+            if (entry.session->is_connected())
+            {
+                ++state->in_use;
+                return std::make_unique<Lease>(std::move(entry.session),
+                                               state,
+                                               state->generation);
+            }
+
+            mpl::debug(category, "Dropping disconnected SSH session");
+            dropped.push_back(std::move(entry));
+        }
+
+        if (state->in_use < max_sessions)
+        {
+            ++state->in_use;
+            const auto generation = state->generation;
+            lock.unlock();
+
+            try
+            {
+                mpl::trace(category, "Connecting new SSH session");
+                return std::make_unique<Lease>(connect(), state, generation);
+            }
+            catch (...)
+            {
+                lock.lock();
+                if (generation == state->generation)
+                    --state->in_use;
+
+                state->released.notify_one();
+                throw;
+            }
+        }
+
+        state->released.wait(lock);
+    }
+}
+
+std::unique_ptr<mp::SSHProcess> mp::SSHSessionPool::exec(const std::string& cmd, bool whisper)
+{
+    auto session = acquire();
+    auto process = session->exec(cmd, whisper);
+
+    return std::make_unique<PooledSSHProcess>(std::move(session), std::move(process));
+}
+
+void mp::SSHSessionPool::add(std::unique_ptr<SSHSession> session)
+{
+    std::lock_guard lock{state->mutex};
+    state->idle.push_back({std::move(session), std::chrono::steady_clock::now()});
+    state->released.notify_one();
+}
+
+void mp::SSHSessionPool::reset(std::unique_ptr<SSHSession> session)
+{
+    std::vector<Entry> dropped;
+    std::lock_guard lock{state->mutex};
+
+    dropped = std::exchange(state->idle, {});
+    state->in_use = 0;
+    ++state->generation;
+
+    if (session)
+        state->idle.push_back({std::move(session), std::chrono::steady_clock::now()});
+
+    state->released.notify_all();
+}
+
+bool mp::SSHSessionPool::healthy()
+{
+    std::vector<Entry> dropped;
+    std::lock_guard lock{state->mutex};
+
+    auto& idle = state->idle;
+    auto disconnected = std::stable_partition(idle.begin(), idle.end(), [](const Entry& entry) {
+        return entry.session->is_connected();
+    });
+
+    std::move(disconnected, idle.end(), std::back_inserter(dropped));
+    idle.erase(disconnected, idle.end());
+
+    return !idle.empty() || state->in_use > 0;
+}
+
+std::size_t mp::SSHSessionPool::size() const
+{
+    std::lock_guard lock{state->mutex};
+    return state->idle.size() + state->in_use;
+}
+
+void mp::SSHSessionPool::State::release(std::unique_ptr<SSHSession> session,
+                                        std::uint64_t session_generation)
+{
+    std::vector<Entry> dropped;
+    std::lock_guard lock{mutex};
+
+    if (session_generation != generation)
+    {
+        dropped.push_back({std::move(session), {}}); // the pool was reset meanwhile
+        return;
+    }
+
+    --in_use;
+    idle.push_back({std::move(session), std::chrono::steady_clock::now()});
+    dropped = evict_idle();
+    released.notify_one();
+}
+
+auto mp::SSHSessionPool::State::evict_idle() -> std::vector<Entry>
+{
+    std::vector<Entry> evicted;
+    if (idle.size() < 2)
+        return evicted;
+
+    // Keep the most recently used session around, whatever its age
+    const auto deadline = std::chrono::steady_clock::now() - max_idle;
+    auto fresh = std::find_if(idle.begin(), std::prev(idle.end()), [deadline](const Entry& entry) {
+        return entry.last_used > deadline;
+    });
+
+    std::move(idle.begin(), fresh, std::back_inserter(evicted));
+    idle.erase(idle.begin(), fresh);
+
+    if (!evicted.empty())
+        mpl::debug(category, "Evicting {} idle SSH session(s)", evicted.size());
+
+    return evicted;
+}
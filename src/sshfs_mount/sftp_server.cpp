@@ -296,7 +296,7 @@ constexpr bool follows_symlinks(uint8_t type)
 }
 } // namespace
 
-mp::SftpServer::SftpServer(std::unique_ptr<SSHSession>&& session,
+mp::SftpServer::SftpServer(std::shared_ptr<SSHSession> session,
                            const std::string& source,
                            const std::string& target,
                            const id_mappings& gid_mappings,
@@ -495,6 +495,8 @@ std::string mp::SftpServer::host_to_guest_path(const fs::path& host_path) const
 
 void mp::SftpServer::process_message(sftp_client_message msg)
 {
+    served_operations.fetch_add(1, std::memory_order_relaxed);
+
     int ret = 0;
     const auto type = MP_LIBSSH.sftp_client_message_get_type(msg);
     switch (type)
@@ -561,67 +563,84 @@ void mp::SftpServer::process_message(sftp_client_message msg)
 }
 
 void mp::SftpServer::run()
+{
+    while (serve_next())
+        ;
+}
+
+bool mp::SftpServer::serve_next()
 {
     using MsgUPtr = std::unique_ptr<sftp_client_message_struct, void (*)(sftp_client_message)>;
 
-    while (true)
+    MsgUPtr client_msg{MP_LIBSSH.sftp_get_client_message(sftp_server_session.get()),
+                       [](sftp_client_message m) { MP_LIBSSH.sftp_client_message_free(m); }};
+    auto msg = client_msg.get();
+    if (msg == nullptr)
     {
-        MsgUPtr client_msg{MP_LIBSSH.sftp_get_client_message(sftp_server_session.get()),
-                           [](sftp_client_message m) { MP_LIBSSH.sftp_client_message_free(m); }};
-        auto msg = client_msg.get();
-        if (msg == nullptr)
+        if (stop_invoked)
+            return false;
+
+        int status{0};
+        try
+        {
+            status = sshfs_process->exit_code(250ms);
+        }
+        catch (const mp::ExitlessSSHProcessException&) // should we limit this to
+                                                       // SSHProcessExitError?
         {
-            if (stop_invoked)
-                break;
+            status = 1;
+        }
 
-            int status{0};
-            try
-            {
-                status = sshfs_process->exit_code(250ms);
-            }
-            catch (const mp::ExitlessSSHProcessException&) // should we limit this to
-                                                           // SSHProcessExitError?
-            {
-                status = 1;
-            }
+        if (status != 0)
+        {
+            mpl::error(category,
+                       "sshfs in the instance appears to have exited unexpectedly.  Trying to "
+                       "recover.");
 
-            if (status != 0)
-            {
-                mpl::error(category,
-                           "sshfs in the instance appears to have exited unexpectedly.  Trying to "
-                           "recover.");
-
-                std::string mount_path = [this] {
-                    auto proc = ssh_session->exec(
-                        fmt::format("findmnt --source :{}  -o TARGET -n", source_path));
-                    return proc->read_std_output();
-                }();
-
-                if (!mount_path.empty())
-                {
-                    // TODO@sftp nodiscard
-                    (void)ssh_session->exec(fmt::format("sudo umount {}", mount_path));
-                }
-
-                sshfs_process = create_sshfs_process(*ssh_session,
-                                                     sshfs_exec_line,
-                                                     source_path.string(),
-                                                     target_path.generic_string());
-                sftp_server_session =
-                    make_sftp_session(*ssh_session,
-                                      static_cast<PlainSSHProcess*>(sshfs_process.get())
-                                          ->release_channel()); // TODO@rewiressh no cast
-
-                continue;
-            }
-            else
+            std::string mount_path = [this] {
+                auto proc = ssh_session->exec(
+                    fmt::format("findmnt --source :{}  -o TARGET -n", source_path));
+                return proc->read_std_output();
+            }();
+
+            if (!mount_path.empty())
             {
-                break;
+                // TODO@sftp nodiscard
+                (void)ssh_session->exec(fmt::format("sudo umount {}", mount_path));
             }
-        }
 
-        process_message(msg);
+            sshfs_process = create_sshfs_process(*ssh_session,
+                                                 sshfs_exec_line,
+                                                 source_path.string(),
+                                                 target_path.generic_string());
+            sftp_server_session =
+                make_sftp_session(*ssh_session,
+                                  static_cast<PlainSSHProcess*>(sshfs_process.get())
+                                      ->release_channel()); // TODO@rewiressh no cast
+
+            return true;
+        }
+        else
+        {
+            return false;
+        }
     }
+
+    process_message(msg);
+    return true;
+}
+
+bool mp::SftpServer::has_pending(std::chrono::milliseconds timeout) const
+{
+    // Anything but "no data yet" (i.e. data, EOF or an error) is for serve_next() to deal with
+    return MP_LIBSSH.ssh_channel_poll_timeout(sftp_server_session->channel,
+                                              static_cast<int>(timeout.count()),
+                                              0) != 0;
+}
+
+std::uint64_t mp::SftpServer::operations() const
+{
+    return served_operations.load(std::memory_order_relaxed);
 }
 
 void mp::SftpServer::stop()
@@ -23,6 +23,9 @@
 
 #include <libssh/sftp.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <memory>
 #include <unordered_map>
 
@@ -37,7 +40,7 @@ class SSHProcess;
 class SftpServer
 {
 public:
-    SftpServer(std::unique_ptr<SSHSession>&& ssh_session,
+    SftpServer(std::shared_ptr<SSHSession> ssh_session,
                const std::string& source,
                const std::string& target,
                const id_mappings& gid_mappings,
@@ -51,6 +54,14 @@ public:
     void run();
     void stop();
 
+    // Serve a single client request, blocking until one arrives. Returns false once the client
+    // is gone for good. This lets a caller interleave several servers sharing one SSH session.
+    bool serve_next();
+    // Whether the client channel has a request (or EOF) ready within the given timeout.
+    bool has_pending(std::chrono::milliseconds timeout) const;
+    // How many client requests have been handled so far. Safe to call from any thread.
+    std::uint64_t operations() const;
+
     using SSHSessionUptr = std::unique_ptr<ssh_session_struct, void (*)(ssh_session)>;
     using SftpSessionUptr = std::unique_ptr<sftp_session_struct, void (*)(sftp_session)>;
     using SSHFSProcUptr = std::unique_ptr<SSHProcess>;
@@ -93,7 +104,7 @@ private:
     template <typename T>
     T* get_handle(sftp_client_message msg);
 
-    std::unique_ptr<SSHSession> ssh_session;
+    std::shared_ptr<SSHSession> ssh_session;
     SSHFSProcUptr sshfs_process;
     SftpSessionUptr sftp_server_session;
     const std::filesystem::path source_path;
@@ -106,5 +117,6 @@ private:
     const int default_gid;
     const std::string sshfs_exec_line;
     bool stop_invoked{false};
+    std::atomic<std::uint64_t> served_operations{0};
 };
 } // namespace multipass
@@ -23,6 +23,7 @@
 #include <multipass/id_mappings.h>
 #include <multipass/logging/log.h>
 #include <multipass/logging/log_location.h>
+#include <multipass/ssh/libssh_wrapper.h>
 #include <multipass/ssh/plain_ssh_session.h>
 #include <multipass/top_catch_all.h>
 #include <multipass/utils.h>
@@ -32,6 +33,7 @@
 
 #include <QDir>
 #include <QString>
+#include <QStringList>
 
 #include <cassert>
 #include <iostream>
@@ -43,6 +45,7 @@ namespace mpu = multipass::utils;
 namespace
 {
 constexpr auto category = "sshfs mount";
+constexpr auto idle_poll_timeout = std::chrono::milliseconds{10};
 const std::string fuse_version_string{"FUSE library version"};
 const std::string ld_library_path_key{"LD_LIBRARY_PATH="};
 const std::string snap_path_key{"SNAP="};
@@ -122,7 +125,7 @@ auto get_sshfs_exec_and_options(mp::SSHSession& session)
     return sshfs_exec;
 }
 
-auto make_sftp_server(std::unique_ptr<mp::SSHSession>&& session,
+auto make_sftp_server(std::shared_ptr<mp::SSHSession> session,
                       const std::string& source,
                       const std::string& target,
                       const mp::id_mappings& gid_mappings,
@@ -151,7 +154,7 @@ auto make_sftp_server(std::unique_ptr<mp::SSHSession>&& session,
         mpu::set_owner_for(*session, leading, missing, default_uid, default_gid);
     }
 
-    return std::make_unique<mp::SftpServer>(std::move(session),
+    return std::make_unique<mp::SftpServer>(session,
                                             source,
                                             leading + missing,
                                             gid_mappings,
@@ -161,6 +164,18 @@ auto make_sftp_server(std::unique_ptr<mp::SSHSession>&& session,
                                             sshfs_exec_line);
 }
 
+// Block until something arrives on the session (for any channel) or the timeout expires
+void wait_for_activity(ssh_session session, std::chrono::milliseconds timeout)
+{
+    std::unique_ptr<ssh_event_struct, void (*)(ssh_event)> event{
+        MP_LIBSSH.ssh_event_new(),
+        [](ssh_event e) { MP_LIBSSH.ssh_event_free(e); }};
+
+    if (event && MP_LIBSSH.ssh_event_add_session(event.get(), session) == SSH_OK)
+        MP_LIBSSH.ssh_event_dopoll(event.get(), static_cast<int>(timeout.count()));
+    else
+        std::this_thread::sleep_for(timeout);
+}
 } // namespace
 
 mp::SshfsMount::SshfsMount(std::unique_ptr<SSHSession>&& session,
@@ -203,3 +218,209 @@ bool mp::SshfsMount::alive() const
 {
     return state.load(std::memory_order_acquire) != State::Stopped;
 }
+
+std::uint64_t mp::SshfsMount::operations() const
+{
+    return sftp_server->operations();
+}
+
+mp::SshfsMountMultiplexer::SshfsMountMultiplexer(std::unique_ptr<SSHSession>&& session,
+                                                 StoppedCallback on_stopped)
+    : session{std::move(session)}, on_stopped{std::move(on_stopped)}, loop_thread{[this] {
+          mp::top_catch_all(category, [this] { serve(); });
+          running.store(false, std::memory_order_release);
+      }}
+{
+}
+
+mp::SshfsMountMultiplexer::~SshfsMountMultiplexer()
+{
+    top_catch_all(category, [this] { stop(); });
+}
+
+void mp::SshfsMountMultiplexer::add(const std::string& id,
+                                    const std::string& source,
+                                    const std::string& target,
+                                    const mp::id_mappings& gid_mappings,
+                                    const mp::id_mappings& uid_mappings)
+{
+    run_in_loop<void>([&] {
+        if (sftp_servers.count(id))
+            throw std::runtime_error(fmt::format("mount '{}' is already being served", id));
+
+        sftp_servers.emplace(
+            id,
+            make_sftp_server(session, source, target, gid_mappings, uid_mappings));
+    });
+}
+
+bool mp::SshfsMountMultiplexer::remove(const std::string& id)
+{
+    // Dropping the server frees its channel; sshfs in the instance then exits and unmounts
+    return run_in_loop<bool>([&] { return sftp_servers.erase(id) > 0; });
+}
+
+void mp::SshfsMountMultiplexer::stop()
+{
+    {
+        std::lock_guard lock{tasks_mutex};
+        stopping = true;
+    }
+
+    if (loop_thread.joinable())
+        loop_thread.join();
+}
+
+bool mp::SshfsMountMultiplexer::alive() const
+{
+    return running.load(std::memory_order_acquire);
+}
+
+std::map<std::string, std::uint64_t> mp::SshfsMountMultiplexer::operations()
+{
+    return run_in_loop<std::map<std::string, std::uint64_t>>([this] {
+        std::map<std::string, std::uint64_t> operations;
+        for (const auto& [id, sftp_server] : sftp_servers)
+            operations.emplace(id, sftp_server->operations());
+        return operations;
+    });
+}
+
+template <typename T>
+T mp::SshfsMountMultiplexer::run_in_loop(std::function<T()> work)
+{
+    std::packaged_task<T()> task{std::move(work)};
+    auto result = task.get_future();
+
+    {
+        std::lock_guard lock{tasks_mutex};
+        if (stopping || !alive())
+            throw std::runtime_error("the sshfs multiplexer has stopped");
+
+        tasks.emplace_back([task = std::move(task)]() mutable { task(); });
+    }
+
+    // Tasks abandoned by a stopping loop are destroyed unrun, which breaks the promise
+    return result.get();
+}
+
+void mp::SshfsMountMultiplexer::serve()
+{
+    auto run_tasks = [this] {
+        std::deque<std::packaged_task<void()>> pending;
+        {
+            std::lock_guard lock{tasks_mutex};
+            if (stopping)
+                return false;
+            pending.swap(tasks);
+        }
+
+        for (auto& task : pending)
+            task();
+        return true;
+    };
+
+    auto drop = [this](auto it) {
+        auto id = it->first;
+        sftp_servers.erase(it);
+        on_stopped(id);
+    };
+
+    while (run_tasks() && session->is_connected())
+    {
+        auto served = false;
+        for (auto it = sftp_servers.begin(); it != sftp_servers.end();)
+        {
+            auto current = it++;
+            try
+            {
+                if (!current->second->has_pending(std::chrono::milliseconds::zero()))
+                    continue;
+
+                served = true;
+                if (!current->second->serve_next())
+                    drop(current);
+            }
+            catch (const std::exception& e)
+            {
+                mpl::error(category, "mount '{}' failed: {}", current->first, e.what());
+                drop(current);
+            }
+        }
+
+        if (!served)
+            wait_for_activity(*session, idle_poll_timeout);
+    }
+
+    // Servers must go away on this thread, as they still talk to libssh
+    sftp_servers.clear();
+
+    std::lock_guard lock{tasks_mutex};
+    stopping = true;
+    tasks.clear();
+}
+
+mp::id_mappings mp::parse_id_mappings(const std::string& mappings)
+{
+    mp::id_mappings ret_map;
+
+    auto maps = QString::fromStdString(mappings).split(',', Qt::SkipEmptyParts);
+    for (auto map : maps)
+    {
+        auto ids = map.split(":");
+        if (ids.count() != 2)
+        {
+            std::cerr << "Incorrect ID mapping syntax";
+            continue;
+        }
+
+        bool ok1, ok2;
+        int from = ids.first().toInt(&ok1);
+        int to = ids.last().toInt(&ok2);
+        if (!ok1 || !ok2)
+        {
+            std::cerr << "Incorrect ID mapping ids found, ignored" << std::endl;
+            continue;
+        }
+
+        ret_map.push_back({from, to});
+    }
+
+    return ret_map;
+}
+
+std::string mp::run_multiplexer_command(SshfsMountMultiplexer& multiplexer,
+                                        const std::string& command)
+{
+    const auto fields = QString::fromStdString(command).split('\t');
+    const auto id = fields.value(1).toStdString();
+
+    try
+    {
+        if (fields.first() == "add" && fields.size() == 6)
+        {
+            multiplexer.add(id,
+                            fields[2].toStdString(),
+                            fields[3].toStdString(),
+                            parse_id_mappings(fields[5].toStdString()),
+                            parse_id_mappings(fields[4].toStdString()));
+            return "added\t" + id;
+        }
+
+        if (fields.first() == "remove" && fields.size() == 2)
+        {
+            multiplexer.remove(id);
+            return "removed\t" + id;
+        }
+
+        return "failed\t" + id + "\tIncorrect command";
+    }
+    catch (const mp::SSHFSMissingError&)
+    {
+        return "missing\t" + id;
+    }
+    catch (const std::exception& e)
+    {
+        return "failed\t" + id + '\t' + e.what();
+    }
+}
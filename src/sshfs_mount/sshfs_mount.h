@@ -19,7 +19,15 @@
 
 #include <multipass/id_mappings.h>
 
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <string>
 #include <thread>
 
 namespace multipass
@@ -40,6 +48,8 @@ public:
     void stop();
 
     [[nodiscard]] bool alive() const;
+    // How many SFTP requests the mount has served
+    [[nodiscard]] std::uint64_t operations() const;
 
 private:
     enum class State
@@ -55,4 +65,52 @@ private:
     std::unique_ptr<SftpServer> sftp_server;
     std::thread sftp_thread;
 };
+
+// Serves any number of mounts for one instance over a single SSH session, one channel per mount.
+// All libssh work happens on a single thread, which interleaves requests from every channel.
+class SshfsMountMultiplexer
+{
+public:
+    using StoppedCallback = std::function<void(const std::string& id)>;
+
+    SshfsMountMultiplexer(std::unique_ptr<SSHSession>&& session, StoppedCallback on_stopped);
+    ~SshfsMountMultiplexer();
+
+    // Blocks until the mount is being served, rethrowing any error setting it up
+    void add(const std::string& id,
+             const std::string& source,
+             const std::string& target,
+             const id_mappings& gid_mappings,
+             const id_mappings& uid_mappings);
+    bool remove(const std::string& id);
+    void stop();
+
+    [[nodiscard]] bool alive() const;
+    // How many SFTP requests each mount being served has handled, by id
+    [[nodiscard]] std::map<std::string, std::uint64_t> operations();
+
+private:
+    void serve();
+    template <typename T>
+    T run_in_loop(std::function<T()> work);
+
+    std::shared_ptr<SSHSession> session;
+    StoppedCallback on_stopped;
+    std::map<std::string, std::unique_ptr<SftpServer>> sftp_servers; // only touched by the loop
+
+    std::mutex tasks_mutex;
+    std::deque<std::packaged_task<void()>> tasks;
+    bool stopping{false};
+    std::atomic<bool> running{true};
+    std::thread loop_thread;
+};
+
+// ID mappings as sshfs_server takes them: comma-separated "<host id>:<instance id>" pairs
+id_mappings parse_id_mappings(const std::string& mappings);
+
+// Runs one command of the multiplexed sshfs_server protocol, tab-separated
+//   add <id> <source> <target> <uid mappings> <gid mappings>
+//   remove <id>
+// and returns its reply: "added", "failed" (and why), "missing" or "removed", then the id
+std::string run_multiplexer_command(SshfsMountMultiplexer& multiplexer, const std::string& command);
 } // namespace multipass
@@ -17,6 +17,7 @@
 
 #include <multipass/exceptions/exitless_sshprocess_exceptions.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/ssh/ssh_session.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
@@ -25,6 +26,13 @@
 #include <QCoreApplication>
 #include <QEventLoop>
 #include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -33,6 +41,7 @@ namespace mpu = multipass::utils;
 namespace
 {
 constexpr auto category = "sshfs-mount-handler";
+constexpr auto process_wait_timeout = std::chrono::milliseconds{5000};
 
 void start_and_block_until_connected(mp::Process* process)
 {
@@ -57,6 +66,30 @@ void start_and_block_until_connected(mp::Process* process)
     QObject::disconnect(running_conn);
 }
 
+// Hands over each complete line in the buffer, split on tabs, leaving any partial line behind
+template <typename OnLine>
+void take_lines(QByteArray& buffer, OnLine&& on_line)
+{
+    for (auto end = buffer.indexOf('\n'); end >= 0; end = buffer.indexOf('\n'))
+    {
+        const auto fields = QString::fromUtf8(buffer.left(end)).split('\t');
+        buffer.remove(0, end + 1);
+        on_line(fields);
+    }
+}
+
+// sshfs_server reports how many SFTP requests a mount served since its previous report
+void count_sftp_operations(const std::string& instance,
+                           const std::string& target,
+                           const QString& count)
+{
+    mp::metrics::registry()
+        .counter("multipass_sftp_operations_total",
+                 "SFTP requests served for mounts",
+                 {{"instance", instance}, {"target", target}})
+        .increment(count.toULongLong());
+}
+
 bool has_sshfs(const std::string& name, mp::SSHSession& session)
 {
     // Check if snap support is installed in the instance
@@ -117,10 +150,249 @@ catch (const mp::ExitlessSSHProcessException& e)
 
 namespace multipass
 {
+// One sshfs_server per instance, serving every multiplexed mount of it over a single SSH session.
+// Mounts are added and removed through line-based commands on the server's stdin.
+class SharedSSHFSServer
+{
+public:
+    static std::shared_ptr<SharedSSHFSServer> for_instance(const SSHFSServerConfig& config)
+    {
+        static std::mutex registry_mutex;
+        static std::map<std::string, std::weak_ptr<SharedSSHFSServer>> registry;
+
+        std::lock_guard lock{registry_mutex};
+        if (auto server = registry[config.instance].lock(); server && server->process->running())
+            return server;
+
+        auto server = std::make_shared<SharedSSHFSServer>(config);
+        registry[config.instance] = server;
+        return server;
+    }
+
+    explicit SharedSSHFSServer(SSHFSServerConfig server_config)
+        : sources{std::make_shared<std::vector<std::string>>()}, instance{server_config.instance}
+    {
+        server_config.multiplexed_sources = sources;
+        process.reset(platform::make_sshfs_server_process(server_config).release());
+
+        QObject::connect(process.get(), &Process::finished, [this](const ProcessState& state) {
+            if (state.completed_successfully())
+                mpl::info(category, "Mount server for instance '{}' has stopped", instance);
+            else
+                mpl::warn(category,
+                          "Mount server for instance '{}' has stopped unsuccessfully: {}",
+                          instance,
+                          state.failure_message());
+        });
+
+        mpl::info(category, "process program '{}'", process->program());
+        mpl::info(category, "process arguments '{}'", process->arguments().join(", "));
+
+        start_and_block_until_connected(process.get());
+        // See SSHFSMountHandler::activate_impl() for why the process is moved to the main thread
+        process->moveToThread(QCoreApplication::instance()->thread());
+
+        if (const auto state = process->process_state(); state.exit_code || state.error)
+            throw std::runtime_error(fmt::format("{}: {}",
+                                                 state.failure_message(),
+                                                 process->read_all_standard_error()));
+
+        QObject::connect(process.get(),
+                         &Process::ready_read_standard_output,
+                         process.get(),
+                         [this] { read_replies(); });
+    }
+
+    ~SharedSSHFSServer()
+    {
+        mpl::info(category, "Stopping mount server for instance '{}'", instance);
+        if (process->terminate(); !process->wait_for_finished(process_wait_timeout.count()))
+        {
+            process->kill();
+            process->wait_for_finished(process_wait_timeout.count());
+        }
+
+        // The process is only deleted later, but its handlers use members that go away with us
+        QObject::disconnect(process.get(), nullptr, nullptr, nullptr);
+    }
+
+    std::string add(const SSHFSServerConfig& mount, std::chrono::milliseconds timeout)
+    {
+        std::lock_guard lock{request_mutex};
+        const auto id = std::to_string(++last_id);
+
+        try
+        {
+            // The server needs to be allowed into the source before it starts serving it
+            sources->push_back(mount.source_path);
+            process->reload_security_policy();
+
+            {
+                std::lock_guard lock{reply_mutex};
+                targets[QString::fromStdString(id)] = mount.target_path;
+            }
+
+            const auto reply = request({"add",
+                                        QString::fromStdString(id),
+                                        QString::fromStdString(mount.source_path),
+                                        QString::fromStdString(mount.target_path),
+                                        serialise(mount.uid_mappings),
+                                        serialise(mount.gid_mappings)},
+                                       timeout);
+
+            if (reply.first() == "missing")
+                throw SSHFSMissingError();
+            if (reply.first() != "added")
+                throw std::runtime_error(reply.value(2).toStdString());
+        }
+        catch (...)
+        {
+            drop_source(mount.source_path);
+            drop_target(id);
+            throw;
+        }
+
+        return id;
+    }
+
+    void remove(const std::string& id,
+                const std::string& source_path,
+                std::chrono::milliseconds timeout)
+    {
+        std::lock_guard lock{request_mutex};
+        request({"remove", QString::fromStdString(id)}, timeout);
+        drop_source(source_path);
+        drop_target(id);
+    }
+
+private:
+    static QString serialise(const id_mappings& xid_mappings)
+    {
+        QString out;
+        for (auto ids : xid_mappings)
+            out += QString("%1:%2,").arg(ids.first).arg(ids.second);
+        return out;
+    }
+
+    void drop_source(const std::string& source_path)
+    {
+        if (auto it = std::find(sources->begin(), sources->end(), source_path);
+            it != sources->end())
+            sources->erase(it);
+
+        process->reload_security_policy();
+    }
+
+    void drop_target(const std::string& id)
+    {
+        std::lock_guard lock{reply_mutex};
+        targets.erase(QString::fromStdString(id));
+    }
+
+    // Sends one command and waits for its reply; callers hold request_mutex
+    QStringList request(const QStringList& command, std::chrono::milliseconds timeout)
+    {
+        for (const auto& field : command)
+            if (field.contains('\t') || field.contains('\n'))
+                throw std::runtime_error(
+                    fmt::format("Cannot share \"{}\" through a multiplexed mount", field));
+
+        auto reply = [this, &command] {
+            std::lock_guard lock{reply_mutex};
+            pending_id = command.value(1);
+            pending_reply.emplace();
+            return pending_reply->get_future();
+        }();
+
+        auto line = command.join('\t').toUtf8() + '\n';
+        auto is_ready = [&reply] {
+            return reply.wait_for(std::chrono::seconds::zero()) == std::future_status::ready;
+        };
+
+        if (QThread::currentThread() == process->thread())
+        {
+            // The replies are read on this thread, so keep its events flowing while waiting
+            QEventLoop event_loop;
+            QTimer::singleShot(timeout, &event_loop, &QEventLoop::quit);
+            QObject::connect(process.get(), &Process::finished, &event_loop, &QEventLoop::quit);
+            QObject::connect(process.get(),
+                             &Process::ready_read_standard_output,
+                             &event_loop,
+                             [&event_loop, &is_ready] {
+                                 if (is_ready())
+                                     event_loop.quit();
+                             });
+
+            process->write(line);
+            if (!is_ready())
+                event_loop.exec();
+        }
+        else
+        {
+            QMetaObject::invokeMethod(
+                process.get(),
+                [process = process.get(), line] { process->write(line); },
+                Qt::QueuedConnection);
+            reply.wait_for(timeout);
+        }
+
+        if (!is_ready())
+        {
+            std::lock_guard lock{reply_mutex};
+            pending_reply.reset();
+            throw std::runtime_error(fmt::format("Mount server for instance '{}' did not answer",
+                                                 instance));
+        }
+
+        return reply.get();
+    }
+
+    void read_replies()
+    {
+        partial_replies += process->read_all_standard_output();
+
+        take_lines(partial_replies, [this](const QStringList& fields) {
+            if (fields.first() == "stopped")
+            {
+                mpl::warn(category,
+                          "Mount {} in instance '{}' has stopped",
+                          fields.value(1),
+                          instance);
+                return;
+            }
+
+            std::lock_guard lock{reply_mutex};
+            if (fields.first() == "operations")
+            {
+                if (const auto it = targets.find(fields.value(1)); it != targets.end())
+                    count_sftp_operations(instance, it->second, fields.value(2));
+            }
+            else if (pending_reply && fields.size() > 1 && fields[1] == pending_id)
+            {
+                pending_reply->set_value(fields);
+                pending_reply.reset();
+            }
+        });
+    }
+
+    std::mutex request_mutex; // one command in flight at a time
+    std::shared_ptr<std::vector<std::string>> sources;
+    int last_id{0};
+    const std::string instance;
+    qt_delete_later_unique_ptr<Process> process;
+    QByteArray partial_replies; // only touched from the process' thread
+
+    std::mutex reply_mutex;
+    QString pending_id;
+    std::optional<std::promise<QStringList>> pending_reply;
+    std::map<QString, std::string> targets; // of the mounts being served, by id
+};
+
 SSHFSMountHandler::SSHFSMountHandler(VirtualMachine* vm,
                                      const SSHKeyProvider* ssh_key_provider,
                                      const std::string& target,
-                                     VMMount mount_spec)
+                                     VMMount mount_spec,
+                                     bool multiplexed)
     : MountHandler{vm, ssh_key_provider, std::move(mount_spec), target},
       process{nullptr},
       config{"",
@@ -131,7 +403,8 @@ SSHFSMountHandler::SSHFSMountHandler(VirtualMachine* vm,
              source,
              target,
              this->mount_spec.get_gid_mappings(),
-             this->mount_spec.get_uid_mappings()}
+             this->mount_spec.get_uid_mappings()},
+      multiplexed{multiplexed}
 {
     mpl::info(category,
               "initializing mount {} => {} in '{}'",
@@ -161,6 +434,14 @@ void SSHFSMountHandler::activate_impl(ServerVariant server, std::chrono::millise
     config.host = vm->ssh_hostname();
     config.port = vm->ssh_port();
 
+    if (multiplexed)
+    {
+        auto server = SharedSSHFSServer::for_instance(config);
+        mount_id = server->add(config, timeout);
+        shared_server = std::move(server);
+        return;
+    }
+
     process.reset(platform::make_sshfs_server_process(config).release());
 
     QObject::connect(process.get(), &Process::finished, [this](const ProcessState& exit_state) {
@@ -208,6 +489,17 @@ void SSHFSMountHandler::activate_impl(ServerVariant server, std::chrono::millise
     // So, for any future travelers, this^ is the main reason why we use qt_delete_later_unique_ptr
     // thingy.
 
+    QObject::connect(process.get(),
+                     &Process::ready_read_standard_output,
+                     process.get(),
+                     [this, partial_lines = QByteArray{}]() mutable {
+                         partial_lines += process->read_all_standard_output();
+                         take_lines(partial_lines, [this](const QStringList& fields) {
+                             if (fields.first() == "operations")
+                                 count_sftp_operations(vm->get_name(), target, fields.value(1));
+                         });
+                     });
+
     // Check in case sshfs_server stopped, usually due to an error
     const auto process_state = process->process_state();
     if (process_state.exit_code == 9) // Magic number returned by sshfs_server
@@ -221,9 +513,32 @@ void SSHFSMountHandler::activate_impl(ServerVariant server, std::chrono::millise
 void SSHFSMountHandler::deactivate_impl(bool force)
 {
     mpl::info(category, "Stopping mount \"{}\" in instance '{}'", target, vm->get_name());
+
+    if (shared_server)
+    {
+        try
+        {
+            shared_server->remove(mount_id, config.source_path, process_wait_timeout);
+        }
+        catch (const std::exception& e)
+        {
+            if (!force)
+                throw;
+
+            mpl::warn(category,
+                      "Failed to stop mount \"{}\" in instance '{}': {}",
+                      target,
+                      vm->get_name(),
+                      e.what());
+        }
+
+        // The last mount going away stops the shared server
+        shared_server.reset();
+        return;
+    }
+
     QObject::disconnect(process.get(), &Process::error_occurred, nullptr, nullptr);
 
-    constexpr auto process_wait_timeout = std::chrono::milliseconds{5000};
     if (process->terminate(); !process->wait_for_finished(process_wait_timeout.count()))
     {
         auto fetch_stderr = [](Process& process) {
@@ -28,11 +28,14 @@
 
 #include <ssh/ssh_client_key_provider.h>
 
-#include <QStringList>
-
+#include <atomic>
+#include <cstdint>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
 
 namespace mp = multipass;
 namespace mpl = multipass::logging;
@@ -41,34 +44,108 @@ using namespace std;
 
 namespace
 {
-mp::id_mappings convert_id_mappings(const char* in)
+std::unique_ptr<mpl::MultiplexingLogger> make_standard_logger(mpl::Level log_level)
+{
+    auto logger = mpp::make_logger(log_level);
+    if (!logger)
+        logger = std::make_unique<mpl::StandardLogger>(log_level);
+
+    // Use the MultiplexingLogger as we may end up routing messages to the daemon too at some point
+    return std::make_unique<mpl::MultiplexingLogger>(std::move(logger));
+}
+
+// Multiplexed mode: mounts come and go through tab-separated commands on stdin
+//   add <id> <source> <target> <uid mappings> <gid mappings>
+//   remove <id>
+// with one reply line per command ("added", "failed", "missing" or "removed", then the id), plus
+// an unsolicited "stopped <id>" whenever a mount goes away on its own and a periodic
+// "operations <id> <count>" with the SFTP requests a mount served since its last report. EOF on
+// stdin stops the server.
+int serve_multiplexed(const string& priv_key_blob, char* argv[])
 {
-    mp::id_mappings ret_map;
-    QString input(in);
+    const auto host = string(argv[2]);
+    const int port = atoi(argv[3]);
+    const auto username = string(argv[4]);
+
+    mutex output_mutex;
+    auto reply = [&output_mutex](const string& verb, const string& id, const string& detail = {}) {
+        lock_guard lock{output_mutex};
+        cout << verb << '\t' << id;
+        if (!detail.empty())
+            cout << '\t' << detail;
+        cout << endl;
+    };
 
-    auto maps = input.split(',', Qt::SkipEmptyParts);
-    for (auto map : maps)
+    try
     {
-        auto ids = map.split(":");
-        if (ids.count() != 2)
-        {
-            cerr << "Incorrect ID mapping syntax";
-            continue;
-        }
+        auto watchdog = mpp::make_quit_watchdog(
+            std::chrono::milliseconds{500}); // called while there is only one thread
+
+        mp::SshfsMountMultiplexer multiplexer{
+            std::make_unique<mp::PlainSSHSession>(host,
+                                                  port,
+                                                  username,
+                                                  mp::SSHClientKeyProvider{priv_key_blob}),
+            [&reply](const string& id) { reply("stopped", id); }};
 
-        bool ok1, ok2;
-        int from = ids.first().toInt(&ok1);
-        int to = ids.last().toInt(&ok2);
-        if (!ok1 || !ok2)
         {
-            cerr << "Incorrect ID mapping ids found, ignored" << endl;
-            continue;
+            lock_guard lock{output_mutex};
+            cout << "Connected" << endl;
         }
 
-        ret_map.push_back({from, to});
-    }
+        atomic<bool> input_open{true};
+        thread commands{[&multiplexer, &output_mutex, &input_open] {
+            for (string line; getline(cin, line);)
+            {
+                const auto result = mp::run_multiplexer_command(multiplexer, line);
+
+                lock_guard lock{output_mutex};
+                cout << result << endl;
+            }
+
+            input_open.store(false);
+        }};
+        commands.detach(); // may be blocked reading stdin when we are asked to quit
+
+        auto report_operations = [&multiplexer,
+                                  &reply,
+                                  reported = map<string, uint64_t>{}]() mutable {
+            try
+            {
+                auto operations = multiplexer.operations();
+                for (const auto& [id, served] : operations)
+                    if (const auto last = reported[id]; served > last)
+                        reply("operations", id, to_string(served - last));
+
+                reported = std::move(operations);
+            }
+            catch (const exception&)
+            {
+                // the multiplexer has stopped, which the watchdog finds out next
+            }
+        };
+
+        auto sig = watchdog([&multiplexer, &input_open, &report_operations] {
+            report_operations();
+            return multiplexer.alive() && input_open.load();
+        });
+
+        if (sig.has_value())
+            cout << "Received signal " << *sig << ". Stopping" << endl;
+        else if (multiplexer.alive())
+            cout << "Input closed. Stopping" << endl;
+        else
+            cerr << "SSH session to the instance was lost." << endl;
 
-    return ret_map;
+        const auto success = sig.has_value() || multiplexer.alive();
+        multiplexer.stop();
+        exit(success ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+    catch (const exception& e)
+    {
+        cerr << e.what();
+    }
+    return 1;
 }
 } // namespace
 
@@ -77,7 +154,8 @@ int main(int argc, char* argv[])
     // TODO: Remove static once we do not use exit() anymore
     static multipass::LibsshScopeGuard libssh_guard;
 
-    if (argc != 9)
+    const auto multiplexed = argc == 6 && string(argv[1]) == "--multiplex";
+    if (argc != 9 && !multiplexed)
     {
         cerr << "Incorrect arguments" << endl;
         exit(2);
@@ -90,22 +168,23 @@ int main(int argc, char* argv[])
         exit(2);
     }
     const auto priv_key_blob = string(key);
+    if (multiplexed)
+    {
+        mpl::set_logger(make_standard_logger(static_cast<mpl::Level>(atoi(argv[5]))));
+        MP_PLATFORM.setup_permission_inheritance(false);
+        return serve_multiplexed(priv_key_blob, argv);
+    }
+
     const auto host = string(argv[1]);
     const int port = atoi(argv[2]);
     const auto username = string(argv[3]);
     const auto source_path = string(argv[4]);
     const auto target_path = string(argv[5]);
-    const mp::id_mappings uid_mappings = convert_id_mappings(argv[6]);
-    const mp::id_mappings gid_mappings = convert_id_mappings(argv[7]);
+    const mp::id_mappings uid_mappings = mp::parse_id_mappings(argv[6]);
+    const mp::id_mappings gid_mappings = mp::parse_id_mappings(argv[7]);
     const mpl::Level log_level = static_cast<mpl::Level>(atoi(argv[8]));
 
-    auto logger = mpp::make_logger(log_level);
-    if (!logger)
-        logger = std::make_unique<mpl::StandardLogger>(log_level);
-
-    // Use the MultiplexingLogger as we may end up routing messages to the daemon too at some point
-    auto standard_logger = std::make_shared<mpl::MultiplexingLogger>(std::move(logger));
-    mpl::set_logger(standard_logger);
+    mpl::set_logger(make_standard_logger(log_level));
 
     MP_PLATFORM.setup_permission_inheritance(false);
 
@@ -124,8 +203,18 @@ int main(int argc, char* argv[])
             gid_mappings,
             uid_mappings);
 
-        // ssh lives on its own thread, use this thread to listen for quit signal
-        auto sig = watchdog([&sshfs_mount] { return sshfs_mount.alive(); });
+        // ssh lives on its own thread, use this thread to listen for quit signal and to report the
+        // SFTP requests served since the last report, as "operations <count>"
+        uint64_t reported_operations = 0;
+        auto sig = watchdog([&sshfs_mount, &reported_operations] {
+            if (const auto served = sshfs_mount.operations(); served > reported_operations)
+            {
+                cout << "operations\t" << served - reported_operations << endl;
+                reported_operations = served;
+            }
+
+            return sshfs_mount.alive();
+        });
 
         if (sig.has_value())
             cout << "Received signal " << *sig << ". Stopping" << endl;
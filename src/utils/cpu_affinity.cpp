@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/cpu_affinity.h>
+#include <multipass/format.h>
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+
+namespace mp = multipass;
+
+namespace
+{
+constexpr auto max_cpus = 8192; // the most the kernel can be configured for (NR_CPUS)
+
+int parse_cpu(std::string_view cpu_str, const std::string& list)
+{
+    int cpu = 0;
+    const auto* end = cpu_str.data() + cpu_str.size();
+    if (auto [ptr, ec] = std::from_chars(cpu_str.data(), end, cpu);
+        cpu_str.empty() || ec != std::errc{} || ptr != end || cpu >= max_cpus)
+        throw std::invalid_argument{fmt::format("Invalid CPU list: \"{}\"", list)};
+
+    return cpu;
+}
+} // namespace
+
+std::vector<int> mp::parse_cpu_list(const std::string& list)
+{
+    std::vector<int> cpus;
+    const std::string_view view{list};
+
+    for (std::size_t pos = 0; pos <= view.size();)
+    {
+        const auto comma = std::min(view.find(',', pos), view.size());
+        const auto item = view.substr(pos, comma - pos);
+        pos = comma + 1;
+
+        const auto dash = item.find('-');
+        const auto first = parse_cpu(item.substr(0, dash), list);
+        const auto last =
+            dash == std::string_view::npos ? first : parse_cpu(item.substr(dash + 1), list);
+        if (last < first)
+            throw std::invalid_argument{fmt::format("Invalid CPU range in \"{}\": {}", list, item)};
+
+        for (auto cpu = first; cpu <= last; ++cpu)
+            cpus.push_back(cpu);
+    }
+
+    std::ranges::sort(cpus);
+    cpus.erase(std::ranges::unique(cpus).begin(), cpus.end());
+    return cpus;
+}
+
+std::string mp::format_cpu_list(std::vector<int> cpus)
+{
+    std::ranges::sort(cpus);
+    cpus.erase(std::ranges::unique(cpus).begin(), cpus.end());
+
+    std::string ret;
+    for (auto it = cpus.begin(); it != cpus.end();)
+    {
+        auto range_end = std::next(it);
+        while (range_end != cpus.end() && *range_end == *std::prev(range_end) + 1)
+            ++range_end;
+
+        const auto last = *std::prev(range_end);
+        ret += fmt::format("{}{}", ret.empty() ? "" : ",", *it);
+        if (last != *it)
+            ret += fmt::format("-{}", last);
+
+        it = range_end;
+    }
+
+    return ret;
+}
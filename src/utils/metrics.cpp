@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/format.h>
+#include <multipass/metrics.h>
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+namespace mpm = multipass::metrics;
+
+namespace
+{
+std::string escape(std::string_view text, bool quoted)
+{
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (const auto c : text)
+    {
+        if (c == '\\')
+            escaped += "\\\\";
+        else if (c == '\n')
+            escaped += "\\n";
+        else if (c == '"' && quoted)
+            escaped += "\\\"";
+        else
+            escaped += c;
+    }
+
+    return escaped;
+}
+
+std::string render(const mpm::Labels& labels)
+{
+    std::string rendered;
+    for (const auto& [name, value] : labels)
+        rendered +=
+            fmt::format("{}{}=\"{}\"", rendered.empty() ? "" : ",", name, escape(value, true));
+
+    return rendered;
+}
+
+// A series' name followed by its labels, if any
+std::string series(std::string_view name, std::string_view labels, std::string_view extra = {})
+{
+    if (labels.empty() && extra.empty())
+        return std::string{name};
+
+    return fmt::format("{}{{{}{}{}}}",
+                       name,
+                       labels,
+                       labels.empty() || extra.empty() ? "" : ",",
+                       extra);
+}
+} // namespace
+
+void mpm::Counter::increment(std::uint64_t amount) noexcept
+{
+    count.fetch_add(amount, std::memory_order_relaxed);
+}
+
+std::uint64_t mpm::Counter::value() const noexcept
+{
+    return count.load(std::memory_order_relaxed);
+}
+
+mpm::Histogram::Histogram(std::vector<double> upper_bounds)
+    : bounds{std::move(upper_bounds)},
+      buckets{std::make_unique<std::atomic<std::uint64_t>[]>(bounds.size() + 1)}
+{
+    if (!std::is_sorted(bounds.begin(), bounds.end()))
+        throw std::invalid_argument("histogram bounds need to be in increasing order");
+}
+
+void mpm::Histogram::observe(double value) noexcept
+{
+    // bucket i holds the values up to and including bounds[i]
+    const auto bucket = std::lower_bound(bounds.begin(), bounds.end(), value) - bounds.begin();
+    buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(value, std::memory_order_relaxed);
+}
+
+void mpm::Histogram::observe(std::chrono::steady_clock::duration duration) noexcept
+{
+    observe(std::chrono::duration<double>{duration}.count());
+}
+
+const std::vector<double>& mpm::Histogram::upper_bounds() const noexcept
+{
+    return bounds;
+}
+
+std::vector<std::uint64_t> mpm::Histogram::bucket_counts() const
+{
+    std::vector<std::uint64_t> counts;
+    for (std::size_t i = 0; i <= bounds.size(); ++i)
+        counts.push_back(buckets[i].load(std::memory_order_relaxed));
+
+    return counts;
+}
+
+std::uint64_t mpm::Histogram::count() const noexcept
+{
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i <= bounds.size(); ++i)
+        count += buckets[i].load(std::memory_order_relaxed);
+
+    return count;
+}
+
+double mpm::Histogram::sum() const noexcept
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+mpm::Counter& mpm::Registry::counter(std::string_view name,
+                                     std::string_view help,
+                                     const Labels& labels)
+{
+    std::lock_guard lock{mutex};
+    auto& counter = family(name, "counter", help).counters[render(labels)];
+    if (!counter)
+        counter = std::make_unique<Counter>();
+
+    return *counter;
+}
+
+mpm::Histogram& mpm::Registry::histogram(std::string_view name,
+                                         std::string_view help,
+                                         const Labels& labels,
+                                         const std::vector<double>& upper_bounds)
+{
+    std::lock_guard lock{mutex};
+    auto& histogram = family(name, "histogram", help).histograms[render(labels)];
+    if (!histogram)
+        histogram = std::make_unique<Histogram>(upper_bounds);
+
+    return *histogram;
+}
+
+std::string mpm::Registry::to_text() const
+{
+    fmt::memory_buffer text;
+    auto out = std::back_inserter(text);
+
+    std::lock_guard lock{mutex};
+    for (const auto& [name, family] : families)
+    {
+        fmt::format_to(out, "# HELP {} {}\n# TYPE {} {}\n", name, family.help, name, family.type);
+
+        for (const auto& [labels, counter] : family.counters)
+            fmt::format_to(out, "{} {}\n", series(name, labels), counter->value());
+
+        for (const auto& [labels, histogram] : family.histograms)
+        {
+            const auto& bounds = histogram->upper_bounds();
+            const auto counts = histogram->bucket_counts();
+
+            std::uint64_t cumulative = 0;
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+                cumulative += counts[i];
+                const auto le = i < bounds.size() ? fmt::format("le=\"{}\"", bounds[i])
+                                                  : std::string{"le=\"+Inf\""};
+                fmt::format_to(out, "{} {}\n", series(name + "_bucket", labels, le), cumulative);
+            }
+
+            fmt::format_to(out, "{} {}\n", series(name + "_sum", labels), histogram->sum());
+            fmt::format_to(out, "{} {}\n", series(name + "_count", labels), cumulative);
+        }
+    }
+
+    return fmt::to_string(text);
+}
+
+mpm::Registry::Family& mpm::Registry::family(std::string_view name,
+                                             std::string_view type,
+                                             std::string_view help)
+{
+    auto it = families.find(name);
+    if (it == families.end())
+        it = families
+                 .emplace(std::string{name},
+                          Family{std::string{type}, escape(help, false), {}, {}})
+                 .first;
+    else if (it->second.type != type)
+        throw std::invalid_argument(
+            fmt::format("metric {} is a {}, not a {}", name, it->second.type, type));
+
+    return it->second;
+}
+
+mpm::Registry& mpm::registry()
+{
+    static Registry registry;
+    return registry;
+}
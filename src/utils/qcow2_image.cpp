@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/format.h>
+#include <multipass/utils/qcow2_image.h>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace mp = multipass;
+
+namespace
+{
+// See docs/interop/qcow2.txt in the QEMU tree for the on-disk layout
+constexpr std::array<unsigned char, 4> qcow2_magic{'Q', 'F', 'I', 0xfb};
+constexpr std::size_t v2_header_size = 72;
+constexpr std::size_t v3_header_size = 104;
+constexpr std::size_t snapshot_entry_fixed_size = 40;
+
+// Same limits QEMU enforces when opening an image
+constexpr std::uint32_t min_cluster_bits = 9;
+constexpr std::uint32_t max_cluster_bits = 21;
+constexpr std::uint32_t max_backing_file_size = 1023;
+constexpr std::uint32_t max_snapshots = 65536;
+constexpr std::uint32_t max_snapshot_extra_data = 1024;
+constexpr std::uint64_t max_snapshot_table_size = 64 * 1024 * 1024;
+
+std::uint64_t be_to_host(const unsigned char* data, std::size_t width)
+{
+    std::uint64_t ret = 0;
+    for (std::size_t i = 0; i < width; ++i)
+        ret = (ret << 8) | data[i];
+
+    return ret;
+}
+
+class BoundedReader
+{
+public:
+    explicit BoundedReader(std::istream& stream) : stream{stream}
+    {
+        stream.seekg(0, std::ios::end);
+        const auto end = stream.tellg();
+        if (end < 0)
+            throw mp::backend::Qcow2FormatException{"Cannot determine the size of the image"};
+
+        size = static_cast<std::uint64_t>(end);
+    }
+
+    std::uint64_t file_size() const
+    {
+        return size;
+    }
+
+    // Only reads what lies entirely inside the file, so that corrupted offsets and lengths cannot
+    // make us allocate or read past the end
+    std::vector<unsigned char> read(std::uint64_t offset, std::uint64_t length, const char* what)
+    {
+        if (offset > size || length > size - offset)
+            throw mp::backend::Qcow2FormatException{
+                fmt::format("The {} lies outside the image (offset: {}, length: {}, size: {})",
+                            what,
+                            offset,
+                            length,
+                            size)};
+
+        std::vector<unsigned char> buffer(length);
+        stream.seekg(static_cast<std::streamoff>(offset));
+        stream.read(reinterpret_cast<char*>(buffer.data()), static_cast<std::streamsize>(length));
+        if (!stream)
+            throw mp::backend::Qcow2FormatException{fmt::format("Could not read the {}", what)};
+
+        return buffer;
+    }
+
+private:
+    std::istream& stream;
+    std::uint64_t size;
+};
+
+class FieldCursor
+{
+public:
+    explicit FieldCursor(const std::vector<unsigned char>& data, std::size_t pos = 0)
+        : data{data}, pos{pos}
+    {
+    }
+
+    std::uint64_t u64()
+    {
+        return take(8);
+    }
+
+    std::uint32_t u32()
+    {
+        return static_cast<std::uint32_t>(take(4));
+    }
+
+    std::uint16_t u16()
+    {
+        return static_cast<std::uint16_t>(take(2));
+    }
+
+    std::string str(std::size_t length)
+    {
+        check(length);
+        std::string ret{reinterpret_cast<const char*>(data.data() + pos), length};
+        pos += length;
+        return ret;
+    }
+
+    void skip(std::size_t length)
+    {
+        check(length);
+        pos += length;
+    }
+
+    std::size_t position() const
+    {
+        return pos;
+    }
+
+private:
+    std::uint64_t take(std::size_t width)
+    {
+        check(width);
+        auto ret = be_to_host(data.data() + pos, width);
+        pos += width;
+        return ret;
+    }
+
+    void check(std::size_t length) const
+    {
+        if (length > data.size() - pos)
+            throw mp::backend::Qcow2FormatException{"Truncated qcow2 metadata"};
+    }
+
+    const std::vector<unsigned char>& data;
+    std::size_t pos;
+};
+
+std::size_t align_up(std::size_t value, std::size_t alignment)
+{
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+std::vector<mp::backend::Qcow2Snapshot> read_snapshot_table(BoundedReader& reader,
+                                                            std::uint64_t table_offset,
+                                                            std::uint32_t count,
+                                                            std::uint32_t cluster_bits)
+{
+    std::vector<mp::backend::Qcow2Snapshot> snapshots;
+    if (!count)
+        return snapshots;
+
+    if (count > max_snapshots)
+        throw mp::backend::Qcow2FormatException{
+            fmt::format("Too many snapshots in the image: {}", count)};
+
+    if (table_offset & ((std::uint64_t{1} << cluster_bits) - 1))
+        throw mp::backend::Qcow2FormatException{"The snapshot table is not cluster-aligned"};
+
+    // Entries are variable-length: the fixed part tells us how much follows it
+    snapshots.reserve(count);
+    std::uint64_t offset = table_offset;
+    for (std::uint32_t i = 0; i < count; ++i)
+    {
+        const auto fixed = reader.read(offset, snapshot_entry_fixed_size, "snapshot table");
+        FieldCursor entry{fixed};
+        entry.skip(8 + 4); // L1 table offset and size
+
+        const auto id_size = entry.u16();
+        const auto name_size = entry.u16();
+
+        mp::backend::Qcow2Snapshot snapshot{};
+        snapshot.date_sec = entry.u32();
+        snapshot.date_nsec = entry.u32();
+        snapshot.vm_clock_nsec = entry.u64();
+        snapshot.vm_state_size = entry.u32();
+
+        const auto extra_data_size = entry.u32();
+        if (extra_data_size > max_snapshot_extra_data)
+            throw mp::backend::Qcow2FormatException{
+                fmt::format("Snapshot extra data too large: {}", extra_data_size)};
+
+        const auto variable = reader.read(offset + snapshot_entry_fixed_size,
+                                          std::size_t{extra_data_size} + id_size + name_size,
+                                          "snapshot table");
+        FieldCursor extra{variable};
+        if (extra_data_size >= 8)
+            snapshot.vm_state_size = extra.u64();
+        if (extra_data_size >= 24)
+        {
+            extra.skip(8); // disk size
+            if (const auto icount = extra.u64(); icount != ~std::uint64_t{0})
+                snapshot.icount = icount;
+        }
+
+        FieldCursor names{variable, extra_data_size};
+        snapshot.id = names.str(id_size);
+        snapshot.tag = names.str(name_size);
+
+        offset += align_up(snapshot_entry_fixed_size + variable.size(), 8);
+        if (offset - table_offset > max_snapshot_table_size)
+            throw mp::backend::Qcow2FormatException{"Snapshot table too large"};
+
+        snapshots.push_back(std::move(snapshot));
+    }
+
+    return snapshots;
+}
+} // namespace
+
+std::optional<mp::backend::Qcow2Info> mp::backend::read_qcow2_info(std::istream& image)
+{
+    BoundedReader reader{image};
+    if (reader.file_size() < v2_header_size)
+        return std::nullopt;
+
+    const auto header = reader.read(0, v2_header_size, "image header");
+    if (!std::equal(qcow2_magic.begin(), qcow2_magic.end(), header.begin()))
+        return std::nullopt;
+
+    FieldCursor fields{header, qcow2_magic.size()};
+
+    Qcow2Info info{};
+    info.version = fields.u32();
+    if (info.version != 2 && info.version != 3)
+        throw Qcow2FormatException{fmt::format("Unsupported qcow2 version: {}", info.version)};
+
+    const auto backing_file_offset = fields.u64();
+    const auto backing_file_size = fields.u32();
+
+    info.cluster_bits = fields.u32();
+    if (info.cluster_bits < min_cluster_bits || info.cluster_bits > max_cluster_bits)
+        throw Qcow2FormatException{fmt::format("Invalid cluster size: 2^{}", info.cluster_bits)};
+
+    info.virtual_size = fields.u64();
+
+    fields.skip(4 + 4 + 8 + 8 + 4); // encryption, L1 table and refcount table
+    const auto nb_snapshots = fields.u32();
+    const auto snapshots_offset = fields.u64();
+
+    if (info.version == 3)
+    {
+        const auto v3_header = reader.read(0, v3_header_size, "image header");
+        const auto header_length = static_cast<std::uint32_t>(be_to_host(&v3_header[100], 4));
+        if (header_length < v3_header_size)
+            throw Qcow2FormatException{fmt::format("Invalid header length: {}", header_length)};
+    }
+
+    if (backing_file_offset)
+    {
+        if (backing_file_size > max_backing_file_size)
+            throw Qcow2FormatException{"Backing file name too long"};
+
+        const auto name = reader.read(backing_file_offset, backing_file_size, "backing file name");
+        info.backing_file.assign(name.begin(), name.end());
+    }
+
+    info.snapshots = read_snapshot_table(reader, snapshots_offset, nb_snapshots, info.cluster_bits);
+
+    return info;
+}
+
+std::optional<mp::backend::Qcow2Info> mp::backend::read_qcow2_info(
+    const std::filesystem::path& image_path)
+{
+    std::ifstream image{image_path, std::ios::binary};
+    if (!image.is_open())
+        return std::nullopt;
+
+    return read_qcow2_info(image);
+}
@@ -18,11 +18,20 @@
 #include <multipass/constants.h>
 #include <multipass/format.h>
 #include <multipass/json_utils.h>
+#include <multipass/logging/log.h>
 #include <multipass/memory_size.h>
 #include <multipass/platform.h>
 #include <multipass/process/qemuimg_process_spec.h>
+#include <multipass/utils/qcow2_image.h>
 #include <multipass/utils/qemu_img_utils.h>
 
+#include <fmt/chrono.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <ctime>
 #include <regex>
 
 #include <QString>
@@ -31,10 +40,90 @@
 #include <boost/json.hpp>
 
 namespace mp = multipass;
+namespace mpl = multipass::logging;
 namespace mpp = multipass::platform;
 
+namespace
+{
+constexpr auto category = "qemu-img";
+
+// Reading the qcow2 metadata ourselves saves a qemu-img fork/exec for the common queries. Anything
+// we cannot handle natively (other formats, unreadable or odd images) is left for qemu-img to deal
+// with and report.
+std::optional<mp::backend::Qcow2Info> try_read_qcow2_info(const std::filesystem::path& image_path)
+{
+    try
+    {
+        return mp::backend::read_qcow2_info(image_path);
+    }
+    catch (const mp::backend::Qcow2FormatException& e)
+    {
+        mpl::debug(category,
+                   "Could not read qcow2 metadata natively, falling back to qemu-img: {}",
+                   e.what());
+        return std::nullopt;
+    }
+}
+
+// Like QEMU's size_to_str, which qemu-img uses: three significant digits, in binary units
+std::string human_readable_size(std::uint64_t bytes)
+{
+    static constexpr std::array suffixes{"B", "KiB", "MiB", "GiB", "TiB", "PiB", "EiB"};
+
+    // The correction has sizes of 1000 units and more move up to the next unit
+    int exponent = 0;
+    std::frexp(bytes / (1000.0 / 1024.0), &exponent);
+    const auto unit = (exponent - 1) / 10;
+
+    const auto unit_size = static_cast<double>(std::uint64_t{1} << (unit * 10));
+    return fmt::format("{:.3g} {}", static_cast<double>(bytes) / unit_size, suffixes[unit]);
+}
+
+QByteArray format_snapshot_list(const std::vector<mp::backend::Qcow2Snapshot>& snapshots)
+{
+    if (snapshots.empty())
+        return {};
+
+    // Mirrors `qemu-img snapshot -l`, dates in local time included
+    auto output = fmt::format("Snapshot list:\n{:<10}{:<17}{:>8}{:>20}{:>13}{:>11}\n",
+                              "ID",
+                              "TAG",
+                              "VM SIZE",
+                              "DATE",
+                              "VM CLOCK",
+                              "ICOUNT");
+
+    for (const auto& snapshot : snapshots)
+    {
+        const std::time_t date_sec = snapshot.date_sec;
+        const auto date = *std::localtime(&date_sec);
+        const auto clock = std::chrono::milliseconds{snapshot.vm_clock_nsec / 1'000'000};
+        const auto hours = std::chrono::duration_cast<std::chrono::hours>(clock);
+
+        fmt::format_to(std::back_inserter(output),
+                       "{:<9} {:<16} {:>8} {:%Y-%m-%d %H:%M:%S} {:02}:{:%M:%S} {:>10}\n",
+                       snapshot.id,
+                       snapshot.tag,
+                       human_readable_size(snapshot.vm_state_size),
+                       date,
+                       hours.count(),
+                       clock,
+                       snapshot.icount ? std::to_string(*snapshot.icount) : "--");
+    }
+
+    return QByteArray::fromStdString(output);
+}
+} // namespace
+
 QString mp::backend::get_image_info(const std::filesystem::path& image_path, const QString& key)
 {
+    if (key == "format" || key == "virtual-size")
+    {
+        if (const auto info = try_read_qcow2_info(image_path))
+            return key == "format" ? QStringLiteral("qcow2")
+                                   : QString::number(info->virtual_size);
+    }
+
     auto qemuimg_info_process = checked_exec_qemu_img(
         std::make_unique<mp::QemuImgProcessSpec>(
             QStringList{"info", "--output=json", MP_PLATFORM.path_to_qstr(image_path)},
@@ -119,12 +208,22 @@ std::filesystem::path mp::backend::convert(const std::filesystem::path& source_p
 bool mp::backend::instance_image_has_snapshot(const std::filesystem::path& image_path,
                                               const std::string& snapshot_tag)
 {
+    if (const auto info = try_read_qcow2_info(image_path))
+        return std::any_of(info->snapshots.cbegin(),
+                           info->snapshots.cend(),
+                           [&snapshot_tag](const auto& snapshot) {
+                               return snapshot.tag == snapshot_tag;
+                           });
+
     std::regex regex{snapshot_tag + R"(\s)"};
     return std::regex_search(snapshot_list_output(image_path).toStdString(), regex);
 }
 
 QByteArray mp::backend::snapshot_list_output(const std::filesystem::path& image_path)
 {
+    if (const auto info = try_read_qcow2_info(image_path))
+        return format_snapshot_list(info->snapshots);
+
     auto qemuimg_info_process = checked_exec_qemu_img(
         std::make_unique<mp::QemuImgProcessSpec>(
             QStringList{"snapshot", "-l", MP_PLATFORM.path_to_qstr(image_path)},
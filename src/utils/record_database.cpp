@@ -0,0 +1,395 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/record_database.h>
+
+#include <multipass/constants.h>
+#include <multipass/file_ops.h>
+#include <multipass/format.h>
+#include <multipass/json_utils.h>
+#include <multipass/logging/log.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <bit>
+#include <cstdint>
+#include <string_view>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+
+namespace
+{
+constexpr auto category = "record database";
+constexpr std::string_view magic = "MPDB\x01";
+constexpr auto max_depth = 64;
+
+// Each value is a tag byte followed by its payload. Integers are little-endian, strings, arrays
+// and objects are prefixed by a 32-bit size.
+enum class Tag : std::uint8_t
+{
+    null,
+    false_,
+    true_,
+    int64,
+    uint64,
+    double_,
+    string,
+    array,
+    object
+};
+
+void put_uint(QByteArray& out, std::uint64_t value, int size)
+{
+    for (auto i = 0; i < size; ++i, value >>= 8)
+        out.append(static_cast<char>(value & 0xff));
+}
+
+void put_tag(QByteArray& out, Tag tag)
+{
+    out.append(static_cast<char>(tag));
+}
+
+void put_string(QByteArray& out, std::string_view string)
+{
+    put_uint(out, string.size(), 4);
+    out.append(string.data(), static_cast<qsizetype>(string.size()));
+}
+
+void put_value(QByteArray& out, const boost::json::value& value)
+{
+    switch (value.kind())
+    {
+    case boost::json::kind::null:
+        put_tag(out, Tag::null);
+        break;
+    case boost::json::kind::bool_:
+        put_tag(out, value.get_bool() ? Tag::true_ : Tag::false_);
+        break;
+    case boost::json::kind::int64:
+        put_tag(out, Tag::int64);
+        put_uint(out, static_cast<std::uint64_t>(value.get_int64()), 8);
+        break;
+    case boost::json::kind::uint64:
+        put_tag(out, Tag::uint64);
+        put_uint(out, value.get_uint64(), 8);
+        break;
+    case boost::json::kind::double_:
+        put_tag(out, Tag::double_);
+        put_uint(out, std::bit_cast<std::uint64_t>(value.get_double()), 8);
+        break;
+    case boost::json::kind::string:
+        put_tag(out, Tag::string);
+        put_string(out, {value.get_string().data(), value.get_string().size()});
+        break;
+    case boost::json::kind::array:
+        put_tag(out, Tag::array);
+        put_uint(out, value.get_array().size(), 4);
+        for (const auto& element : value.get_array())
+            put_value(out, element);
+        break;
+    case boost::json::kind::object:
+        put_tag(out, Tag::object);
+        put_uint(out, value.get_object().size(), 4);
+        for (const auto& [key, member] : value.get_object())
+        {
+            put_string(out, {key.data(), key.size()});
+            put_value(out, member);
+        }
+        break;
+    }
+}
+
+class Reader
+{
+public:
+    explicit Reader(std::span<const std::byte> data) : data{data}
+    {
+    }
+
+    bool at_end() const
+    {
+        return data.empty();
+    }
+
+    std::span<const std::byte> bytes(std::uint64_t size)
+    {
+        if (size > data.size())
+            throw mp::CorruptRecordDatabaseException{"unexpected end of record database"};
+
+        auto ret = data.first(size);
+        data = data.subspan(size);
+        return ret;
+    }
+
+    std::uint64_t uint(int size)
+    {
+        std::uint64_t value = 0;
+        auto span = bytes(size);
+        for (auto it = span.rbegin(); it != span.rend(); ++it)
+            value = (value << 8) | std::to_integer<std::uint64_t>(*it);
+        return value;
+    }
+
+    std::string_view string()
+    {
+        auto span = bytes(uint(4));
+        return {reinterpret_cast<const char*>(span.data()), span.size()};
+    }
+
+    boost::json::value value(int depth = 0)
+    {
+        if (depth > max_depth)
+            throw mp::CorruptRecordDatabaseException{"record database nested too deeply"};
+
+        switch (static_cast<Tag>(uint(1)))
+        {
+        case Tag::null:
+            return nullptr;
+        case Tag::false_:
+            return false;
+        case Tag::true_:
+            return true;
+        case Tag::int64:
+            return static_cast<std::int64_t>(uint(8));
+        case Tag::uint64:
+            return uint(8);
+        case Tag::double_:
+            return std::bit_cast<double>(uint(8));
+        case Tag::string:
+        {
+            auto text = string();
+            return boost::json::string{text.data(), text.size()};
+        }
+        case Tag::array:
+        {
+            boost::json::array array;
+            for (auto count = uint(4); count > 0; --count)
+                array.push_back(value(depth + 1));
+            return array;
+        }
+        case Tag::object:
+        {
+            boost::json::object object;
+            for (auto count = uint(4); count > 0; --count)
+            {
+                auto key = string();
+                object[boost::json::string_view{key.data(), key.size()}] = value(depth + 1);
+            }
+            return object;
+        }
+        }
+
+        throw mp::CorruptRecordDatabaseException{"unknown value in record database"};
+    }
+
+private:
+    std::span<const std::byte> data;
+};
+
+bool has_contents(const QString& path)
+{
+    return QFileInfo{path}.size() > 0;
+}
+
+void remove_if_present(const QString& path)
+{
+    if (QFile::exists(path))
+    {
+        QFile file{path};
+        MP_FILEOPS.remove(file);
+    }
+}
+} // namespace
+
+mp::RecordDatabase::Format mp::RecordDatabase::configured_format()
+{
+    return qEnvironmentVariable(database_format_env_var).toLower() == "binary" ? Format::binary
+                                                                               : Format::json;
+}
+
+QString mp::RecordDatabase::binary_path(const QString& json_path)
+{
+    return (json_path.endsWith(".json") ? json_path.chopped(5) : json_path) + ".db";
+}
+
+std::optional<mp::RecordDatabase> mp::RecordDatabase::open(const QString& json_path)
+{
+    const auto bin_path = binary_path(json_path);
+    const auto binary = configured_format() == Format::binary;
+    const auto& wanted = binary ? bin_path : json_path;
+    const auto& other = binary ? json_path : bin_path;
+
+    if (has_contents(wanted))
+        return open_file(wanted);
+
+    if (!has_contents(other))
+        return std::nullopt;
+
+    mpl::info(category, "Converting {} to {}", other, wanted);
+    auto records = open_file(other).to_json();
+    try
+    {
+        write(json_path, records);
+    }
+    catch (const std::exception& e)
+    {
+        // The records are still good; the conversion is simply tried again next time
+        mpl::warn(category, "Could not convert {} to {}: {}", other, wanted, e.what());
+    }
+
+    return RecordDatabase{std::move(records)};
+}
+
+mp::RecordDatabase mp::RecordDatabase::open_file(const QString& path)
+{
+    auto file = std::make_unique<QFile>(path);
+    if (!file->open(QIODevice::ReadOnly))
+        throw std::runtime_error{fmt::format("failed to open {}: {}", path, file->errorString())};
+
+    const auto header = file->peek(magic.size());
+    if (std::string_view(header) != magic)
+    {
+        auto records = boost::json::parse(std::string_view(file->readAll()));
+        if (!records.is_object())
+            throw CorruptRecordDatabaseException{
+                fmt::format("{} does not contain a JSON object", path)};
+
+        return RecordDatabase{std::move(records.as_object())};
+    }
+
+    // Fall back to reading the file when it cannot be mapped, e.g. on some network filesystems
+    QByteArray contents;
+    const auto mapped = file->map(0, file->size());
+    if (!mapped)
+        contents = file->readAll();
+
+    return RecordDatabase{std::move(file), mapped, std::move(contents)};
+}
+
+void mp::RecordDatabase::write(const QString& json_path, const boost::json::value& records)
+{
+    const auto bin_path = binary_path(json_path);
+    if (configured_format() == Format::binary)
+    {
+        MP_FILEOPS.write_transactionally(bin_path, encode(records.as_object()));
+        remove_if_present(json_path);
+    }
+    else
+    {
+        MP_FILEOPS.write_transactionally(json_path, pretty_print(records));
+        remove_if_present(bin_path);
+    }
+}
+
+QByteArray mp::RecordDatabase::encode(const boost::json::object& records)
+{
+    QByteArray out{magic.data(), static_cast<qsizetype>(magic.size())};
+    put_uint(out, records.size(), 4);
+    for (const auto& [key, record] : records)
+    {
+        put_string(out, {key.data(), key.size()});
+
+        QByteArray value;
+        put_value(value, record);
+        put_uint(out, value.size(), 8);
+        out.append(value);
+    }
+
+    return out;
+}
+
+mp::RecordDatabase::RecordDatabase(boost::json::object records)
+    : db_format{Format::json}, json_records{std::move(records)}
+{
+    for (const auto& [key, record] : json_records)
+        record_keys.emplace_back(key);
+}
+
+mp::RecordDatabase::RecordDatabase(std::unique_ptr<QFile> file,
+                                   const uchar* mapped,
+                                   QByteArray contents)
+    : db_format{Format::binary}, file{std::move(file)}, contents{std::move(contents)}
+{
+    const auto data =
+        mapped ? std::span{reinterpret_cast<const std::byte*>(mapped),
+                           static_cast<std::size_t>(this->file->size())}
+               : std::as_bytes(std::span{this->contents.constData(),
+                                         static_cast<std::size_t>(this->contents.size())});
+
+    // Only the index is read here, records are decoded in at()
+    Reader reader{data};
+    reader.bytes(magic.size());
+    for (auto count = reader.uint(4); count > 0; --count)
+    {
+        std::string key{reader.string()};
+        auto record = reader.bytes(reader.uint(8));
+        if (binary_records.emplace(key, record).second)
+            record_keys.push_back(std::move(key));
+    }
+
+    if (!reader.at_end())
+        throw CorruptRecordDatabaseException{
+            fmt::format("unexpected data at the end of {}", this->file->fileName())};
+}
+
+mp::RecordDatabase::RecordDatabase(RecordDatabase&&) noexcept = default;
+mp::RecordDatabase& mp::RecordDatabase::operator=(RecordDatabase&&) noexcept = default;
+mp::RecordDatabase::~RecordDatabase() = default;
+
+auto mp::RecordDatabase::format() const -> Format
+{
+    return db_format;
+}
+
+const std::vector<std::string>& mp::RecordDatabase::keys() const
+{
+    return record_keys;
+}
+
+boost::json::value mp::RecordDatabase::at(const std::string& key) const
+{
+    if (db_format == Format::json)
+    {
+        if (auto it = json_records.find(key); it != json_records.end())
+            return it->value();
+    }
+    else if (auto it = binary_records.find(key); it != binary_records.end())
+    {
+        Reader reader{it->second};
+        auto record = reader.value();
+        if (!reader.at_end())
+            throw CorruptRecordDatabaseException{fmt::format("corrupt record '{}'", key)};
+
+        return record;
+    }
+
+    throw std::out_of_range{fmt::format("no record '{}' in database", key)};
+}
+
+boost::json::object mp::RecordDatabase::to_json() const
+{
+    if (db_format == Format::json)
+        return json_records;
+
+    boost::json::object records;
+    for (const auto& key : record_keys)
+        records[key] = at(key);
+
+    return records;
+}
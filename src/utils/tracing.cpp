@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/tracing.h>
+
+#include <boost/json.hpp>
+
+#include <atomic>
+
+namespace mptr = multipass::tracing;
+
+namespace
+{
+thread_local std::shared_ptr<mptr::Trace> thread_trace;
+
+int this_thread_number()
+{
+    static std::atomic_int next_thread_number{1};
+    thread_local const int thread_number = next_thread_number++;
+    return thread_number;
+}
+
+auto microseconds_between(mptr::Clock::time_point from, mptr::Clock::time_point to)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(to - from).count();
+}
+} // namespace
+
+mptr::Trace::Trace() : origin{Clock::now()}
+{
+}
+
+void mptr::Trace::add(SpanRecord span)
+{
+    std::lock_guard lock{mutex};
+    records.push_back(std::move(span));
+}
+
+std::vector<mptr::SpanRecord> mptr::Trace::spans() const
+{
+    std::lock_guard lock{mutex};
+    return records;
+}
+
+std::string mptr::Trace::to_chrome_json() const
+{
+    boost::json::array events;
+    for (const auto& span : spans())
+        events.push_back({{"name", span.name},
+                          {"cat", "multipass"},
+                          {"ph", "X"}, // a complete event, with a duration
+                          {"ts", microseconds_between(origin, span.start)},
+                          {"dur", microseconds_between(span.start, span.end)},
+                          {"pid", 1},
+                          {"tid", span.thread}});
+
+    return boost::json::serialize(
+        boost::json::object{{"traceEvents", std::move(events)}, {"displayTimeUnit", "ms"}});
+}
+
+std::shared_ptr<mptr::Trace> mptr::current_trace()
+{
+    return thread_trace;
+}
+
+mptr::ActiveTrace::ActiveTrace(std::shared_ptr<Trace> trace)
+    : previous{std::exchange(thread_trace, std::move(trace))}
+{
+}
+
+mptr::ActiveTrace::~ActiveTrace()
+{
+    thread_trace = std::move(previous);
+}
+
+mptr::Span::Span(std::string_view name) : trace{thread_trace}
+{
+    if (trace)
+    {
+        this->name = name;
+        start = Clock::now();
+    }
+}
+
+mptr::Span::~Span()
+{
+    if (trace)
+        trace->add({std::move(name), start, Clock::now(), this_thread_number()});
+}
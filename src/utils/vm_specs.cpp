@@ -45,6 +45,10 @@ void mp::tag_invoke(const boost::json::value_from_tag&,
         {"mounts", boost::json::value_from(specs.mounts, MapAsJsonArray{"target_path"})},
         {"clone_count", specs.clone_count},
         {"zone", specs.zone},
+        {"network_multiqueue", specs.network_multiqueue},
+        {"disk_profile", specs.disk_profile},
+        {"memory_backing", boost::json::value_from(specs.memory_backing)},
+        {"cpu_affinity", boost::json::value_from(specs.cpu_affinity)},
     };
 }
 
@@ -83,5 +87,9 @@ mp::VMSpecs mp::tag_invoke(const boost::json::value_to_tag<mp::VMSpecs>&,
         metadata,
         lookup_or<int>(json, "clone_count", 0),
         lookup_or<std::string>(json, "zone", az_manager.get_default_zone_name()),
+        lookup_or<bool>(json, "network_multiqueue", false),
+        lookup_or<std::string>(json, "disk_profile", disk_profile_default),
+        lookup_or<MemoryBacking>(json, "memory_backing", MemoryBacking{}),
+        lookup_or<CpuAffinity>(json, "cpu_affinity", CpuAffinity{}),
     };
 }
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/cloud_init_iso.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <filesystem>
+#include <string>
+
+namespace mp = multipass;
+
+namespace
+{
+// The seed image the daemon writes for every launch; user-data grows with the user's cloud-init
+mp::CloudInitIso make_iso(std::size_t user_data_size)
+{
+    mp::CloudInitIso iso;
+    iso.add_file("meta-data", "#cloud-config\ninstance-id: bench\nlocal-hostname: bench\n");
+    iso.add_file("vendor-data", "#cloud-config\npackage_update: false\n");
+    iso.add_file("network-config", "#cloud-config\nversion: 2\nethernets: {}\n");
+
+    std::string user_data{"#cloud-config\nwrite_files:\n- content: "};
+    user_data.append(user_data_size, 'x');
+    iso.add_file("user-data", user_data);
+
+    return iso;
+}
+
+std::filesystem::path iso_path_in(const QTemporaryDir& dir)
+{
+    return QDir{dir.path()}.filePath("cloud-init-config.iso").toStdString();
+}
+
+void BM_CloudInitIsoWriteTo(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const auto iso_path = iso_path_in(dir);
+    auto iso = make_iso(state.range(0));
+
+    for (auto _ : state)
+        iso.write_to(iso_path);
+
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(iso_path));
+}
+BENCHMARK(BM_CloudInitIsoWriteTo)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+// The in-place update done when only metadata changes, e.g. on clone or when adding interfaces
+void BM_CloudInitIsoWriteChangesTo(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const auto iso_path = iso_path_in(dir);
+    auto iso = make_iso(state.range(0));
+    iso.write_to(iso_path);
+
+    auto generation = 0;
+    for (auto _ : state)
+    {
+        iso["meta-data"] =
+            "#cloud-config\ninstance-id: bench-" + std::to_string(generation++ % 10) + "\n";
+        iso.write_changes_to(iso_path);
+    }
+}
+BENCHMARK(BM_CloudInitIsoWriteChangesTo)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+
+void BM_CloudInitIsoReadFrom(benchmark::State& state)
+{
+    QTemporaryDir dir;
+    const auto iso_path = iso_path_in(dir);
+    make_iso(state.range(0)).write_to(iso_path);
+
+    for (auto _ : state)
+    {
+        mp::CloudInitIso iso;
+        iso.read_from(iso_path);
+        benchmark::DoNotOptimize(iso);
+    }
+
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(iso_path));
+}
+BENCHMARK(BM_CloudInitIsoReadFrom)->RangeMultiplier(16)->Range(1 << 10, 1 << 20);
+} // namespace
@@ -0,0 +1,126 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/cli/csv_formatter.h>
+#include <multipass/cli/json_formatter.h>
+#include <multipass/cli/table_formatter.h>
+#include <multipass/cli/yaml_formatter.h>
+#include <multipass/format.h>
+#include <multipass/rpc/multipass.grpc.pb.h>
+
+#include <benchmark/benchmark.h>
+
+namespace mp = multipass;
+
+namespace
+{
+auto make_list_reply(int num_instances)
+{
+    mp::ListReply list_reply;
+
+    for (int i = 0; i < num_instances; ++i)
+    {
+        auto list_entry = list_reply.mutable_instance_list()->add_instances();
+        list_entry->set_name(fmt::format("instance-{}", i));
+        list_entry->mutable_instance_status()->set_status(
+            i % 2 ? mp::InstanceStatus::RUNNING : mp::InstanceStatus::STOPPED);
+        list_entry->set_current_release("24.04 LTS");
+        list_entry->set_os("Ubuntu");
+        list_entry->add_ipv4(fmt::format("10.97.{}.{}", i / 250, i % 250 + 2));
+        list_entry->add_ipv4(fmt::format("172.27.{}.{}", i / 250, i % 250 + 2));
+        const auto zone = list_entry->mutable_zone();
+        zone->set_name(fmt::format("zone{}", i % 3 + 1));
+        zone->set_available(true);
+    }
+
+    return list_reply;
+}
+
+auto make_info_reply(int num_instances)
+{
+    mp::InfoReply info_reply;
+
+    for (int i = 0; i < num_instances; ++i)
+    {
+        auto info_entry = info_reply.add_details();
+        info_entry->set_name(fmt::format("instance-{}", i));
+        info_entry->mutable_instance_status()->set_status(mp::InstanceStatus::RUNNING);
+        info_entry->mutable_instance_info()->set_image_release("24.04 LTS");
+        info_entry->mutable_instance_info()->set_os("Ubuntu");
+        info_entry->mutable_instance_info()->set_id(std::string(64, 'f'));
+        const auto zone = info_entry->mutable_zone();
+        zone->set_name(fmt::format("zone{}", i % 3 + 1));
+        zone->set_available(true);
+
+        auto mount_info = info_entry->mutable_mount_info();
+        mount_info->set_longest_path_len(19);
+        auto mount_entry = mount_info->add_mount_paths();
+        mount_entry->set_source_path("/home/user/source");
+        mount_entry->set_target_path("source");
+        auto uid_map_pair = mount_entry->mutable_mount_maps()->add_uid_mappings();
+        uid_map_pair->set_host_id(1000);
+        uid_map_pair->set_instance_id(1000);
+        auto gid_map_pair = mount_entry->mutable_mount_maps()->add_gid_mappings();
+        gid_map_pair->set_host_id(1000);
+        gid_map_pair->set_instance_id(1000);
+
+        info_entry->set_cpu_count("2");
+        info_entry->mutable_instance_info()->set_load("0.45 0.51 0.15");
+        info_entry->mutable_instance_info()->set_memory_usage("60817408");
+        info_entry->set_memory_total("1503238554");
+        info_entry->mutable_instance_info()->set_disk_usage("1288490188");
+        info_entry->set_disk_total("5153960756");
+        info_entry->mutable_instance_info()->set_current_release("Ubuntu 24.04 LTS");
+        info_entry->mutable_instance_info()->add_ipv4(
+            fmt::format("10.97.{}.{}", i / 250, i % 250 + 2));
+    }
+
+    return info_reply;
+}
+
+template <typename FormatterT>
+void BM_FormatList(benchmark::State& state)
+{
+    const auto reply = make_list_reply(state.range(0));
+    FormatterT formatter;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(formatter.format(reply));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FormatList, mp::TableFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::CSVFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::JsonFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatList, mp::YamlFormatter)->RangeMultiplier(8)->Range(8, 512);
+
+template <typename FormatterT>
+void BM_FormatInfo(benchmark::State& state)
+{
+    const auto reply = make_info_reply(state.range(0));
+    FormatterT formatter;
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(formatter.format(reply));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::TableFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::CSVFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::JsonFormatter)->RangeMultiplier(8)->Range(8, 512);
+BENCHMARK_TEMPLATE(BM_FormatInfo, mp::YamlFormatter)->RangeMultiplier(8)->Range(8, 512);
+} // namespace
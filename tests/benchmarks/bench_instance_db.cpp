@@ -0,0 +1,105 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "stub_availability_zone_manager.h"
+
+#include <multipass/format.h>
+#include <multipass/record_database.h>
+#include <multipass/vm_specs.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <string>
+#include <unordered_map>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+namespace
+{
+// Mirrors what the daemon keeps in its instance database
+constexpr auto instance_db_name = "multipassd-vm-instances.json";
+
+auto make_specs(int num_instances)
+{
+    std::unordered_map<std::string, mp::VMSpecs> specs;
+    for (int i = 0; i < num_instances; ++i)
+    {
+        mp::VMSpecs instance{};
+        instance.num_cores = 2;
+        instance.mem_size = mp::MemorySize{"2G"};
+        instance.disk_space = mp::MemorySize{"10G"};
+        instance.default_mac_address = fmt::format("52:54:00:00:{:02x}:{:02x}", i / 256, i % 256);
+        instance.extra_interfaces = {
+            {"eth1", fmt::format("52:54:00:01:{:02x}:{:02x}", i / 256, i % 256), true}};
+        instance.ssh_username = "ubuntu";
+        instance.state = mp::VirtualMachine::State::stopped;
+        instance.mounts.emplace("/home/ubuntu/src",
+                                mp::VMMount{"/home/user/src",
+                                            {{1000, 1000}},
+                                            {{1000, 1000}},
+                                            mp::VMMount::MountType::Classic});
+        instance.deleted = false;
+        instance.metadata = {{"arguments", boost::json::array{"-machine", "virt"}}};
+        instance.zone = "zone1";
+
+        specs.emplace(fmt::format("instance-{}", i), std::move(instance));
+    }
+
+    return specs;
+}
+
+// What Daemon::persist_instances() does on every state change
+void BM_PersistInstances(benchmark::State& state)
+{
+    QTemporaryDir data_dir;
+    const auto db_path = QDir{data_dir.path()}.filePath(instance_db_name);
+    const auto specs = make_specs(state.range(0));
+
+    for (auto _ : state)
+        mp::RecordDatabase::write(db_path, boost::json::value_from(specs));
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PersistInstances)->RangeMultiplier(8)->Range(8, 512);
+
+// What the daemon's load_db() does on startup
+void BM_LoadInstances(benchmark::State& state)
+{
+    QTemporaryDir data_dir;
+    const auto db_path = QDir{data_dir.path()}.filePath(instance_db_name);
+    mp::RecordDatabase::write(db_path, boost::json::value_from(make_specs(state.range(0))));
+    const mpt::StubAvailabilityZoneManager az_manager{};
+
+    for (auto _ : state)
+    {
+        auto records = mp::RecordDatabase::open(db_path);
+
+        std::unordered_map<std::string, mp::VMSpecs> specs;
+        for (const auto& key : records->keys())
+            specs.emplace(key, value_to<mp::VMSpecs>(records->at(key), az_manager));
+
+        benchmark::DoNotOptimize(specs);
+    }
+
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_LoadInstances)->RangeMultiplier(8)->Range(8, 512);
+} // namespace
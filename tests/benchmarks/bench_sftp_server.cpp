@@ -0,0 +1,190 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "mock_sftpserver.h"
+#include "mock_ssh_process_exit_status.h"
+#include "mock_ssh_test_fixture.h"
+#include "stub_ssh_key_provider.h"
+
+#include <src/sshfs_mount/sftp_server.h>
+
+#include <multipass/cli/client_platform.h>
+#include <multipass/file_ops.h>
+#include <multipass/format.h>
+#include <multipass/ssh/plain_ssh_session.h>
+
+#include <benchmark/benchmark.h>
+
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <cstdlib>
+#include <utility>
+
+#include <fcntl.h>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+namespace mcp = multipass::cli::platform;
+
+namespace
+{
+// Stands in for libssh on the server side: requests come from next_msg and replies go nowhere, so
+// that only the SftpServer handlers and the host file system calls they make are measured
+struct SftpTransport
+{
+    mp::SftpServer make_sftpserver(const std::string& path)
+    {
+        return {std::make_unique<mp::PlainSSHSession>("a", 42, "ubuntu", key_provider),
+                path,
+                path,
+                {{mcp::getgid(), mp::default_id}},
+                {{mcp::getuid(), mp::default_id}},
+                mcp::getuid(),
+                mcp::getgid(),
+                "sshfs"};
+    }
+
+    mpt::MockSSHTestFixture mock_ssh_test_fixture;
+    mpt::ExitStatusMock exit_status_mock;
+    const mpt::StubSSHKeyProvider key_provider;
+
+    sftp_client_message_struct init_msg{.type = SSH_FXP_INIT};
+    sftp_client_message next_msg{&init_msg};
+    void* handle{nullptr};
+    bool eof{false};
+
+    MockScope<decltype(mock_ssh_channel_new)> channel_new{
+        mock_ssh_channel_new,
+        [](auto...) { return reinterpret_cast<ssh_channel>(0xdeadbeefdeadbeef); }};
+    MockScope<decltype(mock_ssh_channel_free)> channel_free{mock_ssh_channel_free,
+                                                            [](auto...) {}};
+    MockScope<decltype(mock_ssh_remove_channel_callbacks)> remove_channel_callbacks{
+        mock_ssh_remove_channel_callbacks,
+        [](auto...) { return SSH_OK; }};
+    MockScope<decltype(mock_ssh_event_new)> event_new{
+        mock_ssh_event_new,
+        [](auto...) { return reinterpret_cast<ssh_event>(0xdeadbeefdeadbeef); }};
+    MockScope<decltype(mock_ssh_event_free)> event_free{mock_ssh_event_free, [](auto...) {}};
+    MockScope<decltype(mock_ssh_event_add_session)> event_add_session{
+        mock_ssh_event_add_session,
+        [](auto...) { return SSH_OK; }};
+
+    MockScope<decltype(mock_sftp_server_new)> server_new{
+        mock_sftp_server_new,
+        [](ssh_session, ssh_channel) -> sftp_session {
+            return static_cast<sftp_session_struct*>(
+                std::calloc(1, sizeof(struct sftp_session_struct)));
+        }};
+    MockScope<decltype(mock_sftp_server_free)> server_free{mock_sftp_server_free,
+                                                           [](sftp_session sftp) {
+                                                               std::free(sftp->handles);
+                                                               std::free(sftp);
+                                                           }};
+    MockScope<decltype(mock_sftp_get_client_message)> get_client_message{
+        mock_sftp_get_client_message,
+        [this](auto...) { return std::exchange(next_msg, nullptr); }};
+    MockScope<decltype(mock_sftp_client_message_free)> client_message_free{
+        mock_sftp_client_message_free,
+        [](auto...) {}};
+    MockScope<decltype(mock_sftp_handle)> sftp_handle{mock_sftp_handle,
+                                                      [this](auto...) { return handle; }};
+    MockScope<decltype(mock_sftp_reply_version)> reply_version{mock_sftp_reply_version,
+                                                               [](auto...) { return SSH_OK; }};
+    MockScope<decltype(mock_sftp_reply_data)> reply_data{mock_sftp_reply_data,
+                                                         [](auto...) { return SSH_OK; }};
+    MockScope<decltype(mock_sftp_reply_names_add)> reply_names_add{
+        mock_sftp_reply_names_add,
+        [](auto...) { return SSH_OK; }};
+    MockScope<decltype(mock_sftp_reply_names)> reply_names{mock_sftp_reply_names,
+                                                           [](auto...) { return SSH_OK; }};
+    MockScope<decltype(mock_sftp_reply_status)> reply_status{mock_sftp_reply_status,
+                                                             [this](auto...) {
+                                                                 eof = true;
+                                                                 return SSH_OK;
+                                                             }};
+};
+
+// Sequential reads of a large file, in chunks of the size sshfs asks for
+void BM_SftpServerRead(benchmark::State& state)
+{
+    constexpr auto file_size = 16u << 20;
+    const auto chunk_size = static_cast<uint32_t>(state.range(0));
+
+    QTemporaryDir dir;
+    const auto file_path = QDir{dir.path()}.filePath("file");
+    {
+        QFile file{file_path};
+        file.open(QIODevice::WriteOnly);
+        file.resize(file_size);
+    }
+
+    SftpTransport transport;
+    auto sftp = transport.make_sftpserver(dir.path().toStdString());
+    const auto named_fd = MP_FILEOPS.open_fd(file_path.toStdString(), O_RDONLY, 0);
+    transport.handle = named_fd.get();
+
+    sftp_client_message_struct read_msg{.type = SFTP_READ};
+    read_msg.len = chunk_size;
+    for (auto _ : state)
+    {
+        transport.next_msg = &read_msg;
+        sftp.serve_next();
+        read_msg.offset = (read_msg.offset + chunk_size) % file_size;
+    }
+
+    state.SetBytesProcessed(state.iterations() * chunk_size);
+}
+BENCHMARK(BM_SftpServerRead)->RangeMultiplier(4)->Range(4 << 10, 64 << 10);
+
+// Listing a whole directory, as in an `ls` of a mounted directory
+void BM_SftpServerReaddir(benchmark::State& state)
+{
+    const auto num_entries = state.range(0);
+
+    QTemporaryDir dir;
+    for (auto i = 0; i < num_entries; ++i)
+    {
+        QFile file{QDir{dir.path()}.filePath(QString::fromStdString(fmt::format("file-{}", i)))};
+        file.open(QIODevice::WriteOnly);
+    }
+
+    SftpTransport transport;
+    auto sftp = transport.make_sftpserver(dir.path().toStdString());
+
+    sftp_client_message_struct readdir_msg{.type = SFTP_READDIR};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        std::error_code err;
+        auto dir_iterator = MP_FILEOPS.dir_iterator(dir.path().toStdString(), err);
+        transport.handle = dir_iterator.get();
+        transport.eof = false;
+        state.ResumeTiming();
+
+        while (!transport.eof)
+        {
+            transport.next_msg = &readdir_msg;
+            sftp.serve_next();
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * num_entries);
+}
+BENCHMARK(BM_SftpServerReaddir)->RangeMultiplier(8)->Range(8, 4096);
+} // namespace
@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <multipass/format.h>
+#include <multipass/simple_streams_manifest.h>
+
+#include <benchmark/benchmark.h>
+
+#include <boost/json.hpp>
+
+#include <QHash>
+#include <QSysInfo>
+
+#include <string>
+
+namespace mp = multipass;
+
+namespace
+{
+// The host architecture as SimpleStreamsManifest names it, so that the products below are kept
+std::string manifest_arch()
+{
+    const QHash<QString, QString> arch_to_manifest{{"x86_64", "amd64"},
+                                                   {"arm", "armhf"},
+                                                   {"power", "powerpc"},
+                                                   {"power64", "ppc64el"},
+                                                   {"power64le", "ppc64el"}};
+    const auto arch = QSysInfo::currentCpuArchitecture();
+    return arch_to_manifest.value(arch, arch).toStdString();
+}
+
+// A manifest shaped like cloud-images.ubuntu.com's, with a few dated versions per product and
+// as many products for other architectures, which the parser must skip
+QByteArray make_manifest(int num_products)
+{
+    constexpr auto num_versions = 4;
+    const auto host_arch = manifest_arch();
+
+    boost::json::object products;
+    for (int i = 0; i < num_products; ++i)
+    {
+        for (const auto& arch : {host_arch, std::string{"s390x"}})
+        {
+            boost::json::object versions;
+            for (int v = 0; v < num_versions; ++v)
+            {
+                const auto version = fmt::format("202401{:02}", v + 1);
+                const auto path = fmt::format("server/releases/r{}/release-{}/ubuntu-{}.img",
+                                              i,
+                                              version,
+                                              arch);
+                versions[version] = {
+                    {"items",
+                     {{"disk1.img",
+                       {{"path", path},
+                        {"sha256", std::string(64, 'a')},
+                        {"size", 654311424}}}}},
+                    {"pubname", fmt::format("ubuntu-r{}-{}-server-{}", i, arch, version)}};
+            }
+
+            products[fmt::format("com.ubuntu.cloud:server:{}.04:{}", i, arch)] = {
+                {"aliases", fmt::format("r{0},{0}.04", i)},
+                {"arch", arch},
+                {"os", "ubuntu"},
+                {"release", fmt::format("r{}", i)},
+                {"release_codename", fmt::format("Release {}", i)},
+                {"release_title", fmt::format("{}.04 LTS", i)},
+                {"supported", true},
+                {"versions", std::move(versions)}};
+        }
+    }
+
+    const boost::json::object manifest{{"updated", "Wed, 01 Jan 2024 00:00:00 +0000"},
+                                       {"products", std::move(products)}};
+    return QByteArray::fromStdString(boost::json::serialize(manifest));
+}
+
+void BM_SimpleStreamsManifestFromJson(benchmark::State& state)
+{
+    const auto json = make_manifest(state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+            mp::SimpleStreamsManifest::fromJson(json, std::nullopt, "http://stream/"));
+
+    state.SetBytesProcessed(state.iterations() * json.size());
+}
+BENCHMARK(BM_SimpleStreamsManifestFromJson)->RangeMultiplier(4)->Range(4, 256);
+
+// With a mirror, every product is also looked up in the official manifest
+void BM_SimpleStreamsManifestFromJsonWithMirror(benchmark::State& state)
+{
+    const auto json = make_manifest(state.range(0));
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(
+            mp::SimpleStreamsManifest::fromJson(json, json, "http://mirror/"));
+
+    state.SetBytesProcessed(state.iterations() * json.size() * 2);
+}
+BENCHMARK(BM_SimpleStreamsManifestFromJsonWithMirror)->RangeMultiplier(4)->Range(4, 256);
+} // namespace
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+#
+# Copyright (C) Canonical, Ltd.
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation; version 3.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+#
+
+"""Multipass network performance tests.
+
+Measures instance-to-instance TCP throughput with iperf3, first over the
+default single-queue NIC and then with `local.<instance>.network-multiqueue`
+enabled, and reports both figures."""
+
+import json
+import logging
+
+import pytest
+
+from cli.multipass import (
+    exec,
+    get_default_interface_name,
+    info,
+    launch,
+    multipass,
+)
+
+CPUS = 4
+IPERF_SECONDS = 10
+
+
+def install_iperf3(name):
+    """Install iperf3 inside the instance."""
+    assert exec(name, "sudo", "apt-get", "update", "-q", timeout=300)
+    assert exec(
+        name,
+        "sudo",
+        "env",
+        "DEBIAN_FRONTEND=noninteractive",
+        "apt-get",
+        "install",
+        "-y",
+        "-q",
+        "iperf3",
+        timeout=300,
+    )
+
+
+def queue_count(name):
+    """Return how many receive queues the default interface of the instance has."""
+    iface = get_default_interface_name(name)
+    with exec(name, "ls", f"/sys/class/net/{iface}/queues") as result:
+        assert result, f"Failed: {result.content} ({result.exitstatus})"
+        return sum(1 for queue in result.content.split() if queue.startswith("rx-"))
+
+
+def measure_throughput(server, client):
+    """Run one parallel stream per CPU from the client to the server and
+    return the received throughput, in Gbit/s."""
+    server_ip = info(server)[server]["ipv4"][0]
+
+    assert exec(server, "iperf3", "--server", "--daemon", "--one-off")
+    with exec(
+        client,
+        "iperf3",
+        "--client",
+        server_ip,
+        "--parallel",
+        CPUS,
+        "--time",
+        IPERF_SECONDS,
+        "--json",
+        timeout=IPERF_SECONDS + 60,
+    ) as result:
+        assert result, f"Failed: {result.content} ({result.exitstatus})"
+        report = json.loads(result.content)
+
+    return report["end"]["sum_received"]["bits_per_second"] / 1e9
+
+
+def set_multiqueue(names, value):
+    """Stop the instances, toggle multiqueue networking and start them again."""
+    assert multipass("stop", *names)
+    for name in names:
+        assert multipass("set", f"local.{name}.network-multiqueue={value}")
+    assert multipass("start", *names, timeout=300)
+
+
+@pytest.mark.network_performance
+@pytest.mark.slow
+@pytest.mark.usefixtures("multipassd")
+class TestNetworkPerformance:
+    """Network throughput benchmarks."""
+
+    def test_multiqueue_network_throughput(self):
+        """Compare throughput between two instances with and without
+        multiqueue networking."""
+
+        vm_cfg = {"cpus": CPUS, "memory": "2G", "disk": "8G"}
+        with launch(vm_cfg) as server, launch(vm_cfg) as client:
+            for name in (server, client):
+                install_iperf3(name)
+                assert queue_count(name) == 1
+
+            single_queue = measure_throughput(server, client)
+
+            set_multiqueue((server, client), "true")
+            for name in (server, client):
+                assert multipass("get", f"local.{name}.network-multiqueue") == "true"
+                assert queue_count(name) == CPUS
+
+            multi_queue = measure_throughput(server, client)
+
+            logging.info(
+                "iperf3 throughput with %d streams: single queue %.2f Gbit/s, "
+                "multiqueue %.2f Gbit/s",
+                CPUS,
+                single_queue,
+                multi_queue,
+            )
+            assert single_queue > 0
+            assert multi_queue > 0
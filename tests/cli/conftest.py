@@ -326,11 +326,22 @@ def pytest_collection_modifyitems(config, items):
                 )
             )
 
+    def maybe_skip_network_performance_test(item):
+        if not item.get_closest_marker("network_performance"):
+            return
+        if sys.platform != "linux" or cfg.driver != "qemu":
+            item.add_marker(
+                pytest.mark.skip(
+                    "Skipped -- Multiqueue networking is only available with QEMU on Linux."
+                )
+            )
+
     for item in items:
         maybe_skip_mount_test(item)
         maybe_skip_clone_test(item)
         maybe_skip_snapshot_test(item)
         maybe_skip_suspend_test(item)
+        maybe_skip_network_performance_test(item)
 
 
 def pytest_runtest_setup(item):
@@ -228,7 +228,8 @@ TEST_F(AppleVZVirtualMachineFactory_UnitTests, cloneCopiesRelevantFiles)
                                    dest_vm_name,
                                    {},
                                    stub_key_provider,
-                                   stub_monitor));
+                                   stub_monitor,
+                                   {}));
 
     std::unordered_set<std::string> actual_files;
     for (const auto& file : fs::directory_iterator(dest_vm_dir))
@@ -43,6 +43,7 @@ add_c_mocks(
   ssh_channel_request_pty
   ssh_channel_change_pty_size
   ssh_channel_read_timeout
+  ssh_channel_poll_timeout
   ssh_channel_get_exit_state
   ssh_channel_free
   ssh_event_new
@@ -734,6 +734,13 @@ template grpc::Status mpt::DaemonTestFixture::call_daemon_slot(
                          mp::DaemonRpcContext*),
     const mp::SuspendRequest&,
     StrictMock<mpt::MockServerReaderWriter<mp::SuspendReply, mp::SuspendRequest>>&&);
+template grpc::Status mpt::DaemonTestFixture::call_daemon_slot(
+    mp::Daemon&,
+    void (mp::Daemon::*)(const mp::SuspendRequest*,
+                         grpc::ServerReaderWriterInterface<mp::SuspendReply, mp::SuspendRequest>*,
+                         mp::DaemonRpcContext*),
+    const mp::SuspendRequest&,
+    StrictMock<mpt::MockServerReaderWriter<mp::SuspendReply, mp::SuspendRequest>>&);
 template grpc::Status mpt::DaemonTestFixture::call_daemon_slot(
     mp::Daemon&,
     void (mp::Daemon::*)(const mp::SnapshotRequest*,
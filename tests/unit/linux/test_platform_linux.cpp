@@ -43,7 +43,17 @@
 #include <QFile>
 #include <QString>
 
+#include <arpa/inet.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+
+#include <cstddef>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <span>
 #include <stdexcept>
+#include <system_error>
 #include <tests/unit/mock_platform.h>
 #include <tests/unit/stub_availability_zone_manager.h>
 
@@ -172,6 +182,36 @@ INSTANTIATE_TEST_SUITE_P(PlatformLinux,
                          TestUnsupportedDrivers,
                          Values(QStringLiteral("hyper-v"), QStringLiteral("other")));
 
+TEST_F(PlatformLinux, cloneFileCopiesDataAroundHoles)
+{
+    const mpt::TempDir tmp_dir;
+    const std::filesystem::path source = tmp_dir.path().toStdString() + "/disk.img";
+    const std::filesystem::path dest = tmp_dir.path().toStdString() + "/clone.img";
+    constexpr auto hole_size = 8 * 1024 * 1024;
+
+    {
+        std::ofstream image{source, std::ios::binary};
+        image << "head";
+        image.seekp(hole_size);
+        image << "tail";
+    }
+    std::filesystem::permissions(source, std::filesystem::perms::owner_read);
+
+    std::vector<std::uintmax_t> progress;
+    MP_PLATFORM.clone_file(source, dest, [&progress](auto bytes) { progress.push_back(bytes); });
+
+    std::ifstream clone{dest, std::ios::binary};
+    const std::string contents{std::istreambuf_iterator<char>{clone}, {}};
+    EXPECT_EQ(contents.size(), hole_size + 4);
+    EXPECT_EQ(contents.substr(0, 4), "head");
+    EXPECT_EQ(contents.find_first_not_of('\0', 4), hole_size);
+    EXPECT_EQ(contents.substr(hole_size), "tail");
+
+    EXPECT_EQ(std::filesystem::status(dest).permissions(), std::filesystem::perms::owner_read);
+    ASSERT_THAT(progress, Not(IsEmpty()));
+    EXPECT_EQ(progress.back(), hole_size + 4);
+}
+
 TEST_F(PlatformLinux, retrievesEmptyBridges)
 {
     const mpt::TempDir tmp_dir;
@@ -684,23 +724,26 @@ TEST_F(PlatformLinux, testSnapMultipassCertLocation)
     EXPECT_EQ(snap_location.filename(), unconfined_location.filename());
 }
 
+mp::SubnetOverlapIndex make_routed_subnets()
+{
+    return mp::SubnetOverlapIndex{{mp::Subnet{"10.20.30.0/24"},
+                                   mp::Subnet{"10.192.168.0/24"},
+                                   mp::Subnet{"10.255.19.0/24"},
+                                   mp::Subnet{"172.172.0.0/16"},
+                                   mp::Subnet{"192.168.0.0/24"},
+                                   mp::Subnet{"192.168.123.0/24"}}};
+}
+
 TEST_F(PlatformLinux, subnetUsedLocallyDetectsUnused)
 {
     const mp::Subnet testSubnet{"192.168.1.0/24"};
 
     auto [mock_utils, guard] = mpt::MockUtils::inject();
+    EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ping"), _, _))
+        .Times(2)
+        .WillRepeatedly(Return(false));
 
-    EXPECT_CALL(*mock_utils, run_cmd_for_output(QString("ip"), _, _)).WillOnce(Return(R"(
-default via 192.168.0.0 dev wlo1 proto dhcp src 192.168.0.1 metric 600
-10.20.30.0/24 dev lxdbr0 proto kernel scope link src 10.20.30.1
-10.192.168.0/24 dev mpqemubr0 proto kernel scope link src 10.192.168.1 linkdown
-10.255.19.0/24 dev mpbr0 proto kernel scope link src 10.255.19.1
-172.172.0.0/16 dev docker0 proto kernel scope link src 172.172.0.1 linkdown
-192.168.0.0/24 dev wlo1 proto kernel scope link src 192.168.0.1 metric 600
-192.168.123.0/24 dev virbr0 proto kernel scope link src 192.168.123.1 linkdown
-)"));
-
-    EXPECT_FALSE(MP_PLATFORM.subnet_used_locally(testSubnet));
+    EXPECT_FALSE(MP_PLATFORM.subnet_used_locally(testSubnet, make_routed_subnets()));
 }
 
 TEST_F(PlatformLinux, subnetUsedLocallyDetectsOverlapping)
@@ -708,18 +751,9 @@ TEST_F(PlatformLinux, subnetUsedLocallyDetectsOverlapping)
     const mp::Subnet testSubnet{"172.172.1.0/24"};
 
     auto [mock_utils, guard] = mpt::MockUtils::inject();
+    EXPECT_CALL(*mock_utils, run_cmd_for_status).Times(0);
 
-    EXPECT_CALL(*mock_utils, run_cmd_for_output(QString("ip"), _, _)).WillOnce(Return(R"(
-default via 192.168.0.0 dev wlo1 proto dhcp src 192.168.0.1 metric 600
-10.20.30.0/24 dev lxdbr0 proto kernel scope link src 10.20.30.1
-10.192.168.0/24 dev mpqemubr0 proto kernel scope link src 10.192.168.1 linkdown
-10.255.19.0/24 dev mpbr0 proto kernel scope link src 10.255.19.1
-172.172.0.0/16 dev docker0 proto kernel scope link src 172.172.0.1 linkdown
-192.168.0.0/24 dev wlo1 proto kernel scope link src 192.168.0.1 metric 600
-192.168.123.0/24 dev virbr0 proto kernel scope link src 192.168.123.1 linkdown
-)"));
-
-    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet));
+    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet, make_routed_subnets()));
 }
 
 TEST_F(PlatformLinux, subnetUsedLocallyDetectsConflicting)
@@ -727,37 +761,130 @@ TEST_F(PlatformLinux, subnetUsedLocallyDetectsConflicting)
     const mp::Subnet testSubnet{"10.20.30.0/24"};
 
     auto [mock_utils, guard] = mpt::MockUtils::inject();
+    EXPECT_CALL(*mock_utils, run_cmd_for_status).Times(0);
 
-    EXPECT_CALL(*mock_utils, run_cmd_for_output(QString("ip"), _, _)).WillOnce(Return(R"(
-default via 192.168.0.0 dev wlo1 proto dhcp src 192.168.0.1 metric 600
-10.20.30.0/24 dev lxdbr0 proto kernel scope link src 10.20.30.1
-10.192.168.0/24 dev mpqemubr0 proto kernel scope link src 10.192.168.1 linkdown
-10.255.19.0/24 dev mpbr0 proto kernel scope link src 10.255.19.1
-172.172.0.0/16 dev docker0 proto kernel scope link src 172.172.0.1 linkdown
-192.168.0.0/24 dev wlo1 proto kernel scope link src 192.168.0.1 metric 600
-192.168.123.0/24 dev virbr0 proto kernel scope link src 192.168.123.1 linkdown
-)"));
-
-    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet));
+    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet, make_routed_subnets()));
 }
 
-TEST_F(PlatformLinux, subnetUsedLocallyHandlesBadSubnets)
+TEST_F(PlatformLinux, subnetUsedLocallyDetectsReachableGateway)
 {
-    const mp::Subnet testSubnet{"10.255.19.0/24"};
+    const mp::Subnet testSubnet{"192.168.1.0/24"};
 
     auto [mock_utils, guard] = mpt::MockUtils::inject();
+    EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ping"), _, _)).WillOnce(Return(true));
+
+    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet, mp::SubnetOverlapIndex{}));
+}
+
+struct RouteDump
+{
+    void add_route(uint8_t family, const std::string& destination, uint8_t dst_len, uint32_t table)
+    {
+        const auto header_at = start_message(RTM_NEWROUTE);
+
+        rtmsg route{};
+        route.rtm_family = family;
+        route.rtm_dst_len = dst_len;
+        route.rtm_table = RT_TABLE_UNSPEC;
+        append(&route, sizeof(route));
+
+        append_attribute(RTA_TABLE, table);
+        if (family == AF_INET && dst_len)
+            append_attribute(RTA_DST, htonl(mp::IPAddress{destination}.as_uint32()));
+
+        finish_message(header_at);
+    }
+
+    void add_error(int error)
+    {
+        const auto header_at = start_message(NLMSG_ERROR);
+        nlmsgerr payload{};
+        payload.error = -error;
+        append(&payload, sizeof(payload));
+        finish_message(header_at);
+    }
+
+    void add_done()
+    {
+        finish_message(start_message(NLMSG_DONE));
+    }
+
+    std::span<const char> span() const
+    {
+        return {bytes.data(), bytes.size()};
+    }
+
+private:
+    size_t start_message(uint16_t type)
+    {
+        const auto header_at = bytes.size();
+        nlmsghdr header{};
+        header.nlmsg_type = type;
+        append(&header, sizeof(header));
+        return header_at;
+    }
+
+    void finish_message(size_t header_at)
+    {
+        const auto length = static_cast<uint32_t>(bytes.size() - header_at);
+        std::memcpy(bytes.data() + header_at + offsetof(nlmsghdr, nlmsg_len),
+                    &length,
+                    sizeof(length));
+        bytes.resize(header_at + NLMSG_ALIGN(length));
+    }
+
+    void append_attribute(uint16_t type, uint32_t value)
+    {
+        rtattr attribute{};
+        attribute.rta_type = type;
+        attribute.rta_len = RTA_LENGTH(sizeof(value));
+        append(&attribute, sizeof(attribute));
+        append(&value, sizeof(value));
+    }
+
+    void append(const void* data, size_t size)
+    {
+        const auto* begin = static_cast<const char*>(data);
+        bytes.insert(bytes.end(), begin, begin + size);
+        bytes.resize(NLMSG_ALIGN(bytes.size()));
+    }
+
+    std::vector<char> bytes;
+};
+
+TEST_F(PlatformLinux, collectRoutedSubnetsKeepsMainTableNetworks)
+{
+    RouteDump dump;
+    dump.add_route(AF_INET, "0.0.0.0", 0, RT_TABLE_MAIN);
+    dump.add_route(AF_INET, "10.20.30.0", 24, RT_TABLE_MAIN);
+    dump.add_route(AF_INET, "10.20.31.7", 32, RT_TABLE_MAIN);
+    dump.add_route(AF_INET, "172.172.0.0", 16, RT_TABLE_LOCAL);
+    dump.add_route(AF_INET6, "", 64, RT_TABLE_MAIN);
+    dump.add_done();
+
+    std::vector<mp::Subnet> subnets;
+    EXPECT_TRUE(mp::platform::detail::collect_routed_subnets(dump.span(), subnets));
+    EXPECT_THAT(subnets, ElementsAre(mp::Subnet{"10.20.30.0/24"}));
+}
+
+TEST_F(PlatformLinux, collectRoutedSubnetsWantsMoreWithoutDone)
+{
+    RouteDump dump;
+    dump.add_route(AF_INET, "10.20.30.0", 24, RT_TABLE_MAIN);
+
+    std::vector<mp::Subnet> subnets;
+    EXPECT_FALSE(mp::platform::detail::collect_routed_subnets(dump.span(), subnets));
+    EXPECT_THAT(subnets, ElementsAre(mp::Subnet{"10.20.30.0/24"}));
+}
+
+TEST_F(PlatformLinux, collectRoutedSubnetsThrowsOnError)
+{
+    RouteDump dump;
+    dump.add_error(EPERM);
 
-    EXPECT_CALL(*mock_utils, run_cmd_for_output(QString("ip"), _, _)).WillOnce(Return(R"(
-default via 192.168.0.0 dev wlo1 proto dhcp src 192.168.0.1 metric 600
-(incomplete) dev lxdbr0 proto kernel scope link src (unknown)
-10.192.168.0/33 dev mpqemubr0 proto kernel scope link src 10.192.168.1
-172.256.0.0/16 dev docker0 proto kernel scope link src 172.256.0.1
-10.255.19.0/24 dev mpbr0 proto kernel scope link src 10.255.19.1
-192.168.0.256/24 dev wlo1 proto kernel scope link src 192.168.0.1 metric 600
-256.168.123.0/24 dev virbr0 proto kernel scope link src 256.168.123.1 linkdown
-)"));
-
-    EXPECT_TRUE(MP_PLATFORM.subnet_used_locally(testSubnet));
+    std::vector<mp::Subnet> subnets;
+    EXPECT_THROW(mp::platform::detail::collect_routed_subnets(dump.span(), subnets),
+                 std::system_error);
 }
 
 TEST_F(PlatformLinux, getPreferredSubnetDefault)
@@ -38,7 +38,10 @@ struct MockAvailabilityZoneManager : public mp::AvailabilityZoneManager
                 get_zones,
                 (),
                 (const override));
-    MOCK_METHOD(std::string, get_automatic_zone_name, (), (override));
+    MOCK_METHOD(std::string,
+                get_automatic_zone_name,
+                (mp::ZonePlacement, const ZoneLoads&),
+                (override));
     MOCK_METHOD(std::string, get_default_zone_name, (), (const, override));
 };
 
@@ -483,5 +483,20 @@ public:
                 PrepareAsynczones_stateRaw,
                 (grpc::ClientContext * context, grpc::CompletionQueue* cq),
                 (override));
+    MOCK_METHOD(
+        (grpc::ClientReaderWriterInterface<multipass::MetricsRequest, multipass::MetricsReply>*),
+        metricsRaw,
+        (grpc::ClientContext * context),
+        (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::MetricsRequest,
+                                                        multipass::MetricsReply>*),
+                AsyncmetricsRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq, void* tag),
+                (override));
+    MOCK_METHOD((grpc::ClientAsyncReaderWriterInterface<multipass::MetricsRequest,
+                                                        multipass::MetricsReply>*),
+                PrepareAsyncmetricsRaw,
+                (grpc::ClientContext * context, grpc::CompletionQueue* cq),
+                (override));
 };
 } // namespace multipass::test
@@ -195,6 +195,12 @@ struct MockDaemon : public Daemon
                  (grpc::ServerReaderWriterInterface<ZonesStateReply, ZonesStateRequest>*),
                  DaemonRpcContext*),
                 (override));
+    MOCK_METHOD(void,
+                metrics,
+                (const MetricsRequest*,
+                 (grpc::ServerReaderWriterInterface<MetricsReply, MetricsRequest>*),
+                 DaemonRpcContext*),
+                (override));
 
     MOCK_METHOD(void,
                 wait_ready,
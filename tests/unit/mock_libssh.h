@@ -66,6 +66,10 @@ public:
                 ssh_channel_read_nonblocking,
                 (ssh_channel channel, void* dest, uint32_t count, int is_stderr),
                 (const, override));
+    MOCK_METHOD(int,
+                ssh_channel_poll_timeout,
+                (ssh_channel channel, int timeout_ms, int is_stderr),
+                (const, override));
     MOCK_METHOD(int,
                 ssh_channel_request_pty_size,
                 (ssh_channel channel, const char* term, int cols, int rows),
@@ -50,6 +50,12 @@ public:
     MOCK_METHOD(bool, link, (const char*, const char*), (const, override));
     MOCK_METHOD(bool, symlink, (const char*, const char*, bool), (const, override));
     MOCK_METHOD(int, utime, (const char*, int, int), (const, override));
+    MOCK_METHOD(void,
+                clone_file,
+                (const std::filesystem::path&,
+                 const std::filesystem::path&,
+                 const std::function<void(std::uintmax_t)>&),
+                (const, override));
     MOCK_METHOD(void,
                 create_alias_script,
                 (const std::string&, const AliasDefinition&),
@@ -67,7 +73,11 @@ public:
     MOCK_METHOD(QString, default_privileged_mounts, (), (const, override));
     MOCK_METHOD(QString, get_username, (), (const, override));
     MOCK_METHOD(std::string, bridge_nomenclature, (), (const, override));
-    MOCK_METHOD(bool, subnet_used_locally, (Subnet), (const, override));
+    MOCK_METHOD(SubnetOverlapIndex, local_subnets, (), (const, override));
+    MOCK_METHOD(bool,
+                subnet_used_locally,
+                (Subnet, const SubnetOverlapIndex&),
+                (const, override));
     MOCK_METHOD(Subnet, get_preferred_subnet, (const std::filesystem::path&), (const, override));
     MOCK_METHOD(std::filesystem::path, get_root_cert_dir, (), (const, override));
     MOCK_METHOD(void, shutdown_socket, (Socket), (const, override));
@@ -35,6 +35,7 @@ DECL_MOCK(ssh_channel_free);
 DECL_MOCK(ssh_channel_open_session);
 DECL_MOCK(ssh_channel_request_exec);
 DECL_MOCK(ssh_channel_read_timeout);
+DECL_MOCK(ssh_channel_poll_timeout);
 DECL_MOCK(ssh_channel_get_exit_state);
 DECL_MOCK(ssh_event_add_session);
 DECL_MOCK(ssh_event_new);
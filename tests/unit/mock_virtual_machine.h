@@ -103,6 +103,12 @@ struct MockVirtualMachineT : public T
                 add_network_interface,
                 (int, const std::string&, const NetworkInterface&),
                 (override));
+    MOCK_METHOD(void, set_network_multiqueue, (bool), (override));
+    MOCK_METHOD(void, set_disk_profile, (const std::string&), (override));
+    MOCK_METHOD(void, set_memory_backing, (const MemoryBacking&), (override));
+    MOCK_METHOD(void, set_cpu_affinity, (const CpuAffinity&), (override));
+    MOCK_METHOD(MemoryBalloon, memory_balloon, (), (override));
+    MOCK_METHOD(void, set_memory_balloon_target, (const MemorySize&), (override));
     MOCK_METHOD(std::unique_ptr<MountHandler>,
                 make_native_mount_handler,
                 (const std::string&, const VMMount&),
@@ -123,6 +129,10 @@ struct MockVirtualMachineT : public T
                 take_snapshot,
                 (const VMSpecs&, const std::string&, const std::string&),
                 (override));
+    MOCK_METHOD(std::shared_ptr<const Snapshot>,
+                take_live_snapshot,
+                (const VMSpecs&, const std::string&, const std::string&, std::chrono::microseconds&),
+                (override));
     MOCK_METHOD(void,
                 rename_snapshot,
                 (const std::string& old_name, const std::string& new_name),
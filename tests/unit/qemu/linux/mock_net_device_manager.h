@@ -0,0 +1,48 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "tests/unit/common.h"
+#include "tests/unit/mock_singleton_helpers.h"
+
+#include <src/platform/backends/qemu/linux/net_device_manager.h>
+
+namespace multipass
+{
+namespace test
+{
+struct MockNetDeviceManager : public NetDeviceManager
+{
+    using NetDeviceManager::NetDeviceManager;
+
+    MOCK_METHOD(std::optional<bool>, link_exists, (const QString&), (const, override));
+    MOCK_METHOD(std::optional<bool>, is_multi_queue_tap, (const QString&), (const, override));
+    MOCK_METHOD(bool, add_tap, (const QString&, bool), (const, override));
+    MOCK_METHOD(bool, add_bridge, (const QString&, const std::string&), (const, override));
+    MOCK_METHOD(bool,
+                add_address,
+                (const QString&, const IPAddress&, Subnet::PrefixLength, const IPAddress&),
+                (const, override));
+    MOCK_METHOD(bool, set_master, (const QString&, const QString&), (const, override));
+    MOCK_METHOD(bool, set_up, (const QString&), (const, override));
+    MOCK_METHOD(bool, delete_link, (const QString&), (const, override));
+
+    MP_MOCK_SINGLETON_BOILERPLATE(MockNetDeviceManager, NetDeviceManager);
+};
+} // namespace test
+} // namespace multipass
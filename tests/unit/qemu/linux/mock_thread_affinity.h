@@ -0,0 +1,40 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "tests/unit/common.h"
+#include "tests/unit/mock_singleton_helpers.h"
+
+#include <src/platform/backends/qemu/linux/thread_affinity.h>
+
+namespace multipass
+{
+namespace test
+{
+struct MockThreadAffinity : public ThreadAffinity
+{
+    using ThreadAffinity::ThreadAffinity;
+
+    MOCK_METHOD(std::vector<qint64>, threads_of, (qint64), (const, override));
+    MOCK_METHOD(std::vector<int>, get, (qint64), (const, override));
+    MOCK_METHOD(bool, set, (qint64, const std::vector<int>&), (const, override));
+
+    MP_MOCK_SINGLETON_BOILERPLATE(MockThreadAffinity, ThreadAffinity);
+};
+} // namespace test
+} // namespace multipass
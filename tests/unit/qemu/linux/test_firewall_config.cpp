@@ -26,6 +26,7 @@
 
 #include <multipass/format.h>
 
+#include <QFile>
 #include <QString>
 
 #include <tuple>
@@ -273,3 +274,147 @@ INSTANTIATE_TEST_SUITE_P(
     Values(std::make_tuple("undefined", "Cannot parse kernel version \'undefined\'"),
            std::make_tuple("4.20.1", "Kernel version does not meet minimum requirement of 5.2"),
            std::make_tuple("5.1.4", "Kernel version does not meet minimum requirement of 5.2")));
+
+namespace
+{
+struct BatchedFirewallConfig : FirewallConfig
+{
+    // Records the ruleset handed to each -restore, and serves -save with the given output
+    void simulate_save_and_restore(QByteArray saved_rules = {}, bool restore_succeeds = true)
+    {
+        factory->register_callback([=, this](mpt::MockProcess* process) {
+            if (process->program().endsWith("-save"))
+            {
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(saved_rules));
+            }
+            else if (process->program().endsWith("-restore"))
+            {
+                EXPECT_CALL(*process, execute(_)).WillOnce([=, this](int) {
+                    QFile ruleset_file{process->arguments().last()};
+                    EXPECT_TRUE(ruleset_file.open(QIODevice::ReadOnly));
+                    rulesets << QString::fromUtf8(ruleset_file.readAll());
+
+                    return mp::ProcessState{restore_succeeds ? 0 : 1, std::nullopt};
+                });
+            }
+        });
+    }
+
+    long count_processes_with_arg(const QString& arg)
+    {
+        const auto processes = factory->process_list();
+        return std::count_if(processes.cbegin(), processes.cend(), [&arg](const auto& info) {
+            return info.arguments.contains(arg);
+        });
+    }
+
+    std::unique_ptr<mpt::MockProcessFactory::Scope> factory = mpt::MockProcessFactory::Inject();
+    QStringList rulesets;
+};
+
+// What iptables-save prints once all the rules for goodbr0 are installed
+const QByteArray saved_goodbr0_rules{R"(# Generated by iptables-save
+*mangle
+:POSTROUTING ACCEPT [0:0]
+-A POSTROUTING -o goodbr0 -p udp -m udp --dport 68 -m comment --comment "generated for Multipass network goodbr0" -j CHECKSUM --checksum-fill
+COMMIT
+*nat
+:POSTROUTING ACCEPT [0:0]
+-A POSTROUTING -s 192.168.2.0/24 ! -d 192.168.2.0/24 -m comment --comment "generated for Multipass network goodbr0" -j MASQUERADE
+-A POSTROUTING -s 192.168.2.0/24 ! -d 192.168.2.0/24 -p udp -m comment --comment "generated for Multipass network goodbr0" -j MASQUERADE --to-ports 1024-65535
+-A POSTROUTING -s 192.168.2.0/24 ! -d 192.168.2.0/24 -p tcp -m comment --comment "generated for Multipass network goodbr0" -j MASQUERADE --to-ports 1024-65535
+-A POSTROUTING -s 192.168.2.0/24 -d 255.255.255.255/32 -m comment --comment "generated for Multipass network goodbr0" -j RETURN
+-A POSTROUTING -s 192.168.2.0/24 -d 224.0.0.0/24 -m comment --comment "generated for Multipass network goodbr0" -j RETURN
+COMMIT
+*filter
+:INPUT ACCEPT [0:0]
+-A INPUT -i goodbr0 -p tcp -m tcp --dport 53 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A INPUT -i goodbr0 -p udp -m udp --dport 53 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A INPUT -i goodbr0 -p udp -m udp --dport 67 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A FORWARD -i goodbr0 -o goodbr0 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A FORWARD -s 192.168.2.0/24 -i goodbr0 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A FORWARD -d 192.168.2.0/24 -o goodbr0 -m conntrack --ctstate RELATED,ESTABLISHED -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A FORWARD -i goodbr0 -m comment --comment "generated for Multipass network goodbr0" -j REJECT --reject-with icmp-port-unreachable
+-A FORWARD -o goodbr0 -m comment --comment "generated for Multipass network goodbr0" -j REJECT --reject-with icmp-port-unreachable
+-A OUTPUT -o goodbr0 -p tcp -m tcp --sport 53 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A OUTPUT -o goodbr0 -p udp -m udp --sport 53 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+-A OUTPUT -o goodbr0 -p udp -m udp --sport 67 -m comment --comment "generated for Multipass network goodbr0" -j ACCEPT
+COMMIT
+)"};
+} // namespace
+
+TEST_F(BatchedFirewallConfig, installsAllRulesInOneRestore)
+{
+    simulate_save_and_restore();
+
+    mp::BatchedFirewallConfig firewall_config{goodbr0, subnet};
+
+    ASSERT_THAT(rulesets, SizeIs(1));
+    const auto& ruleset = rulesets.front();
+    EXPECT_THAT(ruleset.toStdString(),
+                AllOf(HasSubstr("*filter\n"),
+                      HasSubstr("*nat\n"),
+                      HasSubstr("*mangle\n"),
+                      HasSubstr("-I INPUT --in-interface goodbr0 --protocol udp --dport 67 "
+                                "--jump ACCEPT --match comment --comment \"generated for "
+                                "Multipass network goodbr0\""),
+                      HasSubstr("-A FORWARD --out-interface goodbr0 --jump REJECT")));
+    EXPECT_EQ(ruleset.count("COMMIT"), 3);
+    EXPECT_EQ(ruleset.count("\n-"), 17);
+
+    EXPECT_EQ(count_processes_with_arg("--insert"), 0);
+    EXPECT_EQ(count_processes_with_arg("--append"), 0);
+}
+
+TEST_F(BatchedFirewallConfig, leavesInstalledRulesAloneWhenTheyMatch)
+{
+    simulate_save_and_restore(saved_goodbr0_rules);
+
+    mp::BatchedFirewallConfig firewall_config{goodbr0, subnet};
+    EXPECT_NO_THROW(firewall_config.verify_firewall_rules());
+
+    EXPECT_THAT(rulesets, IsEmpty());
+}
+
+TEST_F(BatchedFirewallConfig, verifyReinstallsDriftedRules)
+{
+    auto drifted = saved_goodbr0_rules;
+    drifted.replace("--dport 68", "--dport 69");
+    simulate_save_and_restore(drifted);
+
+    mp::BatchedFirewallConfig firewall_config{goodbr0, subnet};
+    firewall_config.verify_firewall_rules();
+
+    ASSERT_THAT(rulesets, SizeIs(2));
+    EXPECT_THAT(rulesets.back().toStdString(),
+                AllOf(HasSubstr("-D POSTROUTING -o goodbr0 -p udp -m udp --dport 69"),
+                      HasSubstr("-I POSTROUTING --out-interface goodbr0 --protocol udp "
+                                "--dport 68")));
+}
+
+TEST_F(BatchedFirewallConfig, dtorDeletesKnownRulesInOneRestore)
+{
+    {
+        simulate_save_and_restore(saved_goodbr0_rules);
+        mp::BatchedFirewallConfig firewall_config{goodbr0, subnet};
+    }
+
+    ASSERT_THAT(rulesets, SizeIs(1));
+    EXPECT_EQ(rulesets.front().count("\n-D "), 17);
+    EXPECT_FALSE(rulesets.front().contains("\n-I "));
+}
+
+TEST_F(BatchedFirewallConfig, fallsBackToOneProcessPerRuleWhenRestoreFails)
+{
+    simulate_save_and_restore({}, /*restore_succeeds=*/false);
+
+    logger_scope.mock_logger->screen_logs(mpl::Level::warning);
+    logger_scope.mock_logger->expect_log(mpl::Level::warning, "Falling back");
+
+    mp::BatchedFirewallConfig firewall_config{goodbr0, subnet};
+
+    EXPECT_EQ(count_processes_with_arg("--insert"), 15);
+    EXPECT_EQ(count_processes_with_arg("--append"), 2);
+    EXPECT_NO_THROW(firewall_config.verify_firewall_rules());
+}
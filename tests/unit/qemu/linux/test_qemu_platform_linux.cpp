@@ -17,6 +17,8 @@
 
 #include "mock_dnsmasq_server.h"
 #include "mock_firewall_config.h"
+#include "mock_net_device_manager.h"
+#include "mock_thread_affinity.h"
 
 #include "tests/unit/common.h"
 #include "tests/unit/mock_backend_utils.h"
@@ -31,6 +33,7 @@
 
 #include <QCoreApplication>
 
+namespace fs = std::filesystem;
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpt = multipass::test;
@@ -152,6 +155,11 @@ struct QemuPlatformLinux : public Test
     mpt::MockFirewallConfigFactory* mock_firewall_config_factory =
         firewall_config_factory_attr.first;
 
+    // Netlink reports being unavailable by default, so that devices are handled through `ip`
+    mpt::MockNetDeviceManager::GuardedMock net_device_manager_attr{
+        mpt::MockNetDeviceManager::inject<NiceMock>()};
+    mpt::MockNetDeviceManager* mock_net_device_manager = net_device_manager_attr.first;
+
     mpt::MockFileOps::GuardedMock file_ops_attr{mpt::MockFileOps::inject<NiceMock>()};
     mpt::MockFileOps* mock_file_ops = file_ops_attr.first;
 
@@ -401,6 +409,247 @@ TEST_F(QemuPlatformLinux, createTapDeviceReconfiguresExistingDevice)
     qemu_platform_linux.vm_platform_args(vm_desc);
 }
 
+TEST_F(QemuPlatformLinux, tapDevicesAreManagedThroughNetlinkWhenAvailable)
+{
+    mp::VirtualMachineDescription vm_desc;
+
+    const auto& vswitch = switches.front();
+    vm_desc.vm_name = vswitch.name;
+    vm_desc.zone = "zone1";
+    vm_desc.default_mac_address = vswitch.hw_addr;
+
+    const auto is_tap = mpt::match_qstring(StartsWith("tap-"));
+
+    // Bridges keep going through `ip`, as set up by the fixture
+    EXPECT_CALL(*mock_net_device_manager, link_exists(_)).Times(AnyNumber());
+    EXPECT_CALL(*mock_net_device_manager, set_up(_)).Times(AnyNumber());
+    EXPECT_CALL(*mock_net_device_manager, delete_link(_)).Times(AnyNumber());
+
+    EXPECT_CALL(*mock_net_device_manager, link_exists(is_tap))
+        .WillOnce(Return(false))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, add_tap(is_tap, false)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, set_master(is_tap, vswitch.bridge_name))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, set_up(is_tap)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, delete_link(is_tap)).WillOnce(Return(true));
+
+    EXPECT_CALL(*mock_utils, run_cmd_for_status(QString("ip"), Contains(is_tap), _)).Times(0);
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    qemu_platform_linux.vm_platform_args(vm_desc);
+    qemu_platform_linux.remove_resources_for(vswitch.name);
+}
+
+TEST_F(QemuPlatformLinux, multiqueueNetworkGetsOneQueuePerCoreWithVhost)
+{
+    mp::VirtualMachineDescription vm_desc;
+
+    const auto& vswitch = switches.front();
+    vm_desc.vm_name = vswitch.name;
+    vm_desc.zone = "zone1";
+    vm_desc.default_mac_address = vswitch.hw_addr;
+    vm_desc.num_cores = 4;
+    vm_desc.network_multiqueue = true;
+
+    EXPECT_CALL(
+        *mock_utils,
+        run_cmd_for_status(
+            QString("ip"),
+            ElementsAre(QString("addr"), QString("show"), mpt::match_qstring(StartsWith("tap-"))),
+            _))
+        .WillRepeatedly(Return(false));
+
+    QString tap_name;
+    EXPECT_CALL(*mock_utils,
+                run_cmd_for_status(QString("ip"),
+                                   ElementsAre(QString("tuntap"),
+                                               QString("add"),
+                                               mpt::match_qstring(StartsWith("tap-")),
+                                               QString("mode"),
+                                               QString("tap"),
+                                               QString("multi_queue")),
+                                   _))
+        .WillOnce(DoAll(WithArg<1>([&tap_name](const QStringList& args) { tap_name = args[2]; }),
+                        Return(true)));
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    const auto platform_args = qemu_platform_linux.vm_platform_args(vm_desc);
+
+#if defined Q_PROCESSOR_S390
+    const auto device = fmt::format("virtio-net-ccw,netdev=net0,mac={},mq=on", vswitch.hw_addr);
+#else
+    const auto device =
+        fmt::format("virtio-net-pci,netdev=net0,mac={},mq=on,vectors=10", vswitch.hw_addr);
+#endif
+
+    EXPECT_THAT(platform_args, Not(Contains(QString("-nic"))));
+    EXPECT_THAT(platform_args,
+                IsSupersetOf({QString("-netdev"),
+                              QString::fromStdString(fmt::format(
+                                  "tap,id=net0,ifname={},script=no,downscript=no,vhost=on,queues=4",
+                                  tap_name)),
+                              QString("-device"),
+                              QString::fromStdString(device)}));
+}
+
+TEST_F(QemuPlatformLinux, tapIsRecreatedWhenItsQueueModeChanges)
+{
+    mp::VirtualMachineDescription vm_desc;
+
+    const auto& vswitch = switches.front();
+    vm_desc.vm_name = vswitch.name;
+    vm_desc.zone = "zone1";
+    vm_desc.default_mac_address = vswitch.hw_addr;
+    vm_desc.num_cores = 2;
+    vm_desc.network_multiqueue = true;
+
+    const auto is_tap = mpt::match_qstring(StartsWith("tap-"));
+
+    EXPECT_CALL(*mock_net_device_manager, link_exists(_)).Times(AnyNumber());
+    EXPECT_CALL(*mock_net_device_manager, link_exists(is_tap)).WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, is_multi_queue_tap(is_tap)).WillOnce(Return(false));
+    EXPECT_CALL(*mock_net_device_manager, set_up(_)).Times(AnyNumber());
+    EXPECT_CALL(*mock_net_device_manager, delete_link(_)).Times(AnyNumber());
+
+    // The single-queue leftover goes away first; the replacement is removed on destruction
+    EXPECT_CALL(*mock_net_device_manager, delete_link(is_tap))
+        .Times(2)
+        .WillRepeatedly(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, add_tap(is_tap, true)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_net_device_manager, set_master(is_tap, vswitch.bridge_name))
+        .WillOnce(Return(true));
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    qemu_platform_linux.vm_platform_args(vm_desc);
+}
+
+TEST_F(QemuPlatformLinux, hugepageInstanceIsRefusedWithoutEnoughFreeHugepages)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.vm_name = "pugliese";
+    vm_desc.zone = "zone1";
+    vm_desc.mem_size = mp::MemorySize{"1G"};
+    vm_desc.memory_backing.type = mp::memory_backing_hugepages;
+
+    EXPECT_CALL(*mock_file_ops,
+                try_read_file(fs::path{"/sys/kernel/mm/hugepages/hugepages-2048kB/free_hugepages"}))
+        .WillOnce(Return("100\n"));
+    EXPECT_CALL(*mock_net_device_manager, add_tap).Times(0);
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    MP_EXPECT_THROW_THAT(qemu_platform_linux.vm_platform_args(vm_desc),
+                         std::runtime_error,
+                         mpt::match_what(AllOf(HasSubstr("pugliese"),
+                                               HasSubstr("512 needed, 100 available"),
+                                               HasSubstr("hugepages-2048kB/nr_hugepages"))));
+}
+
+TEST_F(QemuPlatformLinux, hugepagesAreCountedOnTheRequestedHostNode)
+{
+    mp::VirtualMachineDescription vm_desc;
+
+    const auto& vswitch = switches.front();
+    vm_desc.vm_name = vswitch.name;
+    vm_desc.zone = "zone1";
+    vm_desc.default_mac_address = vswitch.hw_addr;
+    vm_desc.mem_size = mp::MemorySize{"1G"};
+    vm_desc.memory_backing = {mp::memory_backing_hugepages, true, 1};
+
+    const auto node = fs::path{"/sys/devices/system/node/node1"};
+    EXPECT_CALL(*mock_file_ops, exists(TypedEq<const fs::path&>(node))).WillOnce(Return(true));
+    EXPECT_CALL(*mock_file_ops,
+                try_read_file(node / "hugepages" / "hugepages-2048kB" / "free_hugepages"))
+        .WillOnce(Return("512\n"));
+    EXPECT_CALL(
+        *mock_utils,
+        run_cmd_for_status(
+            QString("ip"),
+            ElementsAre(QString("addr"), QString("show"), mpt::match_qstring(StartsWith("tap-"))),
+            _))
+        .WillRepeatedly(Return(false));
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    EXPECT_NO_THROW(qemu_platform_linux.vm_platform_args(vm_desc));
+}
+
+TEST_F(QemuPlatformLinux, instanceIsRefusedOnMissingHostNode)
+{
+    mp::VirtualMachineDescription vm_desc;
+    vm_desc.vm_name = "troilo";
+    vm_desc.zone = "zone1";
+    vm_desc.memory_backing.host_node = 7;
+
+    EXPECT_CALL(*mock_file_ops,
+                exists(TypedEq<const fs::path&>(fs::path{"/sys/devices/system/node/node7"})))
+        .WillOnce(Return(false));
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    MP_EXPECT_THROW_THAT(qemu_platform_linux.vm_platform_args(vm_desc),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("Host NUMA node 7")));
+}
+
+TEST_F(QemuPlatformLinux, cpuAffinityConfinesAllThreadsAndPinsVcpusRoundRobin)
+{
+    auto [mock_thread_affinity, guard] = mpt::MockThreadAffinity::inject<StrictMock>();
+    const std::vector<int> cpus{2, 3, 4, 5};
+
+    EXPECT_CALL(*mock_thread_affinity, threads_of(100))
+        .WillOnce(Return(std::vector<qint64>{100, 101, 102, 103}));
+    EXPECT_CALL(*mock_thread_affinity, set(100, cpus)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_thread_affinity, set(101, cpus)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_thread_affinity, set(102, cpus)).WillOnce(Return(true));
+    EXPECT_CALL(*mock_thread_affinity, set(103, cpus)).WillOnce(Return(false)); // gone already
+    {
+        InSequence seq;
+        EXPECT_CALL(*mock_thread_affinity, set(101, std::vector<int>{2})).WillOnce(Return(true));
+        EXPECT_CALL(*mock_thread_affinity, set(102, std::vector<int>{3})).WillOnce(Return(true));
+    }
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    EXPECT_NO_THROW(qemu_platform_linux.apply_cpu_affinity(100, {101, 102}, {"2-5", true}));
+}
+
+TEST_F(QemuPlatformLinux, vcpuPinningWithoutHostCpusUsesTheProcessAffinity)
+{
+    auto [mock_thread_affinity, guard] = mpt::MockThreadAffinity::inject<StrictMock>();
+
+    EXPECT_CALL(*mock_thread_affinity, get(100)).WillOnce(Return(std::vector<int>{0, 1}));
+    {
+        InSequence seq;
+        EXPECT_CALL(*mock_thread_affinity, set(101, std::vector<int>{0})).WillOnce(Return(true));
+        EXPECT_CALL(*mock_thread_affinity, set(102, std::vector<int>{1})).WillOnce(Return(true));
+        EXPECT_CALL(*mock_thread_affinity, set(103, std::vector<int>{0})).WillOnce(Return(true));
+    }
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    qemu_platform_linux.apply_cpu_affinity(100, {101, 102, 103}, {"", true});
+}
+
+TEST_F(QemuPlatformLinux, cpuAffinityThrowsWhenTheMainThreadCannotBeConfined)
+{
+    auto [mock_thread_affinity, guard] = mpt::MockThreadAffinity::inject<NiceMock>();
+
+    EXPECT_CALL(*mock_thread_affinity, threads_of(100))
+        .WillOnce(Return(std::vector<qint64>{100, 101}));
+    EXPECT_CALL(*mock_thread_affinity, set(100, _)).WillOnce(Return(false));
+
+    mp::QemuPlatformLinux qemu_platform_linux{data_dir.path(), stub_az_manager};
+
+    MP_EXPECT_THROW_THAT(qemu_platform_linux.apply_cpu_affinity(100, {101}, {"7", false}),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("host CPUs 7")));
+}
+
 TEST_F(QemuPlatformLinux, platformHealthCheckCallsExpectedMethods)
 {
     EXPECT_CALL(*mock_backend, check_for_kvm_support()).WillOnce(Return());
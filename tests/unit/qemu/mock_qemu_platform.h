@@ -45,6 +45,14 @@ struct MockQemuPlatform : public QemuPlatform
     MOCK_METHOD(bool, needs_network_prep, (), (const override));
     MOCK_METHOD(std::string, create_bridge_with, (const NetworkInterfaceInfo&), (const, override));
     MOCK_METHOD(void, set_authorization, (std::vector<NetworkInterfaceInfo>&), (override));
+    MOCK_METHOD(bool, supports_virtiofs, (), (const, override));
+    MOCK_METHOD(bool, supports_multiqueue_network, (), (const, override));
+    MOCK_METHOD(bool, supports_memory_backing, (), (const, override));
+    MOCK_METHOD(bool, supports_cpu_affinity, (), (const, override));
+    MOCK_METHOD(void,
+                apply_cpu_affinity,
+                (qint64, const std::vector<qint64>&, const CpuAffinity&),
+                (override));
 };
 
 struct MockQemuPlatformFactory : public QemuPlatformFactory
@@ -18,11 +18,13 @@
 #include "mock_qemu_platform.h"
 
 #include "tests/unit/common.h"
+#include "tests/unit/file_operations.h"
 #include "tests/unit/mock_cloud_init_file_ops.h"
 #include "tests/unit/mock_environment_helpers.h"
 #include "tests/unit/mock_logger.h"
 #include "tests/unit/mock_platform.h"
 #include "tests/unit/mock_process_factory.h"
+#include "tests/unit/mock_settings.h"
 #include "tests/unit/mock_snapshot.h"
 #include "tests/unit/mock_status_monitor.h"
 #include "tests/unit/mock_virtual_machine.h"
@@ -40,6 +42,7 @@
 #include <src/platform/backends/qemu/qemu_virtual_machine_factory.h>
 
 #include <multipass/auto_join_thread.h>
+#include <multipass/constants.h>
 #include <multipass/exceptions/ip_unavailable_exception.h>
 #include <multipass/exceptions/start_exception.h>
 #include <multipass/exceptions/virtual_machine_state_exceptions.h>
@@ -54,6 +57,7 @@
 #include <QDir>
 #include <boost/json.hpp>
 
+#include <atomic>
 #include <thread>
 
 namespace mp = multipass;
@@ -195,6 +199,9 @@ struct QemuBackend : public mpt::TestWithMockedBinPath
     std::unique_ptr<mpt::MockProcessFactory::Scope> process_factory{
         mpt::MockProcessFactory::Inject()};
 
+    mpt::MockSettings::GuardedMock mock_settings_injection = mpt::MockSettings::inject<NiceMock>();
+    mpt::MockSettings& mock_settings = *mock_settings_injection.first;
+
     std::unique_ptr<mpt::MockQemuPlatform> mock_qemu_platform{
         std::make_unique<mpt::MockQemuPlatform>()};
 
@@ -427,7 +434,10 @@ TEST_F(QemuBackend, throwsWhenShutdownWhileStarting)
 
     using namespace std::chrono_literals;
     while (machine->state != mp::VirtualMachine::State::off)
+    {
+        QCoreApplication::processEvents(); // the machine gets its own thread to kill the process
         std::this_thread::sleep_for(1ms);
+    }
 
     MP_EXPECT_THROW_THAT(machine->wait_for_cloud_init(1ms),
                          mp::StartException,
@@ -667,6 +677,50 @@ TEST_F(QemuBackend, forceShutdownKillsProcessAndLogs)
     EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::off);
 }
 
+TEST_F(QemuBackend, forceShutdownFromAnotherThreadKillsOnTheMachineThread)
+{
+    const auto machine_thread = std::this_thread::get_id();
+    process_factory->register_callback([this, machine_thread](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()) &&
+            !process->arguments().contains(
+                "-dump-vmstate")) // we only care about the actual vm process
+        {
+            EXPECT_CALL(*process, kill()).WillOnce([process, machine_thread] {
+                EXPECT_EQ(std::this_thread::get_id(), machine_thread);
+                mp::ProcessState exit_state{
+                    std::nullopt,
+                    mp::ProcessState::Error{QProcess::Crashed, QStringLiteral("Force stopped")}};
+                emit process->finished(exit_state);
+            });
+        }
+    });
+
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running;
+
+    std::atomic_bool done{false};
+    mp::AutoJoinThread thread{[&machine, &done] {
+        EXPECT_NO_THROW(machine->shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff));
+        done = true;
+    }};
+
+    using namespace std::chrono_literals;
+    while (!done)
+    {
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::off);
+}
+
 TEST_F(QemuBackend, forceShutdownNoProcessLogs)
 {
     EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
@@ -737,7 +791,7 @@ TEST_F(QemuBackend, forceShutdownSuspendedStateButNoSuspensionSnapshotInImage)
     logger_scope.mock_logger->expect_log(mpl::Level::info, "Forcing shutdown");
     logger_scope.mock_logger->expect_log(mpl::Level::debug, "No process to kill");
     logger_scope.mock_logger->expect_log(mpl::Level::warning,
-                                         "Image has no suspension snapshot, but the state is 7");
+                                         "Instance has no suspension snapshot or state file, but the state is 7");
 
     mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
 
@@ -1322,6 +1376,524 @@ TEST_F(QemuBackend, addNetworkInterface)
     EXPECT_NO_THROW(machine->add_network_interface(0, "", {"", "", true}));
 }
 
+TEST_F(QemuBackend, networkMultiqueueReachesThePlatformArgs)
+{
+    EXPECT_CALL(*mock_qemu_platform, supports_multiqueue_network()).WillOnce(Return(true));
+    EXPECT_CALL(*mock_qemu_platform,
+                vm_platform_args(Field(&mp::VirtualMachineDescription::network_multiqueue, true)))
+        .WillOnce(Return(QStringList{}));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+    machine->set_network_multiqueue(true);
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running;
+}
+
+TEST_F(QemuBackend, networkMultiqueueThrowsWhenUnsupportedByThePlatform)
+{
+    EXPECT_CALL(*mock_qemu_platform, supports_multiqueue_network()).WillOnce(Return(false));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+    EXPECT_THROW(machine->set_network_multiqueue(true), mp::NotImplementedOnThisBackendException);
+    EXPECT_NO_THROW(machine->set_network_multiqueue(false));
+}
+
+TEST_F(QemuBackend, memoryBackingThrowsWhenUnsupportedByThePlatform)
+{
+    EXPECT_CALL(*mock_qemu_platform, supports_memory_backing()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+    EXPECT_THROW(machine->set_memory_backing({mp::memory_backing_hugepages, false, {}}),
+                 mp::NotImplementedOnThisBackendException);
+    EXPECT_THROW(machine->set_memory_backing({mp::memory_backing_default, false, 0}),
+                 mp::NotImplementedOnThisBackendException);
+    EXPECT_NO_THROW(machine->set_memory_backing({mp::memory_backing_default, true, {}}));
+}
+
+TEST_F(QemuBackend, cpuAffinityThrowsWhenUnsupportedByThePlatform)
+{
+    EXPECT_CALL(*mock_qemu_platform, supports_cpu_affinity()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, stub_monitor);
+    EXPECT_THROW(machine->set_cpu_affinity({"0-3", false}),
+                 mp::NotImplementedOnThisBackendException);
+    EXPECT_THROW(machine->set_cpu_affinity({"", true}), mp::NotImplementedOnThisBackendException);
+    EXPECT_NO_THROW(machine->set_cpu_affinity({}));
+}
+
+TEST_F(QemuBackend, startAppliesCpuAffinityToTheVcpuThreads)
+{
+    const mp::CpuAffinity affinity{"4-7", true};
+    EXPECT_CALL(*mock_qemu_platform,
+                apply_cpu_affinity(200, std::vector<qint64>{201, 202}, affinity));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    process_factory->register_callback([this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            ON_CALL(*process, process_id()).WillByDefault(Return(200));
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([process](const QByteArray& data) {
+                auto json = boost::json::parse(std::string_view(data));
+                if (value_to<std::string>(json.at("execute")) == "query-cpus-fast")
+                {
+                    // vCPUs are not necessarily listed in order
+                    EXPECT_CALL(*process, read_all_standard_output())
+                        .WillRepeatedly(Return(R"({"id": "multipass-1", "return": [)"
+                                               R"({"cpu-index": 1, "thread-id": 202}, )"
+                                               R"({"cpu-index": 0, "thread-id": 201}]})"));
+                    emit process->ready_read_standard_output();
+                }
+
+                return data.size();
+            });
+        }
+    });
+
+    auto desc = default_description;
+    desc.cpu_affinity = affinity;
+    auto machine = backend.create_virtual_machine(desc, key_provider, mock_monitor);
+
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
+}
+
+TEST_F(QemuBackend, startAppliesCpuAffinityOnceQemuListsTheVcpuThreads)
+{
+    const mp::CpuAffinity affinity{"4-7", true};
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+    auto* qemu_platform = mock_qemu_platform.get();
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    mpt::MockProcess* vmproc = nullptr;
+    process_factory->register_callback([this, &vmproc](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            vmproc = process;
+            ON_CALL(*process, process_id()).WillByDefault(Return(200));
+        }
+    });
+
+    auto desc = default_description;
+    desc.cpu_affinity = affinity;
+    auto machine = backend.create_virtual_machine(desc, key_provider, mock_monitor);
+
+    // starting does not wait for QEMU to answer
+    EXPECT_CALL(*qemu_platform, apply_cpu_affinity).Times(0);
+    machine->start();
+    ASSERT_TRUE(vmproc);
+    Mock::VerifyAndClearExpectations(qemu_platform);
+
+    EXPECT_CALL(*qemu_platform, apply_cpu_affinity(200, std::vector<qint64>{201}, affinity));
+    EXPECT_CALL(*vmproc, read_all_standard_output())
+        .WillRepeatedly(Return(R"({"id": "multipass-1", "return": [)"
+                               R"({"cpu-index": 0, "thread-id": 201}]})"));
+    emit vmproc->ready_read_standard_output();
+
+    machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
+}
+
+TEST_F(QemuBackend, memoryBalloonReportsGuestStatsAndSetsTarget)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto last_update = std::make_shared<int>(0);
+    auto commands = std::make_shared<std::vector<std::string>>();
+    process_factory->register_callback([last_update, commands, this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([=](const QByteArray& data) {
+                auto json = boost::json::parse(std::string_view(data)).as_object();
+                auto execute = value_to<std::string>(json.at("execute"));
+                if (!json.contains("id"))
+                    return data.size();
+
+                commands->push_back(execute);
+                boost::json::object reply{{"id", json.at("id")}, {"return", boost::json::object{}}};
+                if (execute == "query-balloon")
+                    reply["return"] = {{"actual", 2147483648}};
+                else if (execute == "qom-get")
+                    reply["return"] = {{"last-update", *last_update},
+                                       {"stats", {{"stat-available-memory", 1073741824}}}};
+
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(QByteArray::fromStdString(serialize(reply))));
+                emit process->ready_read_standard_output();
+
+                return data.size();
+            });
+        }
+    });
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, mock_monitor);
+    machine->start();
+
+    // Each call reports what QEMU replied to the previous one, starting from the full memory
+    auto balloon = machine->memory_balloon();
+    EXPECT_EQ(balloon.actual, default_description.mem_size);
+    EXPECT_FALSE(balloon.available.has_value());
+    EXPECT_THAT(*commands, ElementsAre("query-balloon", "qom-get", "qom-set"));
+
+    *last_update = 1700000000;
+    balloon = machine->memory_balloon();
+    EXPECT_EQ(balloon.actual, mp::MemorySize{"2G"});
+    EXPECT_FALSE(balloon.available.has_value());
+
+    balloon = machine->memory_balloon();
+    EXPECT_EQ(balloon.available, mp::MemorySize{"1G"});
+
+    commands->clear();
+    machine->set_memory_balloon_target(mp::MemorySize{"1536M"});
+    EXPECT_THAT(*commands, ElementsAre("balloon"));
+
+    machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
+}
+
+TEST_F(QemuBackend, liveSnapshotReportsHowLongQemuKeptTheGuestStopped)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    const auto machine_thread = std::this_thread::get_id();
+    auto commands = std::make_shared<std::vector<std::string>>();
+    process_factory->register_callback([commands, machine_thread, this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([=](const QByteArray& data) {
+                EXPECT_EQ(std::this_thread::get_id(), machine_thread);
+                auto json = boost::json::parse(std::string_view(data)).as_object();
+                auto execute = value_to<std::string>(json.at("execute"));
+                if (!json.contains("id"))
+                    return data.size();
+
+                // QEMU emits the events while executing the commands, so before replying
+                commands->push_back(execute);
+                std::string output;
+                if (execute == "stop")
+                    output = R"({"event": "STOP", )"
+                             R"("timestamp": {"seconds": 100, "microseconds": 900000}})"
+                             "\n";
+                else if (execute == "cont")
+                    output = R"({"event": "RESUME", )"
+                             R"("timestamp": {"seconds": 101, "microseconds": 150000}})"
+                             "\n";
+                output += serialize(
+                    boost::json::object{{"id", json.at("id")}, {"return", boost::json::object{}}});
+
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(QByteArray::fromStdString(output)));
+                emit process->ready_read_standard_output();
+
+                return data.size();
+            });
+        }
+    });
+
+    auto machine = backend.create_virtual_machine(default_description, key_provider, mock_monitor);
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running;
+    commands->clear();
+
+    // QEMU is heard from on the machine's thread, so the snapshot is taken from another one
+    auto& qemu_machine = dynamic_cast<mp::QemuVirtualMachine&>(*machine);
+    std::atomic_bool done{false};
+    std::chrono::microseconds pause{};
+    mp::AutoJoinThread thread{[&qemu_machine, &done, &pause] {
+        EXPECT_NO_THROW(pause = qemu_machine.capture_live_snapshot("snapshot1"));
+        done = true;
+    }};
+
+    using namespace std::chrono_literals;
+    while (!done)
+    {
+        QCoreApplication::processEvents();
+        std::this_thread::sleep_for(1ms);
+    }
+
+    EXPECT_EQ(pause, 250ms);
+    EXPECT_THAT(*commands, ElementsAre("stop", "blockdev-snapshot-internal-sync", "cont"));
+}
+
+TEST_F(QemuBackend, suspendToFileMigratesTheStateOutOfTheImage)
+{
+    EXPECT_CALL(mock_settings, get(Eq(mp::suspend_mode_key)))
+        .WillRepeatedly(Return(mp::suspend_mode_file));
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto commands = std::make_shared<std::vector<std::string>>();
+    auto migrate_uri = std::make_shared<std::string>();
+    process_factory->register_callback([commands, migrate_uri, this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([=](const QByteArray& data) {
+                auto json = boost::json::parse(std::string_view(data)).as_object();
+                auto execute = value_to<std::string>(json.at("execute"));
+                if (!json.contains("id"))
+                    return data.size();
+
+                commands->push_back(execute);
+                boost::json::object reply{{"id", json.at("id")}, {"return", boost::json::object{}}};
+                if (execute == "query-migrate-capabilities")
+                    reply["return"] = boost::json::array{
+                        boost::json::object{{"capability", "mapped-ram"}, {"state", false}}};
+                else if (execute == "query-migrate")
+                    reply["return"] = {{"status", "completed"}};
+                else if (execute == "migrate")
+                    *migrate_uri = value_to<std::string>(json.at("arguments").at("uri"));
+
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(QByteArray::fromStdString(serialize(reply))));
+                emit process->ready_read_standard_output();
+
+                return data.size();
+            });
+        }
+    });
+
+    mpt::TempDir image_dir;
+    auto desc = default_description;
+    desc.image.image_path = image_dir.filePath("image.img").toStdString();
+    mpt::make_file_with_content(image_dir.filePath("image.img"));
+
+    auto machine = backend.create_virtual_machine(desc, key_provider, mock_monitor);
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running;
+
+    EXPECT_CALL(mock_monitor,
+                update_metadata_for(_, Truly([](const boost::json::object& metadata) {
+                                        return metadata.contains("migration_options");
+                                    })));
+    EXPECT_CALL(mock_monitor, on_suspend());
+    machine->suspend();
+
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::suspended);
+    EXPECT_EQ(*migrate_uri, "file:" + image_dir.filePath("suspend.vmstate").toStdString());
+    EXPECT_THAT(*commands,
+                ElementsAre("query-migrate-capabilities",
+                            "stop",
+                            "migrate-set-capabilities",
+                            "migrate-set-parameters",
+                            "migrate",
+                            "query-migrate"));
+}
+
+TEST_F(QemuBackend, resumesFromStateFileOverQmp)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    NiceMock<mpt::MockVMStatusMonitor> mock_monitor;
+    EXPECT_CALL(mock_monitor, retrieve_metadata_for(_))
+        .WillRepeatedly(Return(boost::json::object{
+            {"migration_options",
+             {{"capabilities",
+               boost::json::array{
+                   boost::json::object{{"capability", "mapped-ram"}, {"state", true}}}},
+              {"parameters", {{"multifd-channels", 2}}}}}}));
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    auto commands = std::make_shared<std::vector<std::string>>();
+    process_factory->register_callback([commands, this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([=](const QByteArray& data) {
+                auto json = boost::json::parse(std::string_view(data)).as_object();
+                auto execute = value_to<std::string>(json.at("execute"));
+                if (!json.contains("id"))
+                    return data.size();
+
+                commands->push_back(execute);
+                boost::json::object reply{{"id", json.at("id")}, {"return", boost::json::object{}}};
+                if (execute == "query-migrate")
+                    reply["return"] = {{"status", "completed"}};
+
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(QByteArray::fromStdString(serialize(reply))));
+                emit process->ready_read_standard_output();
+
+                return data.size();
+            });
+        }
+    });
+
+    mpt::TempDir image_dir;
+    auto desc = default_description;
+    desc.image.image_path = image_dir.filePath("image.img").toStdString();
+    mpt::make_file_with_content(image_dir.filePath("image.img"));
+    mpt::make_file_with_content(image_dir.filePath("suspend.vmstate"));
+
+    auto machine = backend.create_virtual_machine(desc, key_provider, mock_monitor);
+    ASSERT_EQ(machine->current_state(), mp::VirtualMachine::State::suspended);
+
+    machine->start();
+    machine->state = mp::VirtualMachine::State::running; // Necessary to properly shutdown
+
+    auto processes = process_factory->process_list();
+    auto qemu = std::find_if(processes.cbegin(),
+                             processes.cend(),
+                             [this](const mpt::MockProcessFactory::ProcessInfo& process_info) {
+                                 return process_info.command.startsWith(
+                                     expected_qemu_system_prefix());
+                             });
+
+    ASSERT_TRUE(qemu != processes.cend());
+    EXPECT_TRUE(qemu->arguments.contains("-incoming"));
+    EXPECT_FALSE(qemu->arguments.contains("-loadvm"));
+    EXPECT_THAT(*commands,
+                ElementsAre("migrate-set-capabilities",
+                            "migrate-set-parameters",
+                            "migrate-incoming",
+                            "query-migrate",
+                            "cont"));
+    EXPECT_FALSE(QFile::exists(image_dir.filePath("suspend.vmstate")));
+}
+
+TEST_F(QemuBackend, forceShutdownDeletesSuspendStateFile)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mpt::TempDir image_dir;
+    auto desc = default_description;
+    desc.image.image_path = image_dir.filePath("image.img").toStdString();
+    mpt::make_file_with_content(image_dir.filePath("image.img"));
+    mpt::make_file_with_content(image_dir.filePath("suspend.vmstate"));
+
+    logger_scope.mock_logger->screen_logs(mpl::Level::warning);
+    logger_scope.mock_logger->expect_log(mpl::Level::info, "Deleting suspend state file");
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    const auto machine = backend.create_virtual_machine(desc, key_provider, stub_monitor);
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::suspended);
+
+    machine->shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff);
+
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::off);
+    EXPECT_FALSE(QFile::exists(image_dir.filePath("suspend.vmstate")));
+}
+
+TEST_F(QemuBackend, forceShutdownRunningStateButWithSuspendStateFile)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mpt::TempDir image_dir;
+    auto desc = default_description;
+    desc.image.image_path = image_dir.filePath("image.img").toStdString();
+    mpt::make_file_with_content(image_dir.filePath("image.img"));
+
+    logger_scope.mock_logger->screen_logs(mpl::Level::warning);
+    logger_scope.mock_logger->expect_log(mpl::Level::info, "Deleting suspend state file");
+    logger_scope.mock_logger->expect_log(mpl::Level::warning,
+                                         "Instance has a suspend state file, but the state is 4");
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+
+    const auto machine = backend.create_virtual_machine(desc, key_provider, stub_monitor);
+    mpt::make_file_with_content(image_dir.filePath("suspend.vmstate"));
+    machine->state = mp::VirtualMachine::State::running;
+    machine->shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff);
+
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::off);
+    EXPECT_FALSE(QFile::exists(image_dir.filePath("suspend.vmstate")));
+}
+
+TEST_F(QemuBackend, failedStateRestoreIsReportedWhenWaitingForTheInstance)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    process_factory->register_callback([this](mpt::MockProcess* process) {
+        if (process->program().startsWith(expected_qemu_system_prefix()))
+        {
+            EXPECT_CALL(*process, write(_)).WillRepeatedly([=](const QByteArray& data) {
+                auto json = boost::json::parse(std::string_view(data)).as_object();
+                if (!json.contains("id"))
+                    return data.size();
+
+                boost::json::object reply{{"id", json.at("id")}, {"return", boost::json::object{}}};
+                if (value_to<std::string>(json.at("execute")) == "migrate-incoming")
+                    reply = {{"id", json.at("id")},
+                             {"error", {{"class", "GenericError"}, {"desc", "bad state"}}}};
+
+                EXPECT_CALL(*process, read_all_standard_output())
+                    .WillRepeatedly(Return(QByteArray::fromStdString(serialize(reply))));
+                emit process->ready_read_standard_output();
+
+                return data.size();
+            });
+        }
+    });
+
+    logger_scope.mock_logger->screen_logs(mpl::Level::error);
+    logger_scope.mock_logger->expect_log(mpl::Level::error,
+                                         "Failed to restore the instance state");
+
+    mpt::TempDir image_dir;
+    auto desc = default_description;
+    desc.image.image_path = image_dir.filePath("image.img").toStdString();
+    mpt::make_file_with_content(image_dir.filePath("image.img"));
+    mpt::make_file_with_content(image_dir.filePath("suspend.vmstate"));
+
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+    auto machine = backend.create_virtual_machine(desc, key_provider, stub_monitor);
+
+    machine->start(); // the state is restored in the background
+
+    MP_EXPECT_THROW_THAT(machine->wait_until_ssh_up(std::chrono::seconds{1}),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("bad state")));
+    EXPECT_EQ(machine->current_state(), mp::VirtualMachine::State::off);
+    EXPECT_FALSE(QFile::exists(image_dir.filePath("suspend.vmstate")));
+}
+
 TEST_F(QemuBackend, createBridgeWithChecksWithQemuPlatform)
 {
     EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
@@ -1431,7 +2003,8 @@ TEST_F(QemuBackend, cloneCopiesRelevantFiles)
                                       dest_vm_name,
                                       {},
                                       key_provider,
-                                      stub_monitor));
+                                      stub_monitor,
+                                      {}));
 
     std::unordered_set<std::string> actual_files;
     for (const auto& file : fs::directory_iterator(dest_vm_dir))
@@ -1445,6 +2018,57 @@ TEST_F(QemuBackend, cloneCopiesRelevantFiles)
     EXPECT_EQ(actual_files, expected_files);
 }
 
+TEST_F(QemuBackend, cloneCopiesImageContentsAndReportsProgress)
+{
+    EXPECT_CALL(*mock_qemu_platform_factory, make_qemu_platform(_, _)).WillOnce([this](auto&&...) {
+        return std::move(mock_qemu_platform);
+    });
+
+    mpt::StubVMStatusMonitor stub_monitor;
+    mp::QemuVirtualMachineFactory backend{data_dir.path(), az_manager};
+    const mpt::MockCloudInitFileOps::GuardedMock mock_cloud_init_file_ops_injection =
+        mpt::MockCloudInitFileOps::inject<NiceMock>();
+
+    namespace fs = std::filesystem;
+    const fs::path instances_dir{data_dir.filePath("vault/instances/").toStdString()};
+    const fs::path src_vm_dir = instances_dir / "src";
+    const fs::path dest_vm_dir = instances_dir / "dest";
+
+    const std::string disk_contents = std::string(3 * 1024 * 1024, 'x') + "tail";
+    const std::string iso_contents = "cloud-init";
+    fs::create_directories(src_vm_dir);
+    std::ofstream(src_vm_dir / "disk.qcow2", std::ios::binary) << disk_contents;
+    std::ofstream(src_vm_dir / "cloud-init-config.iso", std::ios::binary) << iso_contents;
+
+    std::vector<int> percentages;
+    auto progress_monitor = [&percentages](int, int percentage) {
+        percentages.push_back(percentage);
+        return true;
+    };
+
+    mp::VMSpecs src_spec, dest_spec;
+    src_spec.zone = dest_spec.zone = "zone1";
+    EXPECT_TRUE(backend.clone_bare_vm(src_spec,
+                                      dest_spec,
+                                      "src",
+                                      "dest",
+                                      {},
+                                      key_provider,
+                                      stub_monitor,
+                                      progress_monitor));
+
+    auto read_file = [](const fs::path& path) {
+        std::ifstream file{path, std::ios::binary};
+        return std::string{std::istreambuf_iterator<char>{file}, {}};
+    };
+    EXPECT_EQ(read_file(dest_vm_dir / "disk.qcow2"), disk_contents);
+    EXPECT_EQ(read_file(dest_vm_dir / "cloud-init-config.iso"), iso_contents);
+
+    ASSERT_THAT(percentages, Not(IsEmpty()));
+    EXPECT_TRUE(std::is_sorted(percentages.begin(), percentages.end()));
+    EXPECT_EQ(percentages.back(), 100);
+}
+
 TEST(QemuPlatform, baseQemuPlatformReturnsExpectedValues)
 {
     mpt::MockQemuPlatform qemu_platform;
@@ -50,6 +50,10 @@ struct MockQemuVirtualMachine : mpt::MockVirtualMachineT<mp::QemuVirtualMachine>
     }
 
     MOCK_METHOD(mp::QemuVirtualMachine::MountArgs&, modifiable_mount_args, (), (override));
+    MOCK_METHOD(mp::QemuVirtualMachine::VirtiofsShares&,
+                modifiable_virtiofs_shares,
+                (),
+                (override));
 };
 
 struct CommandOutput
@@ -210,6 +214,61 @@ TEST_F(QemuMountHandlerTest, mountHandlesMountArgs)
     EXPECT_EQ(mount_args.size(), 0);
 }
 
+TEST_F(QemuMountHandlerTest, virtiofsMountHandlesMountArgsAndShares)
+{
+    const mp::VMMount virtiofs_mount{default_source,
+                                     gid_mappings,
+                                     uid_mappings,
+                                     mp::VMMount::MountType::Virtiofs};
+    mp::QemuVirtualMachine::VirtiofsShares shares;
+    EXPECT_CALL(vm, modifiable_virtiofs_shares).WillOnce(ReturnRef(shares));
+
+    {
+        mp::QemuMountHandler handler{&vm, &key_provider, default_target, virtiofs_mount};
+
+        const auto tag = tag_from_target(default_target);
+        ASSERT_EQ(shares.size(), 1);
+        const auto& share = shares.at(tag);
+        EXPECT_EQ(share.source_path, default_source);
+        EXPECT_EQ(share.uid_map, uid_mappings.front());
+        EXPECT_EQ(share.gid_map, gid_mappings.front());
+
+        ASSERT_EQ(mount_args.size(), 1);
+        EXPECT_EQ(mount_args.at(tag).second,
+                  QStringList({"-chardev",
+                               QString("socket,id=%1,path=%2")
+                                   .arg(QString::fromStdString(tag), share.socket_path),
+                               "-device",
+                               QString("vhost-user-fs-pci,chardev=%1,tag=%1")
+                                   .arg(QString::fromStdString(tag))}));
+    }
+
+    EXPECT_THAT(shares, IsEmpty());
+    EXPECT_THAT(mount_args, IsEmpty());
+}
+
+TEST_F(QemuMountHandlerTest, virtiofsMountUsesVirtiofsInInstance)
+{
+    const mp::VMMount virtiofs_mount{default_source,
+                                     gid_mappings,
+                                     uid_mappings,
+                                     mp::VMMount::MountType::Virtiofs};
+    mp::QemuVirtualMachine::VirtiofsShares shares;
+    EXPECT_CALL(vm, modifiable_virtiofs_shares).WillOnce(ReturnRef(shares));
+
+    auto session = std::make_unique<NiceMock<mpt::MockSSHSession>>();
+    expect_ssh_success(*session, "echo $PWD/target", "/home/ubuntu/target");
+    expect_ssh_success(*session, "P=\"/home/ubuntu/target\"", "/home/ubuntu/target");
+    expect_ssh_success(*session,
+                       fmt::format("sudo mount -t virtiofs {} {}",
+                                   tag_from_target(default_target),
+                                   default_target));
+    EXPECT_CALL(vm, new_ssh_session()).WillOnce(Return(std::move(session)));
+
+    mp::QemuMountHandler handler{&vm, &key_provider, default_target, virtiofs_mount};
+    EXPECT_NO_THROW(handler.activate(&server));
+}
+
 TEST_F(QemuMountHandlerTest, mountLogsInit)
 {
     logger_scope.mock_logger->expect_log(mpl::Level::info,
@@ -59,6 +59,14 @@ struct PublicQemuSnapshot : public mp::QemuSnapshot
     // clang-format on
 };
 
+struct MockQemuVirtualMachine : public mpt::MockVirtualMachineT<mp::QemuVirtualMachine>
+{
+    using mpt::MockVirtualMachineT<mp::QemuVirtualMachine>::MockVirtualMachineT;
+
+    MOCK_METHOD(std::chrono::microseconds, capture_live_snapshot, (const std::string&), (override));
+    MOCK_METHOD(void, erase_live_snapshot, (const std::string&), (override));
+};
+
 struct TestQemuSnapshot : public Test
 {
     using ArgsMatcher = Matcher<QStringList>;
@@ -102,7 +110,7 @@ struct TestQemuSnapshot : public Test
 
     mpt::StubSSHKeyProvider key_provider{};
     mpt::StubAvailabilityZone zone{};
-    NiceMock<mpt::MockVirtualMachineT<mp::QemuVirtualMachine>> vm{"qemu-vm", key_provider, zone};
+    NiceMock<MockQemuVirtualMachine> vm{"qemu-vm", key_provider, zone};
     ArgsMatcher list_args_matcher =
         ElementsAre("snapshot", "-l", QString::fromStdString(desc.image.image_path));
     const mpt::MockCloudInitFileOps::GuardedMock mock_cloud_init_file_ops_injection =
@@ -224,6 +232,49 @@ TEST_F(TestQemuSnapshot, capturesSnapshot)
     EXPECT_EQ(proc_count, 2);
 }
 
+TEST_F(TestQemuSnapshot, capturesLiveSnapshotThroughTheRunningInstance)
+{
+    auto snapshot_index = 5;
+    auto snapshot_tag = derive_tag(snapshot_index);
+    EXPECT_CALL(vm, get_snapshot_count).WillOnce(Return(snapshot_index - 1));
+    EXPECT_CALL(vm, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::running));
+    EXPECT_CALL(vm, capture_live_snapshot(snapshot_tag))
+        .WillOnce(Return(std::chrono::microseconds{1234}));
+
+    auto proc_count = 0;
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([&](mpt::MockProcess* process) {
+        ASSERT_EQ(++proc_count, 1); // only the tag check, no qemu-img snapshot -c
+
+        set_common_expectations_on(process);
+        EXPECT_THAT(process->arguments(), list_args_matcher);
+    });
+
+    quick_snapshot().capture();
+    EXPECT_EQ(proc_count, 1);
+}
+
+TEST_F(TestQemuSnapshot, erasesLiveSnapshotThroughTheRunningInstance)
+{
+    auto snapshot = loaded_snapshot();
+    auto tag = derive_tag(snapshot.get_index());
+    EXPECT_CALL(vm, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::running));
+    EXPECT_CALL(vm, erase_live_snapshot(tag));
+
+    auto proc_count = 0;
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([&](mpt::MockProcess* process) {
+        ASSERT_EQ(++proc_count, 1);
+
+        set_common_expectations_on(process);
+        EXPECT_THAT(process->arguments(), list_args_matcher);
+        set_tag_output(process, tag);
+    });
+
+    snapshot.erase();
+    EXPECT_EQ(proc_count, 1);
+}
+
 TEST_F(TestQemuSnapshot, captureThrowsOnRepeatedTag)
 {
     auto snapshot_index = 22;
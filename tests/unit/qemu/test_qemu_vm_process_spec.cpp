@@ -63,8 +63,10 @@ TEST_F(TestQemuVMProcessSpec, defaultArgumentsCorrect)
 
 #if defined Q_PROCESSOR_S390
     const auto storage_interface = "virtio-scsi-ccw";
+    const auto balloon_interface = "virtio-balloon-ccw";
 #else
     const auto storage_interface = "virtio-scsi-pci";
+    const auto balloon_interface = "virtio-balloon-pci";
 #endif
     const auto expected_uuid = QString::fromStdString(multipass::utils::make_uuid(desc.vm_name));
     EXPECT_EQ(spec.arguments(),
@@ -83,6 +85,9 @@ TEST_F(TestQemuVMProcessSpec, defaultArgumentsCorrect)
                            "2",
                            "-m",
                            "3072M",
+                           "-device",
+                           QString::fromStdString(fmt::format(
+                               "{},id=balloon0,free-page-reporting=on", balloon_interface)),
                            "-qmp",
                            "stdio",
                            "-chardev",
@@ -99,6 +104,143 @@ TEST_F(TestQemuVMProcessSpec, defaultArgumentsCorrect)
                            "path=path/to/target,mount_tag=m810e457178f448d9afffc9d950d726"}));
 }
 
+TEST_F(TestQemuVMProcessSpec, virtiofsMountsShareGuestMemory)
+{
+    const mp::QemuVirtualMachine::MountArgs virtiofs_args{
+        {"mtag",
+         {"path/to/source",
+          {"-chardev",
+           "socket,id=mtag,path=/run/multipass-virtiofs/tag.sock",
+           "-device",
+           "vhost-user-fs-pci,chardev=mtag,tag=mtag"}}}};
+    mp::QemuVMProcessSpec spec(desc, platform_args, virtiofs_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    const auto object = args.indexOf("-object");
+    ASSERT_NE(object, -1);
+    EXPECT_EQ(args[object + 1], "memory-backend-memfd,id=mem,size=3072M,share=on");
+    EXPECT_EQ(args[object + 2], "-numa");
+    EXPECT_EQ(args[object + 3], "node,memdev=mem");
+}
+
+TEST_F(TestQemuVMProcessSpec, ninePMountsDoNotShareGuestMemory)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
+
+    EXPECT_FALSE(spec.arguments().contains("-object"));
+}
+
+TEST_F(TestQemuVMProcessSpec, hugepageMemoryIsPreallocatedOnTheRequestedHostNode)
+{
+    auto hugepages_desc = desc;
+    hugepages_desc.memory_backing = {mp::memory_backing_hugepages, true, 1};
+    mp::QemuVMProcessSpec spec(hugepages_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    const auto object = args.indexOf("-object");
+    ASSERT_NE(object, -1);
+    EXPECT_EQ(args[object + 1],
+              "memory-backend-memfd,id=mem,size=3072M,share=on,hugetlb=on,hugetlbsize=2M,"
+              "prealloc=on,prealloc-threads=2,policy=bind,host-nodes=1");
+    EXPECT_EQ(args[object + 2], "-numa");
+    EXPECT_EQ(args[object + 3], "node,memdev=mem");
+}
+
+TEST_F(TestQemuVMProcessSpec, hugepageMemoryIsMadeOfWholePages)
+{
+    auto hugepages_desc = desc;
+    hugepages_desc.mem_size = mp::MemorySize{"1025M"};
+    hugepages_desc.memory_backing.type = mp::memory_backing_hugepages;
+    mp::QemuVMProcessSpec spec(hugepages_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_EQ(args[args.indexOf("-m") + 1], "1024M");
+    EXPECT_EQ(args.filter("memory-backend-memfd,id=mem,size=1024M,").size(), 1);
+}
+
+TEST_F(TestQemuVMProcessSpec, preallocatedRegularMemoryUsesRamBackend)
+{
+    auto prealloc_desc = desc;
+    prealloc_desc.memory_backing.prealloc = true;
+    mp::QemuVMProcessSpec spec(prealloc_desc, platform_args, mount_args, std::nullopt);
+
+    const auto args = spec.arguments();
+    EXPECT_EQ(args[args.indexOf("-m") + 1], "3072M");
+    EXPECT_TRUE(
+        args.contains("memory-backend-ram,id=mem,size=3072M,prealloc=on,prealloc-threads=2"));
+}
+
+TEST_F(TestQemuVMProcessSpec, pinnedMemoryIsNotReportedFree)
+{
+    auto prealloc_desc = desc;
+    prealloc_desc.memory_backing.prealloc = true;
+    auto hugepages_desc = desc;
+    hugepages_desc.memory_backing.type = mp::memory_backing_hugepages;
+
+    for (const auto& pinned_desc : {prealloc_desc, hugepages_desc})
+    {
+        mp::QemuVMProcessSpec spec(pinned_desc, platform_args, mount_args, std::nullopt);
+
+        const auto args = spec.arguments();
+        EXPECT_EQ(args.filter(",id=balloon0").size(), 1);
+        EXPECT_TRUE(args.filter("free-page-reporting").isEmpty());
+    }
+}
+
+TEST_F(TestQemuVMProcessSpec, iothreadDiskProfileServesScsiFromDedicatedThread)
+{
+    auto iothread_desc = desc;
+    iothread_desc.disk_profile = mp::disk_profile_iothread;
+    mp::QemuVMProcessSpec spec(iothread_desc, platform_args, mount_args, std::nullopt);
+
+#if defined Q_PROCESSOR_S390
+    const auto storage_interface = "virtio-scsi-ccw";
+#else
+    const auto storage_interface = "virtio-scsi-pci";
+#endif
+#if defined Q_OS_LINUX
+    const auto aio = "native";
+#else
+    const auto aio = "threads";
+#endif
+    const auto args = spec.arguments();
+    const auto object = args.indexOf("-object");
+    ASSERT_NE(object, -1);
+    EXPECT_EQ(args.mid(object, 8),
+              QStringList({"-object",
+                           "iothread,id=iothread0",
+                           "-device",
+                           QString::fromStdString(
+                               fmt::format("{},id=scsi0,iothread=iothread0,num_queues=2",
+                                           storage_interface)),
+                           "-drive",
+                           QString::fromStdString(
+                               fmt::format("file=/path/to/image,if=none,format=qcow2,"
+                                           "discard=unmap,id=hda,cache=none,aio={}",
+                                           aio)),
+                           "-device",
+                           "scsi-hd,drive=hda,bus=scsi0.0"}));
+}
+
+TEST_F(TestQemuVMProcessSpec, virtioBlkDiskProfileGetsQueuePerCore)
+{
+    auto virtio_blk_desc = desc;
+    virtio_blk_desc.disk_profile = mp::disk_profile_virtio_blk;
+    virtio_blk_desc.num_cores = 6;
+    mp::QemuVMProcessSpec spec(virtio_blk_desc, platform_args, mount_args, std::nullopt);
+
+#if defined Q_PROCESSOR_S390
+    const auto blk_interface = "virtio-blk-ccw";
+#else
+    const auto blk_interface = "virtio-blk-pci";
+#endif
+    const auto args = spec.arguments();
+    EXPECT_TRUE(args.contains(QString::fromStdString(
+        fmt::format("{},drive=hda,iothread=iothread0,num-queues=6", blk_interface))));
+    EXPECT_FALSE(args.contains("scsi-hd,drive=hda,bus=scsi0.0"));
+    EXPECT_EQ(args.filter("id=hda,cache=none,aio=").size(), 1);
+}
+
 TEST_F(TestQemuVMProcessSpec, resumeArgumentsTakenFromResumedata)
 {
     const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag",
@@ -151,6 +293,32 @@ TEST_F(TestQemuVMProcessSpec, resumeFixesVmnetFormat)
                   << mount_args.begin()->second.second);
 }
 
+TEST_F(TestQemuVMProcessSpec, resumeFromStateFileDefersIncomingMigration)
+{
+    const mp::QemuVMProcessSpec::ResumeData resume_data{"suspend_tag",
+                                                        "machine_type",
+                                                        {"-one", "-two"},
+                                                        "/path/to/suspend.vmstate"};
+
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, resume_data);
+
+    EXPECT_EQ(spec.arguments(),
+              QStringList({"-L",
+                           spec.firmware_path(),
+                           "-one",
+                           "-two",
+                           "-incoming",
+                           "defer",
+                           "-machine",
+                           "machine_type"})
+                  << mount_args.begin()->second.second);
+}
+
+TEST_F(TestQemuVMProcessSpec, suspendStateFileGoesNextToTheImage)
+{
+    EXPECT_EQ(mp::QemuVMProcessSpec::suspend_state_file(desc), "/path/to/suspend.vmstate");
+}
+
 TEST_F(TestQemuVMProcessSpec, apparmorProfileIncludesFileMountPerms)
 {
     mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
@@ -175,6 +343,23 @@ TEST_F(TestQemuVMProcessSpec, apparmorProfileIncludesDiskImages)
     EXPECT_THAT(spec.apparmor_profile().toStdString(), HasSubstr("/path/to/cloud_init.iso rk,"));
 }
 
+TEST_F(TestQemuVMProcessSpec, apparmorProfileIncludesSuspendStateFile)
+{
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
+
+    EXPECT_THAT(spec.apparmor_profile().toStdString(), HasSubstr("/path/to/suspend.vmstate rw,"));
+}
+
+TEST_F(TestQemuVMProcessSpec, apparmorProfileLimitsVirtiofsSocketsToTheirDirectory)
+{
+    mpt::UnsetEnvScope e("SNAP_NAME");
+    mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
+
+    const auto profile = spec.apparmor_profile().toStdString();
+    EXPECT_THAT(profile, HasSubstr("/run/multipass-virtiofs/*.sock rw,"));
+    EXPECT_THAT(profile, Not(HasSubstr("/tmp/")));
+}
+
 TEST_F(TestQemuVMProcessSpec, apparmorProfileIdentifier)
 {
     mp::QemuVMProcessSpec spec(desc, platform_args, mount_args, std::nullopt);
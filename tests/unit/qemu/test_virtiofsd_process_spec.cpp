@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+#include "tests/unit/common.h"
+#include "tests/unit/mock_environment_helpers.h"
+#include "tests/unit/temp_dir.h"
+
+#include <src/platform/backends/qemu/virtiofsd_process_spec.h>
+
+#include <QFile>
+#include <QFileInfo>
+
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+struct TestVirtiofsdProcessSpec : public Test
+{
+    const mp::VirtiofsShare share{"/path/to/source",
+                                  "/run/multipass-virtiofs/tag.sock",
+                                  {1000, 1001},
+                                  {100, 101}};
+    mp::VirtiofsdProcessSpec spec{"instance", "mtag", share};
+};
+
+TEST_F(TestVirtiofsdProcessSpec, programCorrect)
+{
+    EXPECT_EQ(spec.program(), "/usr/libexec/virtiofsd");
+}
+
+TEST_F(TestVirtiofsdProcessSpec, programInSnapCorrect)
+{
+    mpt::TempDir snap_dir;
+    mpt::SetEnvScope env_scope("SNAP", snap_dir.path().toUtf8());
+    mpt::SetEnvScope env_scope2("SNAP_NAME", "multipass");
+
+    EXPECT_EQ(spec.program(),
+              QFileInfo{snap_dir.path()}.canonicalFilePath() + "/usr/libexec/virtiofsd");
+}
+
+TEST_F(TestVirtiofsdProcessSpec, argumentsCorrect)
+{
+    EXPECT_THAT(spec.arguments(),
+                IsSupersetOf({QString{"--socket-path=/run/multipass-virtiofs/tag.sock"},
+                              QString{"--shared-dir=/path/to/source"},
+                              QString{"--translate-uid=map:1001:1000:1"},
+                              QString{"--translate-gid=map:101:100:1"}}));
+}
+
+TEST_F(TestVirtiofsdProcessSpec, identifierCorrect)
+{
+    EXPECT_EQ(spec.identifier(), "instance.mtag");
+}
+
+TEST_F(TestVirtiofsdProcessSpec, apparmorProfileAllowsSourceAndSocket)
+{
+    const auto profile = spec.apparmor_profile();
+
+    EXPECT_TRUE(profile.contains("/path/to/source/** rwlk,"));
+    EXPECT_TRUE(profile.contains("/run/multipass-virtiofs/tag.sock rw,"));
+}
+
+TEST(VirtiofsSocketDir, isUnderRunOutsideSnap)
+{
+    mpt::UnsetEnvScope env_scope("SNAP_NAME");
+
+    EXPECT_EQ(mp::virtiofs_socket_dir(), "/run/multipass-virtiofs");
+}
+
+TEST(VirtiofsSocketDir, isUnderSnapCommonInSnap)
+{
+    mpt::TempDir common_dir;
+    mpt::SetEnvScope env_scope("SNAP_COMMON", common_dir.path().toUtf8());
+    mpt::SetEnvScope env_scope2("SNAP_NAME", "multipass");
+
+    EXPECT_EQ(mp::virtiofs_socket_dir(),
+              QFileInfo{common_dir.path()}.canonicalFilePath() + "/virtiofs");
+}
+
+TEST(VirtiofsSocketDir, isCreatedPrivate)
+{
+    mpt::TempDir temp_dir;
+    const auto dir = temp_dir.filePath("virtiofs");
+
+    mp::make_virtiofs_socket_dir(dir);
+
+    struct stat info{};
+    ASSERT_EQ(::lstat(dir.toStdString().c_str(), &info), 0);
+    EXPECT_TRUE(S_ISDIR(info.st_mode));
+    EXPECT_EQ(info.st_mode & (S_IRWXG | S_IRWXO), 0u);
+}
+
+TEST(VirtiofsSocketDir, existingPrivateDirIsReused)
+{
+    mpt::TempDir temp_dir;
+    const auto dir = temp_dir.filePath("virtiofs");
+    ASSERT_EQ(::mkdir(dir.toStdString().c_str(), S_IRWXU), 0);
+
+    EXPECT_NO_THROW(mp::make_virtiofs_socket_dir(dir));
+}
+
+TEST(VirtiofsSocketDir, existingDirOpenToOthersIsRefused)
+{
+    mpt::TempDir temp_dir;
+    const auto dir = temp_dir.filePath("virtiofs");
+    ASSERT_EQ(::mkdir(dir.toStdString().c_str(), S_IRWXU), 0);
+    ASSERT_EQ(::chmod(dir.toStdString().c_str(), S_IRWXU | S_IRWXO | S_ISVTX), 0);
+
+    MP_EXPECT_THROW_THAT(mp::make_virtiofs_socket_dir(dir),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("refusing to use")));
+}
+
+TEST(VirtiofsSocketDir, symlinkIsRefused)
+{
+    mpt::TempDir temp_dir, target_dir;
+    const auto dir = temp_dir.filePath("virtiofs");
+    ASSERT_TRUE(QFile::link(target_dir.path(), dir));
+
+    MP_EXPECT_THROW_THAT(mp::make_virtiofs_socket_dir(dir),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("refusing to use")));
+}
+
+TEST(VirtiofsSocket, socketOwnedByTheDaemonIsAccepted)
+{
+    mpt::TempDir temp_dir;
+    const auto path = temp_dir.filePath("tag.sock");
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, path.toStdString().c_str(), sizeof(address.sun_path) - 1);
+    const auto fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_NE(fd, -1);
+    ASSERT_EQ(::bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    EXPECT_NO_THROW(mp::check_virtiofs_socket(path));
+
+    ::close(fd);
+}
+
+TEST(VirtiofsSocket, otherFilesAreRefused)
+{
+    mpt::TempDir temp_dir;
+    const auto path = temp_dir.filePath("tag.sock");
+    QFile file{path};
+    ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+
+    MP_EXPECT_THROW_THAT(mp::check_virtiofs_socket(path),
+                         std::runtime_error,
+                         mpt::match_what(HasSubstr("refusing to hand")));
+}
@@ -47,7 +47,7 @@ public:
         return true;
     }
 
-    void set_available(bool) override
+    void set_available(bool, const TransitionProgress&) override
     {
     }
 
@@ -61,7 +61,7 @@ struct StubAvailabilityZoneManager final : public AvailabilityZoneManager
         }
         throw AvailabilityZoneNotFound{name};
     }
-    std::string get_automatic_zone_name() override
+    std::string get_automatic_zone_name(ZonePlacement, const ZoneLoads&) override
     {
         return zones[0]->get_name();
     }
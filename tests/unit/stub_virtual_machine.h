@@ -137,6 +137,31 @@ struct StubVirtualMachine final : public VirtualMachine
     {
     }
 
+    void set_network_multiqueue(bool) override
+    {
+    }
+
+    void set_disk_profile(const std::string&) override
+    {
+    }
+
+    void set_memory_backing(const MemoryBacking&) override
+    {
+    }
+
+    void set_cpu_affinity(const CpuAffinity&) override
+    {
+    }
+
+    MemoryBalloon memory_balloon() override
+    {
+        return {};
+    }
+
+    void set_memory_balloon_target(const MemorySize&) override
+    {
+    }
+
     std::unique_ptr<MountHandler> make_native_mount_handler(const std::string&,
                                                             const VMMount&) override
     {
@@ -180,6 +205,14 @@ struct StubVirtualMachine final : public VirtualMachine
         return {};
     }
 
+    std::shared_ptr<const Snapshot> take_live_snapshot(const VMSpecs&,
+                                                       const std::string&,
+                                                       const std::string&,
+                                                       std::chrono::microseconds&) override
+    {
+        return {};
+    }
+
     void rename_snapshot(const std::string& /*old_name*/, const std::string& /*new_name*/) override
     {
     }
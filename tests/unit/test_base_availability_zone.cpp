@@ -26,6 +26,13 @@
 
 #include <QString>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <set>
+#include <thread>
+
 namespace mp = multipass;
 namespace mpl = multipass::logging;
 namespace mpt = multipass::test;
@@ -36,6 +43,7 @@ struct BaseAvailabilityZoneTest : public Test
     BaseAvailabilityZoneTest()
     {
         mock_logger.mock_logger->screen_logs(mpl::Level::error);
+        EXPECT_CALL(mock_platform, local_subnets).Times(AnyNumber());
     }
 
     const std::string az_name{"zone1"};
@@ -142,3 +150,122 @@ TEST_F(BaseAvailabilityZoneTest, AvailabilityStateManagement)
     // Setting to new state should notify all VMs
     zone.set_available(false);
 }
+
+TEST_F(BaseAvailabilityZoneTest, DisablingReportsEveryVmWithBoundedConcurrency)
+{
+    EXPECT_CALL(*mock_logger.mock_logger, log(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(mock_file_ops,
+                write_transactionally(QString::fromStdU16String(az_file.u16string()), _))
+        .Times(2); // Once in constructor, once in set_available
+    EXPECT_CALL(mock_platform, subnet_used_locally).WillOnce(Return(false));
+
+    std::array<NiceMock<mpt::MockVirtualMachine>, 10> mock_vms;
+    std::atomic_int in_flight{0}, most_in_flight{0};
+    for (auto i = 0u; i < mock_vms.size(); ++i)
+    {
+        ON_CALL(mock_vms[i], get_name).WillByDefault(ReturnRefOfCopy("vm" + std::to_string(i)));
+        EXPECT_CALL(mock_vms[i], set_available(false)).WillOnce([&] {
+            const auto now = ++in_flight;
+            for (auto most = most_in_flight.load(); now > most;)
+                most_in_flight.compare_exchange_weak(most, now);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+            --in_flight;
+        });
+    }
+
+    mp::BaseAvailabilityZone zone{az_name, az_dir, subnet_alloc};
+    for (auto& mock_vm : mock_vms)
+        zone.add_vm(mock_vm);
+
+    std::vector<std::size_t> done_counts;
+    std::set<std::string> reported;
+    const auto progress = [&](const mp::VirtualMachine& vm, std::size_t done, std::size_t total) {
+        EXPECT_EQ(total, mock_vms.size());
+        done_counts.push_back(done);
+        reported.insert(vm.get_name());
+    };
+    zone.set_available(false, progress);
+
+    EXPECT_FALSE(zone.is_available());
+    EXPECT_THAT(done_counts, ElementsAre(1, 2, 3, 4, 5, 6, 7, 8, 9, 10));
+    EXPECT_EQ(reported.size(), mock_vms.size());
+    EXPECT_LE(most_in_flight, 4);
+}
+
+TEST_F(BaseAvailabilityZoneTest, FailedDisablingRollsBack)
+{
+    EXPECT_CALL(*mock_logger.mock_logger, log(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(mock_file_ops,
+                write_transactionally(QString::fromStdU16String(az_file.u16string()), _))
+        .Times(2); // Once in constructor, once in set_available
+    EXPECT_CALL(mock_platform, subnet_used_locally).WillOnce(Return(false));
+
+    NiceMock<mpt::MockVirtualMachine> failing_vm;
+    EXPECT_CALL(failing_vm, set_available(false)).WillOnce(Throw(std::runtime_error{"nope"}));
+
+    mp::BaseAvailabilityZone zone{az_name, az_dir, subnet_alloc};
+    zone.add_vm(failing_vm);
+
+    MP_EXPECT_THROW_THAT(zone.set_available(false),
+                         std::runtime_error,
+                         mpt::match_what(StrEq("nope")));
+    EXPECT_TRUE(zone.is_available());
+}
+
+TEST_F(BaseAvailabilityZoneTest, EnablingBringsVmsBackInParallel)
+{
+    EXPECT_CALL(*mock_logger.mock_logger, log(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(mock_file_ops, try_read_file(az_file))
+        .WillOnce(Return(R"({"subnet": "10.0.0.0/24", "available": false})"));
+    EXPECT_CALL(mock_file_ops,
+                write_transactionally(QString::fromStdU16String(az_file.u16string()), _))
+        .Times(2); // Once in constructor, once in set_available
+
+    // each instance waits for the other to be on its way, which only happens if they go together
+    std::array<NiceMock<mpt::MockVirtualMachine>, 2> mock_vms;
+    std::atomic_int started{0};
+    for (auto& mock_vm : mock_vms)
+        EXPECT_CALL(mock_vm, set_available(true)).WillOnce([&started] {
+            ++started;
+            const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+            while (started < 2 && std::chrono::steady_clock::now() < deadline)
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+            EXPECT_EQ(started, 2);
+        });
+
+    mp::BaseAvailabilityZone zone{az_name, az_dir, subnet_alloc};
+    for (auto& mock_vm : mock_vms)
+        zone.add_vm(mock_vm);
+
+    zone.set_available(true);
+    EXPECT_TRUE(zone.is_available());
+}
+
+TEST_F(BaseAvailabilityZoneTest, AnswersOtherThreadsWhileVmsTransition)
+{
+    EXPECT_CALL(*mock_logger.mock_logger, log(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(mock_file_ops,
+                write_transactionally(QString::fromStdU16String(az_file.u16string()), _))
+        .Times(2); // Once in constructor, once in set_available
+    EXPECT_CALL(mock_platform, subnet_used_locally).WillOnce(Return(false));
+
+    mp::BaseAvailabilityZone zone{az_name, az_dir, subnet_alloc};
+
+    // like QEMU instances, which get their thread to handle their processes, and that thread may be
+    // busy with the zone in the meantime
+    NiceMock<mpt::MockVirtualMachine> mock_vm, new_vm;
+    EXPECT_CALL(mock_vm, set_available(false)).WillOnce([&zone, &new_vm] {
+        auto other_thread = std::async(std::launch::async, [&zone, &new_vm] {
+            zone.add_vm(new_vm);
+            return zone.is_available();
+        });
+
+        ASSERT_EQ(other_thread.wait_for(std::chrono::seconds{5}), std::future_status::ready);
+        EXPECT_FALSE(other_thread.get());
+    });
+    zone.add_vm(mock_vm);
+
+    zone.set_available(false);
+}
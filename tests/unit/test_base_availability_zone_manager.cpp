@@ -36,6 +36,7 @@ struct BaseAvailabilityZoneManagerTest : public Test
     BaseAvailabilityZoneManagerTest()
     {
         mock_logger.mock_logger->screen_logs(mpl::Level::error);
+        EXPECT_CALL(mock_platform, local_subnets).Times(AnyNumber());
     }
 
     const mp::fs::path data_dir{"/path/to/data"};
@@ -207,3 +208,42 @@ TEST_F(BaseAvailabilityZoneManagerTest, PrefersZone1ThenZone2ThenZone3)
 
     EXPECT_THROW(manager.get_automatic_zone_name(), mp::NoAvailabilityZoneAvailable);
 }
+
+TEST_F(BaseAvailabilityZoneManagerTest, LeastLoadedPicksAvailableZoneWithSmallestShare)
+{
+    EXPECT_CALL(*mock_logger.mock_logger, log(_, _, _)).Times(AnyNumber());
+    EXPECT_CALL(mock_file_ops, try_read_file(manager_file)).WillOnce(Return(std::nullopt));
+    EXPECT_CALL(mock_platform, get_preferred_subnet).WillOnce(Return(mp::Subnet{"192.168.0.0/16"}));
+    EXPECT_CALL(mock_platform, subnet_used_locally).WillRepeatedly(Return(false));
+
+    for (const auto& zone_name : mp::default_zone_names)
+    {
+        const auto zone_file = zones_dir / (std::string{zone_name} + ".json");
+        EXPECT_CALL(mock_file_ops, try_read_file(zone_file)).WillOnce(Return(std::nullopt));
+        EXPECT_CALL(mock_file_ops,
+                    write_transactionally(QString::fromStdU16String(zone_file.u16string()), _))
+            .Times(AnyNumber());
+    }
+
+    EXPECT_CALL(mock_file_ops, write_transactionally(manager_file_qstr, _)).Times(AnyNumber());
+
+    mp::BaseAvailabilityZoneManager manager{data_dir};
+    constexpr auto policy = mp::ZonePlacement::least_loaded;
+
+    // Without any load, the earliest zone wins the tie
+    EXPECT_EQ(manager.get_automatic_zone_name(policy, {}), "zone1");
+
+    // zone2 has fewer CPUs than zone3 but much more memory and disk, so zone3 has the smaller share
+    const mp::AvailabilityZoneManager::ZoneLoads loads{
+        {"zone1", {.instances = 4, .cpus = 8, .memory_bytes = 8 << 20, .disk_bytes = 8 << 20}},
+        {"zone2", {.instances = 1, .cpus = 1, .memory_bytes = 6 << 20, .disk_bytes = 6 << 20}},
+        {"zone3", {.instances = 2, .cpus = 2, .memory_bytes = 2 << 20, .disk_bytes = 2 << 20}}};
+    EXPECT_EQ(manager.get_automatic_zone_name(policy, loads), "zone3");
+
+    // Unavailable zones are never picked, however light
+    manager.get_zone("zone3").set_available(false);
+    EXPECT_EQ(manager.get_automatic_zone_name(policy, loads), "zone2");
+
+    // And the default policy still ignores loads
+    EXPECT_EQ(manager.get_automatic_zone_name(), "zone1");
+}
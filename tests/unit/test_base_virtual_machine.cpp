@@ -721,20 +721,25 @@ TEST_F(BaseVM, providesChildrenNames)
 
     constexpr auto name_template = "s{}";
     const auto num_snapshots = 5;
-    const mp::VMSpecs specs{};
-    for (int i = 0; i < num_snapshots; ++i)
-        vm.take_snapshot(specs, fmt::format(name_template, i), "");
+    mp::VMSpecs specs{};
+    vm.take_snapshot(specs, fmt::format(name_template, 0), "");
 
-    ASSERT_EQ(snapshot_album.size(), num_snapshots);
+    ASSERT_EQ(snapshot_album.size(), 1);
+    std::unordered_map<std::string, mp::VMMount> mounts;
+    EXPECT_CALL(*snapshot_album[0], get_mounts).WillRepeatedly(ReturnRef(mounts));
+    boost::json::object metadata;
+    EXPECT_CALL(*snapshot_album[0], get_metadata).WillRepeatedly(ReturnRef(metadata));
 
     std::vector<std::string> expected_children_names{};
     for (int i = 1; i < num_snapshots; ++i)
     {
-        EXPECT_CALL(Const(*snapshot_album[i]), get_parent())
-            .WillRepeatedly(Return(snapshot_album[0]));
+        vm.restore_snapshot(fmt::format(name_template, 0), specs);
+        vm.take_snapshot(specs, fmt::format(name_template, i), "");
         expected_children_names.push_back(fmt::format(name_template, i));
     }
 
+    ASSERT_EQ(snapshot_album.size(), num_snapshots);
+
     EXPECT_THAT(vm.get_childrens_names(snapshot_album[0].get()),
                 UnorderedElementsAreArray(expected_children_names));
 
@@ -1038,6 +1043,77 @@ TEST_F(BaseVM, loadsSnasphots)
     }
 }
 
+TEST_F(BaseVM, keepsSnapshotTreeConsistentThroughBulkLoadingAndPruning)
+{
+    static constexpr auto num_snapshots = 1000;
+    static constexpr auto name_of = [](int idx) { return fmt::format("ci{}", idx); };
+
+    // Snapshot i descends from snapshot i/2, so that every deletion below reparents two children
+    std::vector<std::shared_ptr<mp::Snapshot>> parents(num_snapshots + 1);
+    int next_idx = 1;
+    EXPECT_CALL(vm, make_specific_snapshot(_))
+        .WillRepeatedly([this, &parents, &next_idx](const QString&) {
+            const auto idx = next_idx++;
+            parents[idx] = idx > 1 ? vm.get_snapshot(idx / 2) : nullptr; // as BaseSnapshot does
+
+            auto ret = std::make_shared<NiceMock<mpt::MockSnapshot>>();
+            EXPECT_CALL(*ret, get_index).WillRepeatedly(Return(idx));
+            EXPECT_CALL(*ret, get_name).WillRepeatedly(Return(name_of(idx)));
+            EXPECT_CALL(*ret, get_parent()).WillRepeatedly(ReturnPointee(&parents[idx]));
+            EXPECT_CALL(Const(*ret), get_parent()).WillRepeatedly(ReturnPointee(&parents[idx]));
+            EXPECT_CALL(*ret, set_parent).WillRepeatedly(SaveArg<0>(&parents[idx]));
+
+            return ret;
+        });
+
+    for (int idx = 1; idx <= num_snapshots; ++idx)
+        mpt::make_file_with_content(get_snapshot_file_path(idx), "stub");
+    mpt::make_file_with_content(head_path, fmt::format("{}", num_snapshots));
+    mpt::make_file_with_content(count_path, fmt::format("{}", num_snapshots));
+
+    ASSERT_NO_THROW(vm.load_snapshots());
+    ASSERT_EQ(vm.get_num_snapshots(), num_snapshots);
+    EXPECT_THAT(vm.get_childrens_names(vm.get_snapshot(1).get()),
+                UnorderedElementsAre(name_of(2), name_of(3)));
+
+    for (int idx = 1; idx <= num_snapshots; idx += 2)
+        vm.delete_snapshot(name_of(idx));
+
+    ASSERT_EQ(vm.get_num_snapshots(), num_snapshots / 2);
+
+    std::unordered_map<const mp::Snapshot*, std::vector<std::string>> expected_children{};
+    for (const auto& snapshot : vm.view_snapshots())
+        expected_children[snapshot->get_parent().get()].push_back(snapshot->get_name());
+
+    for (const auto& [parent, children] : expected_children)
+        EXPECT_THAT(vm.get_childrens_names(parent), UnorderedElementsAreArray(children));
+
+    for (int idx = 2; idx <= num_snapshots; idx += 2)
+    {
+        EXPECT_EQ(vm.get_snapshot(idx)->get_name(), name_of(idx));
+        vm.delete_snapshot(name_of(idx));
+    }
+
+    EXPECT_EQ(vm.get_num_snapshots(), 0);
+    EXPECT_THAT(vm.get_childrens_names(nullptr), IsEmpty());
+}
+
+TEST_F(BaseVM, snapshotDeletionHandsChildrenOverToGrandparent)
+{
+    mock_snapshotting();
+
+    const mp::VMSpecs specs{};
+    for (int i = 0; i < 3; ++i)
+        vm.take_snapshot(specs, "", "");
+
+    ASSERT_EQ(snapshot_album.size(), 3);
+    vm.delete_snapshot(snapshot_album[1]->get_name());
+
+    EXPECT_THAT(vm.get_childrens_names(snapshot_album[0].get()),
+                ElementsAre(snapshot_album[2]->get_name()));
+    EXPECT_THAT(vm.get_childrens_names(snapshot_album[1].get()), IsEmpty());
+}
+
 TEST_F(BaseVM, throwsIfThereAreSnapshotsToLoadButNoGenericInfo)
 {
     auto snapshot = std::make_shared<NiceMock<mpt::MockSnapshot>>();
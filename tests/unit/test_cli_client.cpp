@@ -197,6 +197,11 @@ struct MockDaemonRpc : public mp::DaemonRpc
                 (grpc::ServerContext * context,
                  (grpc::ServerReaderWriter<mp::ZonesStateReply, mp::ZonesStateRequest> * server)),
                 (override));
+    MOCK_METHOD(grpc::Status,
+                metrics,
+                (grpc::ServerContext * context,
+                 (grpc::ServerReaderWriter<mp::MetricsReply, mp::MetricsRequest> * server)),
+                (override));
 };
 
 struct Client : public Test
@@ -448,7 +453,7 @@ struct Client : public Test
     const mpt::MockPlatform::GuardedMock platform_attr{mpt::MockPlatform::inject<NiceMock>()};
     const mpt::MockPlatform* mock_platform = platform_attr.first;
     const mpt::MockUtils::GuardedMock utils_attr{mpt::MockUtils::inject<NiceMock>()};
-    const mpt::MockUtils* mock_utils = utils_attr.first;
+    mpt::MockUtils* mock_utils = utils_attr.first;
 
     mpt::StubCertStore cert_store;
 
@@ -2238,6 +2243,17 @@ TEST_F(Client, mountCmdGoodNativeMountType)
               mp::ReturnCode::Ok);
 }
 
+TEST_F(Client, mountCmdGoodVirtiofsMountType)
+{
+    EXPECT_CALL(mock_daemon, mount)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::MountReply, mp::MountRequest>(
+            Property(&mp::MountRequest::mount_type, mp::MountRequest_MountType_VIRTIOFS),
+            grpc::Status::OK)));
+    EXPECT_EQ(send_command(
+                  {"mount", "-t", "virtiofs", mpt::test_data_path().toStdString(), "test-vm:test"}),
+              mp::ReturnCode::Ok);
+}
+
 TEST_F(Client, mountCmdFailsBogusMountType)
 {
     EXPECT_EQ(
@@ -2562,6 +2578,36 @@ TEST_F(Client, startCmdForwardsTimeoutToSubcommands)
                 Eq(mp::ReturnCode::Ok));
 }
 
+TEST_F(Client, startCmdWritesRequestedTrace)
+{
+    const std::string trace{R"({"traceEvents":[]})"};
+    const auto trace_matcher = Property(&mp::StartRequest::trace, IsTrue());
+    mp::StartReply reply;
+    reply.set_trace(trace);
+
+    EXPECT_CALL(mock_daemon, start)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::StartReply, mp::StartRequest>(
+            trace_matcher,
+            ok,
+            reply)));
+    EXPECT_CALL(*mock_utils, make_file_with_content(Eq("start.json"), Eq(trace), true));
+
+    EXPECT_THAT(send_command({"start", "foo", "--trace", "start.json"}), Eq(mp::ReturnCode::Ok));
+}
+
+TEST_F(Client, startCmdDoesNotRequestTraceByDefault)
+{
+    const auto no_trace_matcher = Property(&mp::StartRequest::trace, IsFalse());
+
+    EXPECT_CALL(mock_daemon, start)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::StartReply, mp::StartRequest>(
+            no_trace_matcher,
+            ok)));
+    EXPECT_CALL(*mock_utils, make_file_with_content(_, _, _)).Times(0);
+
+    EXPECT_THAT(send_command({"start", "foo"}), Eq(mp::ReturnCode::Ok));
+}
+
 TEST_F(Client, startCmdFailsWhenUnableToRetrieveAutomountSetting)
 {
     const auto aborted = aborted_start_status({petenv_name});
@@ -3742,6 +3788,31 @@ TEST_F(Client, cloneCmdWithDestName)
     EXPECT_EQ(send_command({"clone", "vm1", "--name", "vm2"}), mp::ReturnCode::Ok);
 }
 
+TEST_F(Client, cloneCmdShowsCopyProgress)
+{
+    EXPECT_CALL(mock_daemon, clone)
+        .WillOnce([](auto, grpc::ServerReaderWriter<mp::CloneReply, mp::CloneRequest>* server) {
+            mp::CloneReply reply;
+            reply.set_percent_complete("42");
+            server->Write(reply);
+            reply.set_percent_complete("100");
+            server->Write(reply);
+
+            reply.Clear();
+            reply.set_reply_message("Cloned from vm1 to vm1-clone1.\n");
+            server->Write(reply);
+            return grpc::Status{};
+        });
+
+    // What the spinner draws before the first update depends on timing; what follows does not
+    const std::string clear_line{"\x1B[2K\x1B[0A\x1B[0E"};
+    std::stringstream cout_stream;
+    EXPECT_EQ(send_command({"clone", "vm1"}, cout_stream), mp::ReturnCode::Ok);
+    EXPECT_THAT(cout_stream.str(),
+                EndsWith(clear_line + "\rCloning vm1: 42%" + clear_line + "\rCloning vm1: 100%\n" +
+                         clear_line + "Cloned from vm1 to vm1-clone1.\n" + clear_line));
+}
+
 TEST_F(Client, cloneCmdFailedFromDaemon)
 {
     const grpc::Status clone_failure{grpc::StatusCode::FAILED_PRECONDITION, "dummy_msg"};
@@ -3791,6 +3862,15 @@ TEST_F(Client, snapshotCmdCommentConsumesArg)
     EXPECT_EQ(send_command({"snapshot", "-m", "foo"}), mp::ReturnCode::CommandLineError);
 }
 
+TEST_F(Client, snapshotCmdLiveOptionOk)
+{
+    EXPECT_CALL(mock_daemon, snapshot)
+        .WillOnce(WithArg<1>(check_request_and_return<mp::SnapshotReply, mp::SnapshotRequest>(
+            Property(&mp::SnapshotRequest::live, IsTrue()),
+            grpc::Status::OK)));
+    EXPECT_EQ(send_command({"snapshot", "--live", "foo"}), mp::ReturnCode::Ok);
+}
+
 TEST_F(Client, snapshotCmdTooFewArgsFails)
 {
     EXPECT_EQ(send_command({"snapshot", "-m", "Who controls the past controls the future"}),
@@ -4443,6 +4523,48 @@ TEST_F(ClientAlias, aliasRefusesCreationRpcError)
     EXPECT_THAT(cout_stream.str(), csv_header + "an_alias,an_instance,a_command,map,default*\n");
 }
 
+// metrics cli tests
+TEST_F(Client, metricsCmdPrintsDaemonMetrics)
+{
+    const auto verbosity = 1;
+    const auto request_matcher = make_request_verbosity_matcher<mp::MetricsRequest>(verbosity);
+    mp::MetricsReply reply;
+    reply.set_metrics("# HELP foo_total Foos\n# TYPE foo_total counter\nfoo_total 3\n");
+
+    EXPECT_CALL(mock_daemon, metrics)
+        .WillOnce(WithArg<1>(
+            check_request_and_return<mp::MetricsReply, mp::MetricsRequest>(request_matcher,
+                                                                            ok,
+                                                                            reply)));
+
+    std::stringstream cout_stream;
+    EXPECT_EQ(send_command({"metrics", "-v"}, cout_stream), mp::ReturnCode::Ok);
+    EXPECT_EQ(cout_stream.str(), reply.metrics());
+}
+
+TEST_F(Client, metricsCmdHelpOk)
+{
+    EXPECT_EQ(send_command({"metrics", "-h"}), mp::ReturnCode::Ok);
+}
+
+TEST_F(Client, metricsCmdFailsWithArgs)
+{
+    std::stringstream cerr_stream;
+    EXPECT_EQ(send_command({"metrics", "foo"}, trash_stream, cerr_stream),
+              mp::ReturnCode::CommandLineError);
+    EXPECT_THAT(cerr_stream.str(), HasSubstr("This command takes no arguments"));
+}
+
+TEST_F(Client, metricsCmdReportsFailure)
+{
+    EXPECT_CALL(mock_daemon, metrics)
+        .WillOnce(Return(grpc::Status{grpc::StatusCode::INTERNAL, "oops"}));
+
+    std::stringstream cerr_stream;
+    EXPECT_EQ(send_command({"metrics"}, trash_stream, cerr_stream), mp::ReturnCode::CommandFail);
+    EXPECT_THAT(cerr_stream.str(), HasSubstr("oops"));
+}
+
 // zones cli tests
 TEST_F(Client, zonesCmdNoArgsOk)
 {
@@ -4510,9 +4632,10 @@ TEST_F(Client, zonesCmdFormatIsCorrectCSV)
         .WillOnce(
             WithArg<1>(check_request_and_return<mp::ZonesReply, mp::ZonesRequest>(_, ok, reply)));
     EXPECT_EQ(setup_client_and_run({"zones", "--format", "csv"}, term), mp::ReturnCode::Ok);
-    EXPECT_THAT(
-        cout.str(),
-        HasSubstr("Name,Available,Subnet\nzone1,true,192.168.1.0/24\nzone2,false,192.168.2.0/24"));
+    EXPECT_THAT(cout.str(),
+                HasSubstr("Name,Available,Subnet,Instances,CPUs,Memory,Disk\n"
+                          "zone1,true,192.168.1.0/24,0,0,0,0\n"
+                          "zone2,false,192.168.2.0/24,0,0,0,0"));
 }
 
 // enable_zones tests
@@ -403,6 +403,60 @@ write_files:
     EXPECT_EQ(original_iso, new_iso);
 }
 
+TEST_F(CloudInitIso, readsIsoFileWithDirectoriesSpanningMultipleBlocks)
+{
+    mp::CloudInitIso original_iso;
+    for (auto i = 0; i < 200; ++i)
+        original_iso.add_file(fmt::format("file-number-{}", i), std::string(i * 37, 'x'));
+    original_iso.add_file("user-data", std::string(3 * 1024 * 1024, 'u'));
+    original_iso.write_to(iso_path);
+
+    mp::CloudInitIso new_iso;
+    new_iso.read_from(iso_path);
+    EXPECT_EQ(original_iso, new_iso);
+}
+
+TEST_F(CloudInitIso, writeChangesPatchesFilesThatFitInPlace)
+{
+    mp::CloudInitIso original_iso;
+    original_iso.add_file("meta-data", default_meta_data_content);
+    original_iso.add_file("network-config", "dummy_data");
+    original_iso.write_to(iso_path);
+    const auto original_size = std::filesystem::file_size(iso_path);
+
+    mp::CloudInitIso iso;
+    iso.read_from(iso_path);
+    iso["network-config"] = "some longer, but still small, network data";
+    iso.write_changes_to(iso_path);
+
+    EXPECT_EQ(std::filesystem::file_size(iso_path), original_size);
+
+    mp::CloudInitIso new_iso;
+    new_iso.read_from(iso_path);
+    EXPECT_EQ(new_iso, iso);
+}
+
+TEST_F(CloudInitIso, writeChangesRewritesImageWhenFilesDoNotFit)
+{
+    mp::CloudInitIso original_iso;
+    original_iso.add_file("meta-data", default_meta_data_content);
+    original_iso.add_file("network-config", "dummy_data");
+    original_iso.write_to(iso_path);
+    const auto original_size = std::filesystem::file_size(iso_path);
+
+    mp::CloudInitIso iso;
+    iso.read_from(iso_path);
+    iso["meta-data"] = std::string(5000, 'm');
+    iso["user-data"] = "#cloud-config";
+    iso.write_changes_to(iso_path);
+
+    EXPECT_GT(std::filesystem::file_size(iso_path), original_size);
+
+    mp::CloudInitIso new_iso;
+    new_iso.read_from(iso_path);
+    EXPECT_EQ(new_iso, iso);
+}
+
 TEST_F(CloudInitIso, updateCloudInitWithNewNonEmptyExtraInterfaces)
 {
     mp::CloudInitIso original_iso;
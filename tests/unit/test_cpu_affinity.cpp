@@ -0,0 +1,82 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <multipass/cpu_affinity.h>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+struct TestCpuList : public TestWithParam<std::pair<std::string, std::vector<int>>>
+{
+};
+
+TEST_P(TestCpuList, parsesCpuList)
+{
+    const auto& [list, cpus] = GetParam();
+    EXPECT_EQ(mp::parse_cpu_list(list), cpus);
+}
+
+INSTANTIATE_TEST_SUITE_P(CpuAffinity,
+                         TestCpuList,
+                         Values(std::make_pair("0", std::vector<int>{0}),
+                                std::make_pair("0-3", std::vector<int>{0, 1, 2, 3}),
+                                std::make_pair("8,0-2", std::vector<int>{0, 1, 2, 8}),
+                                std::make_pair("3,1-3,1", std::vector<int>{1, 2, 3}),
+                                std::make_pair("5-5", std::vector<int>{5})));
+
+struct TestBadCpuList : public TestWithParam<std::string>
+{
+};
+
+TEST_P(TestBadCpuList, refusesMalformedCpuList)
+{
+    MP_EXPECT_THROW_THAT(mp::parse_cpu_list(GetParam()),
+                         std::invalid_argument,
+                         mpt::match_what(HasSubstr(GetParam())));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    CpuAffinity,
+    TestBadCpuList,
+    Values("", ",", "0,", "a", "1-", "-1", "3-1", "1 ", "+1", "0-9000", "1-2-3"));
+
+TEST(CpuAffinity, formatsShortestCpuList)
+{
+    EXPECT_EQ(mp::format_cpu_list({}), "");
+    EXPECT_EQ(mp::format_cpu_list({4}), "4");
+    EXPECT_EQ(mp::format_cpu_list({8, 3, 0, 1, 2, 2}), "0-3,8");
+    EXPECT_EQ(mp::format_cpu_list({1, 3, 5, 6}), "1,3,5-6");
+}
+
+TEST(CpuAffinity, formattedListParsesBack)
+{
+    const std::vector<int> cpus{0, 2, 3, 4, 7, 9, 10};
+    EXPECT_EQ(mp::parse_cpu_list(mp::format_cpu_list(cpus)), cpus);
+}
+
+TEST(CpuAffinity, roundTripsThroughJson)
+{
+    const mp::CpuAffinity affinity{"0-3,8", true};
+    EXPECT_EQ(boost::json::value_to<mp::CpuAffinity>(boost::json::value_from(affinity)), affinity);
+}
+} // namespace
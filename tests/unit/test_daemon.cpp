@@ -47,7 +47,9 @@
 #include <multipass/constants.h>
 #include <multipass/image_host/vm_image_host.h>
 #include <multipass/logging/log.h>
+#include <multipass/metrics.h>
 #include <multipass/name_generator.h>
+#include <multipass/record_database.h>
 #include <multipass/signal.h>
 #include <multipass/version.h>
 #include <multipass/virtual_machine_factory.h>
@@ -56,6 +58,7 @@
 
 #include <scope_guard.hpp>
 
+#include <QCoreApplication>
 #include <QNetworkProxyFactory>
 #include <QStorageInfo>
 #include <QString>
@@ -139,6 +142,24 @@ a few more tests for `false`, since there are different portions of code dependi
         EXPECT_CALL(mock_settings, get(Eq(mp::winterm_key))).WillRepeatedly(Return("none"));
         EXPECT_CALL(mock_settings, get(Eq(mp::bridged_interface_key)))
             .WillRepeatedly(Return("eth8"));
+        EXPECT_CALL(mock_settings, get(Eq(mp::autostart_concurrency_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(mp::autostart_concurrency_default));
+        EXPECT_CALL(mock_settings, get(Eq(mp::autostart_priority_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(""));
+        EXPECT_CALL(mock_settings, get(Eq(mp::memory_reclaim_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return("false"));
+        EXPECT_CALL(mock_settings, get(Eq(mp::multiplexed_mounts_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return("false"));
+        EXPECT_CALL(mock_settings, get(Eq(mp::zone_placement_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(mp::zone_placement_least_loaded));
+        EXPECT_CALL(mock_settings, get(Eq(mp::warm_pool_size_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return("0"));
     }
 
     mpt::MockUtils::GuardedMock mock_utils_injection{mpt::MockUtils::inject<NiceMock>()};
@@ -272,6 +293,10 @@ TEST_F(Daemon, receivesCommandsAndCallsCorrespondingSlot)
         .WillRepeatedly(Invoke(
             &daemon,
             &mpt::MockDaemon::set_promise_value<mp::ZonesStateRequest, mp::ZonesStateReply>));
+    EXPECT_CALL(daemon, metrics)
+        .WillOnce(Invoke(
+            &daemon,
+            &mpt::MockDaemon::set_promise_value<mp::MetricsRequest, mp::MetricsReply>));
     EXPECT_CALL(mock_settings, get(Eq("foo"))).WillRepeatedly(Return("bar"));
 
     send_commands({
@@ -302,6 +327,7 @@ TEST_F(Daemon, receivesCommandsAndCallsCorrespondingSlot)
         {"zones"},
         {"enable-zones", "foo"},
         {"disable-zones", "foo", "--force"},
+        {"metrics"},
     });
 }
 
@@ -317,6 +343,23 @@ TEST_F(Daemon, providesVersion)
         call_daemon_slot(daemon, &mp::Daemon::version, mp::VersionRequest{}, mock_server).ok());
 }
 
+TEST_F(Daemon, providesMetrics)
+{
+    mp::metrics::registry().counter("multipass_test_total", "A test counter").increment();
+
+    mp::Daemon daemon{config_builder.build()};
+    StrictMock<mpt::MockServerReaderWriter<mp::MetricsReply, mp::MetricsRequest>> mock_server;
+    EXPECT_CALL(mock_server,
+                Write(Property(&mp::MetricsReply::metrics,
+                               AllOf(HasSubstr("# TYPE multipass_test_total counter\n"),
+                                     ContainsRegex("\nmultipass_test_total [1-9][0-9]*\n"))),
+                      _))
+        .WillOnce(Return(true));
+
+    EXPECT_TRUE(
+        call_daemon_slot(daemon, &mp::Daemon::metrics, mp::MetricsRequest{}, mock_server).ok());
+}
+
 TEST_F(Daemon, failedRestartCommandReturnsFulfilledPromise)
 {
     mp::Daemon daemon{config_builder.build()};
@@ -483,6 +526,147 @@ TEST_F(Daemon, startsPreviouslyRunningVmsBack)
     mp::Daemon daemon{config_builder.build()};
 }
 
+TEST_F(Daemon, restartsPreviouslyRunningVmsThroughPrioritizedBootQueue)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+
+    constexpr auto instance_json = R"({
+        "alpha": {
+                "deleted": false,
+                "disk_space": "3232323232",
+                "mac_addr": "52:54:00:00:00:01",
+                "mem_size": "2323232323",
+                "metadata": {},
+                "mounts": [],
+                "num_cores": 4,
+                "ssh_username": "ubuntu",
+                "state": 4
+        },
+        "bravo": {
+                "deleted": false,
+                "disk_space": "3232323232",
+                "mac_addr": "52:54:00:00:00:02",
+                "mem_size": "2323232323",
+                "metadata": {},
+                "mounts": [],
+                "num_cores": 4,
+                "ssh_username": "ubuntu",
+                "state": 4
+        },
+        "charlie": {
+                "deleted": false,
+                "disk_space": "3232323232",
+                "mac_addr": "52:54:00:00:00:03",
+                "mem_size": "2323232323",
+                "metadata": {},
+                "mounts": [],
+                "num_cores": 4,
+                "ssh_username": "ubuntu",
+                "state": 4
+        }
+})";
+    const auto [temp_dir, _] = plant_instance_json(instance_json);
+    config_builder.data_directory = temp_dir->path();
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    // Only one instance may boot at a time, and the one named in the priority list goes first.
+    // The rest would follow once it is up, but the daemon is gone by then.
+    EXPECT_CALL(mock_settings, get(Eq(mp::autostart_concurrency_key))).WillRepeatedly(Return("1"));
+    EXPECT_CALL(mock_settings, get(Eq(mp::autostart_priority_key)))
+        .WillRepeatedly(Return("charlie"));
+
+    EXPECT_CALL(*mock_factory, create_virtual_machine)
+        .Times(3)
+        .WillRepeatedly([](const mp::VirtualMachineDescription& desc, auto&, auto&) {
+            auto mock_vm = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+            EXPECT_CALL(*mock_vm, get_name).WillRepeatedly(ReturnRefOfCopy(desc.vm_name));
+            EXPECT_CALL(*mock_vm, current_state)
+                .WillRepeatedly(Return(mp::VirtualMachine::State::stopped));
+            EXPECT_CALL(*mock_vm, start).Times(desc.vm_name == "charlie" ? 1 : 0);
+            return mp::VirtualMachine::UPtr{std::move(mock_vm)};
+        });
+
+    mp::Daemon daemon{config_builder.build()};
+}
+
+TEST_F(Daemon, stoppingAnInstanceWaitingToBootKeepsItDown)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+
+    constexpr auto instance_json = R"({
+        "alpha": {
+                "deleted": false,
+                "disk_space": "3232323232",
+                "mac_addr": "52:54:00:00:00:01",
+                "mem_size": "2323232323",
+                "metadata": {},
+                "mounts": [],
+                "num_cores": 4,
+                "ssh_username": "ubuntu",
+                "state": 4
+        },
+        "bravo": {
+                "deleted": false,
+                "disk_space": "3232323232",
+                "mac_addr": "52:54:00:00:00:02",
+                "mem_size": "2323232323",
+                "metadata": {},
+                "mounts": [],
+                "num_cores": 4,
+                "ssh_username": "ubuntu",
+                "state": 4
+        }
+})";
+    const auto [temp_dir, _] = plant_instance_json(instance_json);
+    config_builder.data_directory = temp_dir->path();
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    // alpha boots first, and bravo waits for it to be up
+    EXPECT_CALL(mock_settings, get(Eq(mp::autostart_concurrency_key))).WillRepeatedly(Return("1"));
+    EXPECT_CALL(mock_settings, get(Eq(mp::autostart_priority_key))).WillRepeatedly(Return("alpha"));
+
+    auto alpha_up = false;
+    EXPECT_CALL(*mock_factory, create_virtual_machine)
+        .Times(2)
+        .WillRepeatedly([&alpha_up](const mp::VirtualMachineDescription& desc, auto&, auto&) {
+            auto mock_vm = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+            EXPECT_CALL(*mock_vm, get_name).WillRepeatedly(ReturnRefOfCopy(desc.vm_name));
+            EXPECT_CALL(*mock_vm, current_state)
+                .WillRepeatedly(Return(mp::VirtualMachine::State::stopped));
+            if (desc.vm_name == "alpha")
+            {
+                EXPECT_CALL(*mock_vm, start).Times(1);
+                EXPECT_CALL(*mock_vm, handle_state_update).WillRepeatedly([&alpha_up] {
+                    alpha_up = true;
+                });
+            }
+            else
+                EXPECT_CALL(*mock_vm, start).Times(0);
+            return mp::VirtualMachine::UPtr{std::move(mock_vm)};
+        });
+
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::StopRequest request;
+    request.mutable_instance_names()->add_instance_name("bravo");
+    request.set_force_stop(true);
+    StrictMock<mpt::MockServerReaderWriter<mp::StopReply, mp::StopRequest>> mock_server;
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::stop, request, mock_server).ok());
+
+    // Once alpha is up, the queue moves on, but bravo is no longer in it
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    while (!alpha_up && std::chrono::steady_clock::now() < deadline)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    EXPECT_TRUE(alpha_up);
+
+    // and it stays down the next time the daemon starts
+    const auto records =
+        mp::RecordDatabase::open(temp_dir->filePath("multipassd-vm-instances.json"));
+    ASSERT_TRUE(records);
+    EXPECT_EQ(records->to_json().at("bravo").at("state").to_number<int>(),
+              static_cast<int>(mp::VirtualMachine::State::stopped));
+}
+
 TEST_F(Daemon, callsOnRestartForAlreadyRunningVmsOnConstruction)
 {
     auto mock_factory = use_a_mock_vm_factory();
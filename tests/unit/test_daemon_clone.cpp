@@ -163,6 +163,30 @@ TEST_F(TestDaemonClone, successfulCloneSpecifyDestNameOkStatus)
     EXPECT_EQ(status.error_code(), grpc::StatusCode::OK);
 }
 
+TEST_F(TestDaemonClone, forwardsCopyProgressToClient)
+{
+    const auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state).WillOnce(Return(mp::VirtualMachine::State::stopped));
+    EXPECT_CALL(mock_factory, clone_bare_vm)
+        .WillOnce(WithArg<7>([](const mp::ProgressMonitor& progress_monitor) {
+            progress_monitor(0, 42);
+            return mp::VirtualMachine::UPtr{};
+        }));
+
+    mp::CloneRequest request{};
+    request.set_source_name(mock_src_instance_name);
+
+    auto server = NiceMock<mpt::MockServerReaderWriter<mp::CloneReply, mp::CloneRequest>>{};
+    EXPECT_CALL(server, Write(Property(&mp::CloneReply::percent_complete, Eq("42")), _))
+        .WillOnce(Return(true));
+    EXPECT_CALL(server, Write(Property(&mp::CloneReply::reply_message, HasSubstr("Cloned")), _))
+        .WillOnce(Return(true));
+
+    const auto status = call_daemon_slot(*daemon, &mp::Daemon::clone, request, server);
+
+    EXPECT_EQ(status.error_code(), grpc::StatusCode::OK);
+}
+
 TEST_F(TestDaemonClone, failsOnCloneOnNonStoppedInstance)
 {
     const auto [daemon, instance] = build_daemon_with_mock_instance();
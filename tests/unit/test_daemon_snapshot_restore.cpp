@@ -28,6 +28,8 @@
 
 #include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 
+#include <thread>
+
 namespace mp = multipass;
 namespace mpt = multipass::test;
 
@@ -248,6 +250,84 @@ TEST_F(TestDaemonSnapshot, acceptsEmptySnapshotName)
     EXPECT_EQ(status.error_code(), grpc::OK);
 }
 
+TEST_F(TestDaemonSnapshot, takesLiveSnapshotOfRunningInstance)
+{
+    static constexpr auto* snapshot_name = "chimpanzee";
+    constexpr auto pause_duration = std::chrono::microseconds{4321};
+
+    mp::SnapshotRequest request{};
+    request.set_instance(mock_instance_name);
+    request.set_snapshot(snapshot_name);
+    request.set_live(true);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state)
+        .WillRepeatedly(Return(mp::VirtualMachine::State::running));
+
+    auto snapshot = std::make_shared<NiceMock<mpt::MockSnapshot>>();
+    EXPECT_CALL(*snapshot, get_name).WillOnce(Return(snapshot_name));
+    EXPECT_CALL(*instance, take_snapshot).Times(0);
+    EXPECT_CALL(*instance, take_live_snapshot(_, Eq(snapshot_name), _, _))
+        .WillOnce(DoAll(SetArgReferee<3>(pause_duration), Return(snapshot)));
+
+    auto server = StrictMock<mpt::MockServerReaderWriter<mp::SnapshotReply, mp::SnapshotRequest>>{};
+    EXPECT_CALL(server,
+                Write(AllOf(Property(&mp::SnapshotReply::snapshot, Eq(snapshot_name)),
+                            Property(&mp::SnapshotReply::pause_duration_us,
+                                     Eq(pause_duration.count()))),
+                      _))
+        .WillOnce(Return(true));
+
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::snapshot, request, server);
+
+    EXPECT_EQ(status.error_code(), grpc::OK);
+}
+
+TEST_F(TestDaemonSnapshot, takesLiveSnapshotsOffTheDaemonThread)
+{
+    mp::SnapshotRequest request{};
+    request.set_instance(mock_instance_name);
+    request.set_live(true);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    std::thread::id daemon_thread{};
+    EXPECT_CALL(*instance, current_state).WillRepeatedly([&daemon_thread] {
+        daemon_thread = std::this_thread::get_id();
+        return mp::VirtualMachine::State::running;
+    });
+
+    // the instance can need the daemon's thread to hear from its hypervisor meanwhile
+    EXPECT_CALL(*instance, take_live_snapshot).WillOnce([&daemon_thread](auto&&...) {
+        EXPECT_NE(std::this_thread::get_id(), daemon_thread);
+        return std::make_shared<NiceMock<mpt::MockSnapshot>>();
+    });
+
+    auto server = NiceMock<mpt::MockServerReaderWriter<mp::SnapshotReply, mp::SnapshotRequest>>{};
+    auto status = call_daemon_slot(*daemon, &mp::Daemon::snapshot, request, server);
+
+    EXPECT_EQ(status.error_code(), grpc::OK);
+}
+
+TEST_F(TestDaemonSnapshot, liveSnapshotFailsOnStoppedInstance)
+{
+    mp::SnapshotRequest request{};
+    request.set_instance(mock_instance_name);
+    request.set_live(true);
+
+    auto [daemon, instance] = build_daemon_with_mock_instance();
+    EXPECT_CALL(*instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::off));
+    EXPECT_CALL(*instance, take_live_snapshot).Times(0);
+
+    auto status = call_daemon_slot(
+        *daemon,
+        &mp::Daemon::snapshot,
+        request,
+        StrictMock<mpt::MockServerReaderWriter<mp::SnapshotReply, mp::SnapshotRequest>>{});
+
+    EXPECT_EQ(status.error_code(), grpc::FAILED_PRECONDITION);
+    EXPECT_THAT(status.error_message(), HasSubstr("running"));
+}
+
 TEST_F(TestDaemonRestore, failsIfBackendDoesNotSupportSnapshots)
 {
     mp::RestoreRequest request{};
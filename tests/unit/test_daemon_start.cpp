@@ -93,6 +93,78 @@ TEST_F(TestDaemonStart, successfulStartOkStatus)
     EXPECT_TRUE(status.ok());
 }
 
+TEST_F(TestDaemonStart, repliesWithTraceWhenRequested)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+    const auto [temp_dir, filename] =
+        plant_instance_json(fake_json_contents(mac_addr, extra_interfaces));
+
+    auto instance_ptr = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    EXPECT_CALL(*mock_factory, create_virtual_machine).WillOnce([&instance_ptr](auto&&...) {
+        return std::move(instance_ptr);
+    });
+    EXPECT_CALL(*instance_ptr, get_name).WillRepeatedly(ReturnRef(mock_instance_name));
+    EXPECT_CALL(*instance_ptr, current_state())
+        .WillRepeatedly(Return(mp::VirtualMachine::State::off));
+
+    config_builder.data_directory = temp_dir->path();
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::StartRequest request;
+    request.mutable_instance_names()->add_instance_name(mock_instance_name);
+    request.set_trace(true);
+
+    std::string trace;
+    StrictMock<mpt::MockServerReaderWriter<mp::StartReply, mp::StartRequest>> mock_server{};
+    EXPECT_CALL(mock_server, Write(_, _)).WillOnce([&trace](const mp::StartReply& reply, auto) {
+        trace = reply.trace();
+        return true;
+    });
+
+    auto status = call_daemon_slot(daemon, &mp::Daemon::start, request, std::move(mock_server));
+
+    EXPECT_TRUE(status.ok());
+    EXPECT_THAT(trace, HasSubstr("\"traceEvents\""));
+    EXPECT_THAT(trace, HasSubstr("\"VirtualMachine::start\""));
+    EXPECT_THAT(trace, HasSubstr("\"Daemon::async_wait_for_ssh_and_start_mounts_for\""));
+}
+
+TEST_F(TestDaemonStart, repliesWithResumeDurationOfSuspendedInstances)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+    const auto [temp_dir, filename] =
+        plant_instance_json(fake_json_contents(mac_addr, extra_interfaces));
+
+    auto instance_ptr = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    EXPECT_CALL(*mock_factory, create_virtual_machine).WillOnce([&instance_ptr](auto&&...) {
+        return std::move(instance_ptr);
+    });
+    EXPECT_CALL(*instance_ptr, get_name).WillRepeatedly(ReturnRef(mock_instance_name));
+    EXPECT_CALL(*instance_ptr, current_state())
+        .WillRepeatedly(Return(mp::VirtualMachine::State::suspended));
+    EXPECT_CALL(*instance_ptr, start()).Times(1);
+
+    config_builder.data_directory = temp_dir->path();
+    config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::StartRequest request;
+    request.mutable_instance_names()->add_instance_name(mock_instance_name);
+
+    StrictMock<mpt::MockServerReaderWriter<mp::StartReply, mp::StartRequest>> mock_server{};
+    EXPECT_CALL(mock_server, Write(_, _)).WillOnce([this](const mp::StartReply& reply, auto) {
+        EXPECT_EQ(reply.resume_duration_us().count(mock_instance_name), 1u);
+        return true;
+    });
+
+    auto status = call_daemon_slot(daemon, &mp::Daemon::start, request, std::move(mock_server));
+
+    EXPECT_TRUE(status.ok());
+}
+
 TEST_F(TestDaemonStart, exitlessSshProcessExceptionDoesNotShowMessage)
 {
     auto event_dopoll = [](auto...) { return SSH_ERROR; };
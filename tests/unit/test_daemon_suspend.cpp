@@ -88,11 +88,40 @@ TEST_F(TestDaemonSuspend, suspendStopsMounts)
     mp::SuspendRequest request;
     request.mutable_instance_names()->add_instance_name(mock_instance_name);
 
-    auto status = call_daemon_slot(
-        daemon,
-        &mp::Daemon::suspend,
-        request,
-        StrictMock<mpt::MockServerReaderWriter<mp::SuspendReply, mp::SuspendRequest>>{});
+    StrictMock<mpt::MockServerReaderWriter<mp::SuspendReply, mp::SuspendRequest>> server;
+    EXPECT_CALL(server, Write(_, _)).WillOnce(Return(true));
+
+    auto status = call_daemon_slot(daemon, &mp::Daemon::suspend, request, server);
+
+    EXPECT_TRUE(status.ok());
+}
+
+TEST_F(TestDaemonSuspend, repliesWithSuspendDuration)
+{
+    auto mock_factory = use_a_mock_vm_factory();
+    const auto [temp_dir, filename] =
+        plant_instance_json(fake_json_contents(mac_addr, extra_interfaces));
+    config_builder.data_directory = temp_dir->path();
+
+    auto mock_vm = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    EXPECT_CALL(*mock_vm, get_name).WillRepeatedly(ReturnRef(mock_instance_name));
+    EXPECT_CALL(*mock_vm, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::running));
+    EXPECT_CALL(*mock_vm, suspend);
+
+    EXPECT_CALL(*mock_factory, create_virtual_machine).WillOnce(Return(std::move(mock_vm)));
+
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::SuspendRequest request;
+    request.mutable_instance_names()->add_instance_name(mock_instance_name);
+
+    StrictMock<mpt::MockServerReaderWriter<mp::SuspendReply, mp::SuspendRequest>> server;
+    EXPECT_CALL(server, Write(_, _)).WillOnce([this](const mp::SuspendReply& reply, auto) {
+        EXPECT_EQ(reply.suspend_duration_us().count(mock_instance_name), 1u);
+        return true;
+    });
+
+    auto status = call_daemon_slot(daemon, &mp::Daemon::suspend, request, server);
 
     EXPECT_TRUE(status.ok());
 }
@@ -0,0 +1,365 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// The daemon test fixture contains premock code so it must be included first.
+#include "daemon_test_fixture.h"
+
+#include "common.h"
+#include "file_operations.h"
+#include "mock_daemon_rpc_context.h"
+#include "mock_permission_utils.h"
+#include "mock_platform.h"
+#include "mock_server_reader_writer.h"
+#include "mock_settings.h"
+#include "mock_virtual_machine.h"
+#include "mock_vm_image_vault.h"
+#include "stub_availability_zone_manager.h"
+#include "stub_virtual_machine.h"
+
+#include <src/daemon/daemon.h>
+#include <src/daemon/warm_pool.h>
+
+#include <multipass/constants.h>
+#include <multipass/format.h>
+#include <multipass/record_database.h>
+#include <multipass/signal.h>
+
+#include <QCoreApplication>
+#include <QThread>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+using namespace testing;
+
+struct TestDaemonWarmPool : public mpt::DaemonTestFixture
+{
+    void SetUp() override
+    {
+        config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+        config_builder.az_manager = std::make_unique<mpt::StubAvailabilityZoneManager>();
+
+        EXPECT_CALL(mock_settings, register_handler).WillRepeatedly(Return(nullptr));
+        EXPECT_CALL(mock_settings, unregister_handler).Times(AnyNumber());
+        ON_CALL(mock_settings, get(Eq(mp::warm_pool_size_key))).WillByDefault(Return("1"));
+
+        launch_request.set_instance_name("handed-out");
+        launch_request.set_time_zone("Europe/London"); // the CLI always sends one
+    }
+
+    void plant_warm_pool(bool ready)
+    {
+        mpt::fake_vm_properties member_properties;
+        member_properties.name = member;
+        member_properties.default_mac = "52:54:00:73:76:28";
+        member_properties.state = mp::VirtualMachine::State::stopped;
+
+        mpt::make_file_with_content(data_dir.filePath("multipassd-vm-instances.json"),
+                                    fake_json_contents(member_properties));
+        mpt::make_file_with_content(
+            data_dir.filePath("multipassd-warm-pool.json"),
+            fmt::format(R"({{"{}": {{"profile": "{}", "ready": {}}}}})",
+                        member,
+                        *mp::WarmPool::profile_for(placed_launch_request()),
+                        ready));
+    }
+
+    // The launch request with the zone the stub zone manager places instances in, as the pool
+    // sees it
+    mp::LaunchRequest placed_launch_request() const
+    {
+        auto request = launch_request;
+        request.set_zone("zone1");
+        return request;
+    }
+
+    // The pool as the daemon last persisted it
+    mp::WarmPool persisted_warm_pool()
+    {
+        const auto records =
+            mp::RecordDatabase::open(data_dir.filePath("multipassd-warm-pool.json"));
+        return records ? mp::WarmPool::from_json(records->to_json()) : mp::WarmPool{};
+    }
+
+    // Like call_daemon_slot, but keeps the daemon going until settled() holds too, so that the
+    // warm-up the launch sets off can finish
+    grpc::Status launch_until(mp::Daemon& daemon, const std::function<bool()>& settled)
+    {
+        std::promise<grpc::Status> status_promise;
+        auto status_future = status_promise.get_future();
+
+        NiceMock<mpt::MockDaemonRpcContext> ctx;
+        ON_CALL(ctx, set_value).WillByDefault([&status_promise](grpc::Status status) {
+            status_promise.set_value(std::move(status));
+        });
+        NiceMock<mpt::MockServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>> server;
+
+        auto thread = QThread::create([&daemon, &server, &ctx, this] {
+            QEventLoop inner_loop;
+            daemon.launch(&launch_request, &server, &ctx);
+            inner_loop.exec();
+        });
+        QObject::connect(thread, &QThread::finished, thread, &QObject::deleteLater);
+        thread->start();
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        const auto launched = [&status_future] {
+            return status_future.wait_for(std::chrono::seconds::zero()) ==
+                   std::future_status::ready;
+        };
+        while (!(launched() && settled()) && std::chrono::steady_clock::now() < deadline)
+            QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+
+        thread->quit();
+        thread->wait();
+
+        EXPECT_TRUE(launched());
+        EXPECT_TRUE(settled());
+        return launched() ? status_future.get() : grpc::Status::CANCELLED;
+    }
+
+    const std::string member{"warm-1a2b3c4d"};
+    mp::LaunchRequest launch_request;
+
+    const mpt::MockVirtualMachineFactory& mock_factory = *use_a_mock_vm_factory();
+
+    const mpt::MockPlatform::GuardedMock attr{mpt::MockPlatform::inject<NiceMock>()};
+
+    mpt::MockSettings::GuardedMock mock_settings_injection = mpt::MockSettings::inject<NiceMock>();
+    mpt::MockSettings& mock_settings = *mock_settings_injection.first;
+
+    const mpt::MockPermissionUtils::GuardedMock mock_permission_utils_injection =
+        mpt::MockPermissionUtils::inject<NiceMock>();
+};
+
+TEST_F(TestDaemonWarmPool, readyInstancesAreNotListed)
+{
+    plant_warm_pool(/*ready=*/true);
+    EXPECT_CALL(mock_factory, create_virtual_machine).WillOnce(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+    EXPECT_CALL(mock_factory, remove_resources_for).Times(0);
+
+    mp::Daemon daemon{config_builder.build()};
+
+    NiceMock<mpt::MockServerReaderWriter<mp::ListReply, mp::ListRequest>> server;
+    mp::ListReply list_reply;
+    EXPECT_CALL(server, Write(_, _)).WillOnce(DoAll(SaveArg<0>(&list_reply), Return(true)));
+
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::list, mp::ListRequest{}, server).ok());
+    EXPECT_THAT(list_reply.instance_list().instances(), IsEmpty());
+}
+
+TEST_F(TestDaemonWarmPool, readyInstancesDoNotCountTowardZoneLoads)
+{
+    plant_warm_pool(/*ready=*/true);
+    EXPECT_CALL(mock_factory, create_virtual_machine).WillOnce(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+
+    mp::Daemon daemon{config_builder.build()};
+
+    NiceMock<mpt::MockServerReaderWriter<mp::ZonesReply, mp::ZonesRequest>> server;
+    mp::ZonesReply zones_reply;
+    EXPECT_CALL(server, Write(_, _)).WillOnce(DoAll(SaveArg<0>(&zones_reply), Return(true)));
+
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::zones, mp::ZonesRequest{}, server).ok());
+    ASSERT_EQ(zones_reply.zones_size(), 1);
+    EXPECT_EQ(zones_reply.zones(0).instances(), 0);
+    EXPECT_EQ(zones_reply.zones(0).cpus(), 0);
+}
+
+TEST_F(TestDaemonWarmPool, launchTakesReadyInstanceFromPool)
+{
+    plant_warm_pool(/*ready=*/true);
+    EXPECT_CALL(mock_factory, create_virtual_machine).WillOnce(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+
+    mp::Daemon daemon{config_builder.build()};
+    ON_CALL(mock_settings, get(Eq(mp::warm_pool_size_key))).WillByDefault(Return("0"));
+
+    auto handed_out = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    ON_CALL(*handed_out, get_name).WillByDefault(ReturnRefOfCopy(launch_request.instance_name()));
+    EXPECT_CALL(*handed_out, start);
+    EXPECT_CALL(mock_factory,
+                clone_bare_vm(_, _, Eq(member), Eq(launch_request.instance_name()), _, _, _, _))
+        .WillOnce(Return(ByMove(std::move(handed_out))));
+    EXPECT_CALL(mock_factory, remove_resources_for(Eq(member)));
+
+    NiceMock<mpt::MockServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>> server;
+    EXPECT_CALL(server,
+                Write(Property(&mp::LaunchReply::create_message, HasSubstr("warm pool")), _))
+        .WillOnce(Return(true));
+
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::launch, launch_request, server).ok());
+}
+
+TEST_F(TestDaemonWarmPool, launchWarmsUpAnInstanceForTheNextOne)
+{
+    mp::Daemon daemon{config_builder.build()};
+
+    auto launched = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    ON_CALL(*launched, get_name).WillByDefault(ReturnRefOfCopy(launch_request.instance_name()));
+
+    auto warmed_up = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    auto& warmed_up_ref = *warmed_up;
+    EXPECT_CALL(warmed_up_ref, start);
+    EXPECT_CALL(warmed_up_ref, wait_until_ssh_up);
+    EXPECT_CALL(warmed_up_ref, shutdown(mp::VirtualMachine::ShutdownPolicy::Halt));
+
+    std::string warm_up_name;
+    EXPECT_CALL(mock_factory, create_virtual_machine)
+        .Times(2)
+        .WillRepeatedly(WithArg<0>([&](const auto& desc) -> mp::VirtualMachine::UPtr {
+            if (desc.vm_name == launch_request.instance_name())
+                return std::move(launched);
+
+            warm_up_name = desc.vm_name;
+            ON_CALL(warmed_up_ref, get_name).WillByDefault(ReturnRefOfCopy(warm_up_name));
+            return std::move(warmed_up);
+        }));
+    EXPECT_CALL(mock_factory, remove_resources_for).Times(0);
+
+    const auto status = launch_until(daemon, [this] {
+        const auto pool = persisted_warm_pool();
+        const auto names = pool.names();
+        return names.size() == 1 && pool.is_ready(names.front());
+    });
+    EXPECT_TRUE(status.ok());
+    EXPECT_THAT(warm_up_name, StartsWith("warm-"));
+
+    NiceMock<mpt::MockServerReaderWriter<mp::ListReply, mp::ListRequest>> server;
+    mp::ListReply list_reply;
+    EXPECT_CALL(server, Write(_, _)).WillOnce(DoAll(SaveArg<0>(&list_reply), Return(true)));
+
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::list, mp::ListRequest{}, server).ok());
+    EXPECT_THAT(list_reply.instance_list().instances(),
+                ElementsAre(Property(&mp::ListVMInstance::name, launch_request.instance_name())));
+}
+
+TEST_F(TestDaemonWarmPool, warmUpsInFlightAreHiddenFromUsers)
+{
+    mp::Daemon daemon{config_builder.build()};
+
+    auto launched = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    ON_CALL(*launched, get_name).WillByDefault(ReturnRefOfCopy(launch_request.instance_name()));
+
+    // The warm-up stays in flight until released
+    std::atomic_bool warming_up{false};
+    mp::Signal released;
+    auto warmed_up = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    auto& warmed_up_ref = *warmed_up;
+    EXPECT_CALL(warmed_up_ref, wait_until_ssh_up).WillOnce([&warming_up, &released](auto&&...) {
+        warming_up = true;
+        released.wait();
+    });
+    EXPECT_CALL(warmed_up_ref, shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff)).Times(0);
+
+    std::string warm_up_name;
+    EXPECT_CALL(mock_factory, create_virtual_machine)
+        .Times(2)
+        .WillRepeatedly(WithArg<0>([&](const auto& desc) -> mp::VirtualMachine::UPtr {
+            if (desc.vm_name == launch_request.instance_name())
+                return std::move(launched);
+
+            warm_up_name = desc.vm_name;
+            ON_CALL(warmed_up_ref, get_name).WillByDefault(ReturnRefOfCopy(warm_up_name));
+            return std::move(warmed_up);
+        }));
+
+    EXPECT_TRUE(launch_until(daemon, [&warming_up] { return warming_up.load(); }).ok());
+
+    NiceMock<mpt::MockServerReaderWriter<mp::ListReply, mp::ListRequest>> list_server;
+    mp::ListReply list_reply;
+    EXPECT_CALL(list_server, Write(_, _)).WillOnce(DoAll(SaveArg<0>(&list_reply), Return(true)));
+    EXPECT_TRUE(call_daemon_slot(daemon, &mp::Daemon::list, mp::ListRequest{}, list_server).ok());
+    EXPECT_THAT(list_reply.instance_list().instances(),
+                ElementsAre(Property(&mp::ListVMInstance::name, launch_request.instance_name())));
+
+    mp::StopRequest stop_request;
+    stop_request.mutable_instance_names()->add_instance_name(warm_up_name);
+    StrictMock<mpt::MockServerReaderWriter<mp::StopReply, mp::StopRequest>> stop_server;
+    EXPECT_EQ(call_daemon_slot(daemon, &mp::Daemon::stop, stop_request, stop_server).error_code(),
+              grpc::StatusCode::NOT_FOUND);
+
+    // Let the warm-up finish, so that it does not outlive the daemon
+    released.signal();
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+    const auto ready = [this] {
+        const auto pool = persisted_warm_pool();
+        const auto names = pool.names();
+        return names.size() == 1 && pool.is_ready(names.front());
+    };
+    while (!ready() && std::chrono::steady_clock::now() < deadline)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 10);
+    EXPECT_TRUE(ready());
+}
+
+TEST_F(TestDaemonWarmPool, failedWarmUpIsCleanedUp)
+{
+    mp::Daemon daemon{config_builder.build()};
+
+    auto launched = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    ON_CALL(*launched, get_name).WillByDefault(ReturnRefOfCopy(launch_request.instance_name()));
+
+    auto warmed_up = std::make_unique<NiceMock<mpt::MockVirtualMachine>>();
+    auto& warmed_up_ref = *warmed_up;
+    EXPECT_CALL(warmed_up_ref, wait_until_ssh_up).WillOnce(Throw(std::runtime_error{"no ssh"}));
+    EXPECT_CALL(warmed_up_ref, shutdown(mp::VirtualMachine::ShutdownPolicy::Poweroff));
+    EXPECT_CALL(warmed_up_ref, shutdown(mp::VirtualMachine::ShutdownPolicy::Halt)).Times(0);
+
+    EXPECT_CALL(mock_factory, create_virtual_machine)
+        .Times(2)
+        .WillRepeatedly(WithArg<0>([&](const auto& desc) -> mp::VirtualMachine::UPtr {
+            if (desc.vm_name == launch_request.instance_name())
+                return std::move(launched);
+
+            ON_CALL(warmed_up_ref, get_name).WillByDefault(ReturnRefOfCopy(desc.vm_name));
+            return std::move(warmed_up);
+        }));
+    EXPECT_CALL(mock_factory, remove_resources_for(StartsWith("warm-")));
+
+    const auto status =
+        launch_until(daemon, [this] { return persisted_warm_pool().names().empty(); });
+    EXPECT_TRUE(status.ok());
+}
+
+TEST_F(TestDaemonWarmPool, discardsInterruptedWarmUps)
+{
+    plant_warm_pool(/*ready=*/false);
+    EXPECT_CALL(mock_factory, create_virtual_machine).Times(0);
+    EXPECT_CALL(mock_factory, remove_resources_for(Eq(member)));
+
+    mp::Daemon daemon{config_builder.build()};
+}
+
+TEST_F(TestDaemonWarmPool, discardsInstancesBeyondPoolSize)
+{
+    plant_warm_pool(/*ready=*/true);
+    ON_CALL(mock_settings, get(Eq(mp::warm_pool_size_key))).WillByDefault(Return("0"));
+    EXPECT_CALL(mock_factory, create_virtual_machine).WillOnce(WithArg<0>([](const auto& desc) {
+        return std::make_unique<mpt::StubVirtualMachine>(desc.vm_name);
+    }));
+    EXPECT_CALL(mock_factory, remove_resources_for(Eq(member)));
+
+    mp::Daemon daemon{config_builder.build()};
+}
@@ -18,16 +18,26 @@
 #include "daemon_test_fixture.h"
 #include "mock_availability_zone.h"
 #include "mock_availability_zone_manager.h"
+#include "mock_daemon_rpc_context.h"
 #include "mock_permission_utils.h"
 #include "mock_platform.h"
 #include "mock_server_reader_writer.h"
 #include "mock_settings.h"
 #include "mock_vm_image_vault.h"
 #include "multipass/exceptions/availability_zone_exceptions.h"
+#include "stub_virtual_machine.h"
 
 #include <src/daemon/daemon.h>
 
 #include <multipass/constants.h>
+#include <multipass/memory_size.h>
+#include <multipass/signal.h>
+
+#include <QEventLoop>
+#include <QThread>
+
+#include <chrono>
+#include <stdexcept>
 
 namespace mp = multipass;
 namespace mpt = multipass::test;
@@ -39,6 +49,9 @@ struct TestDaemonZones : public mpt::DaemonTestFixture
     {
         EXPECT_CALL(mock_settings, register_handler).WillRepeatedly(Return(nullptr));
         EXPECT_CALL(mock_settings, unregister_handler).Times(AnyNumber());
+        EXPECT_CALL(mock_settings, get(Eq(mp::zone_placement_key)))
+            .Times(AnyNumber())
+            .WillRepeatedly(Return(mp::zone_placement_least_loaded));
 
         config_builder.vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
 
@@ -86,10 +99,10 @@ struct TestDaemonZones : public mpt::DaemonTestFixture
 TEST_F(TestDaemonZones, zonesStateCmdDisablesAll)
 {
     ON_CALL(*zone1, is_available()).WillByDefault(Return(true));
-    EXPECT_CALL(*zone1, set_available(false)).Times(1);
+    EXPECT_CALL(*zone1, set_available(false, _)).Times(1);
 
     ON_CALL(*zone2, is_available()).WillByDefault(Return(true));
-    EXPECT_CALL(*zone2, set_available(false)).Times(1);
+    EXPECT_CALL(*zone2, set_available(false, _)).Times(1);
 
     config_builder.az_manager = std::move(mock_az_manager);
     mp::Daemon daemon{config_builder.build()};
@@ -106,10 +119,10 @@ TEST_F(TestDaemonZones, zonesStateCmdDisablesAll)
 TEST_F(TestDaemonZones, zonesStateCmdDisablesOne)
 {
     ON_CALL(*zone1, is_available()).WillByDefault(Return(true));
-    EXPECT_CALL(*zone1, set_available(_)).Times(0);
+    EXPECT_CALL(*zone1, set_available(_, _)).Times(0);
 
     ON_CALL(*zone2, is_available()).WillByDefault(Return(true));
-    EXPECT_CALL(*zone2, set_available(false)).Times(1);
+    EXPECT_CALL(*zone2, set_available(false, _)).Times(1);
 
     config_builder.az_manager = std::move(mock_az_manager);
     mp::Daemon daemon{config_builder.build()};
@@ -125,6 +138,36 @@ TEST_F(TestDaemonZones, zonesStateCmdDisablesOne)
     EXPECT_TRUE(status.ok());
 }
 
+TEST_F(TestDaemonZones, zonesStateCmdStreamsInstanceProgress)
+{
+    const mpt::StubVirtualMachine vm1{"foo"}, vm2{"bar"};
+    EXPECT_CALL(*zone2, set_available(false, _))
+        .WillOnce([&vm1, &vm2](bool, const mp::AvailabilityZone::TransitionProgress& progress) {
+            progress(vm1, 1, 2);
+            progress(vm2, 2, 2);
+        });
+
+    config_builder.az_manager = std::move(mock_az_manager);
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::ZonesStateRequest request;
+    request.set_available(false);
+    request.add_zones(zone2_name);
+
+    StrictMock<mpt::MockServerReaderWriter<mp::ZonesStateReply, mp::ZonesStateRequest>> mock_server;
+    InSequence seq;
+    EXPECT_CALL(mock_server,
+                Write(Property(&mp::ZonesStateReply::reply_message, "zone2: foo unavailable (1/2)"),
+                      _));
+    EXPECT_CALL(mock_server,
+                Write(Property(&mp::ZonesStateReply::reply_message, "zone2: bar unavailable (2/2)"),
+                      _));
+
+    const auto status = call_daemon_slot(daemon, &mp::Daemon::zones_state, request, mock_server);
+
+    EXPECT_TRUE(status.ok());
+}
+
 TEST_F(TestDaemonZones, zonesStateCmdFailsOnDisableNonexistentZone)
 {
     config_builder.az_manager = std::move(mock_az_manager);
@@ -147,10 +190,10 @@ TEST_F(TestDaemonZones, zonesStateCmdFailsOnDisableNonexistentZone)
 TEST_F(TestDaemonZones, zonesStateCmdEnablesAll)
 {
     ON_CALL(*zone1, is_available()).WillByDefault(Return(false));
-    EXPECT_CALL(*zone1, set_available(true)).Times(1);
+    EXPECT_CALL(*zone1, set_available(true, _)).Times(1);
 
     ON_CALL(*zone2, is_available()).WillByDefault(Return(false));
-    EXPECT_CALL(*zone2, set_available(true)).Times(1);
+    EXPECT_CALL(*zone2, set_available(true, _)).Times(1);
 
     config_builder.az_manager = std::move(mock_az_manager);
     mp::Daemon daemon{config_builder.build()};
@@ -167,10 +210,10 @@ TEST_F(TestDaemonZones, zonesStateCmdEnablesAll)
 TEST_F(TestDaemonZones, zonesStateCmdEnablesOne)
 {
     ON_CALL(*zone1, is_available()).WillByDefault(Return(false));
-    EXPECT_CALL(*zone1, set_available(true)).Times(1);
+    EXPECT_CALL(*zone1, set_available(true, _)).Times(1);
 
     ON_CALL(*zone2, is_available()).WillByDefault(Return(false));
-    EXPECT_CALL(*zone2, set_available(_)).Times(0);
+    EXPECT_CALL(*zone2, set_available(_, _)).Times(0);
 
     config_builder.az_manager = std::move(mock_az_manager);
     mp::Daemon daemon{config_builder.build()};
@@ -248,6 +291,7 @@ TEST_F(TestDaemonZones, zonesCmdReturnsMultipleZones)
     const auto status = call_daemon_slot(daemon, &mp::Daemon::zones, request, mock_server);
 
     ASSERT_TRUE(status.ok());
+    EXPECT_EQ(reply.placement(), mp::zone_placement_least_loaded);
     EXPECT_THAT(
         reply.zones(),
         UnorderedElementsAre(AllOf(Property(&mp::Zone::available, IsFalse()),
@@ -297,3 +341,63 @@ TEST_F(TestDaemonZones, zonesCmdFailsOnException)
     ASSERT_FALSE(status.ok());
     EXPECT_THAT(status.error_message(), HasSubstr("test_error"));
 }
+
+TEST_F(TestDaemonZones, overlappingLaunchesCountWhatEarlierOnesAskedFor)
+{
+    EXPECT_CALL(mock_settings, get(Eq(mp::warm_pool_size_key))).WillRepeatedly(Return("0"));
+
+    // The first launch picks zone1 and then hangs on to its image; the second picks while it does
+    mp::AvailabilityZoneManager::ZoneLoads loads_seen_by_second;
+    EXPECT_CALL(*mock_az_manager, get_automatic_zone_name)
+        .WillOnce(Return(zone1_name))
+        .WillOnce(DoAll(SaveArg<1>(&loads_seen_by_second),
+                        Throw(mp::NoAvailabilityZoneAvailable{})));
+
+    mp::Signal fetching, released;
+    auto mock_vault = std::make_unique<NiceMock<mpt::MockVMImageVault>>();
+    EXPECT_CALL(*mock_vault, fetch_image)
+        .WillOnce([&fetching, &released](auto&&...) -> mp::VMImage {
+            fetching.signal();
+            released.wait();
+            throw std::runtime_error{"no image"}; // end the first launch without a trace
+        });
+
+    config_builder.vault = std::move(mock_vault);
+    config_builder.az_manager = std::move(mock_az_manager);
+    mp::Daemon daemon{config_builder.build()};
+
+    mp::LaunchRequest first;
+    first.set_instance_name("first");
+    first.set_num_cores(4);
+    first.set_mem_size("2G");
+    first.set_disk_space("10G");
+    NiceMock<mpt::MockServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>> first_server;
+    NiceMock<mpt::MockDaemonRpcContext> first_ctx;
+    mp::Signal first_done;
+    ON_CALL(first_ctx, set_value).WillByDefault([&first_done](auto&&) { first_done.signal(); });
+    auto first_launch = QThread::create([&daemon, &first, &first_server, &first_ctx] {
+        QEventLoop inner_loop;
+        daemon.launch(&first, &first_server, &first_ctx);
+        inner_loop.exec();
+    });
+    first_launch->start();
+    EXPECT_TRUE(fetching.wait_for(std::chrono::seconds{5}));
+
+    mp::LaunchRequest second;
+    second.set_instance_name("second");
+    StrictMock<mpt::MockServerReaderWriter<mp::LaunchReply, mp::LaunchRequest>> second_server;
+    EXPECT_FALSE(call_daemon_slot(daemon, &mp::Daemon::launch, second, second_server).ok());
+
+    released.signal();
+    EXPECT_TRUE(first_done.wait_for(std::chrono::seconds{5}));
+    first_launch->quit();
+    first_launch->wait();
+    delete first_launch;
+
+    ASSERT_EQ(loads_seen_by_second.count(zone1_name), 1u);
+    const auto& load = loads_seen_by_second.at(zone1_name);
+    EXPECT_EQ(load.instances, 1);
+    EXPECT_EQ(load.cpus, 4);
+    EXPECT_EQ(load.memory_bytes, mp::MemorySize{"2G"}.in_bytes());
+    EXPECT_EQ(load.disk_bytes, mp::MemorySize{"10G"}.in_bytes());
+}
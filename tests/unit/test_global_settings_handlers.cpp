@@ -242,8 +242,16 @@ TEST_F(TestGlobalSettingsHandlers, daemonRegistersPersistentHandlerForDaemonSett
     mp::daemon::register_global_settings_handlers();
     inject_default_returning_mock_qsettings();
 
-    expect_setting_values(
-        {{mp::driver_key, driver}, {mp::bridged_interface_key, ""}, {mp::mounts_key, mount}});
+    expect_setting_values({{mp::driver_key, driver},
+                           {mp::bridged_interface_key, ""},
+                           {mp::mounts_key, mount},
+                           {mp::autostart_concurrency_key, mp::autostart_concurrency_default},
+                           {mp::autostart_priority_key, ""},
+                           {mp::memory_reclaim_key, "false"},
+                           {mp::multiplexed_mounts_key, "false"},
+                           {mp::zone_placement_key, mp::zone_placement_least_loaded},
+                           {mp::warm_pool_size_key, "0"},
+                           {mp::suspend_mode_key, mp::suspend_mode_snapshot}});
 }
 
 TEST_F(TestGlobalSettingsHandlers, daemonRegistersPersistentHandlerForDaemonPlatformSettings)
@@ -358,6 +366,118 @@ TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsBrigedInterf
     ASSERT_NO_THROW(handler->set(mp::bridged_interface_key, val, messages));
 }
 
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsAutostartConcurrency)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::autostart_concurrency_key), Eq("8")));
+    inject_mock_qsettings();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    ASSERT_NO_THROW(handler->set(mp::autostart_concurrency_key, "8", messages));
+}
+
+struct TestBadAutostartConcurrencySetting : public TestGlobalSettingsHandlers,
+                                            WithParamInterface<const char*>
+{
+};
+
+TEST_P(TestBadAutostartConcurrencySetting, daemonRegistersHandlerThatRejectsBadConcurrency)
+{
+    const auto key = mp::autostart_concurrency_key;
+    const auto val = GetParam();
+
+    mp::daemon::register_global_settings_handlers();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    MP_ASSERT_THROW_THAT(handler->set(key, val, messages),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(key), HasSubstr(val))));
+}
+
+INSTANTIATE_TEST_SUITE_P(TestBadAutostartConcurrencySetting,
+                         TestBadAutostartConcurrencySetting,
+                         Values("0", "-2", "two", ""));
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsZonePlacement)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings,
+                setValue(Eq(mp::zone_placement_key), Eq(mp::zone_placement_first_available)));
+    inject_mock_qsettings();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    ASSERT_NO_THROW(
+        handler->set(mp::zone_placement_key, mp::zone_placement_first_available, messages));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsBadZonePlacement)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    MP_ASSERT_THROW_THAT(handler->set(mp::zone_placement_key, "round-robin", messages),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(mp::zone_placement_key),
+                                               HasSubstr(mp::zone_placement_least_loaded))));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsWarmPoolSize)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::warm_pool_size_key), Eq("3")));
+    inject_mock_qsettings();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    ASSERT_NO_THROW(handler->set(mp::warm_pool_size_key, "3", messages));
+}
+
+struct TestBadWarmPoolSizeSetting : public TestGlobalSettingsHandlers,
+                                    WithParamInterface<const char*>
+{
+};
+
+TEST_P(TestBadWarmPoolSizeSetting, daemonRegistersHandlerThatRejectsBadWarmPoolSize)
+{
+    const auto key = mp::warm_pool_size_key;
+    const auto val = GetParam();
+
+    mp::daemon::register_global_settings_handlers();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    MP_ASSERT_THROW_THAT(handler->set(key, val, messages),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(key), HasSubstr(val))));
+}
+
+INSTANTIATE_TEST_SUITE_P(TestBadWarmPoolSizeSetting,
+                         TestBadWarmPoolSizeSetting,
+                         Values("-1", "some", ""));
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatAcceptsSuspendMode)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    EXPECT_CALL(*mock_qsettings, setValue(Eq(mp::suspend_mode_key), Eq(mp::suspend_mode_file)));
+    inject_mock_qsettings();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    ASSERT_NO_THROW(handler->set(mp::suspend_mode_key, mp::suspend_mode_file, messages));
+}
+
+TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatRejectsBadSuspendMode)
+{
+    mp::daemon::register_global_settings_handlers();
+
+    [[maybe_unused]] mp::UserMessages messages{};
+    MP_ASSERT_THROW_THAT(handler->set(mp::suspend_mode_key, "memory", messages),
+                         mp::InvalidSettingException,
+                         mpt::match_what(AllOf(HasSubstr(mp::suspend_mode_key),
+                                               HasSubstr(mp::suspend_mode_file))));
+}
+
 TEST_F(TestGlobalSettingsHandlers, daemonRegistersHandlerThatHashesNonEmptyPassword)
 {
     const auto val = "correct horse battery staple";
@@ -35,6 +35,7 @@
 #include <multipass/exceptions/image_vault_exceptions.h>
 #include <multipass/exceptions/unsupported_image_exception.h>
 #include <multipass/format.h>
+#include <multipass/metrics.h>
 #include <multipass/platform.h>
 #include <multipass/query.h>
 #include <multipass/url_downloader.h>
@@ -480,6 +481,36 @@ TEST_F(ImageVault, cachesPreparedImages)
     EXPECT_THAT(vm_image1.id, Eq(vm_image2.id));
 }
 
+TEST_F(ImageVault, countsCacheHitsAndMisses)
+{
+    auto lookups = [](const std::string& result) -> mp::metrics::Counter& {
+        return mp::metrics::registry().counter(
+            "multipass_image_vault_lookups_total",
+            "Image requests to the vault, by whether they were served from its cache",
+            {{"result", result}});
+    };
+    const auto hits_before = lookups("hit").value();
+    const auto misses_before = lookups("miss").value();
+
+    mp::DefaultVMImageVault vault{hosts,
+                                  &url_downloader,
+                                  cache_dir.path(),
+                                  data_dir.path(),
+                                  mp::days{0}};
+    vault.fetch_image(default_query, stub_prepare, stub_monitor, std::nullopt, instance_dir);
+
+    auto another_query = default_query;
+    another_query.name = "valley-pied-piper-chat";
+    vault.fetch_image(another_query,
+                      stub_prepare,
+                      stub_monitor,
+                      std::nullopt,
+                      save_dir.filePath(QString::fromStdString(another_query.name)));
+
+    EXPECT_EQ(misses_before + 1, lookups("miss").value());
+    EXPECT_EQ(hits_before + 1, lookups("hit").value());
+}
+
 TEST_F(ImageVault, emptyAndReleaseRemoteNamesShareCache)
 {
     mp::DefaultVMImageVault vault{hosts,
@@ -19,6 +19,7 @@
 #include "mock_virtual_machine.h"
 
 #include <multipass/constants.h>
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
 #include <multipass/utils.h>
 #include <multipass/virtual_machine.h>
 #include <multipass/vm_specs.h>
@@ -142,8 +143,21 @@ struct TestInstanceSettingsHandler : public Test
     bool fake_persister_called = false;
     bool user_authorized = true;
     inline static constexpr std::array numeric_properties{"cpus", "disk", "memory"};
-    inline static constexpr std::array boolean_properties{"bridged"};
-    inline static constexpr std::array properties{"cpus", "disk", "memory", "bridged"};
+    inline static constexpr std::array boolean_properties{"bridged",
+                                                          "network-multiqueue",
+                                                          "memory-prealloc",
+                                                          "cpu-pinning"};
+    inline static constexpr std::array properties{"cpus",
+                                                  "disk",
+                                                  "memory",
+                                                  "bridged",
+                                                  "network-multiqueue",
+                                                  "disk-profile",
+                                                  "memory-backing",
+                                                  "memory-prealloc",
+                                                  "memory-host-node",
+                                                  "cpu-affinity",
+                                                  "cpu-pinning"};
 };
 
 QString make_key(const QString& instance_name, const QString& property)
@@ -595,6 +609,298 @@ TEST_F(TestInstanceSettingsHandler, setDoesNotAddTwoInterfaces)
     EXPECT_EQ(specs[target_instance_name].extra_interfaces.size(), 1u);
 }
 
+TEST_F(TestInstanceSettingsHandler, getFetchesNetworkMultiqueue)
+{
+    constexpr auto target_instance_name = "piazzolla";
+    specs.insert({{"pugliese", {}}, {target_instance_name, {}}});
+
+    const auto key = make_key(target_instance_name, "network-multiqueue");
+    EXPECT_EQ(make_handler().get(key), "false");
+
+    specs[target_instance_name].network_multiqueue = true;
+    EXPECT_EQ(make_handler().get(key), "true");
+}
+
+TEST_F(TestInstanceSettingsHandler, setTogglesNetworkMultiqueue)
+{
+    constexpr auto target_instance_name = "troilo";
+    specs.insert({{"salgan", {}}, {target_instance_name, {}}});
+
+    auto& instance = mock_vm<StrictMock>(target_instance_name);
+    EXPECT_CALL(instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::off));
+    {
+        InSequence seq;
+        EXPECT_CALL(instance, set_network_multiqueue(true));
+        EXPECT_CALL(instance, set_network_multiqueue(false));
+    }
+
+    mp::UserMessages messages{};
+    const auto key = make_key(target_instance_name, "network-multiqueue");
+    make_handler().set(key, "on", messages);
+    EXPECT_TRUE(specs[target_instance_name].network_multiqueue);
+    EXPECT_TRUE(fake_persister_called);
+
+    make_handler().set(key, "false", messages);
+    EXPECT_FALSE(specs[target_instance_name].network_multiqueue);
+}
+
+TEST_F(TestInstanceSettingsHandler, setLeavesNetworkMultiqueueUntouchedIfSame)
+{
+    constexpr auto target_instance_name = "pichuco";
+    specs[target_instance_name].network_multiqueue = true;
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_network_multiqueue).Times(0);
+
+    mp::UserMessages messages{};
+    make_handler().set(make_key(target_instance_name, "network-multiqueue"), "true", messages);
+    EXPECT_TRUE(specs[target_instance_name].network_multiqueue);
+}
+
+TEST_F(TestInstanceSettingsHandler, setKeepsNetworkMultiqueueOffWhenBackendRefuses)
+{
+    constexpr auto target_instance_name = "goyeneche";
+    specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_network_multiqueue(true))
+        .WillOnce(Throw(mp::NotImplementedOnThisBackendException{"multiqueue networking"}));
+
+    mp::UserMessages messages{};
+    MP_EXPECT_THROW_THAT(
+        make_handler().set(make_key(target_instance_name, "network-multiqueue"), "true", messages),
+        mp::NotImplementedOnThisBackendException,
+        mpt::match_what(HasSubstr("multiqueue networking")));
+    EXPECT_FALSE(specs[target_instance_name].network_multiqueue);
+}
+
+TEST_F(TestInstanceSettingsHandler, getFetchesDiskProfile)
+{
+    constexpr auto target_instance_name = "spinetta";
+    specs.insert({{"garcia", {}}, {target_instance_name, {}}});
+
+    const auto key = make_key(target_instance_name, "disk-profile");
+    EXPECT_EQ(make_handler().get(key), "default");
+
+    specs[target_instance_name].disk_profile = "virtio-blk";
+    EXPECT_EQ(make_handler().get(key), "virtio-blk");
+}
+
+TEST_F(TestInstanceSettingsHandler, setChangesDiskProfile)
+{
+    constexpr auto target_instance_name = "charly";
+    specs.insert({{"fito", {}}, {target_instance_name, {}}});
+
+    auto& instance = mock_vm<StrictMock>(target_instance_name);
+    EXPECT_CALL(instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::off));
+    {
+        InSequence seq;
+        EXPECT_CALL(instance, set_disk_profile("iothread"));
+        EXPECT_CALL(instance, set_disk_profile("default"));
+    }
+
+    mp::UserMessages messages{};
+    const auto key = make_key(target_instance_name, "disk-profile");
+    make_handler().set(key, "IOThread", messages);
+    EXPECT_EQ(specs[target_instance_name].disk_profile, "iothread");
+    EXPECT_TRUE(fake_persister_called);
+
+    make_handler().set(key, "default", messages);
+    EXPECT_EQ(specs[target_instance_name].disk_profile, "default");
+}
+
+TEST_F(TestInstanceSettingsHandler, setLeavesDiskProfileUntouchedIfSame)
+{
+    constexpr auto target_instance_name = "cerati";
+    specs[target_instance_name].disk_profile = "iothread";
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_disk_profile).Times(0);
+
+    mp::UserMessages messages{};
+    make_handler().set(make_key(target_instance_name, "disk-profile"), "iothread", messages);
+    EXPECT_EQ(specs[target_instance_name].disk_profile, "iothread");
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesUnknownDiskProfile)
+{
+    constexpr auto target_instance_name = "paez";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_disk_profile).Times(0);
+
+    mp::UserMessages messages{};
+    MP_EXPECT_THROW_THAT(
+        make_handler().set(make_key(target_instance_name, "disk-profile"), "io_uring", messages),
+        mp::InvalidSettingException,
+        mpt::match_what(AllOf(HasSubstr("io_uring"), HasSubstr("default, iothread, virtio-blk"))));
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
+TEST_F(TestInstanceSettingsHandler, getFetchesMemoryBacking)
+{
+    constexpr auto target_instance_name = "pescetti";
+    specs.insert({{"nebbia", {}}, {target_instance_name, {}}});
+
+    const auto handler = make_handler();
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-backing")), "default");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-prealloc")), "false");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-host-node")), "none");
+
+    specs[target_instance_name].memory_backing = {"hugepages", true, 1};
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-backing")), "hugepages");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-prealloc")), "true");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "memory-host-node")), "1");
+}
+
+TEST_F(TestInstanceSettingsHandler, setChangesMemoryBacking)
+{
+    constexpr auto target_instance_name = "lebon";
+    specs.insert({{"moris", {}}, {target_instance_name, {}}});
+
+    auto& instance = mock_vm<StrictMock>(target_instance_name);
+    EXPECT_CALL(instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::off));
+    {
+        InSequence seq;
+        EXPECT_CALL(instance, set_memory_backing(mp::MemoryBacking{"hugepages", false, {}}));
+        EXPECT_CALL(instance, set_memory_backing(mp::MemoryBacking{"hugepages", true, {}}));
+        EXPECT_CALL(instance, set_memory_backing(mp::MemoryBacking{"hugepages", true, 0}));
+        EXPECT_CALL(instance, set_memory_backing(mp::MemoryBacking{"hugepages", true, {}}));
+    }
+
+    mp::UserMessages messages{};
+    auto handler = make_handler();
+    handler.set(make_key(target_instance_name, "memory-backing"), "HugePages", messages);
+    handler.set(make_key(target_instance_name, "memory-prealloc"), "on", messages);
+    handler.set(make_key(target_instance_name, "memory-host-node"), "0", messages);
+    EXPECT_EQ(specs[target_instance_name].memory_backing,
+              (mp::MemoryBacking{"hugepages", true, 0}));
+    EXPECT_TRUE(fake_persister_called);
+
+    handler.set(make_key(target_instance_name, "memory-host-node"), "none", messages);
+    EXPECT_FALSE(specs[target_instance_name].memory_backing.host_node.has_value());
+}
+
+TEST_F(TestInstanceSettingsHandler, setLeavesMemoryBackingUntouchedIfSame)
+{
+    constexpr auto target_instance_name = "gieco";
+    specs[target_instance_name].memory_backing = {"memfd", false, 1};
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_memory_backing).Times(0);
+
+    mp::UserMessages messages{};
+    auto handler = make_handler();
+    handler.set(make_key(target_instance_name, "memory-backing"), "memfd", messages);
+    handler.set(make_key(target_instance_name, "memory-prealloc"), "false", messages);
+    handler.set(make_key(target_instance_name, "memory-host-node"), "1", messages);
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesBadMemoryBackingValues)
+{
+    constexpr auto target_instance_name = "nebbia";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_memory_backing).Times(0);
+
+    mp::UserMessages messages{};
+    MP_EXPECT_THROW_THAT(
+        make_handler().set(make_key(target_instance_name, "memory-backing"), "thp", messages),
+        mp::InvalidSettingException,
+        mpt::match_what(AllOf(HasSubstr("thp"), HasSubstr("default, memfd, hugepages"))));
+
+    for (const auto* bad_node : {"-1", "1.5", "first", ""})
+        MP_EXPECT_THROW_THAT(
+            make_handler().set(make_key(target_instance_name, "memory-host-node"),
+                               bad_node,
+                               messages),
+            mp::InvalidSettingException,
+            mpt::match_what(HasSubstr("non-negative integer")));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
+TEST_F(TestInstanceSettingsHandler, getFetchesCpuAffinity)
+{
+    constexpr auto target_instance_name = "salgan";
+    specs.insert({{"laurenz", {}}, {target_instance_name, {}}});
+
+    const auto handler = make_handler();
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "cpu-affinity")), "none");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "cpu-pinning")), "false");
+
+    specs[target_instance_name].cpu_affinity = {"2-5", true};
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "cpu-affinity")), "2-5");
+    EXPECT_EQ(handler.get(make_key(target_instance_name, "cpu-pinning")), "true");
+}
+
+TEST_F(TestInstanceSettingsHandler, setChangesCpuAffinity)
+{
+    constexpr auto target_instance_name = "maderna";
+    specs.insert({{"mores", {}}, {target_instance_name, {}}});
+
+    auto& instance = mock_vm<StrictMock>(target_instance_name);
+    EXPECT_CALL(instance, current_state).WillRepeatedly(Return(mp::VirtualMachine::State::off));
+    {
+        InSequence seq;
+        EXPECT_CALL(instance, set_cpu_affinity(mp::CpuAffinity{"0-3,8", false}));
+        EXPECT_CALL(instance, set_cpu_affinity(mp::CpuAffinity{"0-3,8", true}));
+        EXPECT_CALL(instance, set_cpu_affinity(mp::CpuAffinity{"", true}));
+    }
+
+    mp::UserMessages messages{};
+    auto handler = make_handler();
+    handler.set(make_key(target_instance_name, "cpu-affinity"), "8,0-2,3", messages);
+    handler.set(make_key(target_instance_name, "cpu-pinning"), "on", messages);
+    EXPECT_EQ(specs[target_instance_name].cpu_affinity, (mp::CpuAffinity{"0-3,8", true}));
+    EXPECT_TRUE(fake_persister_called);
+
+    handler.set(make_key(target_instance_name, "cpu-affinity"), "None", messages);
+    EXPECT_TRUE(specs[target_instance_name].cpu_affinity.host_cpus.empty());
+}
+
+TEST_F(TestInstanceSettingsHandler, setLeavesCpuAffinityUntouchedIfSame)
+{
+    constexpr auto target_instance_name = "canaro";
+    specs[target_instance_name].cpu_affinity = {"0-3", true};
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_cpu_affinity).Times(0);
+
+    mp::UserMessages messages{};
+    auto handler = make_handler();
+    handler.set(make_key(target_instance_name, "cpu-affinity"), "3,2,1,0", messages);
+    handler.set(make_key(target_instance_name, "cpu-pinning"), "true", messages);
+}
+
+TEST_F(TestInstanceSettingsHandler, setRefusesBadCpuAffinityValues)
+{
+    constexpr auto target_instance_name = "firpo";
+    const auto original_specs = specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_cpu_affinity).Times(0);
+
+    mp::UserMessages messages{};
+    for (const auto* bad_list : {"", "3-1", "0,,1", "all"})
+        MP_EXPECT_THROW_THAT(
+            make_handler().set(make_key(target_instance_name, "cpu-affinity"), bad_list, messages),
+            mp::InvalidSettingException,
+            mpt::match_what(HasSubstr("CPU")));
+
+    EXPECT_EQ(original_specs, specs[target_instance_name]);
+}
+
+TEST_F(TestInstanceSettingsHandler, setKeepsMemoryBackingWhenBackendRefuses)
+{
+    constexpr auto target_instance_name = "baglietto";
+    specs[target_instance_name];
+
+    EXPECT_CALL(mock_vm(target_instance_name), set_memory_backing)
+        .WillOnce(Throw(mp::NotImplementedOnThisBackendException{"memfd memory"}));
+
+    mp::UserMessages messages{};
+    MP_EXPECT_THROW_THAT(
+        make_handler().set(make_key(target_instance_name, "memory-backing"), "hugepages", messages),
+        mp::NotImplementedOnThisBackendException,
+        mpt::match_what(HasSubstr("memfd memory")));
+    EXPECT_EQ(specs[target_instance_name].memory_backing, mp::MemoryBacking{});
+}
+
 using VMSt = mp::VirtualMachine::State;
 using Property = const char*;
 using PropertyAndState = std::tuple<Property, VMSt>; // no subliminal political msg intended :)
@@ -0,0 +1,151 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "mock_logger.h"
+#include "mock_virtual_machine.h"
+
+#include <multipass/exceptions/not_implemented_on_this_backend_exception.h>
+#include <src/daemon/memory_reclaimer.h>
+
+namespace mp = multipass;
+namespace mpl = multipass::logging;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+const auto total = mp::MemorySize{"4G"};
+
+mp::MemorySize gib(double gibs)
+{
+    return mp::MemorySize::from_bytes(static_cast<long long>(gibs * 1024 * 1024 * 1024));
+}
+
+TEST(MemoryBalloonTarget, waitsForTheGuestToReportItsMemory)
+{
+    EXPECT_EQ(mp::memory_balloon_target(total, {gib(3), std::nullopt}), gib(3));
+}
+
+TEST(MemoryBalloonTarget, shrinksInstancesWithUnusedMemoryAStepAtATime)
+{
+    EXPECT_EQ(mp::memory_balloon_target(total, {total, gib(3.5)}), gib(3.5));
+    EXPECT_EQ(mp::memory_balloon_target(total, {gib(3.5), gib(1.25)}), gib(3.25));
+}
+
+TEST(MemoryBalloonTarget, leavesHeadroomAlone)
+{
+    EXPECT_EQ(mp::memory_balloon_target(total, {gib(2), gib(1)}), gib(2));
+    EXPECT_EQ(mp::memory_balloon_target(total, {gib(2), gib(0.75)}), gib(2));
+}
+
+TEST(MemoryBalloonTarget, givesEverythingBackWhenTheGuestRunsShort)
+{
+    EXPECT_EQ(mp::memory_balloon_target(total, {gib(1.5), gib(0.25)}), total);
+}
+
+TEST(MemoryBalloonTarget, neverShrinksBelowTheFloor)
+{
+    EXPECT_EQ(mp::memory_balloon_target(gib(1), {gib(0.6), gib(0.6)}), gib(0.5));
+    EXPECT_EQ(mp::memory_balloon_target(gib(0.5), {gib(0.5), gib(0.5)}), gib(0.5));
+}
+
+struct MemoryReclaimer : public Test
+{
+    NiceMock<mpt::MockVirtualMachine> vm{};
+    mp::MemoryReclaimer reclaimer;
+};
+
+TEST_F(MemoryReclaimer, inflatesTheBalloonAndRecordsWhatWasReclaimed)
+{
+    EXPECT_CALL(vm, memory_balloon)
+        .WillOnce(Return(mp::MemoryBalloon{total, gib(3.5)}))
+        .WillOnce(Return(mp::MemoryBalloon{gib(3.5), gib(3)}));
+    EXPECT_CALL(vm, set_memory_balloon_target(gib(3.5)));
+    EXPECT_CALL(vm, set_memory_balloon_target(gib(3)));
+
+    reclaimer.reclaim({{"shumway", vm, total}}, true);
+    EXPECT_FALSE(reclaimer.reclaimed_memory("shumway").has_value());
+
+    reclaimer.reclaim({{"shumway", vm, total}}, true);
+    EXPECT_EQ(reclaimer.reclaimed_memory("shumway"), gib(0.5));
+}
+
+TEST_F(MemoryReclaimer, givesMemoryBackWhenDisabled)
+{
+    EXPECT_CALL(vm, memory_balloon)
+        .WillOnce(Return(mp::MemoryBalloon{gib(3), gib(2)}))
+        .WillOnce(Return(mp::MemoryBalloon{gib(2.5), gib(1.5)}))
+        .WillRepeatedly(Return(mp::MemoryBalloon{total, gib(3)}));
+    EXPECT_CALL(vm, set_memory_balloon_target(gib(2.5)));
+    EXPECT_CALL(vm, set_memory_balloon_target(total));
+
+    reclaimer.reclaim({{"melmac", vm, total}}, true);
+    reclaimer.reclaim({{"melmac", vm, total}}, false);
+    EXPECT_EQ(reclaimer.reclaimed_memory("melmac"), gib(1.5));
+
+    reclaimer.reclaim({{"melmac", vm, total}}, false);
+    reclaimer.reclaim({{"melmac", vm, total}}, false); // nothing left to give back
+
+    EXPECT_FALSE(reclaimer.reclaimed_memory("melmac").has_value());
+}
+
+TEST_F(MemoryReclaimer, givesBackWhatItDoesNotRememberTakingWhenDisabled)
+{
+    // As after a daemon restart, with the balloon still inflated
+    EXPECT_CALL(vm, memory_balloon).WillOnce(Return(mp::MemoryBalloon{gib(2.5), gib(1.5)}));
+    EXPECT_CALL(vm, set_memory_balloon_target(total));
+
+    reclaimer.reclaim({{"alf", vm, total}}, false);
+    EXPECT_EQ(reclaimer.reclaimed_memory("alf"), gib(1.5));
+}
+
+TEST_F(MemoryReclaimer, leavesFullBalloonsAloneWhenDisabled)
+{
+    EXPECT_CALL(vm, memory_balloon).WillOnce(Return(mp::MemoryBalloon{total, gib(3)}));
+    EXPECT_CALL(vm, set_memory_balloon_target).Times(0);
+
+    reclaimer.reclaim({{"lucky", vm, total}}, false);
+    EXPECT_FALSE(reclaimer.reclaimed_memory("lucky").has_value());
+}
+
+TEST_F(MemoryReclaimer, leavesInstancesWithoutBalloonAlone)
+{
+    EXPECT_CALL(vm, memory_balloon)
+        .WillOnce(Throw(mp::NotImplementedOnThisBackendException{"memory ballooning"}));
+    EXPECT_CALL(vm, set_memory_balloon_target).Times(0);
+
+    reclaimer.reclaim({{"tanner", vm, total}}, true);
+    EXPECT_FALSE(reclaimer.reclaimed_memory("tanner").has_value());
+}
+
+TEST_F(MemoryReclaimer, logsFailuresAndKeepsWhatWasReclaimed)
+{
+    auto logger_scope = mpt::MockLogger::inject(mpl::Level::warning);
+    logger_scope.mock_logger->screen_logs(mpl::Level::warning);
+    logger_scope.mock_logger->expect_log(mpl::Level::warning, "Timed out");
+
+    EXPECT_CALL(vm, memory_balloon)
+        .WillOnce(Return(mp::MemoryBalloon{gib(3), std::nullopt}))
+        .WillOnce(Throw(std::runtime_error{"Timed out waiting for QEMU"}));
+
+    reclaimer.reclaim({{"ochmonek", vm, total}}, true);
+    reclaimer.reclaim({{"ochmonek", vm, total}}, true);
+    EXPECT_EQ(reclaimer.reclaimed_memory("ochmonek"), gib(1));
+}
+} // namespace
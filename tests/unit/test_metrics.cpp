@@ -0,0 +1,148 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <multipass/metrics.h>
+
+#include <thread>
+
+namespace mpm = multipass::metrics;
+
+using namespace testing;
+
+namespace
+{
+TEST(Metrics, countersAddUp)
+{
+    mpm::Registry registry;
+    auto& counter = registry.counter("things_total", "Things");
+
+    counter.increment();
+    counter.increment(41);
+
+    EXPECT_EQ(counter.value(), 42u);
+}
+
+TEST(Metrics, sameNameAndLabelsGiveSameMetric)
+{
+    mpm::Registry registry;
+
+    auto& first = registry.counter("things_total", "Things", {{"kind", "a"}});
+    auto& again = registry.counter("things_total", "Things", {{"kind", "a"}});
+    auto& other = registry.counter("things_total", "Things", {{"kind", "b"}});
+
+    EXPECT_EQ(&first, &again);
+    EXPECT_NE(&first, &other);
+}
+
+TEST(Metrics, nameCannotChangeType)
+{
+    mpm::Registry registry;
+    registry.counter("things", "Things");
+
+    EXPECT_THROW(registry.histogram("things", "Things"), std::invalid_argument);
+}
+
+TEST(Metrics, histogramsSortObservationsIntoBuckets)
+{
+    mpm::Histogram histogram{{1, 5}};
+
+    histogram.observe(0.5);
+    histogram.observe(1.0);
+    histogram.observe(3.0);
+    histogram.observe(7.0);
+
+    EXPECT_THAT(histogram.bucket_counts(), ElementsAre(2u, 1u, 1u));
+    EXPECT_EQ(histogram.count(), 4u);
+    EXPECT_DOUBLE_EQ(histogram.sum(), 11.5);
+}
+
+TEST(Metrics, histogramsObserveDurationsInSeconds)
+{
+    mpm::Histogram histogram{{1}};
+
+    histogram.observe(std::chrono::milliseconds{1500});
+
+    EXPECT_DOUBLE_EQ(histogram.sum(), 1.5);
+    EXPECT_THAT(histogram.bucket_counts(), ElementsAre(0u, 1u));
+}
+
+TEST(Metrics, histogramsRefuseUnsortedBounds)
+{
+    EXPECT_THROW(mpm::Histogram({5, 1}), std::invalid_argument);
+}
+
+TEST(Metrics, countersAreSafeToUpdateConcurrently)
+{
+    mpm::Counter counter;
+    std::vector<std::thread> threads;
+    for (auto i = 0; i < 4; ++i)
+        threads.emplace_back([&counter] {
+            for (auto j = 0; j < 1000; ++j)
+                counter.increment();
+        });
+
+    for (auto& thread : threads)
+        thread.join();
+
+    EXPECT_EQ(counter.value(), 4000u);
+}
+
+TEST(Metrics, rendersPrometheusTextFormat)
+{
+    mpm::Registry registry;
+    registry.counter("requests_total", "Requests served", {{"code", "OK"}}).increment(3);
+    registry.counter("requests_total", "Requests served", {{"code", "NOT_FOUND"}}).increment();
+    auto& histogram = registry.histogram("request_seconds", "Request time", {}, {0.5, 2});
+    histogram.observe(0.25);
+    histogram.observe(1.0);
+
+    EXPECT_EQ(registry.to_text(),
+              "# HELP request_seconds Request time\n"
+              "# TYPE request_seconds histogram\n"
+              "request_seconds_bucket{le=\"0.5\"} 1\n"
+              "request_seconds_bucket{le=\"2\"} 2\n"
+              "request_seconds_bucket{le=\"+Inf\"} 2\n"
+              "request_seconds_sum 1.25\n"
+              "request_seconds_count 2\n"
+              "# HELP requests_total Requests served\n"
+              "# TYPE requests_total counter\n"
+              "requests_total{code=\"NOT_FOUND\"} 1\n"
+              "requests_total{code=\"OK\"} 3\n");
+}
+
+TEST(Metrics, histogramLabelsPrecedeBucketBound)
+{
+    mpm::Registry registry;
+    registry.histogram("boot_seconds", "Boots", {{"instance", "foo"}}, {1}).observe(0.5);
+
+    EXPECT_THAT(registry.to_text(),
+                AllOf(HasSubstr("boot_seconds_bucket{instance=\"foo\",le=\"1\"} 1\n"),
+                      HasSubstr("boot_seconds_sum{instance=\"foo\"} 0.5\n")));
+}
+
+TEST(Metrics, escapesLabelValuesAndHelp)
+{
+    mpm::Registry registry;
+    registry.counter("ops_total", "Ops\nper \\mount", {{"target", "a \"b\"\\c"}}).increment();
+
+    EXPECT_THAT(registry.to_text(),
+                AllOf(HasSubstr("# HELP ops_total Ops\\nper \\\\mount\n"),
+                      HasSubstr("ops_total{target=\"a \\\"b\\\"\\\\c\"} 1\n")));
+}
+} // namespace
@@ -1436,12 +1436,18 @@ auto construct_zones_reply()
     zone_entry->set_name("zone1");
     zone_entry->set_available(true);
     zone_entry->set_subnet("192.168.1.0/24");
+    zone_entry->set_instances(2);
+    zone_entry->set_cpus(3);
+    zone_entry->set_memory(3221225472);
+    zone_entry->set_disk(21474836480);
 
     zone_entry = zones_reply.add_zones();
     zone_entry->set_name("zone2");
     zone_entry->set_available(false);
     zone_entry->set_subnet("192.168.2.0/24");
 
+    zones_reply.set_placement("least-loaded");
+
     return zones_reply;
 }
 
@@ -1449,9 +1455,12 @@ auto construct_zones_reply()
 TEST_F(BaseFormatterSuite, table_formatter_formats_zones_correctly)
 {
     const auto zones_reply = construct_zones_reply();
-    const std::string expected_output = "Name    State         Subnet\n"
-                                        "zone1   Available     192.168.1.0/24\n"
-                                        "zone2   Unavailable   192.168.2.0/24\n";
+    const std::string expected_output =
+        "Name    State         Subnet           Instances  CPUs       Memory    Disk\n"
+        "zone1   Available     192.168.1.0/24   2          3          3.0GiB    20.0GiB\n"
+        "zone2   Unavailable   192.168.2.0/24   0          0          0B        0B\n"
+        "\n"
+        "Automatic placement: least-loaded\n";
 
     EXPECT_EQ(table_formatter.format(zones_reply), expected_output);
 }
@@ -1463,11 +1472,19 @@ TEST_F(BaseFormatterSuite, json_formatter_formats_zones_correctly)
     const std::string expected_output = "{\n"
                                         "    \"zone1\": {\n"
                                         "        \"available\": true,\n"
-                                        "        \"subnet\": \"192.168.1.0/24\"\n"
+                                        "        \"subnet\": \"192.168.1.0/24\",\n"
+                                        "        \"instances\": 2,\n"
+                                        "        \"cpus\": 3,\n"
+                                        "        \"memory\": 3221225472,\n"
+                                        "        \"disk\": 21474836480\n"
                                         "    },\n"
                                         "    \"zone2\": {\n"
                                         "        \"available\": false,\n"
-                                        "        \"subnet\": \"192.168.2.0/24\"\n"
+                                        "        \"subnet\": \"192.168.2.0/24\",\n"
+                                        "        \"instances\": 0,\n"
+                                        "        \"cpus\": 0,\n"
+                                        "        \"memory\": 0,\n"
+                                        "        \"disk\": 0\n"
                                         "    }\n"
                                         "}\n";
 
@@ -1481,9 +1498,44 @@ TEST_F(BaseFormatterSuite, yaml_formatter_formats_zones_correctly)
     const std::string expected_output = "zone1:\n"
                                         "  available: true\n"
                                         "  subnet: 192.168.1.0/24\n"
+                                        "  instances: 2\n"
+                                        "  cpus: 3\n"
+                                        "  memory: 3221225472\n"
+                                        "  disk: 21474836480\n"
                                         "zone2:\n"
                                         "  available: false\n"
-                                        "  subnet: 192.168.2.0/24\n";
+                                        "  subnet: 192.168.2.0/24\n"
+                                        "  instances: 0\n"
+                                        "  cpus: 0\n"
+                                        "  memory: 0\n"
+                                        "  disk: 0\n";
 
     EXPECT_EQ(yaml_formatter.format(zones_reply), expected_output);
 }
+
+auto construct_ballooned_instance_info_reply()
+{
+    auto info_reply = construct_single_instance_info_reply();
+    info_reply.mutable_details(0)->mutable_instance_info()->set_memory_reclaimed("536870912");
+
+    return info_reply;
+}
+
+// Tests for the formatters' handling of memory reclaimed through the balloon
+TEST_F(BaseFormatterSuite, table_formatter_shows_reclaimed_memory)
+{
+    EXPECT_THAT(table_formatter.format(construct_ballooned_instance_info_reply()),
+                HasSubstr("Memory usage:   58.0MiB out of 1.4GiB (512.0MiB reclaimed)\n"));
+}
+
+TEST_F(BaseFormatterSuite, json_formatter_shows_reclaimed_memory)
+{
+    EXPECT_THAT(json_formatter.format(construct_ballooned_instance_info_reply()),
+                HasSubstr("\"reclaimed\": 536870912"));
+}
+
+TEST_F(BaseFormatterSuite, yaml_formatter_shows_reclaimed_memory)
+{
+    EXPECT_THAT(yaml_formatter.format(construct_ballooned_instance_info_reply()),
+                HasSubstr("reclaimed: 536870912"));
+}
@@ -0,0 +1,306 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "file_operations.h"
+#include "mock_environment_helpers.h"
+#include "mock_process_factory.h"
+#include "path.h"
+#include "temp_file.h"
+
+#include <multipass/platform.h>
+#include <multipass/utils/qcow2_image.h>
+#include <multipass/utils/qemu_img_utils.h>
+
+#include <QFile>
+
+#include <ctime>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <sstream>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+constexpr auto cluster_size = 512u;
+constexpr auto virtual_size = std::uint64_t{5} * 1024 * 1024 * 1024;
+
+struct SnapshotEntry
+{
+    std::string id;
+    std::string tag;
+    std::uint64_t vm_state_size;
+};
+
+void put_be(std::string& image, std::size_t offset, std::uint64_t value, std::size_t width)
+{
+    if (image.size() < offset + width)
+        image.resize(offset + width);
+
+    for (std::size_t i = 0; i < width; ++i)
+        image[offset + i] = static_cast<char>(value >> (8 * (width - 1 - i)));
+}
+
+// Reproduces the metadata layout of `qemu-img create -f qcow2 -o cluster_size=512` followed by
+// `qemu-img snapshot -c` for each entry: v3 header with compression type (112 bytes), refcount
+// table, refcount block and L1 table in the following clusters, snapshot table at the end
+std::string make_qcow2_image(const std::vector<SnapshotEntry>& snapshots = {})
+{
+    std::string image(4 * cluster_size, '\0');
+    image.replace(0, 4, "QFI\xfb");
+    put_be(image, 4, 3, 4);                  // version
+    put_be(image, 20, 9, 4);                 // cluster bits
+    put_be(image, 24, virtual_size, 8);      // size
+    put_be(image, 36, 1, 4);                 // L1 size
+    put_be(image, 40, 3 * cluster_size, 8);  // L1 table offset
+    put_be(image, 48, 1 * cluster_size, 8);  // refcount table offset
+    put_be(image, 56, 1, 4);                 // refcount table clusters
+    put_be(image, 96, 4, 4);                 // refcount order
+    put_be(image, 100, 112, 4);              // header length
+
+    if (!snapshots.empty())
+    {
+        const auto table_offset = image.size();
+        put_be(image, 60, snapshots.size(), 4);
+        put_be(image, 64, table_offset, 8);
+
+        auto pos = table_offset;
+        for (const auto& [id, tag, vm_state_size] : snapshots)
+        {
+            put_be(image, pos, 3 * cluster_size, 8);        // L1 table offset
+            put_be(image, pos + 8, 1, 4);                   // L1 size
+            put_be(image, pos + 12, id.size(), 2);          // id size
+            put_be(image, pos + 14, tag.size(), 2);         // name size
+            put_be(image, pos + 16, 1718148179, 4);         // date
+            put_be(image, pos + 32, vm_state_size, 4);      // VM state size
+            put_be(image, pos + 36, 24, 4);                 // extra data size
+            put_be(image, pos + 40, vm_state_size, 8);      // large VM state size
+            put_be(image, pos + 48, virtual_size, 8);       // disk size
+            put_be(image, pos + 56, ~std::uint64_t{0}, 8);  // icount (disabled)
+            image.resize(pos + 64);
+            image += id + tag;
+            image.resize((image.size() + 7) / 8 * 8);
+            pos = image.size();
+        }
+
+        image.resize((image.size() + cluster_size - 1) / cluster_size * cluster_size);
+    }
+
+    return image;
+}
+
+std::optional<mp::backend::Qcow2Info> read_info(const std::string& image)
+{
+    std::istringstream stream{image};
+    return mp::backend::read_qcow2_info(stream);
+}
+
+void write_image(const mpt::TempFile& file, const std::string& image)
+{
+    std::ofstream out{file.path(), std::ios::binary | std::ios::trunc};
+    out << image;
+}
+
+auto tag_matcher(const std::string& tag)
+{
+    return Field(&mp::backend::Qcow2Snapshot::tag, Eq(tag));
+}
+
+// Has local times be in the given POSIX time zone for the scope's duration
+class TimeZoneScope
+{
+public:
+    explicit TimeZoneScope(const QByteArray& zone) : env{std::in_place, "TZ", zone}
+    {
+        reload();
+    }
+
+    ~TimeZoneScope()
+    {
+        env.reset();
+        reload();
+    }
+
+private:
+    static void reload()
+    {
+#ifdef MULTIPASS_PLATFORM_WINDOWS
+        _tzset();
+#else
+        tzset();
+#endif
+    }
+
+    std::optional<mpt::SetEnvScope> env;
+};
+} // namespace
+
+TEST(Qcow2Image, readsHeader)
+{
+    const auto info = read_info(make_qcow2_image());
+
+    ASSERT_TRUE(info.has_value());
+    EXPECT_EQ(info->version, 3);
+    EXPECT_EQ(info->cluster_bits, 9);
+    EXPECT_EQ(info->virtual_size, virtual_size);
+    EXPECT_THAT(info->backing_file, IsEmpty());
+    EXPECT_THAT(info->snapshots, IsEmpty());
+}
+
+TEST(Qcow2Image, readsSnapshotTable)
+{
+    const auto info = read_info(make_qcow2_image({{"1", "@s1", 0},
+                                                  {"2", "suspend", 1234567890123},
+                                                  {"10", "@s10", 0}}));
+
+    ASSERT_TRUE(info.has_value());
+    ASSERT_THAT(info->snapshots,
+                ElementsAre(tag_matcher("@s1"), tag_matcher("suspend"), tag_matcher("@s10")));
+    EXPECT_EQ(info->snapshots[1].id, "2");
+    EXPECT_EQ(info->snapshots[1].vm_state_size, 1234567890123);
+    EXPECT_EQ(info->snapshots[1].date_sec, 1718148179);
+    EXPECT_FALSE(info->snapshots[1].icount.has_value());
+}
+
+TEST(Qcow2Image, returnsNulloptForOtherFormats)
+{
+    EXPECT_FALSE(read_info(std::string(4096, '\0')).has_value());
+    EXPECT_FALSE(read_info("QFI").has_value());
+    EXPECT_FALSE(
+        mp::backend::read_qcow2_info(std::filesystem::path{"/nonexistent/image"}).has_value());
+}
+
+TEST(Qcow2Image, throwsOnSnapshotTableOutsideImage)
+{
+    auto image = make_qcow2_image({{"1", "@s1", 0}});
+    put_be(image, 64, std::uint64_t{1} << 40, 8);
+
+    MP_EXPECT_THROW_THAT(read_info(image),
+                         mp::backend::Qcow2FormatException,
+                         mpt::match_what(HasSubstr("outside the image")));
+}
+
+TEST(Qcow2Image, survivesCorruptedMetadata)
+{
+    const auto pristine = make_qcow2_image({{"1", "@s1", 0}, {"2", "suspend", 4096}});
+    const auto snapshot_table_end = pristine.find("suspend") + 8;
+
+    std::mt19937 gen{42}; // deterministic, so that failures are reproducible
+    std::uniform_int_distribution<std::size_t> offset_dist{0, snapshot_table_end};
+    std::uniform_int_distribution<int> byte_dist{0, 255};
+    std::uniform_int_distribution<int> count_dist{1, 8};
+
+    for (auto i = 0; i < 20000; ++i)
+    {
+        auto image = pristine;
+        for (auto flips = count_dist(gen); flips; --flips)
+            image[offset_dist(gen)] = static_cast<char>(byte_dist(gen));
+
+        if (i % 4 == 0)
+            image.resize(offset_dist(gen));
+
+        try
+        {
+            read_info(image);
+        }
+        catch (const mp::backend::Qcow2FormatException&)
+        {
+        }
+    }
+}
+
+TEST(Qcow2Image, getImageInfoDoesNotRunQemuImgForQcow2)
+{
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mpt::TempFile file;
+    write_image(file, make_qcow2_image());
+
+    EXPECT_EQ(mp::backend::get_image_info(file.path(), "format"), "qcow2");
+    EXPECT_EQ(mp::backend::get_image_info(file.path(), "virtual-size"),
+              QString::number(virtual_size));
+    EXPECT_THAT(mock_factory_scope->process_list(), IsEmpty());
+}
+
+TEST(Qcow2Image, snapshotQueriesDoNotRunQemuImgForQcow2)
+{
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mpt::TempFile file;
+    write_image(file, make_qcow2_image({{"1", "@s1", 0}, {"10", "@s10", 0}}));
+
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(file.path(), "@s10"));
+    EXPECT_FALSE(mp::backend::instance_image_has_snapshot(file.path(), "@s2"));
+    EXPECT_FALSE(mp::backend::instance_image_has_snapshot(file.path(), "@s"));
+
+    const auto listing = QString{mp::backend::snapshot_list_output(file.path())}.split('\n');
+    ASSERT_GE(listing.size(), 4);
+    EXPECT_EQ(listing[0], "Snapshot list:");
+    EXPECT_THAT(listing[2].toStdString(), StartsWith("1         @s1 "));
+    EXPECT_THAT(listing[3].toStdString(), StartsWith("10        @s10 "));
+    EXPECT_THAT(mock_factory_scope->process_list(), IsEmpty());
+}
+
+TEST(Qcow2Image, snapshotListUsesQemuImgLayout)
+{
+    const TimeZoneScope time_zone{"EST5"};
+    mpt::TempFile file;
+    write_image(file, make_qcow2_image({{"1", "@s1", 0}, {"2", "suspend", 1234567890123}}));
+
+    // dates in local time and sizes in binary units, as qemu-img has them
+    EXPECT_EQ(
+        mp::backend::snapshot_list_output(file.path()).toStdString(),
+        "Snapshot list:\n"
+        "ID        TAG               VM SIZE                DATE     VM CLOCK     ICOUNT\n"
+        "1         @s1                   0 B 2024-06-11 18:22:59 00:00:00.000         --\n"
+        "2         suspend          1.12 TiB 2024-06-11 18:22:59 00:00:00.000         --\n");
+}
+
+TEST(Qcow2Image, snapshotListMatchesQemuImgOnItsOwnImage)
+{
+    const auto image_file = mpt::test_data_path_for("qcow2/snapshots.qcow2");
+    if (!QFile::exists(image_file))
+        GTEST_SKIP() << "No image from qemu-img, see test_data/qcow2/README.md";
+
+    const TimeZoneScope time_zone{"EST5"}; // the zone the expected listing was taken in
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    const auto image_path = MP_PLATFORM.qstr_to_path(image_file);
+
+    EXPECT_EQ(mp::backend::snapshot_list_output(image_path),
+              mpt::load_test_file("qcow2/snapshots.txt"));
+    EXPECT_TRUE(mp::backend::instance_image_has_snapshot(image_path, "suspend"));
+    EXPECT_THAT(mock_factory_scope->process_list(), IsEmpty());
+}
+
+TEST(Qcow2Image, getImageInfoFallsBackToQemuImgForOtherFormats)
+{
+    auto mock_factory_scope = mpt::MockProcessFactory::Inject();
+    mock_factory_scope->register_callback([](mpt::MockProcess* process) {
+        EXPECT_CALL(*process, execute).WillOnce(Return(mp::ProcessState{0, std::nullopt}));
+        EXPECT_CALL(*process, read_all_standard_output)
+            .WillOnce(Return(QByteArray{R"({"format": "raw"})"}));
+    });
+
+    mpt::TempFile file;
+    write_image(file, std::string(4096, '\0'));
+
+    EXPECT_EQ(mp::backend::get_image_info(file.path(), "format"), "raw");
+    EXPECT_EQ(mock_factory_scope->process_list().size(), 1);
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "file_operations.h"
+#include "mock_environment_helpers.h"
+#include "mock_file_ops.h"
+#include "temp_dir.h"
+
+#include <multipass/constants.h>
+#include <multipass/record_database.h>
+
+#include <QFile>
+
+#include <limits>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+
+namespace
+{
+struct RecordDatabase : public Test
+{
+    void write_file(const QString& path, const QByteArray& contents)
+    {
+        QFile file{path};
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly));
+        file.write(contents);
+    }
+
+    mpt::TempDir temp_dir;
+    const QString json_path = temp_dir.filePath("records.json");
+    const QString binary_path = temp_dir.filePath("records.db");
+    const boost::json::object records{
+        {"primary",
+         {{"num_cores", 2},
+          {"mem_size", "1073741824"},
+          {"deleted", false},
+          {"clone_count", std::numeric_limits<std::uint64_t>::max()},
+          {"offset", -42},
+          {"ratio", 0.25},
+          {"zone", nullptr},
+          {"mounts", boost::json::array{"a", "ü", boost::json::object{{"uid", 1000}}}}}},
+        {"other", {{"num_cores", 1}, {"deleted", true}}}};
+};
+
+TEST_F(RecordDatabase, binaryPathReplacesTheJsonExtension)
+{
+    EXPECT_EQ(mp::RecordDatabase::binary_path("/some/dir/records.json"), "/some/dir/records.db");
+    EXPECT_EQ(mp::RecordDatabase::binary_path("records"), "records.db");
+}
+
+TEST_F(RecordDatabase, binaryDatabasesRoundTrip)
+{
+    write_file(binary_path, mp::RecordDatabase::encode(records));
+
+    auto db = mp::RecordDatabase::open_file(binary_path);
+
+    EXPECT_EQ(db.format(), mp::RecordDatabase::Format::binary);
+    EXPECT_THAT(db.keys(), UnorderedElementsAre("primary", "other"));
+    EXPECT_EQ(db.at("primary"), records.at("primary"));
+    EXPECT_EQ(db.to_json(), records);
+}
+
+TEST_F(RecordDatabase, opensJsonDatabases)
+{
+    mpt::make_file_with_content(json_path, boost::json::serialize(records));
+
+    auto db = mp::RecordDatabase::open_file(json_path);
+
+    EXPECT_EQ(db.format(), mp::RecordDatabase::Format::json);
+    EXPECT_EQ(db.to_json(), records);
+}
+
+TEST_F(RecordDatabase, decodesBinaryRecordsOnDemand)
+{
+    auto encoded = mp::RecordDatabase::encode({{"good", 1}, {"bad", true}});
+    encoded[encoded.size() - 1] = '\xff'; // the value of the last record
+    write_file(binary_path, encoded);
+
+    auto db = mp::RecordDatabase::open_file(binary_path);
+
+    EXPECT_THAT(db.keys(), ElementsAre("good", "bad"));
+    EXPECT_EQ(db.at("good"), 1);
+    EXPECT_THROW(db.at("bad"), mp::CorruptRecordDatabaseException);
+}
+
+TEST_F(RecordDatabase, throwsOnTruncatedBinaryDatabases)
+{
+    write_file(binary_path, mp::RecordDatabase::encode(records).chopped(3));
+
+    EXPECT_THROW(mp::RecordDatabase::open_file(binary_path), mp::CorruptRecordDatabaseException);
+}
+
+TEST_F(RecordDatabase, throwsOnUnknownKeys)
+{
+    write_file(binary_path, mp::RecordDatabase::encode(records));
+
+    EXPECT_THROW(mp::RecordDatabase::open_file(binary_path).at("missing"), std::out_of_range);
+}
+
+TEST_F(RecordDatabase, openReturnsNothingWithoutADatabase)
+{
+    EXPECT_FALSE(mp::RecordDatabase::open(json_path));
+
+    mpt::make_file_with_content(json_path, "");
+    EXPECT_FALSE(mp::RecordDatabase::open(json_path));
+}
+
+TEST_F(RecordDatabase, writesJsonByDefault)
+{
+    write_file(binary_path, mp::RecordDatabase::encode({}));
+
+    mp::RecordDatabase::write(json_path, records);
+
+    EXPECT_EQ(boost::json::parse(std::string_view(mpt::load(json_path))), records);
+    EXPECT_FALSE(QFile::exists(binary_path));
+}
+
+TEST_F(RecordDatabase, writesBinaryWhenConfigured)
+{
+    mpt::SetEnvScope env{mp::database_format_env_var, "binary"};
+    mpt::make_file_with_content(json_path, "{}");
+
+    mp::RecordDatabase::write(json_path, records);
+
+    EXPECT_EQ(mpt::load(binary_path), mp::RecordDatabase::encode(records));
+    EXPECT_FALSE(QFile::exists(json_path));
+}
+
+TEST_F(RecordDatabase, convertsJsonToTheConfiguredFormat)
+{
+    mpt::SetEnvScope env{mp::database_format_env_var, "binary"};
+    mpt::make_file_with_content(json_path, boost::json::serialize(records));
+
+    auto db = mp::RecordDatabase::open(json_path);
+
+    ASSERT_TRUE(db);
+    EXPECT_EQ(db->to_json(), records);
+    EXPECT_FALSE(QFile::exists(json_path));
+    EXPECT_EQ(mp::RecordDatabase::open_file(binary_path).to_json(), records);
+}
+
+TEST_F(RecordDatabase, convertsBinaryBackToJson)
+{
+    write_file(binary_path, mp::RecordDatabase::encode(records));
+
+    auto db = mp::RecordDatabase::open(json_path);
+
+    ASSERT_TRUE(db);
+    EXPECT_EQ(db->to_json(), records);
+    EXPECT_FALSE(QFile::exists(binary_path));
+    EXPECT_EQ(mp::RecordDatabase::open_file(json_path).format(), mp::RecordDatabase::Format::json);
+}
+
+TEST_F(RecordDatabase, openReturnsTheRecordsWhenConversionFails)
+{
+    mpt::SetEnvScope env{mp::database_format_env_var, "binary"};
+    mpt::make_file_with_content(json_path, boost::json::serialize(records));
+    auto [mock_file_ops, guard] = mpt::MockFileOps::inject();
+    EXPECT_CALL(*mock_file_ops, write_transactionally(binary_path, _))
+        .WillOnce(Throw(std::runtime_error{"disk full"}));
+
+    auto db = mp::RecordDatabase::open(json_path);
+
+    ASSERT_TRUE(db);
+    EXPECT_EQ(db->to_json(), records);
+    EXPECT_TRUE(QFile::exists(json_path));
+}
+
+TEST_F(RecordDatabase, prefersTheConfiguredFormat)
+{
+    mpt::SetEnvScope env{mp::database_format_env_var, "binary"};
+    mpt::make_file_with_content(json_path, "{}");
+    write_file(binary_path, mp::RecordDatabase::encode(records));
+
+    auto db = mp::RecordDatabase::open(json_path);
+
+    ASSERT_TRUE(db);
+    EXPECT_EQ(db->format(), mp::RecordDatabase::Format::binary);
+    EXPECT_EQ(db->to_json(), records);
+}
+} // namespace
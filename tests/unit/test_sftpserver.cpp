@@ -522,6 +522,73 @@ TEST_F(SftpServer, freesMessage)
     msg_free.expectCalled(1).withValues(msg.get());
 }
 
+TEST_F(SftpServer, countsOperations)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg1 = make_msg(SFTP_BAD_MESSAGE);
+    auto msg2 = make_msg(SFTP_BAD_MESSAGE);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+
+    auto sftp = make_sftpserver();
+    EXPECT_EQ(sftp.operations(), 0u);
+
+    sftp.run();
+
+    EXPECT_EQ(sftp.operations(), 2u);
+}
+
+TEST_F(SftpServer, servesOneRequestAtATime)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    auto msg1 = make_msg(SFTP_BAD_MESSAGE);
+    auto msg2 = make_msg(SFTP_BAD_MESSAGE);
+
+    REPLACE(sftp_get_client_message, make_msg_handler());
+
+    auto sftp = make_sftpserver();
+
+    EXPECT_TRUE(sftp.serve_next());
+    EXPECT_EQ(sftp.operations(), 1u);
+    EXPECT_EQ(messages.size(), 1u);
+
+    EXPECT_TRUE(sftp.serve_next());
+    EXPECT_EQ(sftp.operations(), 2u);
+
+    EXPECT_FALSE(sftp.serve_next()); // the client is gone
+    EXPECT_EQ(sftp.operations(), 2u);
+}
+
+TEST_F(SftpServer, hasPendingPollsTheClientChannel)
+{
+    auto init_msg = make_msg(SSH_FXP_INIT);
+    REPLACE(sftp_get_client_message, make_msg_handler());
+
+    auto sftp = make_sftpserver();
+
+    int poll_result{0};
+    std::vector<int> timeouts;
+    REPLACE(ssh_channel_poll_timeout,
+            [&poll_result, &timeouts](ssh_channel, int timeout_ms, int is_stderr) {
+                EXPECT_EQ(is_stderr, 0);
+                timeouts.push_back(timeout_ms);
+                return poll_result;
+            });
+
+    EXPECT_FALSE(sftp.has_pending(std::chrono::milliseconds{5}));
+
+    poll_result = 12; // bytes waiting
+    EXPECT_TRUE(sftp.has_pending(std::chrono::milliseconds::zero()));
+
+    poll_result = SSH_EOF; // for serve_next() to find out the client is gone
+    EXPECT_TRUE(sftp.has_pending(std::chrono::milliseconds::zero()));
+
+    poll_result = SSH_ERROR;
+    EXPECT_TRUE(sftp.has_pending(std::chrono::milliseconds::zero()));
+
+    EXPECT_THAT(timeouts, ElementsAre(5, 0, 0, 0));
+}
+
 TEST_F(SftpServer, handlesRealpath)
 {
     mpt::TempFile file;
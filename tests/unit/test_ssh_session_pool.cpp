@@ -0,0 +1,198 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+#include "mock_ssh_session.h"
+
+#include <multipass/exceptions/ssh_exception.h>
+#include <multipass/ssh/ssh_session_pool.h>
+
+#include <future>
+
+namespace mp = multipass;
+namespace mpt = multipass::test;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct SSHSessionPool : public Test
+{
+    mp::SSHSessionPool make_pool(std::size_t max_sessions = 4,
+                                 std::chrono::milliseconds max_idle = 1h)
+    {
+        return mp::SSHSessionPool{[this] { return connect(); }, max_sessions, max_idle};
+    }
+
+    std::unique_ptr<mp::SSHSession> connect()
+    {
+        auto session = std::make_unique<NiceMock<mpt::MockSSHSession>>();
+        ON_CALL(*session, is_connected).WillByDefault(Return(true));
+        sessions.push_back(session.get());
+
+        return session;
+    }
+
+    std::vector<mpt::MockSSHSession*> sessions; // owned by the pool
+};
+
+TEST_F(SSHSessionPool, reusesIdleSessions)
+{
+    auto pool = make_pool();
+
+    pool.acquire().reset();
+    pool.acquire().reset();
+
+    EXPECT_THAT(sessions, SizeIs(1));
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST_F(SSHSessionPool, connectsMoreSessionsWhenAllAreInUse)
+{
+    auto pool = make_pool();
+
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+
+    EXPECT_THAT(sessions, SizeIs(2));
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST_F(SSHSessionPool, usesAddedSessions)
+{
+    auto pool = make_pool();
+    pool.add(connect());
+
+    auto session = pool.acquire();
+
+    EXPECT_THAT(sessions, SizeIs(1));
+}
+
+TEST_F(SSHSessionPool, dropsDisconnectedIdleSessions)
+{
+    auto pool = make_pool();
+    pool.acquire().reset();
+    ON_CALL(*sessions.front(), is_connected).WillByDefault(Return(false));
+
+    auto session = pool.acquire();
+
+    EXPECT_THAT(sessions, SizeIs(2));
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST_F(SSHSessionPool, waitsForASessionWhenFull)
+{
+    auto pool = make_pool(1);
+    auto session = pool.acquire();
+
+    auto waiting = std::async(std::launch::async, [&pool] { return pool.acquire(); });
+    EXPECT_EQ(waiting.wait_for(50ms), std::future_status::timeout);
+
+    session.reset();
+    EXPECT_NE(waiting.get(), nullptr);
+    EXPECT_THAT(sessions, SizeIs(1));
+}
+
+TEST_F(SSHSessionPool, keepsSessionsInUseUntilTheirProcessesAreDestroyed)
+{
+    auto pool = make_pool();
+
+    auto first = pool.exec("first");
+    auto second = pool.exec("second");
+    EXPECT_THAT(sessions, SizeIs(2));
+
+    first.reset();
+    second.reset();
+    auto third = pool.exec("third");
+
+    EXPECT_THAT(sessions, SizeIs(2));
+    EXPECT_EQ(pool.size(), 2u);
+}
+
+TEST_F(SSHSessionPool, forwardsCommandsToTheSession)
+{
+    auto pool = make_pool();
+    pool.add(connect());
+
+    EXPECT_CALL(*sessions.front(), exec("echo", true));
+
+    pool.exec("echo", true).reset();
+}
+
+TEST_F(SSHSessionPool, freesTheSlotWhenConnectingFails)
+{
+    auto attempts = 0;
+    mp::SSHSessionPool pool{[this, &attempts] {
+                                if (!attempts++)
+                                    throw mp::SSHException{"intentional"};
+                                return connect();
+                            },
+                            1};
+
+    EXPECT_THROW(pool.acquire(), mp::SSHException);
+    EXPECT_NE(pool.acquire(), nullptr);
+}
+
+TEST_F(SSHSessionPool, resetDiscardsSessionsInUse)
+{
+    auto pool = make_pool();
+    auto session = pool.acquire();
+
+    pool.reset();
+    session.reset();
+
+    EXPECT_EQ(pool.size(), 0u);
+    EXPECT_FALSE(pool.healthy());
+}
+
+TEST_F(SSHSessionPool, evictsIdleSessionsButTheMostRecentlyUsed)
+{
+    auto pool = make_pool(4, 0ms);
+
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+    auto third = pool.acquire();
+    first.reset();
+    second.reset();
+    third.reset();
+
+    EXPECT_EQ(pool.size(), 1u);
+}
+
+TEST_F(SSHSessionPool, healthyDropsDisconnectedIdleSessions)
+{
+    auto pool = make_pool();
+    pool.add(connect());
+    EXPECT_TRUE(pool.healthy());
+
+    ON_CALL(*sessions.front(), is_connected).WillByDefault(Return(false));
+
+    EXPECT_FALSE(pool.healthy());
+    EXPECT_EQ(pool.size(), 0u);
+}
+
+TEST_F(SSHSessionPool, sessionsCanOutliveThePool)
+{
+    auto pool = std::make_unique<mp::SSHSessionPool>([this] { return connect(); });
+    auto session = pool->acquire();
+
+    pool.reset();
+
+    EXPECT_NO_THROW(session.reset());
+}
+} // namespace
@@ -27,6 +27,7 @@
 
 #include <multipass/exceptions/exitless_sshprocess_exceptions.h>
 #include <multipass/exceptions/sshfs_missing_error.h>
+#include <multipass/metrics.h>
 #include <multipass/sshfs_mount/sshfs_mount_handler.h>
 #include <multipass/vm_mount.h>
 
@@ -81,6 +82,13 @@ struct SSHFSMountHandlerTest : public ::Test
         });
     }
 
+    mp::metrics::Counter& sftp_operations(const std::string& target)
+    {
+        return mp::metrics::registry().counter("multipass_sftp_operations_total",
+                                               "SFTP requests served for mounts",
+                                               {{"instance", vm.get_name()}, {"target", target}});
+    }
+
     mpt::StubSSHKeyProvider key_provider;
     std::string source_path{mp::fs::absolute("/my/source/path").string()},
         target_path{"/the/target/path"};
@@ -93,6 +101,34 @@ struct SSHFSMountHandlerTest : public ::Test
     mpt::MockServerReaderWriter<mp::MountReply, mp::MountRequest> server;
     NiceMock<mpt::MockVirtualMachine> vm;
     std::unique_ptr<mpt::MockProcessFactory::Scope> factory = mpt::MockProcessFactory::Inject();
+    QByteArray sshfs_output{"Connected\n"};
+    std::vector<std::string> sshfs_commands;
+    bool sshfs_terminated{false};
+
+    // Have a multiplexed "sshfs_server" acknowledge each command with the given reply
+    mpt::MockProcessFactory::Callback sshfs_serves_multiplexed(const QString& add_reply)
+    {
+        return [this, add_reply](mpt::MockProcess* process) {
+            ON_CALL(*process, read_all_standard_output).WillByDefault([this] {
+                return std::exchange(sshfs_output, {});
+            });
+            ON_CALL(*process, write).WillByDefault([this, process, add_reply](const auto& data) {
+                sshfs_commands.push_back(data.toStdString());
+                const auto fields = QString::fromUtf8(data).trimmed().split('\t');
+                const auto reply = fields.first() == "add" ? add_reply : QString{"removed"};
+                sshfs_output = (reply + '\t' + fields.value(1) + '\n').toUtf8();
+                emit process->ready_read_standard_output();
+                return data.size();
+            });
+            ON_CALL(*process, running).WillByDefault(Return(true));
+            ON_CALL(*process, process_state).WillByDefault(Return(mp::ProcessState{}));
+            ON_CALL(*process, terminate).WillByDefault([this] { sshfs_terminated = true; });
+            ON_CALL(*process, wait_for_finished).WillByDefault(Return(true));
+            QTimer::singleShot(1, process, [process] {
+                emit process->ready_read_standard_output();
+            });
+        };
+    }
 
     mpt::MockProcessFactory::Callback sshfs_prints_connected = [](mpt::MockProcess* process) {
         // Have "sshfs_server" print "Connected" to its stdout after short delay
@@ -186,6 +222,107 @@ TEST_F(SSHFSMountHandlerTest, stopTerminatesSshfsProcess)
     sshfs_mount_handler.deactivate();
 }
 
+TEST_F(SSHFSMountHandlerTest, multiplexedMountsShareOneSshfsProcess)
+{
+    factory->register_callback(sshfs_server_callback(sshfs_serves_multiplexed("added")));
+    EXPECT_CALL(mock_file_ops, status)
+        .WillRepeatedly(
+            Return(mp::fs::file_status{mp::fs::file_type::directory, mp::fs::perms::all}));
+
+    mp::SSHFSMountHandler first{&vm, &key_provider, target_path, mount, /*multiplexed=*/true};
+    mp::SSHFSMountHandler second{&vm, &key_provider, "/other/target", mount, /*multiplexed=*/true};
+    first.activate(&server);
+    second.activate(&server);
+
+    ASSERT_EQ(factory->process_list().size(), 1u);
+    EXPECT_EQ(factory->process_list()[0].arguments.first(), "--multiplex");
+
+    first.deactivate();
+    EXPECT_FALSE(sshfs_terminated);
+    second.deactivate();
+    EXPECT_TRUE(sshfs_terminated);
+
+    ASSERT_EQ(sshfs_commands.size(), 4u);
+    EXPECT_THAT(sshfs_commands[0], AllOf(StartsWith("add\t"), HasSubstr(source_path)));
+    EXPECT_THAT(sshfs_commands[1], AllOf(StartsWith("add\t"), HasSubstr("/other/target")));
+    EXPECT_THAT(sshfs_commands[2], StartsWith("remove\t"));
+    EXPECT_THAT(sshfs_commands[3], StartsWith("remove\t"));
+}
+
+TEST_F(SSHFSMountHandlerTest, multiplexedMountThrowsWhenSshfsIsMissing)
+{
+    factory->register_callback(sshfs_server_callback(sshfs_serves_multiplexed("missing")));
+
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm,
+                                              &key_provider,
+                                              target_path,
+                                              mount,
+                                              /*multiplexed=*/true};
+    EXPECT_THROW(sshfs_mount_handler.activate(&server), mp::SSHFSMissingError);
+}
+
+TEST_F(SSHFSMountHandlerTest, countsSftpOperationsReportedBySshfsServer)
+{
+    mpt::MockProcess* sshfs_process{nullptr};
+    factory->register_callback(
+        sshfs_server_callback([this, &sshfs_process](mpt::MockProcess* process) {
+            sshfs_prints_connected(process);
+            sshfs_process = process;
+        }));
+
+    mp::SSHFSMountHandler sshfs_mount_handler{&vm, &key_provider, target_path, mount};
+    sshfs_mount_handler.activate(&server);
+    ASSERT_NE(sshfs_process, nullptr);
+
+    auto& operations = sftp_operations(target_path);
+    const auto operations_before = operations.value();
+
+    // a report can be split across reads
+    EXPECT_CALL(*sshfs_process, read_all_standard_output)
+        .WillOnce(Return("operations\t4\nopera"))
+        .WillOnce(Return("tions\t3\n"));
+    emit sshfs_process->ready_read_standard_output();
+    emit sshfs_process->ready_read_standard_output();
+
+    EXPECT_EQ(operations.value() - operations_before, 7u);
+}
+
+TEST_F(SSHFSMountHandlerTest, countsSftpOperationsOfEachMultiplexedMount)
+{
+    mpt::MockProcess* sshfs_process{nullptr};
+    factory->register_callback(sshfs_server_callback(
+        [serve = sshfs_serves_multiplexed("added"), &sshfs_process](mpt::MockProcess* process) {
+            serve(process);
+            sshfs_process = process;
+        }));
+    EXPECT_CALL(mock_file_ops, status)
+        .WillRepeatedly(
+            Return(mp::fs::file_status{mp::fs::file_type::directory, mp::fs::perms::all}));
+
+    mp::SSHFSMountHandler first{&vm, &key_provider, target_path, mount, /*multiplexed=*/true};
+    mp::SSHFSMountHandler second{&vm, &key_provider, "/other/target", mount, /*multiplexed=*/true};
+    first.activate(&server);
+    second.activate(&server);
+    ASSERT_NE(sshfs_process, nullptr);
+    ASSERT_EQ(sshfs_commands.size(), 2u);
+
+    auto& first_operations = sftp_operations(target_path);
+    auto& second_operations = sftp_operations("/other/target");
+    const auto first_before = first_operations.value();
+    const auto second_before = second_operations.value();
+
+    auto id_in = [](const std::string& command) {
+        return QString::fromStdString(command).split('\t').value(1);
+    };
+    sshfs_output = QString{"operations\t%1\t5\noperations\t%2\t2\n"}
+                       .arg(id_in(sshfs_commands[0]), id_in(sshfs_commands[1]))
+                       .toUtf8();
+    emit sshfs_process->ready_read_standard_output();
+
+    EXPECT_EQ(first_operations.value() - first_before, 5u);
+    EXPECT_EQ(second_operations.value() - second_before, 2u);
+}
+
 TEST_F(SSHFSMountHandlerTest, throwsInstallSshfsWhichSnapFails)
 {
     auto session = std::make_unique<NiceMock<mpt::MockSSHSession>>();
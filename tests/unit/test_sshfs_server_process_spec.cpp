@@ -63,6 +63,15 @@ TEST_F(TestSSHFSServerProcessSpec, argumentsCorrect)
     EXPECT_EQ(spec.arguments()[7], "0");
 }
 
+TEST_F(TestSSHFSServerProcessSpec, multiplexedArgumentsCorrect)
+{
+    config.multiplexed_sources = std::make_shared<std::vector<std::string>>();
+    mp::SSHFSServerProcessSpec spec(config);
+
+    EXPECT_EQ(spec.arguments(), QStringList({"--multiplex", "host", "42", "username", "0"}));
+    EXPECT_EQ(spec.identifier(), "instance.mounts");
+}
+
 TEST_F(TestSSHFSServerProcessSpec, environmentCorrect)
 {
     mp::SSHFSServerProcessSpec spec(config);
@@ -103,3 +112,17 @@ TEST_F(TestSSHFSServerProcessSpec, unconfinedApparmorProfileReturnsExpectedData)
     EXPECT_TRUE(apparmor_profile.contains(current_dir.absolutePath() + "/{usr/,}lib/**"));
     EXPECT_TRUE(apparmor_profile.contains("signal (receive) peer=unconfined"));
 }
+
+TEST_F(TestSSHFSServerProcessSpec, multiplexedApparmorProfileCoversCurrentSources)
+{
+    config.multiplexed_sources = std::make_shared<std::vector<std::string>>();
+    mp::SSHFSServerProcessSpec spec(config);
+
+    config.multiplexed_sources->push_back("/first/source");
+    config.multiplexed_sources->push_back("/second/source");
+    const auto apparmor_profile = spec.apparmor_profile();
+
+    EXPECT_TRUE(apparmor_profile.contains("/first/source/** rwlk,"));
+    EXPECT_TRUE(apparmor_profile.contains("/second/source/** rwlk,"));
+    EXPECT_FALSE(apparmor_profile.contains("source_path"));
+}
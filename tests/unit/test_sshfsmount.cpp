@@ -31,6 +31,10 @@
 #include <multipass/utils.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <queue>
 #include <tuple>
 #include <vector>
 
@@ -208,6 +212,87 @@ struct SshfsMount : public mp::test::SftpServerTest
             << "\"" << next_expected_cmd->first << "\" not executed";
     }
 
+    // Runs the test against a multiplexer on a fake session, where every command succeeds unless
+    // it contains failing_cmd. Clients send what is queued in client_messages, and their channels
+    // have something pending whenever channel_poll_result says so.
+    void test_multiplexer(const std::function<void(mp::SshfsMountMultiplexer&)>& test,
+                          mp::SshfsMountMultiplexer::StoppedCallback on_stopped = {},
+                          const std::string& failing_cmd = {})
+    {
+        // libssh is only used from the multiplexer's thread, whose tasks the test waits on
+        std::string output;
+        std::string::size_type remaining{0};
+        bool invoked{false};
+        int exit_status{exit_status_mock.success_status};
+        ssh_channel_callbacks channel_cbs{nullptr};
+
+        REPLACE(ssh_channel_new,
+                [](auto...) { return reinterpret_cast<ssh_channel>(0xdeadbeefdeadbeef); });
+        REPLACE(ssh_channel_free, [](auto...) { return; });
+        REPLACE(ssh_add_channel_callbacks, [&channel_cbs](ssh_channel, ssh_channel_callbacks cb) {
+            channel_cbs = cb;
+            return SSH_OK;
+        });
+        REPLACE(ssh_remove_channel_callbacks,
+                [&channel_cbs](ssh_channel, ssh_channel_callbacks cb) {
+                    if (cb == channel_cbs)
+                        channel_cbs = nullptr;
+                    return SSH_OK;
+                });
+        REPLACE(ssh_event_new,
+                [](auto...) { return reinterpret_cast<ssh_event>(0xdeadbeefdeadbeef); });
+        REPLACE(ssh_event_free, [](auto...) { return; });
+        REPLACE(ssh_event_add_session, [](auto...) { return SSH_OK; });
+        // Processes exit as soon as they are waited on; an idle session stays quiet for a while
+        REPLACE(ssh_event_dopoll, [&channel_cbs, &exit_status](auto...) {
+            if (channel_cbs)
+                channel_cbs->channel_exit_status_function(nullptr,
+                                                          nullptr,
+                                                          exit_status,
+                                                          channel_cbs->userdata);
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds{1});
+            return SSH_OK;
+        });
+        REPLACE(ssh_is_connected, [this](auto...) { return session_connected.load() ? 1 : 0; });
+        REPLACE(ssh_channel_poll_timeout, [this](auto...) { return channel_poll_result.load(); });
+        REPLACE(ssh_channel_read_timeout, make_channel_read_return(output, remaining, invoked));
+        REPLACE(ssh_channel_request_exec, [&](ssh_channel, const char* raw_cmd) {
+            const std::string cmd{raw_cmd};
+            const auto it = default_cmds.find(cmd);
+            invoked = it != default_cmds.end();
+            output = invoked ? it->second : "";
+            remaining = output.size();
+            exit_status = !failing_cmd.empty() && cmd.find(failing_cmd) != std::string::npos
+                              ? exit_status_mock.failure_status
+                              : exit_status_mock.success_status;
+            return SSH_OK;
+        });
+        REPLACE(sftp_get_client_message, [this](auto...) -> sftp_client_message {
+            std::lock_guard lock{client_messages_mutex};
+            if (client_messages.empty())
+                return nullptr;
+
+            auto msg = client_messages.front();
+            client_messages.pop();
+            return msg;
+        });
+
+        mp::SshfsMountMultiplexer multiplexer{
+            std::make_unique<mp::PlainSSHSession>("a", 42, "ubuntu", key_provider),
+            on_stopped ? std::move(on_stopped) : [](const std::string& id) {
+                ADD_FAILURE() << "mount " << id << " stopped unexpectedly";
+            }};
+        test(multiplexer);
+        multiplexer.stop();
+    }
+
+    void queue_client_message(sftp_client_message msg)
+    {
+        std::lock_guard lock{client_messages_mutex};
+        client_messages.push(msg);
+    }
+
     sftp_client_message_struct make_init_message()
     {
         sftp_client_message_struct mock_init_client_message{};
@@ -221,6 +306,10 @@ struct SshfsMount : public mp::test::SftpServerTest
     }
 
     mpt::ExitStatusMock exit_status_mock;
+    std::mutex client_messages_mutex;
+    std::queue<sftp_client_message> client_messages;
+    std::atomic<int> channel_poll_result{0};
+    std::atomic<bool> session_connected{true};
 
     std::string default_source{"source"};
     std::string default_target{"target"};
@@ -507,3 +596,115 @@ TEST_F(SshfsMount, blankFuseVersionLogsError)
 
     test_command_execution(commands);
 }
+
+TEST_F(SshfsMount, multiplexerServesMountsUntilTheyAreRemoved)
+{
+    sftp_client_message_struct init_message{make_init_message()};
+    queue_client_message(&init_message);
+    queue_client_message(&init_message);
+
+    test_multiplexer([this](mp::SshfsMountMultiplexer& multiplexer) {
+        multiplexer.add("1", default_source, default_target, default_mappings, default_mappings);
+        multiplexer.add("2", default_source, default_target, default_mappings, default_mappings);
+        EXPECT_THROW(multiplexer.add("1", default_source, default_target, default_mappings, {}),
+                     std::runtime_error);
+
+        EXPECT_THAT(multiplexer.operations(), ElementsAre(Pair("1", 0u), Pair("2", 0u)));
+
+        EXPECT_TRUE(multiplexer.remove("1"));
+        EXPECT_FALSE(multiplexer.remove("1"));
+        EXPECT_THAT(multiplexer.operations(), ElementsAre(Pair("2", 0u)));
+        EXPECT_TRUE(multiplexer.alive());
+    });
+}
+
+TEST_F(SshfsMount, multiplexerServesPendingRequestsUntilTheClientLeaves)
+{
+    sftp_client_message_struct init_message{make_init_message()};
+    sftp_client_message_struct request{};
+    request.type = 255u; // unsupported, answered with a status
+    queue_client_message(&init_message);
+    queue_client_message(&request);
+    queue_client_message(&request);
+
+    std::promise<std::string> stopped;
+    auto stopped_id = stopped.get_future();
+    test_multiplexer(
+        [this, &stopped_id](mp::SshfsMountMultiplexer& multiplexer) {
+            multiplexer.add("1", default_source, default_target, default_mappings, {});
+            channel_poll_result = 1;
+
+            ASSERT_EQ(stopped_id.wait_for(std::chrono::seconds{5}), std::future_status::ready);
+            EXPECT_EQ(stopped_id.get(), "1");
+            EXPECT_TRUE(multiplexer.operations().empty());
+            EXPECT_TRUE(multiplexer.alive());
+        },
+        [&stopped](const std::string& id) { stopped.set_value(id); });
+
+    reply_status.expectCalled(2);
+    EXPECT_TRUE(client_messages.empty());
+}
+
+TEST_F(SshfsMount, multiplexerStopsWhenTheSessionIsLost)
+{
+    sftp_client_message_struct init_message{make_init_message()};
+    queue_client_message(&init_message);
+
+    test_multiplexer([this](mp::SshfsMountMultiplexer& multiplexer) {
+        multiplexer.add("1", default_source, default_target, default_mappings, {});
+        session_connected = false;
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds{5};
+        while (multiplexer.alive() && std::chrono::steady_clock::now() < deadline)
+            std::this_thread::sleep_for(std::chrono::milliseconds{1});
+
+        EXPECT_FALSE(multiplexer.alive());
+        EXPECT_THROW(multiplexer.add("2", default_source, default_target, {}, {}),
+                     std::runtime_error);
+        EXPECT_THROW(multiplexer.operations(), std::runtime_error);
+    });
+}
+
+TEST_F(SshfsMount, multiplexerCommandsAddAndRemoveMounts)
+{
+    sftp_client_message_struct init_message{make_init_message()};
+    queue_client_message(&init_message);
+
+    test_multiplexer([](mp::SshfsMountMultiplexer& multiplexer) {
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "add\t1\tsource\ttarget\t1000:0,\t"),
+                  "added\t1");
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "add\t1\tsource\ttarget\t\t"),
+                  "failed\t1\tmount '1' is already being served");
+        EXPECT_THAT(multiplexer.operations(), ElementsAre(Pair("1", 0u)));
+
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "remove\t1"), "removed\t1");
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "remove\t1"), "removed\t1");
+        EXPECT_TRUE(multiplexer.operations().empty());
+
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "remove\t1\tsource"),
+                  "failed\t1\tIncorrect command");
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "add\t2\tsource\ttarget"),
+                  "failed\t2\tIncorrect command");
+        EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "mount\t3"),
+                  "failed\t3\tIncorrect command");
+    });
+}
+
+TEST_F(SshfsMount, multiplexerCommandsReportMissingSshfs)
+{
+    test_multiplexer(
+        [](mp::SshfsMountMultiplexer& multiplexer) {
+            EXPECT_EQ(mp::run_multiplexer_command(multiplexer, "add\t1\tsource\ttarget\t\t"),
+                      "missing\t1");
+            EXPECT_TRUE(multiplexer.operations().empty());
+        },
+        {},
+        "sshfs");
+}
+
+TEST_F(SshfsMount, parsesIdMappings)
+{
+    EXPECT_EQ(mp::parse_id_mappings("1000:1001,0:-1,"), (mp::id_mappings{{1000, 1001}, {0, -1}}));
+    EXPECT_EQ(mp::parse_id_mappings("1000,a:b,2:3"), (mp::id_mappings{{2, 3}}));
+    EXPECT_TRUE(mp::parse_id_mappings("").empty());
+}
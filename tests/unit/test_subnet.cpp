@@ -348,8 +348,58 @@ TEST(SubnetTest, relationalComparisonsWorkAsExpected)
     EXPECT_LT(submiddle, high);
 }
 
+TEST(SubnetOverlapIndexTest, emptyIndexOverlapsNothing)
+{
+    const mp::SubnetOverlapIndex index{};
+
+    EXPECT_EQ(index.size(), 0);
+    EXPECT_FALSE(index.overlaps(mp::Subnet{"0.0.0.0/0"}));
+    EXPECT_FALSE(index.covers(mp::Subnet{"10.0.0.0/8"}));
+}
+
+TEST(SubnetOverlapIndexTest, overlapsDetectsContainingAndContainedSubnets)
+{
+    const mp::SubnetOverlapIndex index{{mp::Subnet{"192.168.123.0/24"},
+                                        mp::Subnet{"10.0.0.0/8"},
+                                        mp::Subnet{"172.17.0.0/16"}}};
+
+    EXPECT_EQ(index.size(), 3);
+    EXPECT_TRUE(index.overlaps(mp::Subnet{"10.20.30.0/24"}));
+    EXPECT_TRUE(index.overlaps(mp::Subnet{"172.16.0.0/12"}));
+    EXPECT_TRUE(index.overlaps(mp::Subnet{"192.168.123.0/24"}));
+    EXPECT_FALSE(index.overlaps(mp::Subnet{"192.168.122.0/24"}));
+    EXPECT_FALSE(index.overlaps(mp::Subnet{"11.0.0.0/24"}));
+    EXPECT_FALSE(index.overlaps(mp::Subnet{"172.18.0.0/16"}));
+}
+
+TEST(SubnetOverlapIndexTest, overlapsSeesPastShorterLaterRanges)
+{
+    // The /24s start after the /8 but end before it, so a lookup must not stop at them
+    const mp::SubnetOverlapIndex index{
+        {mp::Subnet{"10.0.0.0/8"}, mp::Subnet{"10.1.0.0/24"}, mp::Subnet{"10.2.0.0/24"}}};
+
+    EXPECT_TRUE(index.overlaps(mp::Subnet{"10.200.0.0/16"}));
+    EXPECT_TRUE(index.covers(mp::Subnet{"10.200.0.0/16"}));
+}
+
+TEST(SubnetOverlapIndexTest, coversRequiresASingleContainingSubnet)
+{
+    const mp::SubnetOverlapIndex index{
+        {mp::Subnet{"10.97.0.0/17"}, mp::Subnet{"10.97.128.0/17"}, mp::Subnet{"172.16.0.0/12"}}};
+
+    EXPECT_TRUE(index.covers(mp::Subnet{"10.97.1.0/24"}));
+    EXPECT_TRUE(index.covers(mp::Subnet{"172.27.0.0/16"}));
+    EXPECT_FALSE(index.covers(mp::Subnet{"10.97.0.0/16"}));
+    EXPECT_TRUE(index.overlaps(mp::Subnet{"10.97.0.0/16"}));
+}
+
 struct SubnetAllocatorTest : public Test
 {
+    SubnetAllocatorTest()
+    {
+        EXPECT_CALL(mock_platform, local_subnets).Times(AnyNumber());
+    }
+
     const mp::Subnet subnet{"192.168.0.1/16"};
 
     mpt::MockPlatform::GuardedMock mock_platform_injection{mpt::MockPlatform::inject<StrictMock>()};
@@ -414,6 +464,20 @@ TEST_F(SubnetAllocatorTest, nextAvailableSkipsUsedSubnets)
     EXPECT_EQ(res2.masked_address(), mp::IPAddress{"192.168.4.0"});
 }
 
+TEST_F(SubnetAllocatorTest, nextAvailableTakesOneRouteSnapshotPerCall)
+{
+    const mp::SubnetOverlapIndex routes{{mp::Subnet{"192.168.0.0/23"}}};
+    EXPECT_CALL(mock_platform, local_subnets).WillOnce(Return(routes));
+    EXPECT_CALL(mock_platform, subnet_used_locally)
+        .Times(3)
+        .WillRepeatedly([](mp::Subnet subnet, const mp::SubnetOverlapIndex& local_subnets) {
+            return local_subnets.overlaps(subnet);
+        });
+
+    mp::SubnetAllocator allocator{subnet, 24};
+    EXPECT_EQ(allocator.next_available().masked_address(), mp::IPAddress{"192.168.2.0"});
+}
+
 TEST_F(SubnetAllocatorTest, nextAvailableFailsOnBadIndex)
 {
     EXPECT_CALL(mock_platform, subnet_used_locally).WillRepeatedly(Return(false));
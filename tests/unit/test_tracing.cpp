@@ -0,0 +1,129 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <multipass/tracing.h>
+
+#include <boost/json.hpp>
+
+#include <thread>
+
+namespace mptr = multipass::tracing;
+
+using namespace testing;
+
+namespace
+{
+auto span_names(const mptr::Trace& trace)
+{
+    std::vector<std::string> names;
+    for (const auto& span : trace.spans())
+        names.push_back(span.name);
+    return names;
+}
+
+TEST(Tracing, spansWithoutTraceAreNotRecorded)
+{
+    ASSERT_EQ(mptr::current_trace(), nullptr);
+    EXPECT_NO_THROW(mptr::Span{"nothing"});
+}
+
+TEST(Tracing, spansRecordIntoActiveTrace)
+{
+    auto trace = std::make_shared<mptr::Trace>();
+    {
+        mptr::ActiveTrace active_trace{trace};
+        mptr::Span outer{"outer"};
+        {
+            mptr::Span inner{"inner"};
+        }
+    }
+
+    // spans are recorded as they end
+    EXPECT_THAT(span_names(*trace), ElementsAre("inner", "outer"));
+
+    const auto spans = trace->spans();
+    EXPECT_LE(spans[1].start, spans[0].start);
+    EXPECT_GE(spans[1].end, spans[0].end);
+}
+
+TEST(Tracing, activeTraceRestoresPreviousOne)
+{
+    auto outer_trace = std::make_shared<mptr::Trace>();
+    mptr::ActiveTrace outer{outer_trace};
+    {
+        mptr::ActiveTrace inner{nullptr};
+        EXPECT_EQ(mptr::current_trace(), nullptr);
+        mptr::Span span{"untraced"};
+    }
+
+    EXPECT_EQ(mptr::current_trace(), outer_trace);
+    EXPECT_THAT(outer_trace->spans(), IsEmpty());
+}
+
+TEST(Tracing, tracedCarriesTraceToOtherThreads)
+{
+    auto trace = std::make_shared<mptr::Trace>();
+    mptr::ActiveTrace active_trace{trace};
+
+    auto work = mptr::traced([](int n) {
+        mptr::Span span{"work"};
+        return n + 1;
+    });
+
+    int result = 0;
+    std::thread{[&] { result = work(41); }}.join();
+
+    EXPECT_EQ(result, 42);
+    EXPECT_THAT(span_names(*trace), ElementsAre("work"));
+}
+
+TEST(Tracing, spansOnDifferentThreadsGetDifferentThreadIds)
+{
+    auto trace = std::make_shared<mptr::Trace>();
+    {
+        mptr::ActiveTrace active_trace{trace};
+        mptr::Span span{"main"};
+        std::thread{mptr::traced([] { mptr::Span span{"worker"}; })}.join();
+    }
+
+    const auto spans = trace->spans();
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_NE(spans[0].thread, spans[1].thread);
+}
+
+TEST(Tracing, exportsChromeTraceEvents)
+{
+    auto trace = std::make_shared<mptr::Trace>();
+    {
+        mptr::ActiveTrace active_trace{trace};
+        mptr::Span span{"fetch_image"};
+    }
+
+    const auto json = boost::json::parse(trace->to_chrome_json());
+    const auto& events = json.at("traceEvents").as_array();
+    ASSERT_EQ(events.size(), 1u);
+
+    const auto& event = events[0].as_object();
+    EXPECT_EQ(event.at("name"), "fetch_image");
+    EXPECT_EQ(event.at("ph"), "X");
+    EXPECT_GE(event.at("ts").to_number<std::int64_t>(), 0);
+    EXPECT_GE(event.at("dur").to_number<std::int64_t>(), 0);
+    EXPECT_TRUE(event.contains("tid"));
+}
+} // namespace
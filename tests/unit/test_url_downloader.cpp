@@ -23,6 +23,7 @@
 
 #include <multipass/exceptions/aborted_download_exception.h>
 #include <multipass/exceptions/download_exception.h>
+#include <multipass/metrics.h>
 
 #include <QTimer>
 
@@ -84,6 +85,32 @@ TEST_F(URLDownloader, simpleDownloadReturnsExpectedData)
     EXPECT_EQ(downloaded_data, test_data);
 }
 
+TEST_F(URLDownloader, simpleDownloadCountsDownloadedBytes)
+{
+    const QByteArray test_data{"The answer to everything is 42."};
+    mpt::MockQNetworkReply* mock_reply = new mpt::MockQNetworkReply();
+
+    EXPECT_CALL(*mock_network_access_manager, createRequest(_, _, _)).WillOnce(Return(mock_reply));
+    EXPECT_CALL(*mock_reply, readData(_, _))
+        .WillOnce([&test_data](char* data, auto) {
+            memcpy(data, test_data.constData(), test_data.size());
+            return test_data.size();
+        })
+        .WillOnce(Return(0));
+
+    auto& downloaded_bytes = mp::metrics::registry().counter("multipass_download_bytes_total",
+                                                             "Bytes downloaded",
+                                                             {{"source", "network"}});
+    const auto bytes_before = downloaded_bytes.value();
+
+    mp::URLDownloader downloader(cache_dir.path(), 1s);
+    QTimer::singleShot(0, [&mock_reply] { mock_reply->finished(); });
+    downloader.download(fake_url);
+
+    EXPECT_EQ(downloaded_bytes.value() - bytes_before,
+              static_cast<std::uint64_t>(test_data.size()));
+}
+
 TEST_F(URLDownloader, simpleDownloadNetworkTimeoutTriesCache)
 {
     mpt::MockQNetworkReply* mock_reply_abort = new mpt::MockQNetworkReply();
@@ -0,0 +1,128 @@
+/*
+ * Copyright (C) Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "common.h"
+
+#include <src/daemon/warm_pool.h>
+
+namespace mp = multipass;
+
+using namespace testing;
+
+namespace
+{
+mp::LaunchRequest launch_request(const std::string& image, int cores)
+{
+    mp::LaunchRequest request;
+    request.set_image(image);
+    request.set_num_cores(cores);
+    request.set_mem_size("2G");
+    request.set_time_zone("Europe/London");
+
+    return request;
+}
+
+TEST(WarmPool, launchesWithSameImageAndResourcesShareAProfile)
+{
+    auto request = launch_request("noble", 2);
+    const auto profile = mp::WarmPool::profile_for(request);
+    ASSERT_TRUE(profile);
+
+    request.set_instance_name("some-name");
+    EXPECT_EQ(mp::WarmPool::profile_for(request), profile);
+    EXPECT_NE(mp::WarmPool::profile_for(launch_request("noble", 4)), profile);
+    EXPECT_NE(mp::WarmPool::profile_for(launch_request("jammy", 2)), profile);
+
+    request.set_time_zone("America/Sao_Paulo");
+    EXPECT_NE(mp::WarmPool::profile_for(request), profile);
+}
+
+TEST(WarmPool, customisedLaunchesHaveNoProfile)
+{
+    auto with_user_data = launch_request("noble", 2);
+    with_user_data.set_cloud_init_user_data("packages: [git]");
+    EXPECT_EQ(mp::WarmPool::profile_for(with_user_data), std::nullopt);
+
+    auto with_network = launch_request("noble", 2);
+    with_network.add_network_options()->set_id("eth0");
+    EXPECT_EQ(mp::WarmPool::profile_for(with_network), std::nullopt);
+}
+
+TEST(WarmPool, handsOutReadyInstancesOfTheProfileOnly)
+{
+    mp::WarmPool pool;
+    pool.add("warming", "noble");
+    pool.add("ready", "noble");
+    pool.add("other", "jammy");
+    pool.mark_ready("ready");
+    pool.mark_ready("other");
+
+    EXPECT_EQ(pool.take("noble"), "ready");
+    EXPECT_EQ(pool.take("noble"), std::nullopt);
+    EXPECT_FALSE(pool.contains("ready"));
+    EXPECT_TRUE(pool.contains("warming"));
+}
+
+TEST(WarmPool, countsInstancesWarmingUpTowardsSize)
+{
+    mp::WarmPool pool;
+    EXPECT_EQ(pool.missing("noble", 2), 2);
+
+    pool.add("warming", "noble");
+    EXPECT_EQ(pool.missing("noble", 2), 1);
+
+    pool.add("ready", "noble");
+    pool.mark_ready("ready");
+    EXPECT_EQ(pool.missing("noble", 2), 0);
+    EXPECT_EQ(pool.missing("noble", 1), 0);
+    EXPECT_EQ(pool.missing("jammy", 2), 2);
+}
+
+TEST(WarmPool, findsReadyInstancesBeyondSize)
+{
+    mp::WarmPool pool;
+    for (const auto* name : {"a", "b", "c"})
+    {
+        pool.add(name, "noble");
+        pool.mark_ready(name);
+    }
+    pool.add("d", "jammy");
+    pool.mark_ready("d");
+
+    EXPECT_THAT(pool.surplus(1), UnorderedElementsAre("b", "c"));
+    EXPECT_THAT(pool.surplus(0), UnorderedElementsAre("a", "b", "c", "d"));
+    EXPECT_THAT(pool.surplus(3), IsEmpty());
+}
+
+TEST(WarmPool, roundTripsThroughJson)
+{
+    mp::WarmPool pool;
+    pool.add("warming", "noble");
+    pool.add("ready", "jammy");
+    pool.mark_ready("ready");
+
+    const auto restored = mp::WarmPool::from_json(pool.to_json());
+    EXPECT_THAT(restored.names(), ElementsAre("ready", "warming"));
+    EXPECT_TRUE(restored.is_ready("ready"));
+    EXPECT_FALSE(restored.is_ready("warming"));
+}
+
+TEST(WarmPool, refusesMalformedRecords)
+{
+    EXPECT_ANY_THROW(mp::WarmPool::from_json({{"member", {{"profile", "noble"}}}}));
+}
+} // namespace
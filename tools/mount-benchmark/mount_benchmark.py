@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+# coding: utf-8
+
+"""Compare metadata and I/O performance of classic (sshfs), native (9p) and virtiofs mounts.
+
+Usage: mount_benchmark.py <instance> [--source DIR] [--files N] [--size-mib N] [--types ...]
+
+The instance must use the QEMU driver (virtiofs is Linux-only). Native and virtiofs mounts need
+the instance to be stopped while mounting, so the script stops and starts it as needed. Timings
+are taken inside the instance, so they exclude the overhead of `multipass exec` itself.
+"""
+
+import argparse
+import logging
+import subprocess
+import sys
+import tempfile
+
+logger = logging.getLogger("multipass.mount_benchmark")
+logger.addHandler(logging.StreamHandler())
+logger.setLevel(logging.INFO)
+
+TARGET = "/home/ubuntu/mount-benchmark"
+MOUNT_TYPES = ("classic", "native", "virtiofs")
+
+# Each workload prints its own duration, in milliseconds, as the last line of output
+WORKLOADS = {
+    "create files": "mkdir -p {t}/tree && cd {t}/tree && "
+    "for d in $(seq {dirs}); do mkdir $d; for f in $(seq 100); do echo x > $d/$f; done; done",
+    "stat tree": "find {t}/tree -type f -exec stat -c %s {{}} + > /dev/null",
+    "remove tree": "rm -rf {t}/tree",
+    "sequential write": "dd if=/dev/zero of={t}/blob bs=1M count={size} conv=fsync status=none",
+    "sequential read": "sync && echo 3 | sudo tee /proc/sys/vm/drop_caches > /dev/null && "
+    "dd if={t}/blob of=/dev/null bs=1M status=none",
+    "remove blob": "rm -f {t}/blob",
+}
+
+
+def multipass(*args, check=True):
+    logger.debug("multipass %s", " ".join(args))
+    return subprocess.run(["multipass", *args], check=check, capture_output=True, text=True)
+
+
+def timed_exec(instance, command):
+    script = f"s=$(date +%s%N); {command}; e=$(date +%s%N); echo $(( (e - s) / 1000000 ))"
+    result = multipass("exec", instance, "--", "bash", "-c", script)
+    return int(result.stdout.strip().splitlines()[-1])
+
+
+def run_type(instance, source, mount_type, files, size):
+    needs_stop = mount_type != "classic"
+    if needs_stop:
+        multipass("stop", instance)
+
+    multipass("mount", "--type", mount_type, source, f"{instance}:{TARGET}")
+    try:
+        multipass("start", instance)
+        params = {"t": TARGET, "dirs": max(files // 100, 1), "size": size}
+        return {name: timed_exec(instance, cmd.format(**params)) for name, cmd in WORKLOADS.items()}
+    finally:
+        if needs_stop:
+            multipass("stop", instance)
+        multipass("umount", f"{instance}:{TARGET}", check=False)
+
+
+def print_table(results):
+    types = list(results)
+    print(f"{'workload (ms)':<20}" + "".join(f"{t:>12}" for t in types))
+    for name in WORKLOADS:
+        print(f"{name:<20}" + "".join(f"{results[t][name]:>12}" for t in types))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("instance")
+    parser.add_argument("--source", help="host directory to mount (default: a temporary one)")
+    parser.add_argument("--files", type=int, default=10000, help="small files to create")
+    parser.add_argument("--size-mib", type=int, default=1024, help="size of the sequential blob")
+    parser.add_argument("--types", nargs="+", choices=MOUNT_TYPES, default=MOUNT_TYPES)
+    parser.add_argument("--verbose", action="store_true")
+    args = parser.parse_args()
+
+    if args.verbose:
+        logger.setLevel(logging.DEBUG)
+
+    with tempfile.TemporaryDirectory(prefix="mp-mount-benchmark-") as tmp:
+        source = args.source or tmp
+        results = {}
+        for mount_type in args.types:
+            logger.info("Benchmarking %s mount of %s", mount_type, source)
+            try:
+                results[mount_type] = run_type(
+                    args.instance, source, mount_type, args.files, args.size_mib
+                )
+            except subprocess.CalledProcessError as e:
+                logger.error("%s mount failed: %s", mount_type, e.stderr.strip())
+
+    if not results:
+        return 1
+
+    print_table(results)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())